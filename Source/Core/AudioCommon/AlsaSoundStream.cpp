@@ -47,6 +47,7 @@ void AlsaSound::Update()
 void AlsaSound::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - alsa");
+  Common::RegisterCurrentThread(Common::ThreadRole::Audio);
   while (m_thread_status.load() != ALSAThreadStatus::STOPPING)
   {
     while (m_thread_status.load() == ALSAThreadStatus::RUNNING)
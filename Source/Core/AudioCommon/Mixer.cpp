@@ -13,6 +13,7 @@
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 Mixer::Mixer(unsigned int BackendSampleRate)
     : m_sampleRate(BackendSampleRate), m_stretcher(BackendSampleRate)
@@ -122,6 +123,8 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
   if (!samples)
     return 0;
 
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::AudioCallback);
+
   memset(samples, 0, num_samples * 2 * sizeof(short));
 
   if (SConfig::GetInstance().m_audio_stretch)
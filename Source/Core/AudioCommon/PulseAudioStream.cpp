@@ -47,6 +47,7 @@ void PulseAudio::Update()
 void PulseAudio::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - pulse");
+  Common::RegisterCurrentThread(Common::ThreadRole::Audio);
 
   if (PulseInit())
   {
@@ -8,6 +8,7 @@
 
 #include "Common/Assert.h"
 #include "Common/Config/Config.h"
+#include "Common/Config/Snapshot.h"
 
 namespace Config
 {
@@ -72,6 +73,7 @@ void AddConfigChangedCallback(ConfigChangedCallback func)
 
 void InvokeConfigChangedCallbacks()
 {
+  RebuildSnapshot();
   for (const auto& callback : s_callbacks)
     callback();
 }
@@ -95,10 +97,12 @@ void Init()
   ClearCurrentRunLayer();
   // This layer always has to exist
   s_layers[LayerType::Meta] = std::make_unique<RecursiveLayer>();
+  RebuildSnapshot();
 }
 
 void Shutdown()
 {
+  ReleaseSnapshots();
   s_layers.clear();
   s_callbacks.clear();
 }
@@ -0,0 +1,93 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/Config/Snapshot.h"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace Config
+{
+static const Snapshot s_empty_snapshot;
+std::atomic<const Snapshot*> detail::s_snapshot{&s_empty_snapshot};
+std::atomic<u32> detail::s_active_readers{0};
+
+static std::mutex s_mutex;
+static bool s_active = false;
+
+// Function local, as handles may be registered during static initialization.
+static std::vector<CachedValueResolver>& GetResolvers()
+{
+  static std::vector<CachedValueResolver> s_resolvers;
+  return s_resolvers;
+}
+
+static std::unique_ptr<Snapshot> s_current;
+// Replaced snapshots that readers may still be using.
+static std::vector<std::unique_ptr<Snapshot>> s_retired;
+
+// Readers increment the counter before loading the snapshot pointer, and the pointer is replaced
+// before the counter is checked here. Both are sequentially consistent, so if no reader is seen,
+// any reader that comes later is guaranteed to load the new pointer.
+static void ReclaimSnapshotsLocked()
+{
+  if (detail::s_active_readers.load() == 0)
+    s_retired.clear();
+}
+
+static void RebuildSnapshotLocked()
+{
+  const std::vector<CachedValueResolver>& resolvers = GetResolvers();
+  std::vector<CachedValue> values(resolvers.size());
+  for (size_t i = 0; i < resolvers.size(); ++i)
+    resolvers[i](&values[i]);
+
+  auto snapshot = std::make_unique<Snapshot>(std::move(values));
+  detail::s_snapshot.store(snapshot.get());
+  if (s_current)
+    s_retired.push_back(std::move(s_current));
+  s_current = std::move(snapshot);
+  s_active = true;
+
+  ReclaimSnapshotsLocked();
+}
+
+size_t RegisterCachedValue(CachedValueResolver resolver)
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  std::vector<CachedValueResolver>& resolvers = GetResolvers();
+  resolvers.push_back(std::move(resolver));
+
+  // Until the next rebuild, readers fall back to the default value for this index.
+  if (s_active)
+    RebuildSnapshotLocked();
+
+  return resolvers.size() - 1;
+}
+
+void RebuildSnapshot()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  RebuildSnapshotLocked();
+}
+
+void ReleaseSnapshots()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  detail::s_snapshot.store(&s_empty_snapshot);
+  if (s_current)
+    s_retired.push_back(std::move(s_current));
+  s_active = false;
+
+  // Readers are expected to be gone by now. If one isn't, a later rebuild frees the snapshots.
+  ReclaimSnapshotsLocked();
+}
+
+size_t GetRetiredSnapshotCount()
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  return s_retired.size();
+}
+}  // namespace Config
@@ -0,0 +1,93 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Config
+{
+// A resolved setting, as stored in a snapshot.
+class CachedValue final
+{
+public:
+  template <typename T>
+  void Set(const T& value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= sizeof(m_scalar),
+                  "Only scalar settings and strings can be cached");
+    std::memcpy(&m_scalar, &value, sizeof(T));
+  }
+  void Set(const std::string& value) { m_string = value; }
+
+  template <typename T>
+  T Get() const
+  {
+    T value;
+    std::memcpy(&value, &m_scalar, sizeof(T));
+    return value;
+  }
+  const std::string& GetString() const { return m_string; }
+
+private:
+  u64 m_scalar = 0;
+  std::string m_string;
+};
+
+// An immutable set of resolved settings. A new snapshot is built and published whenever the
+// config changes, so readers never have to go through the layers or take a lock.
+class Snapshot final
+{
+public:
+  Snapshot() = default;
+  explicit Snapshot(std::vector<CachedValue> values) : m_values(std::move(values)) {}
+
+  size_t GetSize() const { return m_values.size(); }
+  const CachedValue& GetValue(size_t index) const { return m_values[index]; }
+
+private:
+  std::vector<CachedValue> m_values;
+};
+
+using CachedValueResolver = std::function<void(CachedValue*)>;
+
+// Registers a setting to be resolved into every snapshot, and returns its index.
+size_t RegisterCachedValue(CachedValueResolver resolver);
+
+// Resolves every registered setting and atomically publishes the result. This happens on every
+// config change. Replaced snapshots are freed as soon as no reader is active.
+void RebuildSnapshot();
+void ReleaseSnapshots();
+
+// Number of replaced snapshots that are waiting for readers to finish.
+size_t GetRetiredSnapshotCount();
+
+namespace detail
+{
+extern std::atomic<const Snapshot*> s_snapshot;
+extern std::atomic<u32> s_active_readers;
+}
+
+// Keeps the snapshot returned by GetSnapshot alive for as long as the guard exists. Everything
+// read from the snapshot must be copied out before the guard goes away.
+class SnapshotReadGuard final
+{
+public:
+  SnapshotReadGuard() { detail::s_active_readers.fetch_add(1); }
+  ~SnapshotReadGuard() { detail::s_active_readers.fetch_sub(1); }
+  SnapshotReadGuard(const SnapshotReadGuard&) = delete;
+  SnapshotReadGuard& operator=(const SnapshotReadGuard&) = delete;
+
+  // Never returns nullptr.
+  const Snapshot* GetSnapshot() const { return detail::s_snapshot.load(); }
+};
+}  // namespace Config
@@ -8,6 +8,7 @@
 
 #ifdef _WIN32
 #include <io.h>
+#include <share.h>
 
 #include "Common/CommonFuncs.h"
 #include "Common/StringUtil.h"
@@ -60,7 +61,9 @@ bool IOFile::Open(const std::string& filename, const char openmode[])
 {
   Close();
 #ifdef _WIN32
-  m_good = _tfopen_s(&m_file, UTF8ToTStr(filename).c_str(), UTF8ToTStr(openmode).c_str()) == 0;
+  // Unlike _tfopen_s, this lets the file be opened again at the same time (e.g. to map it).
+  m_file = _tfsopen(UTF8ToTStr(filename).c_str(), UTF8ToTStr(openmode).c_str(), _SH_DENYNO);
+  m_good = m_file != nullptr;
 #else
   m_file = std::fopen(filename.c_str(), openmode);
   m_good = m_file != nullptr;
@@ -0,0 +1,117 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/HostPerfCounter.h"
+
+#if defined(__linux__) && !defined(ANDROID)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define HAVE_PERF_EVENTS 1
+#endif
+
+namespace Common
+{
+#ifdef HAVE_PERF_EVENTS
+static constexpr u64 CacheEvent(u64 cache, u64 op, u64 result)
+{
+  return cache | (op << 8) | (result << 16);
+}
+
+HostPerfCounter::HostPerfCounter(Event event)
+{
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.disabled = 1;
+  // Only user space is interesting here, and that is all unprivileged users may count.
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  switch (event)
+  {
+  case Event::Cycles:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case Event::Instructions:
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case Event::DTLBLoadMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = CacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                             PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  case Event::ITLBLoadMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = CacheEvent(PERF_COUNT_HW_CACHE_ITLB, PERF_COUNT_HW_CACHE_OP_READ,
+                             PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  case Event::L1ICacheLoadMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = CacheEvent(PERF_COUNT_HW_CACHE_L1I, PERF_COUNT_HW_CACHE_OP_READ,
+                             PERF_COUNT_HW_CACHE_RESULT_MISS);
+    break;
+  }
+
+  // pid 0 and cpu -1 count the calling thread on whichever CPU it runs.
+  m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+HostPerfCounter::~HostPerfCounter()
+{
+  if (m_fd >= 0)
+    close(m_fd);
+}
+
+void HostPerfCounter::Start()
+{
+  if (m_fd < 0)
+    return;
+
+  ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+  ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+void HostPerfCounter::Stop()
+{
+  if (m_fd >= 0)
+    ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+}
+
+u64 HostPerfCounter::Read() const
+{
+  u64 value = 0;
+  if (m_fd < 0 || read(m_fd, &value, sizeof(value)) != sizeof(value))
+    return 0;
+  return value;
+}
+
+#else
+
+HostPerfCounter::HostPerfCounter(Event event)
+{
+}
+
+HostPerfCounter::~HostPerfCounter() = default;
+
+void HostPerfCounter::Start()
+{
+}
+
+void HostPerfCounter::Stop()
+{
+}
+
+u64 HostPerfCounter::Read() const
+{
+  return 0;
+}
+
+#endif
+
+}  // namespace Common
@@ -0,0 +1,43 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// Counts a host hardware event (TLB misses, retired instructions, ...) for the thread that created
+// the counter. This uses perf events on Linux. On other hosts, or when the kernel doesn't allow
+// access to the PMU, IsAvailable() returns false and every read returns 0.
+class HostPerfCounter final
+{
+public:
+  enum class Event
+  {
+    Cycles,
+    Instructions,
+    DTLBLoadMisses,
+    ITLBLoadMisses,
+    L1ICacheLoadMisses,
+  };
+
+  explicit HostPerfCounter(Event event);
+  ~HostPerfCounter();
+
+  HostPerfCounter(const HostPerfCounter&) = delete;
+  HostPerfCounter& operator=(const HostPerfCounter&) = delete;
+
+  bool IsAvailable() const { return m_fd >= 0; }
+
+  // Resets the count to 0 and starts counting.
+  void Start();
+  void Stop();
+  u64 Read() const;
+
+private:
+  int m_fd = -1;
+};
+
+}  // namespace Common
@@ -0,0 +1,242 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/JobSystem.h"
+
+#include <string>
+
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+
+namespace Common
+{
+// Identifies the worker (if any) that is running on the current thread.
+static thread_local const JobSystem* s_current_system = nullptr;
+static thread_local size_t s_current_worker = 0;
+// The name given to the current worker by the job it is running, if any.
+static thread_local const char* s_current_job_name = nullptr;
+
+static std::string GetWorkerName(size_t index)
+{
+  return StringFromFormat("Job worker %zu", index);
+}
+
+bool JobHandle::IsDone() const
+{
+  return !m_counter || m_counter->pending.load() == 0;
+}
+
+JobSystem::JobSystem(u32 num_workers)
+{
+  if (num_workers == 0)
+  {
+    // Leave two host threads for the CPU and GPU emulation threads.
+    const u32 host_threads = std::thread::hardware_concurrency();
+    num_workers = std::max(2u, host_threads > 2 ? host_threads - 2 : 0);
+  }
+
+  m_queues.reserve(num_workers);
+  for (u32 i = 0; i < num_workers; ++i)
+    m_queues.push_back(std::make_unique<TaskQueue>());
+
+  m_workers.reserve(num_workers);
+  for (u32 i = 0; i < num_workers; ++i)
+    m_workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<size_t>(i));
+}
+
+JobSystem::~JobSystem()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_sleep_mutex);
+    m_exiting = true;
+  }
+  m_wakeup.notify_all();
+
+  for (std::thread& worker : m_workers)
+    worker.join();
+}
+
+JobSystem& JobSystem::GetInstance()
+{
+  static JobSystem s_instance;
+  return s_instance;
+}
+
+bool JobSystem::IsWorkerThread() const
+{
+  return s_current_system == this;
+}
+
+JobHandle JobSystem::Schedule(Job job, JobPriority priority, JobAffinity affinity)
+{
+  auto counter = std::make_shared<JobHandle::Counter>();
+  Submit(counter, std::move(job), priority, affinity);
+  return JobHandle(std::move(counter));
+}
+
+void JobSystem::SetCurrentJobName(const char* name)
+{
+  if (!s_current_system)
+    return;
+
+  SetCurrentThreadName(name);
+  s_current_job_name = name;
+}
+
+void JobSystem::Wait(const JobHandle& handle)
+{
+  if (!handle.m_counter)
+    return;
+
+  JobHandle::Counter& counter = *handle.m_counter;
+  const bool is_worker = IsWorkerThread();
+  while (counter.pending.load() != 0)
+  {
+    // Help out instead of sleeping. Whatever we pick up is likely to be what we are waiting for,
+    // or work that is blocking it.
+    if (TryRunOne(is_worker))
+      continue;
+
+    // Everything we could run has been taken, so the remaining jobs are running elsewhere.
+    std::unique_lock<std::mutex> lk(counter.mutex);
+    counter.done.wait(lk, [&] { return counter.pending.load() == 0; });
+  }
+}
+
+void JobSystem::Submit(const std::shared_ptr<JobHandle::Counter>& counter, Job job,
+                       JobPriority priority, JobAffinity affinity)
+{
+  counter->pending++;
+
+  TaskQueue& queue = IsWorkerThread() ? *m_queues[s_current_worker] : m_injection_queue;
+  {
+    std::lock_guard<std::mutex> lk(queue.mutex);
+    queue.tasks[static_cast<size_t>(priority)].push_back({std::move(job), counter, affinity});
+    // Counted under the queue lock, so that it can never be decremented before it is incremented.
+    m_num_queued++;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(m_sleep_mutex);
+  }
+  m_wakeup.notify_one();
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+  s_current_system = this;
+  s_current_worker = index;
+  SetCurrentThreadName(GetWorkerName(index).c_str());
+  RegisterCurrentThread(ThreadRole::Background);
+
+  while (true)
+  {
+    if (TryRunOne(true))
+      continue;
+
+    std::unique_lock<std::mutex> lk(m_sleep_mutex);
+    m_wakeup.wait(lk, [this] { return m_num_queued.load() != 0 || m_exiting; });
+    if (m_exiting && m_num_queued.load() == 0)
+      return;
+  }
+}
+
+bool JobSystem::TryRunOne(bool allow_worker_only)
+{
+  if (m_num_queued.load() == 0)
+    return false;
+
+  const bool is_worker = IsWorkerThread();
+  const size_t num_queues = m_queues.size();
+  Task task;
+  for (size_t priority = 0; priority < NUM_PRIORITIES; ++priority)
+  {
+    // Our own queue first, newest job first, as its data is most likely still in cache.
+    if (is_worker && TryPop(*m_queues[s_current_worker], priority, true, allow_worker_only, &task))
+    {
+      Run(task);
+      return true;
+    }
+
+    if (TryPop(m_injection_queue, priority, false, allow_worker_only, &task))
+    {
+      Run(task);
+      return true;
+    }
+
+    // Steal the oldest job from somebody else, starting with our neighbour to spread contention.
+    const size_t first_victim = is_worker ? s_current_worker + 1 : 0;
+    for (size_t i = 0; i < num_queues; ++i)
+    {
+      const size_t victim = (first_victim + i) % num_queues;
+      if (is_worker && victim == s_current_worker)
+        continue;
+
+      if (TryPop(*m_queues[victim], priority, false, allow_worker_only, &task))
+      {
+        Run(task);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+bool JobSystem::TryPop(TaskQueue& queue, size_t priority, bool from_back, bool allow_worker_only,
+                       Task* out)
+{
+  std::lock_guard<std::mutex> lk(queue.mutex);
+  std::deque<Task>& tasks = queue.tasks[priority];
+  if (tasks.empty())
+    return false;
+
+  auto can_run = [allow_worker_only](const Task& task) {
+    return allow_worker_only || task.affinity != JobAffinity::WorkerOnly;
+  };
+
+  if (from_back)
+  {
+    const auto it = std::find_if(tasks.rbegin(), tasks.rend(), can_run);
+    if (it == tasks.rend())
+      return false;
+    *out = std::move(*it);
+    tasks.erase(std::next(it).base());
+  }
+  else
+  {
+    const auto it = std::find_if(tasks.begin(), tasks.end(), can_run);
+    if (it == tasks.end())
+      return false;
+    *out = std::move(*it);
+    tasks.erase(it);
+  }
+
+  m_num_queued--;
+  return true;
+}
+
+void JobSystem::Run(Task& task)
+{
+  // This may be a job that a waiting job picked up, so the waiting job's name is put back after.
+  const char* outer_job_name = s_current_job_name;
+  s_current_job_name = nullptr;
+  task.job();
+  task.job = nullptr;
+  if (s_current_job_name)
+  {
+    SetCurrentThreadName(outer_job_name ? outer_job_name : GetWorkerName(s_current_worker).c_str());
+  }
+  s_current_job_name = outer_job_name;
+
+  JobHandle::Counter& counter = *task.counter;
+  if (counter.pending.fetch_sub(1) == 1)
+  {
+    std::lock_guard<std::mutex> lk(counter.mutex);
+    counter.done.notify_all();
+  }
+  task.counter.reset();
+}
+
+}  // namespace Common
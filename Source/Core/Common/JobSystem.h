@@ -0,0 +1,173 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// A small work-stealing job system shared by every subsystem that wants to run work in the
+// background or split work across host cores.
+//
+// * Schedule(): queues a job and returns a handle which can be waited on.
+// * Wait(): blocks until the job behind a handle has finished. While waiting, the calling thread
+//           helps out by running queued jobs, unless they are marked JobAffinity::WorkerOnly.
+// * ParallelFor(): splits an index range into chunks and runs them on the pool.
+//
+// Each worker owns one deque per priority. Jobs scheduled from a worker go to the back of its own
+// deque and are popped LIFO for cache locality; jobs scheduled from any other thread go to a shared
+// injection queue. Idle workers steal from the front of the other workers' deques. Higher
+// priorities are always drained first, across all queues.
+//
+// Jobs must not block indefinitely. Long-running jobs should poll for cancellation, and work that
+// keeps going for minutes (such as prefetching all hires textures) is better off on its own thread,
+// since it would take a worker away from everything else for that long.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+enum class JobPriority : u8
+{
+  High,
+  Normal,
+  Low,
+};
+
+enum class JobAffinity : u8
+{
+  // May run on any worker, or inline on a thread that is waiting for it.
+  Any,
+  // Only ever runs on a pool worker. Use this for long or I/O-bound jobs, so that a CPU or GPU
+  // emulation thread calling Wait() or ParallelFor() never ends up running them itself.
+  WorkerOnly,
+};
+
+class JobSystem;
+
+class JobHandle final
+{
+public:
+  JobHandle() = default;
+
+  // An empty handle is always done.
+  bool IsDone() const;
+
+private:
+  friend class JobSystem;
+
+  struct Counter
+  {
+    std::atomic<u32> pending{0};
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  explicit JobHandle(std::shared_ptr<Counter> counter) : m_counter(std::move(counter)) {}
+  std::shared_ptr<Counter> m_counter;
+};
+
+class JobSystem final
+{
+public:
+  using Job = std::function<void()>;
+
+  // A worker count of 0 picks a default which leaves room for the CPU and GPU emulation threads.
+  explicit JobSystem(u32 num_workers = 0);
+  // Runs all jobs that are still queued, then stops the workers.
+  ~JobSystem();
+
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  // The emulator-wide instance. Workers are started on first use.
+  static JobSystem& GetInstance();
+
+  u32 GetWorkerCount() const { return static_cast<u32>(m_workers.size()); }
+  // Returns whether the calling thread is one of this system's workers.
+  bool IsWorkerThread() const;
+
+  JobHandle Schedule(Job job, JobPriority priority = JobPriority::Normal,
+                     JobAffinity affinity = JobAffinity::Any);
+  void Wait(const JobHandle& handle);
+
+  // Names the worker thread after the job running on it, until the job returns. Does nothing
+  // outside of a worker.
+  static void SetCurrentJobName(const char* name);
+
+  // Calls func(i) for every i in [begin, end), in chunks of grain_size indices. The calling thread
+  // runs the first chunk itself and helps with the rest, so this is safe to nest inside jobs.
+  template <typename Func>
+  void ParallelFor(size_t begin, size_t end, size_t grain_size, const Func& func,
+                   JobPriority priority = JobPriority::High)
+  {
+    if (begin >= end)
+      return;
+
+    grain_size = std::max<size_t>(grain_size, 1);
+    const size_t first_end = begin + std::min(grain_size, end - begin);
+
+    auto counter = std::make_shared<JobHandle::Counter>();
+    for (size_t chunk = first_end; chunk < end;)
+    {
+      const size_t chunk_end = chunk + std::min(grain_size, end - chunk);
+      Submit(counter,
+             [&func, chunk, chunk_end] {
+               for (size_t i = chunk; i < chunk_end; ++i)
+                 func(i);
+             },
+             priority, JobAffinity::Any);
+      chunk = chunk_end;
+    }
+
+    for (size_t i = begin; i < first_end; ++i)
+      func(i);
+
+    Wait(JobHandle(std::move(counter)));
+  }
+
+private:
+  static constexpr size_t NUM_PRIORITIES = 3;
+
+  struct Task
+  {
+    Job job;
+    std::shared_ptr<JobHandle::Counter> counter;
+    JobAffinity affinity;
+  };
+
+  struct TaskQueue
+  {
+    std::mutex mutex;
+    std::array<std::deque<Task>, NUM_PRIORITIES> tasks;
+  };
+
+  void Submit(const std::shared_ptr<JobHandle::Counter>& counter, Job job, JobPriority priority,
+              JobAffinity affinity);
+  void WorkerLoop(size_t index);
+  bool TryRunOne(bool allow_worker_only);
+  bool TryPop(TaskQueue& queue, size_t priority, bool from_back, bool allow_worker_only,
+              Task* out);
+  void Run(Task& task);
+
+  std::vector<std::unique_ptr<TaskQueue>> m_queues;
+  TaskQueue m_injection_queue;
+  std::vector<std::thread> m_workers;
+
+  std::atomic<u32> m_num_queued{0};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wakeup;
+  bool m_exiting = false;
+};
+
+}  // namespace Common
@@ -2,8 +2,11 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
 #include <cstdarg>
 #include <cstring>
+#include <ctime>
 #include <mutex>
 #include <ostream>
 #include <string>
@@ -15,9 +18,79 @@
 #include "Common/Logging/Log.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/StringUtil.h"
-#include "Common/Timer.h"
+#include "Common/Thread.h"
 
 constexpr size_t MAX_MSGLEN = 1024;
+// How long the drain thread sleeps when no thread wakes it up.
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(50);
+
+struct LogEntry
+{
+  std::chrono::system_clock::time_point time;
+  const char* file;
+  int line;
+  LogTypes::LOG_LEVELS level;
+  LogTypes::LOG_TYPE type;
+  char text[MAX_MSGLEN];
+};
+
+// Lock-free ring of messages, written by the thread that owns it and read by the drain thread.
+class LogRing final
+{
+public:
+  static constexpr size_t SIZE = 256;
+
+  // Returns nullptr if the ring is full.
+  LogEntry* BeginWrite()
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == SIZE)
+      return nullptr;
+    return &m_entries[head % SIZE];
+  }
+
+  // Returns whether the drain thread had caught up with this ring, i.e. may need to be woken up.
+  bool EndWrite()
+  {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    m_head.store(head + 1, std::memory_order_release);
+    return m_tail.load(std::memory_order_acquire) == head;
+  }
+
+  const LogEntry* Peek() const
+  {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return nullptr;
+    return &m_entries[tail % SIZE];
+  }
+
+  void Pop() { m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  // Set when the owning thread exits. The ring is released once it has been drained.
+  Common::Flag abandoned;
+
+private:
+  // The entries keep the producer and consumer indices on separate cache lines.
+  std::atomic<size_t> m_head{0};
+  std::array<LogEntry, SIZE> m_entries;
+  std::atomic<size_t> m_tail{0};
+};
+
+struct ThreadLogRing
+{
+  ~ThreadLogRing()
+  {
+    if (ring)
+      ring->abandoned.Set();
+  }
+
+  std::shared_ptr<LogRing> ring;
+  u32 owner = 0;
+};
+
+static thread_local ThreadLogRing s_thread_ring;
+static std::atomic<u32> s_next_instance_id{1};
 
 class FileLogListener : public LogListener
 {
@@ -66,7 +139,19 @@ static size_t DeterminePathCutOffPoint()
   return 0;
 }
 
-LogManager::LogManager()
+static std::string FormatTimestamp(std::chrono::system_clock::time_point time)
+{
+  const time_t seconds = std::chrono::system_clock::to_time_t(time);
+  const auto milliseconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
+      1000;
+
+  char minutes_seconds[6];
+  strftime(minutes_seconds, sizeof(minutes_seconds), "%M:%S", localtime(&seconds));
+  return StringFromFormat("%s:%03d", minutes_seconds, static_cast<int>(milliseconds));
+}
+
+LogManager::LogManager() : m_instance_id(s_next_instance_id++)
 {
   // create log containers
   m_log[LogTypes::ACTIONREPLAY] = {"ActionReplay", "ActionReplay"};
@@ -128,9 +213,11 @@ LogManager::LogManager()
   bool write_file;
   bool write_console;
   bool write_window;
+  bool asynchronous;
   options->Get("WriteToFile", &write_file, false);
   options->Get("WriteToConsole", &write_console, true);
   options->Get("WriteToWindow", &write_window, true);
+  options->Get("Asynchronous", &asynchronous, true);
 
   // Set up log listeners
   int verbosity;
@@ -151,10 +238,15 @@ LogManager::LogManager()
     logs->Get(container.m_short_name, &container.m_enable, false);
 
   m_path_cutoff_point = DeterminePathCutOffPoint();
+
+  SetAsynchronous(asynchronous);
 }
 
 LogManager::~LogManager()
 {
+  // Hand the remaining messages to the listeners before they go away.
+  SetAsynchronous(false);
+
   // The log window listener pointer is owned by the GUI code.
   delete m_listeners[LogListener::CONSOLE_LISTENER];
   delete m_listeners[LogListener::FILE_LISTENER];
@@ -167,9 +259,10 @@ void LogManager::SaveSettings()
 
   IniFile::Section* options = ini.GetOrCreateSection("Options");
   options->Set("Verbosity", GetLogLevel());
-  options->Set("WriteToFile", m_listener_ids[LogListener::FILE_LISTENER]);
-  options->Set("WriteToConsole", m_listener_ids[LogListener::CONSOLE_LISTENER]);
-  options->Set("WriteToWindow", m_listener_ids[LogListener::LOG_WINDOW_LISTENER]);
+  options->Set("WriteToFile", IsListenerEnabled(LogListener::FILE_LISTENER));
+  options->Set("WriteToConsole", IsListenerEnabled(LogListener::CONSOLE_LISTENER));
+  options->Set("WriteToWindow", IsListenerEnabled(LogListener::LOG_WINDOW_LISTENER));
+  options->Set("Asynchronous", IsAsynchronous());
 
   // Save all enabled/disabled states of the log types to the config ini.
   for (const auto& container : m_log)
@@ -187,21 +280,207 @@ void LogManager::Log(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const
 void LogManager::LogWithFullPath(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type,
                                  const char* file, int line, const char* format, va_list args)
 {
-  if (!IsEnabled(type, level) || !static_cast<bool>(m_listener_ids))
+  if (!IsEnabled(type, level) || !m_any_listener_enabled.IsSet())
     return;
 
-  char temp[MAX_MSGLEN];
-  CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
+  const auto time = std::chrono::system_clock::now();
+  // Counted before the mode is checked, so that SetAsynchronous(false) can wait for the message to
+  // be in the ring before the final drain.
+  m_ring_writers++;
+  if (!m_asynchronous.IsSet())
+  {
+    m_ring_writers--;
+    char temp[MAX_MSGLEN];
+    CharArrayFromFormatV(temp, MAX_MSGLEN, format, args);
+    Dispatch(level, type, file, line, time, temp);
+    return;
+  }
 
-  std::string msg =
-      StringFromFormat("%s %s:%u %c[%s]: %s\n", Common::Timer::GetTimeFormatted().c_str(), file,
-                       line, LogTypes::LOG_LEVEL_TO_CHAR[(int)level], GetShortName(type), temp);
+  LogRing* ring = GetThreadRing();
+  LogEntry* entry = ring->BeginWrite();
+  if (!entry)
+  {
+    m_dropped_messages++;
+    m_ring_writers--;
+    return;
+  }
 
+  // The arguments may point to buffers that don't outlive this call, so the message itself has to
+  // be formatted here. Building the full line and the listener I/O are left to the drain thread.
+  entry->time = time;
+  entry->file = file;
+  entry->line = line;
+  entry->level = level;
+  entry->type = type;
+  CharArrayFromFormatV(entry->text, MAX_MSGLEN, format, args);
+
+  if (ring->EndWrite())
+    m_drain_event.Set();
+  m_ring_writers--;
+}
+
+void LogManager::Dispatch(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file,
+                          int line, std::chrono::system_clock::time_point time, const char* text)
+{
+  const std::string msg =
+      StringFromFormat("%s %s:%u %c[%s]: %s\n", FormatTimestamp(time).c_str(), file, line,
+                       LogTypes::LOG_LEVEL_TO_CHAR[(int)level], GetShortName(type), text);
+
+  std::lock_guard<std::mutex> lk(m_listeners_mutex);
   for (auto listener_id : m_listener_ids)
     if (m_listeners[listener_id])
       m_listeners[listener_id]->Log(level, msg.c_str());
 }
 
+LogRing* LogManager::GetThreadRing()
+{
+  if (s_thread_ring.owner != m_instance_id)
+  {
+    // Either the first message from this thread, or the ring belongs to a previous LogManager.
+    if (s_thread_ring.ring)
+      s_thread_ring.ring->abandoned.Set();
+
+    s_thread_ring.ring = std::make_shared<LogRing>();
+    s_thread_ring.owner = m_instance_id;
+
+    std::lock_guard<std::mutex> lk(m_rings_mutex);
+    m_rings.push_back(s_thread_ring.ring);
+  }
+
+  return s_thread_ring.ring.get();
+}
+
+bool LogManager::IsAsynchronous() const
+{
+  return m_asynchronous.IsSet();
+}
+
+void LogManager::SetAsynchronous(bool asynchronous)
+{
+  if (asynchronous == m_asynchronous.IsSet())
+    return;
+
+  if (asynchronous)
+  {
+    m_asynchronous.Set();
+    StartDrainThread();
+  }
+  else
+  {
+    m_asynchronous.Clear();
+    // Threads that saw the old mode may still be writing to their rings.
+    while (m_ring_writers.load() != 0)
+      std::this_thread::yield();
+    StopDrainThread();
+  }
+}
+
+void LogManager::Flush()
+{
+  if (!m_asynchronous.IsSet() || std::this_thread::get_id() == m_drain_thread.get_id())
+    return;
+
+  std::unique_lock<std::mutex> lk(m_flush_mutex);
+  // A pass that is already running may have missed our messages, so wait for the next one too.
+  const u64 target = m_drain_passes + 2;
+  m_drain_event.Set();
+  m_flush_cv.wait(lk, [&] { return m_drain_passes >= target; });
+}
+
+u64 LogManager::GetDroppedMessageCount() const
+{
+  return m_dropped_messages.load();
+}
+
+void LogManager::StartDrainThread()
+{
+  m_drain_exit.Clear();
+  m_drain_thread = std::thread(&LogManager::DrainThread, this);
+}
+
+void LogManager::StopDrainThread()
+{
+  if (!m_drain_thread.joinable())
+    return;
+
+  m_drain_exit.Set();
+  m_drain_event.Set();
+  m_drain_thread.join();
+}
+
+void LogManager::DrainThread()
+{
+  Common::SetCurrentThreadName("Log drain");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
+
+  while (true)
+  {
+    m_drain_event.WaitFor(DRAIN_INTERVAL);
+    const bool exiting = m_drain_exit.IsSet();
+
+    DrainRings();
+
+    {
+      std::lock_guard<std::mutex> lk(m_flush_mutex);
+      m_drain_passes++;
+    }
+    m_flush_cv.notify_all();
+
+    if (exiting)
+      return;
+  }
+}
+
+void LogManager::DrainRings()
+{
+  std::vector<std::shared_ptr<LogRing>> rings;
+  {
+    std::lock_guard<std::mutex> lk(m_rings_mutex);
+    rings = m_rings;
+  }
+
+  // Merge the rings by timestamp, so that the output stays roughly in order across threads.
+  while (true)
+  {
+    LogRing* oldest_ring = nullptr;
+    const LogEntry* oldest = nullptr;
+    for (const auto& ring : rings)
+    {
+      const LogEntry* entry = ring->Peek();
+      if (entry && (!oldest || entry->time < oldest->time))
+      {
+        oldest_ring = ring.get();
+        oldest = entry;
+      }
+    }
+
+    if (!oldest)
+      break;
+
+    Dispatch(oldest->level, oldest->type, oldest->file, oldest->line, oldest->time, oldest->text);
+    oldest_ring->Pop();
+  }
+
+  const u64 dropped = m_dropped_messages.load();
+  if (dropped != m_reported_dropped_messages)
+  {
+    const std::string text =
+        StringFromFormat("%" PRIu64 " log messages were dropped because the log buffer was full",
+                         dropped - m_reported_dropped_messages);
+    Dispatch(LogTypes::LWARNING, LogTypes::MASTER_LOG, __FILE__ + m_path_cutoff_point, __LINE__,
+             std::chrono::system_clock::now(), text.c_str());
+    m_reported_dropped_messages = dropped;
+  }
+
+  // The owner of an abandoned ring has exited, so nothing can be added to it after this check.
+  std::lock_guard<std::mutex> lk(m_rings_mutex);
+  m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                               [](const std::shared_ptr<LogRing>& ring) {
+                                 return ring->abandoned.IsSet() && !ring->Peek();
+                               }),
+                m_rings.end());
+}
+
 LogTypes::LOG_LEVELS LogManager::GetLogLevel() const
 {
   return m_level;
@@ -234,16 +513,20 @@ const char* LogManager::GetFullName(LogTypes::LOG_TYPE type) const
 
 void LogManager::RegisterListener(LogListener::LISTENER id, LogListener* listener)
 {
+  std::lock_guard<std::mutex> lk(m_listeners_mutex);
   m_listeners[id] = listener;
 }
 
 void LogManager::EnableListener(LogListener::LISTENER id, bool enable)
 {
+  std::lock_guard<std::mutex> lk(m_listeners_mutex);
   m_listener_ids[id] = enable;
+  m_any_listener_enabled.Set(static_cast<bool>(m_listener_ids));
 }
 
 bool LogManager::IsListenerEnabled(LogListener::LISTENER id) const
 {
+  std::lock_guard<std::mutex> lk(m_listeners_mutex);
   return m_listener_ids[id];
 }
 
@@ -5,12 +5,24 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Common/BitSet.h"
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/Logging/Log.h"
 #include "Common/NonCopyable.h"
 
+class LogRing;
+
 // pure virtual interface
 class LogListener
 {
@@ -35,11 +47,22 @@ public:
   static void Init();
   static void Shutdown();
 
+  // file must point to a string with static storage duration (such as __FILE__), because
+  // listeners may only see the message after the call returned.
   void Log(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
            const char* fmt, va_list args);
   void LogWithFullPath(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file,
                        int line, const char* fmt, va_list args);
 
+  // Messages are queued in per-thread rings and handed to the listeners by a drain thread, so that
+  // logging doesn't block the emulation threads on listener I/O. When a ring is full, the message
+  // is dropped and counted instead.
+  bool IsAsynchronous() const;
+  void SetAsynchronous(bool asynchronous);
+  // Blocks until every message logged before the call has been passed to the listeners.
+  void Flush();
+  u64 GetDroppedMessageCount() const;
+
   LogTypes::LOG_LEVELS GetLogLevel() const;
   void SetLogLevel(LogTypes::LOG_LEVELS level);
 
@@ -66,9 +89,38 @@ private:
   LogManager();
   ~LogManager();
 
+  LogRing* GetThreadRing();
+  void StartDrainThread();
+  void StopDrainThread();
+  void DrainThread();
+  void DrainRings();
+  void Dispatch(LogTypes::LOG_LEVELS level, LogTypes::LOG_TYPE type, const char* file, int line,
+                std::chrono::system_clock::time_point time, const char* text);
+
   LogTypes::LOG_LEVELS m_level;
   std::array<LogContainer, LogTypes::NUMBER_OF_LOGS> m_log{};
   std::array<LogListener*, LogListener::NUMBER_OF_LISTENERS> m_listeners{};
   BitSet32 m_listener_ids;
+  // Lets messages be skipped without taking m_listeners_mutex when nothing would receive them.
+  Common::Flag m_any_listener_enabled;
   size_t m_path_cutoff_point = 0;
+
+  // Serializes the calls into the listeners, and listener registration against them.
+  mutable std::mutex m_listeners_mutex;
+
+  const u32 m_instance_id;
+  std::mutex m_rings_mutex;
+  std::vector<std::shared_ptr<LogRing>> m_rings;
+  std::atomic<u64> m_dropped_messages{0};
+  u64 m_reported_dropped_messages = 0;
+
+  Common::Flag m_asynchronous;
+  // Threads in LogWithFullPath that may write to their ring.
+  std::atomic<u32> m_ring_writers{0};
+  std::thread m_drain_thread;
+  Common::Event m_drain_event;
+  Common::Flag m_drain_exit;
+  std::mutex m_flush_mutex;
+  std::condition_variable m_flush_cv;
+  u64 m_drain_passes = 0;
 };
@@ -0,0 +1,103 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include "Common/StringUtil.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+
+namespace File
+{
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(const std::string& filename)
+{
+  Close();
+
+#ifdef _WIN32
+  m_file = CreateFile(UTF8ToTStr(filename).c_str(), GENERIC_READ | GENERIC_WRITE,
+                      FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL, nullptr);
+  LARGE_INTEGER size;
+  if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &size) || size.QuadPart == 0)
+  {
+    Close();
+    return false;
+  }
+  m_mapping = CreateFileMapping(m_file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+  if (m_mapping)
+    m_data = static_cast<u8*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+  m_size = size.QuadPart;
+#else
+  m_fd = open(filename.c_str(), O_RDWR);
+  struct stat file_info;
+  if (m_fd < 0 || fstat(m_fd, &file_info) != 0 || file_info.st_size == 0)
+  {
+    Close();
+    return false;
+  }
+  void* data = mmap(nullptr, file_info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+  if (data != MAP_FAILED)
+    m_data = static_cast<u8*>(data);
+  m_size = file_info.st_size;
+#endif
+
+  if (!m_data)
+  {
+    WARN_LOG(COMMON, "Failed to map %s: %s", filename.c_str(), GetLastErrorMsg().c_str());
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+  if (m_data)
+    UnmapViewOfFile(m_data);
+  if (m_mapping)
+    CloseHandle(m_mapping);
+  if (m_file && m_file != INVALID_HANDLE_VALUE)
+    CloseHandle(m_file);
+  m_file = nullptr;
+  m_mapping = nullptr;
+#else
+  if (m_data)
+    munmap(m_data, m_size);
+  if (m_fd >= 0)
+    close(m_fd);
+  m_fd = -1;
+#endif
+  m_data = nullptr;
+  m_size = 0;
+}
+
+bool MappedFile::Flush()
+{
+  if (!m_data)
+    return false;
+
+#ifdef _WIN32
+  return FlushViewOfFile(m_data, 0) && FlushFileBuffers(m_file);
+#else
+  return msync(m_data, m_size, MS_SYNC) == 0;
+#endif
+}
+}  // namespace File
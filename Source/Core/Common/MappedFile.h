@@ -0,0 +1,41 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/NonCopyable.h"
+
+namespace File
+{
+// Maps a whole existing file into memory for reading and writing. Writes land in the OS page
+// cache, which writes the pages back to the file on its own schedule; Flush forces that.
+class MappedFile final : public NonCopyable
+{
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  bool Open(const std::string& filename);
+  void Close();
+  // Starts writing back the changed pages and waits for them to reach the file.
+  bool Flush();
+
+  bool IsOpen() const { return m_data != nullptr; }
+  u8* GetData() const { return m_data; }
+  u64 GetSize() const { return m_size; }
+
+private:
+  u8* m_data = nullptr;
+  u64 m_size = 0;
+#ifdef _WIN32
+  void* m_file = nullptr;
+  void* m_mapping = nullptr;
+#else
+  int m_fd = -1;
+#endif
+};
+}  // namespace File
@@ -7,10 +7,12 @@
 #include <set>
 #include <string>
 
+#include "Common/Align.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 
@@ -22,6 +24,9 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 #ifdef ANDROID
 #include <linux/ashmem.h>
 #include <sys/ioctl.h>
@@ -52,9 +57,14 @@ static int AshmemCreateFileMapping(const char* name, size_t size)
 }
 #endif
 
-void MemArena::GrabSHMSegment(size_t size)
+void MemArena::GrabSHMSegment(size_t size, bool use_huge_pages)
 {
+  m_use_huge_pages = use_huge_pages;
 #ifdef _WIN32
+  // Large pages can't back a file mapping which is viewed at arbitrary 64 KiB granularity.
+  if (use_huge_pages)
+    INFO_LOG(MEMMAP, "Huge pages are not supported for the memory arena on this host");
+
   hMemoryMapping =
       CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)(size), nullptr);
 #elif defined(ANDROID)
@@ -65,7 +75,29 @@ void MemArena::GrabSHMSegment(size_t size)
     return;
   }
 #else
-  for (int i = 0; i < 10000; i++)
+  fd = -1;
+#if defined(__linux__) && defined(__NR_memfd_create)
+  if (use_huge_pages && Common::TransparentHugePagesEnabled(true))
+  {
+    // Files in /dev/shm get huge pages according to how it was mounted, which is never by
+    // default. memfds follow shmem_enabled, which TransparentHugePagesEnabled checked.
+    fd = static_cast<int>(syscall(__NR_memfd_create, "dolphinmem", 0));
+    if (fd < 0)
+      ERROR_LOG(MEMMAP, "memfd_create failed: %s", strerror(errno));
+  }
+#endif
+  if (fd >= 0)
+  {
+    INFO_LOG(MEMMAP, "Using transparent huge pages for the memory arena");
+  }
+  else if (use_huge_pages)
+  {
+    INFO_LOG(MEMMAP, "Transparent huge pages are unavailable for shared memory on this host, using "
+                     "regular pages for the memory arena");
+    m_use_huge_pages = false;
+  }
+
+  for (int i = 0; fd < 0 && i < 10000; i++)
   {
     std::string file_name = StringFromFormat("/dolphinmem.%d", i);
     fd = shm_open(file_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
@@ -108,10 +140,11 @@ void* MemArena::CreateView(s64 offset, size_t size, void* base)
     NOTICE_LOG(MEMMAP, "mmap failed");
     return nullptr;
   }
-  else
-  {
-    return retval;
-  }
+
+  if (m_use_huge_pages && !Common::AdviseHugePages(retval, size))
+    INFO_LOG(MEMMAP, "Transparent huge pages unavailable for view at %p", retval);
+
+  return retval;
 #endif
 }
 
@@ -124,12 +157,12 @@ void MemArena::ReleaseView(void* view, size_t size)
 #endif
 }
 
-u8* MemArena::FindMemoryBase()
+u8* MemArena::FindMemoryBase(size_t alignment)
 {
 #if _ARCH_32
-  const size_t memory_size = 0x31000000;
+  const size_t memory_size = 0x31000000 + alignment - 1;
 #else
-  const size_t memory_size = 0x400000000;
+  const size_t memory_size = 0x400000000 + alignment - 1;
 #endif
 
 #ifdef _WIN32
@@ -140,7 +173,7 @@ u8* MemArena::FindMemoryBase()
     return nullptr;
   }
   VirtualFree(base, 0, MEM_RELEASE);
-  return base;
+  return reinterpret_cast<u8*>(Common::AlignUp(reinterpret_cast<uintptr_t>(base), alignment));
 #else
 #ifdef ANDROID
   // Android 4.3 changed how mmap works.
@@ -157,6 +190,6 @@ u8* MemArena::FindMemoryBase()
     return nullptr;
   }
   munmap(base, memory_size);
-  return static_cast<u8*>(base);
+  return reinterpret_cast<u8*>(Common::AlignUp(reinterpret_cast<uintptr_t>(base), alignment));
 #endif
 }
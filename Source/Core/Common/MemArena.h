@@ -20,13 +20,16 @@
 class MemArena
 {
 public:
-  void GrabSHMSegment(size_t size);
+  // With use_huge_pages set, views are backed by transparent huge pages where the host supports
+  // them for shared memory. Views only get huge pages where both their address and their offset
+  // into the segment are aligned to Common::HUGE_PAGE_SIZE.
+  void GrabSHMSegment(size_t size, bool use_huge_pages = false);
   void ReleaseSHMSegment();
   void* CreateView(s64 offset, size_t size, void* base = nullptr);
   void ReleaseView(void* view, size_t size);
 
-  // This finds 1 GB in 32-bit, 16 GB in 64-bit.
-  static u8* FindMemoryBase();
+  // This finds 1 GB in 32-bit, 16 GB in 64-bit, starting at a multiple of alignment.
+  static u8* FindMemoryBase(size_t alignment = 1);
 
 private:
 #ifdef _WIN32
@@ -34,4 +37,5 @@ private:
 #else
   int fd;
 #endif
+  bool m_use_huge_pages = false;
 };
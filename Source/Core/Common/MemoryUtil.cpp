@@ -6,8 +6,10 @@
 #include <cstdlib>
 #include <string>
 
+#include "Common/Align.h"
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
@@ -33,16 +35,70 @@ namespace Common
 // This is purposely not a full wrapper for virtualalloc/mmap, but it
 // provides exactly the primitive operations that Dolphin needs.
 
-void* AllocateExecutableMemory(size_t size)
+#ifdef _WIN32
+static void* AllocateLargePages(size_t size, DWORD protect)
+{
+  // Needs the "Lock pages in memory" privilege, so this commonly fails.
+  const SIZE_T large_page_size = GetLargePageMinimum();
+  void* ptr = nullptr;
+  if (large_page_size != 0)
+  {
+    ptr = VirtualAlloc(nullptr, AlignUp(size, large_page_size),
+                       MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, protect);
+  }
+  if (!ptr)
+    INFO_LOG(MEMMAP, "Large pages unavailable: %s", GetLastErrorMsg().c_str());
+  return ptr;
+}
+#else
+// Maps anonymous memory whose start is aligned to HUGE_PAGE_SIZE, which transparent huge pages
+// need, and asks for it to be backed by them. The unaligned head and tail of a larger mapping are
+// given back, so the result can be freed with FreeMemoryPages(ptr, size) like any other allocation.
+static void* MapHugePages(size_t size, int prot)
+{
+  if (!TransparentHugePagesEnabled(false))
+  {
+    INFO_LOG(MEMMAP, "Transparent huge pages are disabled on this host, using regular pages");
+    return nullptr;
+  }
+
+  const size_t padded_size = size + HUGE_PAGE_SIZE;
+  u8* base = static_cast<u8*>(mmap(nullptr, padded_size, prot, MAP_ANON | MAP_PRIVATE, -1, 0));
+  if (base == MAP_FAILED)
+    return nullptr;
+
+  u8* aligned = reinterpret_cast<u8*>(
+      AlignUp(reinterpret_cast<uintptr_t>(base), static_cast<size_t>(HUGE_PAGE_SIZE)));
+  const size_t head = static_cast<size_t>(aligned - base);
+  const size_t tail = padded_size - head - size;
+  if (head != 0)
+    munmap(base, head);
+  if (tail != 0)
+    munmap(aligned + size, tail);
+
+  if (!AdviseHugePages(aligned, size))
+    INFO_LOG(MEMMAP, "Transparent huge pages unavailable");
+
+  return aligned;
+}
+#endif
+
+void* AllocateExecutableMemory(size_t size, bool use_huge_pages)
 {
 #if defined(_WIN32)
-  void* ptr = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_EXECUTE_READWRITE);
+  void* ptr = use_huge_pages ? AllocateLargePages(size, PAGE_EXECUTE_READWRITE) : nullptr;
+  if (!ptr)
+    ptr = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_EXECUTE_READWRITE);
 #else
-  void* ptr =
-      mmap(nullptr, size, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_ANON | MAP_PRIVATE, -1, 0);
+  const int prot = PROT_READ | PROT_WRITE | PROT_EXEC;
+  void* ptr = use_huge_pages ? MapHugePages(size, prot) : nullptr;
+  if (!ptr)
+  {
+    ptr = mmap(nullptr, size, prot, MAP_ANON | MAP_PRIVATE, -1, 0);
 
-  if (ptr == MAP_FAILED)
-    ptr = nullptr;
+    if (ptr == MAP_FAILED)
+      ptr = nullptr;
+  }
 #endif
 
   if (ptr == nullptr)
@@ -51,15 +107,22 @@ void* AllocateExecutableMemory(size_t size)
   return ptr;
 }
 
-void* AllocateMemoryPages(size_t size)
+void* AllocateMemoryPages(size_t size, bool use_huge_pages)
 {
 #ifdef _WIN32
-  void* ptr = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_READWRITE);
+  void* ptr = use_huge_pages ? AllocateLargePages(size, PAGE_READWRITE) : nullptr;
+  if (!ptr)
+    ptr = VirtualAlloc(nullptr, size, MEM_COMMIT, PAGE_READWRITE);
 #else
-  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANON | MAP_PRIVATE, -1, 0);
+  const int prot = PROT_READ | PROT_WRITE;
+  void* ptr = use_huge_pages ? MapHugePages(size, prot) : nullptr;
+  if (!ptr)
+  {
+    ptr = mmap(nullptr, size, prot, MAP_ANON | MAP_PRIVATE, -1, 0);
 
-  if (ptr == MAP_FAILED)
-    ptr = nullptr;
+    if (ptr == MAP_FAILED)
+      ptr = nullptr;
+  }
 #endif
 
   if (ptr == nullptr)
@@ -175,6 +238,38 @@ void UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute)
     PanicAlert("UnWriteProtectMemory failed!\n%s", GetLastErrorMsg().c_str());
 }
 
+bool AdviseHugePages(void* ptr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+  return madvise(ptr, size, MADV_HUGEPAGE) == 0;
+#else
+  return false;
+#endif
+}
+
+bool TransparentHugePagesEnabled(bool shared)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  const std::string path = shared ? "/sys/kernel/mm/transparent_hugepage/shmem_enabled" :
+                                    "/sys/kernel/mm/transparent_hugepage/enabled";
+  std::string modes;
+  if (!File::ReadFileToString(path, modes))
+    return false;
+
+  // The active mode is the one in brackets, e.g. "always [madvise] never".
+  const size_t start = modes.find('[');
+  const size_t end = modes.find(']', start);
+  if (start == std::string::npos || end == std::string::npos)
+    return false;
+  const std::string mode = modes.substr(start + 1, end - start - 1);
+  if (shared)
+    return mode == "always" || mode == "within_size" || mode == "advise" || mode == "force";
+  return mode == "always" || mode == "madvise";
+#else
+  return false;
+#endif
+}
+
 size_t MemPhysical()
 {
 #ifdef _WIN32
@@ -9,14 +9,27 @@
 
 namespace Common
 {
-void* AllocateExecutableMemory(size_t size);
-void* AllocateMemoryPages(size_t size);
+// The huge page size that the allocators below align to when huge pages are requested.
+constexpr size_t HUGE_PAGE_SIZE = 0x200000;
+
+// With use_huge_pages set, the memory is backed by huge pages where the host allows it (explicit
+// large pages on Windows, transparent huge pages on Linux), which reduces TLB misses for large
+// regions. Otherwise, or if that fails, regular pages are used.
+void* AllocateExecutableMemory(size_t size, bool use_huge_pages = false);
+void* AllocateMemoryPages(size_t size, bool use_huge_pages = false);
 void FreeMemoryPages(void* ptr, size_t size);
 void* AllocateAlignedMemory(size_t size, size_t alignment);
 void FreeAlignedMemory(void* ptr);
 void ReadProtectMemory(void* ptr, size_t size);
 void WriteProtectMemory(void* ptr, size_t size, bool executable = false);
 void UnWriteProtectMemory(void* ptr, size_t size, bool allowExecute = false);
+// Asks the host to back an existing mapping with transparent huge pages. Returns false if the
+// host does not support this, in which case the mapping keeps using regular pages.
+bool AdviseHugePages(void* ptr, size_t size);
+// Whether memory that AdviseHugePages is called on actually gets transparent huge pages: for
+// private anonymous memory, or for shared memory with shared set. On Linux, the madvise succeeds
+// either way, and it's /sys/kernel/mm/transparent_hugepage/enabled (shmem_enabled) that decides.
+bool TransparentHugePagesEnabled(bool shared);
 size_t MemPhysical();
 
 }  // namespace Common
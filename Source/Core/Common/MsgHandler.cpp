@@ -9,6 +9,7 @@
 #include "Common/Common.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/Logging/LogManager.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 
@@ -91,6 +92,10 @@ bool MsgAlert(bool yes_no, int Style, const char* format, ...)
 
   ERROR_LOG(MASTER_LOG, "%s: %s", caption.c_str(), buffer);
 
+  // The alert may precede a crash, so make sure that everything leading up to it is written out.
+  if (LogManager::GetInstance())
+    LogManager::GetInstance()->Flush();
+
   // Don't ignore questions, especially AskYesNo, PanicYesNo could be ignored
   if (msg_handler && (AlertEnabled || Style == QUESTION || Style == CRITICAL))
     return msg_handler(caption.c_str(), buffer, yes_no, Style);
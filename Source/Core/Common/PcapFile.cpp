@@ -2,21 +2,24 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
 #include "Common/PcapFile.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
 
 namespace
 {
 const u32 PCAP_MAGIC = 0xa1b2c3d4;
 const u16 PCAP_VERSION_MAJOR = 2;
 const u16 PCAP_VERSION_MINOR = 4;
-const u32 PCAP_CAPTURE_LENGTH = 65535;
-
-// TODO(delroth): Make this configurable at PCAP creation time?
-const u32 PCAP_DATA_LINK_TYPE = 147;  // Reserved for internal use.
 
 // Designed to be directly written into the PCAP file. The PCAP format is
 // endian independent, so this works just fine.
@@ -43,21 +46,192 @@ struct PCAPRecordHeader
 
 }  // namespace
 
-void PCAP::AddHeader()
+void PCAP::AddHeader(u32 data_link_type)
 {
-  PCAPHeader hdr = {PCAP_MAGIC, PCAP_VERSION_MAJOR,  PCAP_VERSION_MINOR, 0,
-                    0,          PCAP_CAPTURE_LENGTH, PCAP_DATA_LINK_TYPE};
+  PCAPHeader hdr = {PCAP_MAGIC, PCAP_VERSION_MAJOR, PCAP_VERSION_MINOR, 0,
+                    0,          m_snap_length,      data_link_type};
   m_fp->WriteBytes(&hdr, sizeof(hdr));
 }
 
 void PCAP::AddPacket(const u8* bytes, size_t size)
 {
-  std::chrono::system_clock::time_point now(std::chrono::system_clock::now());
-  auto ts = now.time_since_epoch();
+  AddPacket(bytes, std::min<size_t>(size, m_snap_length), size, std::chrono::system_clock::now());
+}
+
+void PCAP::AddPacket(const u8* bytes, size_t size, size_t real_size,
+                     std::chrono::system_clock::time_point time)
+{
+  auto ts = time.time_since_epoch();
   PCAPRecordHeader rec_hdr = {
       (u32)std::chrono::duration_cast<std::chrono::seconds>(ts).count(),
       (u32)(std::chrono::duration_cast<std::chrono::microseconds>(ts).count() % 1000000), (u32)size,
-      (u32)size};
+      (u32)real_size};
   m_fp->WriteBytes(&rec_hdr, sizeof(rec_hdr));
   m_fp->WriteBytes(bytes, size);
 }
+
+// How a packet is stored in the buffer, followed by its (truncated) contents.
+struct AsyncPCAP::RecordHeader
+{
+  std::chrono::system_clock::time_point time;
+  u32 size;
+  u32 real_size;
+};
+
+AsyncPCAP::AsyncPCAP(const std::string& path, const Options& options)
+    : m_path(path), m_options(options), m_buffer(std::make_unique<u8[]>(options.buffer_size))
+{
+  if (!OpenFile(0))
+    return;
+
+  m_open.store(true, std::memory_order_relaxed);
+  m_writer_thread = std::thread(&AsyncPCAP::WriterThread, this);
+}
+
+AsyncPCAP::~AsyncPCAP()
+{
+  if (m_writer_thread.joinable())
+  {
+    m_writer_exit.Set();
+    m_writer_event.Set();
+    m_writer_thread.join();
+  }
+}
+
+std::string AsyncPCAP::GetFilePath(const std::string& path, u32 index)
+{
+  if (index == 0)
+    return path;
+
+  const size_t separator = path.find_last_of("/\\");
+  size_t dot = path.rfind('.');
+  if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+    dot = path.size();
+  return path.substr(0, dot) + StringFromFormat(".%u", index) + path.substr(dot);
+}
+
+bool AsyncPCAP::OpenFile(u32 index)
+{
+  auto* file = new File::IOFile(GetFilePath(m_path, index), "wb");
+  if (!file->IsOpen())
+  {
+    ERROR_LOG(COMMON, "Failed to open capture file %s", GetFilePath(m_path, index).c_str());
+    delete file;
+    m_pcap.reset();
+    return false;
+  }
+
+  m_pcap = std::make_unique<PCAP>(file, m_options.snap_length, m_options.data_link_type);
+  m_file_index = index;
+  m_files.fetch_add(1, std::memory_order_relaxed);
+
+  if (m_options.max_files != 0 && index >= m_options.max_files)
+    File::Delete(GetFilePath(m_path, index - m_options.max_files));
+  return true;
+}
+
+void AsyncPCAP::CopyToBuffer(u64 position, const void* data, size_t size)
+{
+  const size_t offset = static_cast<size_t>(position % m_options.buffer_size);
+  const size_t first = std::min(size, m_options.buffer_size - offset);
+  std::memcpy(&m_buffer[offset], data, first);
+  std::memcpy(&m_buffer[0], static_cast<const u8*>(data) + first, size - first);
+}
+
+void AsyncPCAP::CopyFromBuffer(u64 position, void* data, size_t size) const
+{
+  const size_t offset = static_cast<size_t>(position % m_options.buffer_size);
+  const size_t first = std::min(size, m_options.buffer_size - offset);
+  std::memcpy(data, &m_buffer[offset], first);
+  std::memcpy(static_cast<u8*>(data) + first, &m_buffer[0], size - first);
+}
+
+void AsyncPCAP::AddPacket(const u8* bytes, size_t size)
+{
+  if (!IsOpen())
+    return;
+
+  RecordHeader header;
+  header.time = std::chrono::system_clock::now();
+  header.size = static_cast<u32>(std::min<size_t>(size, m_options.snap_length));
+  header.real_size = static_cast<u32>(size);
+  const size_t record_size = sizeof(header) + header.size;
+
+  {
+    std::lock_guard<std::mutex> lock(m_buffer_lock);
+    if (m_write_position - m_read_position + record_size > m_options.buffer_size)
+    {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    CopyToBuffer(m_write_position, &header, sizeof(header));
+    CopyToBuffer(m_write_position + sizeof(header), bytes, header.size);
+    m_write_position += record_size;
+  }
+
+  m_packets.fetch_add(1, std::memory_order_relaxed);
+  m_bytes.fetch_add(size, std::memory_order_relaxed);
+  m_writer_event.Set();
+}
+
+void AsyncPCAP::WriteBufferedPackets()
+{
+  u64 read_position, write_position;
+  {
+    std::lock_guard<std::mutex> lock(m_buffer_lock);
+    read_position = m_read_position;
+    write_position = m_write_position;
+  }
+
+  // Records between the two positions belong to this thread until m_read_position moves past them.
+  std::vector<u8> data;
+  while (read_position != write_position && m_pcap)
+  {
+    RecordHeader header;
+    CopyFromBuffer(read_position, &header, sizeof(header));
+    data.resize(header.size);
+    CopyFromBuffer(read_position + sizeof(header), data.data(), header.size);
+    read_position += sizeof(header) + header.size;
+
+    // Rotating only once there is something to put in the next file doesn't leave an empty one
+    // behind at the end of the capture.
+    if (m_options.rotate_size != 0 && m_pcap->GetSize() >= m_options.rotate_size &&
+        !OpenFile(m_file_index + 1))
+    {
+      ERROR_LOG(COMMON, "Stopped capturing to %s", m_path.c_str());
+      m_open.store(false, std::memory_order_relaxed);
+      break;
+    }
+    m_pcap->AddPacket(data.data(), header.size, header.real_size, header.time);
+  }
+
+  std::lock_guard<std::mutex> lock(m_buffer_lock);
+  m_read_position = write_position;
+}
+
+void AsyncPCAP::WriterThread()
+{
+  Common::SetCurrentThreadName("PCAP writer");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
+
+  while (!m_writer_exit.IsSet())
+  {
+    m_writer_event.Wait();
+    WriteBufferedPackets();
+  }
+
+  WriteBufferedPackets();
+  if (m_pcap)
+    m_pcap->Flush();
+}
+
+AsyncPCAP::Stats AsyncPCAP::GetStats() const
+{
+  Stats stats;
+  stats.packets = m_packets.load(std::memory_order_relaxed);
+  stats.bytes = m_bytes.load(std::memory_order_relaxed);
+  stats.dropped = m_dropped.load(std::memory_order_relaxed);
+  stats.files = m_files.load(std::memory_order_relaxed);
+  return stats;
+}
@@ -10,22 +10,42 @@
 // Example use:
 //   PCAP pcap(new IOFile("test.pcap", "wb"));
 //   pcap.AddPacket(pkt);  // pkt is automatically casted to u8*
+//
+// AsyncPCAP does the same from a separate thread, for captures that must not
+// slow down the thread the packets come from.
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
 #include "Common/File.h"
+#include "Common/Flag.h"
 #include "Common/NonCopyable.h"
 
 class PCAP final : public NonCopyable
 {
 public:
+  static constexpr u32 DEFAULT_SNAP_LENGTH = 65535;
+  static constexpr u32 LINK_TYPE_ETHERNET = 1;
+  // Reserved for internal use.
+  static constexpr u32 LINK_TYPE_USER = 147;
+
   // Takes ownership of the file object. Assumes the file object is already
-  // opened in write mode.
-  explicit PCAP(File::IOFile* fp) : m_fp(fp) { AddHeader(); }
+  // opened in write mode. Packets are truncated to snap_length bytes.
+  explicit PCAP(File::IOFile* fp, u32 snap_length = DEFAULT_SNAP_LENGTH,
+                u32 data_link_type = LINK_TYPE_USER)
+      : m_fp(fp), m_snap_length(snap_length)
+  {
+    AddHeader(data_link_type);
+  }
   template <typename T>
   void AddPacket(const T& obj)
   {
@@ -33,9 +53,87 @@ public:
   }
 
   void AddPacket(const u8* bytes, size_t size);
+  // For packets that were captured earlier, and possibly truncated already.
+  void AddPacket(const u8* bytes, size_t size, size_t real_size,
+                 std::chrono::system_clock::time_point time);
+
+  u64 GetSize() { return m_fp->Tell(); }
+  void Flush() { m_fp->Flush(); }
 
 private:
-  void AddHeader();
+  void AddHeader(u32 data_link_type);
 
   std::unique_ptr<File::IOFile> m_fp;
+  u32 m_snap_length;
+};
+
+// Packets are copied into a bounded buffer and written by a separate thread. When the buffer is
+// full, packets are dropped and counted rather than making the caller wait.
+class AsyncPCAP final : public NonCopyable
+{
+public:
+  struct Options
+  {
+    u32 data_link_type = PCAP::LINK_TYPE_USER;
+    u32 snap_length = PCAP::DEFAULT_SNAP_LENGTH;
+    size_t buffer_size = 4 * 1024 * 1024;
+    // Once a file has grown to this many bytes, the capture continues in a new one. 0 disables
+    // rotation.
+    u64 rotate_size = 0;
+    // How many files to keep when rotating; older ones are deleted. 0 keeps all of them.
+    u32 max_files = 0;
+  };
+
+  struct Stats
+  {
+    u64 packets;
+    u64 bytes;
+    u64 dropped;
+    u32 files;
+  };
+
+  AsyncPCAP(const std::string& path, const Options& options);
+  // Writes whatever is still buffered.
+  ~AsyncPCAP();
+
+  // Becomes false if a file can't be opened when rotating, which ends the capture.
+  bool IsOpen() const { return m_open.load(std::memory_order_relaxed); }
+
+  // Safe to call from any thread.
+  void AddPacket(const u8* bytes, size_t size);
+
+  Stats GetStats() const;
+
+  // The first file is path itself, the next ones get a number before the extension.
+  static std::string GetFilePath(const std::string& path, u32 index);
+
+private:
+  struct RecordHeader;
+
+  bool OpenFile(u32 index);
+  void CopyToBuffer(u64 position, const void* data, size_t size);
+  void CopyFromBuffer(u64 position, void* data, size_t size) const;
+  void WriteBufferedPackets();
+  void WriterThread();
+
+  std::string m_path;
+  Options m_options;
+  std::unique_ptr<PCAP> m_pcap;
+  u32 m_file_index = 0;
+
+  std::unique_ptr<u8[]> m_buffer;
+  std::mutex m_buffer_lock;
+  // Positions in an endless stream of bytes, wrapped around the buffer when accessing it.
+  u64 m_read_position = 0;
+  u64 m_write_position = 0;
+
+  std::atomic<bool> m_open{false};
+  std::thread m_writer_thread;
+  Common::Event m_writer_event;
+  Common::Flag m_writer_exit;
+
+  std::atomic<u64> m_packets{0};
+  std::atomic<u64> m_bytes{0};
+  std::atomic<u64> m_dropped{0};
+  std::atomic<u32> m_files{0};
 };
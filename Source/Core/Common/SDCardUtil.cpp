@@ -184,7 +184,9 @@ static unsigned int write_sector(FILE* file, u8* sector)
 
 static unsigned int write_empty(FILE* file, u64 count)
 {
-  static u8 empty[64 * 1024];
+  // Large enough that creating a card takes few writes, each of which bypasses stdio's buffer. Not
+  // const, so that it's zeroed at startup rather than stored in the binary.
+  static u8 empty[4 * 1024 * 1024] = {};
 
   count *= 512;
   while (count > 0)
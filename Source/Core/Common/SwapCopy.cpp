@@ -0,0 +1,115 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/SwapCopy.h"
+
+#include <cstring>
+
+#include "Common/CPUDetect.h"
+#include "Common/Intrinsics.h"
+#include "Common/Swap.h"
+
+namespace Common
+{
+template <typename T>
+static void SwapCopyScalar(u8* dst, const u8* src, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    T value;
+    std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+    value = FromBigEndian(value);
+    std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+  }
+}
+
+#ifdef _M_X86
+// pshufb masks that reverse every 2, 4 or 8 bytes of a 16-byte lane.
+alignas(16) static const u8 SHUFFLE_16[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+alignas(16) static const u8 SHUFFLE_32[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+alignas(16) static const u8 SHUFFLE_64[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+// Both return the number of bytes they have copied, which is always a multiple of 16.
+FUNCTION_TARGET_AVX2
+static size_t SwapCopyAVX2(u8* dst, const u8* src, size_t size, const u8* shuffle)
+{
+  const __m256i mask =
+      _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(shuffle)));
+
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64)
+  {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(a, mask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32), _mm256_shuffle_epi8(b, mask));
+  }
+  for (; i + 16 <= size; i += 16)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_shuffle_epi8(a, _mm256_castsi256_si128(mask)));
+  }
+
+  // Avoid the penalty for mixing AVX and SSE code in the caller.
+  _mm256_zeroupper();
+  return i;
+}
+
+FUNCTION_TARGET_SSSE3
+static size_t SwapCopySSSE3(u8* dst, const u8* src, size_t size, const u8* shuffle)
+{
+  const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle));
+
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(a, mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 16), _mm_shuffle_epi8(b, mask));
+  }
+  for (; i + 16 <= size; i += 16)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(a, mask));
+  }
+  return i;
+}
+#endif
+
+template <typename T>
+static void SwapCopyImpl(void* dst, const void* src, size_t count)
+{
+  u8* dst_bytes = static_cast<u8*>(dst);
+  const u8* src_bytes = static_cast<const u8*>(src);
+  size_t done = 0;
+
+#ifdef _M_X86
+  const u8* shuffle = sizeof(T) == 2 ? SHUFFLE_16 : sizeof(T) == 4 ? SHUFFLE_32 : SHUFFLE_64;
+  const size_t size = count * sizeof(T);
+  if (cpu_info.bAVX2)
+    done = SwapCopyAVX2(dst_bytes, src_bytes, size, shuffle) / sizeof(T);
+  else if (cpu_info.bSSSE3)
+    done = SwapCopySSSE3(dst_bytes, src_bytes, size, shuffle) / sizeof(T);
+#endif
+
+  SwapCopyScalar<T>(dst_bytes + done * sizeof(T), src_bytes + done * sizeof(T), count - done);
+}
+
+void SwapCopy16(void* dst, const void* src, size_t count)
+{
+  SwapCopyImpl<u16>(dst, src, count);
+}
+
+void SwapCopy32(void* dst, const void* src, size_t count)
+{
+  SwapCopyImpl<u32>(dst, src, count);
+}
+
+void SwapCopy64(void* dst, const void* src, size_t count)
+{
+  SwapCopyImpl<u64>(dst, src, count);
+}
+}  // namespace Common
@@ -0,0 +1,40 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "Common/CommonTypes.h"
+
+namespace Common
+{
+// Bulk copies that reverse the byte order of every 16, 32 or 64-bit element, for moving data
+// between emulated memory and host buffers. They use AVX2 or SSSE3 when the CPU supports it.
+//
+// count is in elements. The buffers don't need to be aligned. They may be the same buffer, but
+// must not overlap otherwise.
+void SwapCopy16(void* dst, const void* src, size_t count);
+void SwapCopy32(void* dst, const void* src, size_t count);
+void SwapCopy64(void* dst, const void* src, size_t count);
+
+template <typename T>
+void SwapCopy(T* dst, const T* src, size_t count)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Elements must be trivially copyable");
+  static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                "Unsupported element size");
+
+  if (sizeof(T) == 2)
+    SwapCopy16(dst, src, count);
+  else if (sizeof(T) == 4)
+    SwapCopy32(dst, src, count);
+  else if (sizeof(T) == 8)
+    SwapCopy64(dst, src, count);
+  else if (dst != src)
+    std::memcpy(dst, src, count);
+}
+}  // namespace Common
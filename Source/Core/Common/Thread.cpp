@@ -3,8 +3,18 @@
 // Refer to the license.txt file included.
 
 #include "Common/Thread.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -12,6 +22,11 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
 #ifdef __APPLE__
 #include <mach/mach.h>
 #elif defined BSD4_4 || defined __FreeBSD__ || defined __OpenBSD__
@@ -150,4 +165,517 @@ void SetCurrentThreadName(const char* szThreadName)
 
 #endif
 
+namespace
+{
+struct PhysicalCore
+{
+  std::vector<int> logical_cpus;
+  // Higher on faster cores: the maximum frequency on Linux, the efficiency class on Windows.
+  u64 performance = 0;
+};
+
+enum class PriorityClass
+{
+  Lowered,
+  Normal,
+  Raised,
+  High,
+};
+
+struct ThreadPlacement
+{
+  ThreadRole role = ThreadRole::Background;
+  // Empty if the thread may run anywhere.
+  std::vector<int> cpus;
+  bool pinned = false;
+  PriorityClass priority = PriorityClass::Normal;
+  bool priority_applied = false;
+};
+
+// Lets a registered thread be placed again from another thread when the policy changes.
+struct ThreadHandle
+{
+#ifdef _WIN32
+  HANDLE handle = nullptr;
+#else
+  pthread_t thread{};
+#ifdef __linux__
+  pid_t tid = 0;
+#endif
+#endif
+};
+
+struct RegisteredThread
+{
+  ThreadHandle handle;
+  ThreadPlacement placement;
+};
+
+// Drops the registration of a thread when it exits.
+struct RegistrationGuard
+{
+  ~RegistrationGuard();
+  bool registered = false;
+};
+}  // namespace
+
+static std::mutex s_placement_mutex;
+static ThreadPlacementPolicy s_placement_policy = ThreadPlacementPolicy::None;
+static std::map<std::thread::id, RegisteredThread> s_registered_threads;
+static thread_local RegistrationGuard s_registration_guard;
+
+static ThreadHandle GetCurrentThreadHandle()
+{
+  ThreadHandle handle;
+#ifdef _WIN32
+  // GetCurrentThread only returns a pseudo handle, which means "the calling thread".
+  DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &handle.handle, 0,
+                  FALSE, DUPLICATE_SAME_ACCESS);
+#else
+  handle.thread = pthread_self();
+#ifdef __linux__
+  handle.tid = static_cast<pid_t>(syscall(SYS_gettid));
+#endif
+#endif
+  return handle;
+}
+
+static void CloseThreadHandle(const ThreadHandle& handle)
+{
+#ifdef _WIN32
+  if (handle.handle)
+    CloseHandle(handle.handle);
+#endif
+}
+
+RegistrationGuard::~RegistrationGuard()
+{
+  if (!registered)
+    return;
+
+  std::lock_guard<std::mutex> lk(s_placement_mutex);
+  const auto it = s_registered_threads.find(std::this_thread::get_id());
+  CloseThreadHandle(it->second.handle);
+  s_registered_threads.erase(it);
+}
+
+static std::vector<PhysicalCore> DetectPhysicalCores()
+{
+  std::vector<PhysicalCore> cores;
+  const int num_cpus = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+#if defined _WIN32
+  DWORD length = 0;
+  GetLogicalProcessorInformation(nullptr, &length);
+  std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(
+      length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+  if (!info.empty() && GetLogicalProcessorInformation(info.data(), &length))
+  {
+    for (const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& entry : info)
+    {
+      if (entry.Relationship != RelationProcessorCore)
+        continue;
+
+      PhysicalCore core;
+      for (int i = 0; i < static_cast<int>(sizeof(ULONG_PTR) * 8); ++i)
+      {
+        if ((entry.ProcessorMask >> i) & 1)
+          core.logical_cpus.push_back(i);
+      }
+      cores.push_back(std::move(core));
+    }
+  }
+
+  // Hybrid hosts tell their performance cores apart with the efficiency class of their CPU sets,
+  // which only Windows 10 and later have.
+  using GetSystemCpuSetInformation_t = BOOL(WINAPI*)(PSYSTEM_CPU_SET_INFORMATION, ULONG, PULONG,
+                                                     HANDLE, ULONG);
+  const auto get_system_cpu_set_information = reinterpret_cast<GetSystemCpuSetInformation_t>(
+      GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "GetSystemCpuSetInformation"));
+  ULONG cpu_sets_length = 0;
+  if (get_system_cpu_set_information)
+    get_system_cpu_set_information(nullptr, 0, &cpu_sets_length, GetCurrentProcess(), 0);
+  std::vector<u8> cpu_sets(cpu_sets_length);
+  if (!cpu_sets.empty() &&
+      get_system_cpu_set_information(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(cpu_sets.data()),
+                                     cpu_sets_length, &cpu_sets_length, GetCurrentProcess(), 0))
+  {
+    for (size_t offset = 0; offset < cpu_sets_length;)
+    {
+      const auto* entry = reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(&cpu_sets[offset]);
+      if (entry->Size == 0)
+        break;
+      offset += entry->Size;
+      // Affinity masks only cover the first processor group.
+      if (entry->Type != CpuSetInformation || entry->CpuSet.Group != 0)
+        continue;
+
+      const int cpu = entry->CpuSet.LogicalProcessorIndex;
+      for (PhysicalCore& core : cores)
+      {
+        if (std::find(core.logical_cpus.begin(), core.logical_cpus.end(), cpu) !=
+            core.logical_cpus.end())
+        {
+          core.performance = std::max<u64>(core.performance, entry->CpuSet.EfficiencyClass);
+        }
+      }
+    }
+  }
+#elif defined __linux__
+  // SMT siblings share the same sibling list, which makes it a convenient key for the core.
+  std::map<std::string, size_t> core_indices;
+  for (int cpu = 0; cpu < num_cpus; ++cpu)
+  {
+    const std::string path = StringFromFormat("/sys/devices/system/cpu/cpu%d/", cpu);
+
+    std::string siblings;
+    if (!File::ReadFileToString(path + "topology/thread_siblings_list", siblings))
+      siblings = std::to_string(cpu);
+
+    // Used to tell performance cores from efficiency cores on hybrid hosts.
+    std::string frequency_string;
+    u64 max_frequency = 0;
+    if (File::ReadFileToString(path + "cpufreq/cpuinfo_max_freq", frequency_string))
+      TryParse(StripSpaces(frequency_string), &max_frequency);
+
+    auto it = core_indices.find(StripSpaces(siblings));
+    if (it == core_indices.end())
+    {
+      it = core_indices.emplace(StripSpaces(siblings), cores.size()).first;
+      cores.emplace_back();
+    }
+    PhysicalCore& core = cores[it->second];
+    core.logical_cpus.push_back(cpu);
+    core.performance = std::max(core.performance, max_frequency);
+  }
+#endif
+
+  // Without topology information, assume that every logical CPU is a core of its own.
+  if (cores.empty())
+  {
+    for (int cpu = 0; cpu < num_cpus; ++cpu)
+    {
+      cores.emplace_back();
+      cores.back().logical_cpus.push_back(cpu);
+    }
+  }
+
+  // Fastest cores first, so that the emulation threads end up on them.
+  std::stable_sort(cores.begin(), cores.end(), [](const PhysicalCore& a, const PhysicalCore& b) {
+    return a.performance > b.performance;
+  });
+  return cores;
+}
+
+static const std::vector<PhysicalCore>& GetPhysicalCores()
+{
+  static const std::vector<PhysicalCore> s_cores = DetectPhysicalCores();
+  return s_cores;
+}
+
+// The CPUs the process was allowed to run on before any thread was placed.
+static const std::vector<int>& GetProcessCPUs()
+{
+  static const std::vector<int> s_cpus = [] {
+    std::vector<int> cpus;
+#ifdef _WIN32
+    DWORD_PTR process_mask, system_mask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+    {
+      for (int cpu = 0; cpu < static_cast<int>(sizeof(process_mask) * 8); ++cpu)
+      {
+        if ((process_mask >> cpu) & 1)
+          cpus.push_back(cpu);
+      }
+    }
+#elif defined __linux__ && !defined ANDROID
+    cpu_set_t cpu_set;
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+    {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      {
+        if (CPU_ISSET(cpu, &cpu_set))
+          cpus.push_back(cpu);
+      }
+    }
+#endif
+    if (cpus.empty())
+    {
+      for (const PhysicalCore& core : GetPhysicalCores())
+        cpus.insert(cpus.end(), core.logical_cpus.begin(), core.logical_cpus.end());
+    }
+    return cpus;
+  }();
+  return s_cpus;
+}
+
+static bool SetThreadCPUs(const ThreadHandle& thread, const std::vector<int>& cpus)
+{
+#ifdef _WIN32
+  DWORD_PTR mask = 0;
+  for (int cpu : cpus)
+  {
+    if (cpu < static_cast<int>(sizeof(mask) * 8))
+      mask |= static_cast<DWORD_PTR>(1) << cpu;
+  }
+  return mask != 0 && SetThreadAffinityMask(thread.handle, mask) != 0;
+#elif (defined __linux__ || defined BSD4_4 || defined __FreeBSD__) && !(defined ANDROID)
+#ifdef __FreeBSD__
+  cpuset_t cpu_set;
+#else
+  cpu_set_t cpu_set;
+#endif
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus)
+    CPU_SET(cpu, &cpu_set);
+
+  return pthread_setaffinity_np(thread.thread, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
+static bool SetThreadPriorityClass(const ThreadHandle& thread, PriorityClass priority)
+{
+#ifdef _WIN32
+  int value = THREAD_PRIORITY_NORMAL;
+  switch (priority)
+  {
+  case PriorityClass::Lowered:
+    value = THREAD_PRIORITY_BELOW_NORMAL;
+    break;
+  case PriorityClass::Normal:
+    break;
+  case PriorityClass::Raised:
+    value = THREAD_PRIORITY_ABOVE_NORMAL;
+    break;
+  case PriorityClass::High:
+    value = THREAD_PRIORITY_HIGHEST;
+    break;
+  }
+  return SetThreadPriority(thread.handle, value) != 0;
+#elif defined __linux__
+  // Linux applies nice values per thread. Lowering them usually needs CAP_SYS_NICE or a raised
+  // RLIMIT_NICE, so failing here is expected for unprivileged users.
+  int nice_value = 0;
+  switch (priority)
+  {
+  case PriorityClass::Lowered:
+    nice_value = 5;
+    break;
+  case PriorityClass::Normal:
+    break;
+  case PriorityClass::Raised:
+    nice_value = -5;
+    break;
+  case PriorityClass::High:
+    nice_value = -10;
+    break;
+  }
+  return setpriority(PRIO_PROCESS, static_cast<id_t>(thread.tid), nice_value) == 0;
+#else
+  return false;
+#endif
+}
+
+static ThreadPlacement ChoosePlacement(ThreadRole role, ThreadPlacementPolicy policy,
+                                       const std::vector<PhysicalCore>& cores)
+{
+  ThreadPlacement placement;
+  placement.role = role;
+  if (policy == ThreadPlacementPolicy::None)
+    return placement;
+
+  size_t dedicated_slot = cores.size();
+  switch (role)
+  {
+  case ThreadRole::EmuCPU:
+    dedicated_slot = 0;
+    placement.priority = PriorityClass::Raised;
+    break;
+  case ThreadRole::EmuGPU:
+    dedicated_slot = 1;
+    placement.priority = PriorityClass::Raised;
+    break;
+  case ThreadRole::EmuDSP:
+    dedicated_slot = 2;
+    placement.priority = PriorityClass::Raised;
+    break;
+  case ThreadRole::Audio:
+    placement.priority = PriorityClass::High;
+    break;
+  case ThreadRole::Background:
+    placement.priority = PriorityClass::Lowered;
+    break;
+  }
+
+  // The CPU and GPU threads each get a core of their own, and so does the DSP thread if that still
+  // leaves a core for everything else.
+  const size_t num_dedicated = cores.size() >= 4 ? 3 : (cores.size() >= 2 ? 2 : 0);
+  if (dedicated_slot < num_dedicated)
+  {
+    placement.cpus = cores[dedicated_slot].logical_cpus;
+  }
+  else if (num_dedicated != 0)
+  {
+    for (size_t i = num_dedicated; i < cores.size(); ++i)
+    {
+      placement.cpus.insert(placement.cpus.end(), cores[i].logical_cpus.begin(),
+                            cores[i].logical_cpus.end());
+    }
+  }
+
+  return placement;
+}
+
+// Applies a placement to a thread, and undoes what its previous placement (if any) changed that
+// the new one leaves alone.
+static void ApplyPlacement(const ThreadHandle& thread, const ThreadPlacement* previous,
+                           ThreadPlacement* placement)
+{
+  if (!placement->cpus.empty())
+    placement->pinned = SetThreadCPUs(thread, placement->cpus);
+  else if (previous && !previous->cpus.empty())
+    SetThreadCPUs(thread, GetProcessCPUs());
+
+  if (placement->priority != PriorityClass::Normal ||
+      (previous && previous->priority != PriorityClass::Normal))
+  {
+    placement->priority_applied = SetThreadPriorityClass(thread, placement->priority);
+  }
+}
+
+static std::string DescribePlacement(const ThreadPlacement& placement)
+{
+  std::string description;
+  if (placement.cpus.empty())
+  {
+    description = "any CPU";
+  }
+  else
+  {
+    description = "CPUs";
+    for (size_t i = 0; i < placement.cpus.size(); ++i)
+      description += StringFromFormat("%s%d", i == 0 ? " " : ",", placement.cpus[i]);
+    if (!placement.pinned)
+      description += " (pinning failed)";
+  }
+
+  if (placement.priority != PriorityClass::Normal)
+  {
+    description += placement.priority == PriorityClass::Lowered ? ", lowered priority" :
+                                                                   ", raised priority";
+    if (!placement.priority_applied)
+      description += " (not permitted)";
+  }
+
+  return description;
+}
+
+const char* GetThreadRoleName(ThreadRole role)
+{
+  switch (role)
+  {
+  case ThreadRole::EmuCPU:
+    return "emu-cpu";
+  case ThreadRole::EmuGPU:
+    return "emu-gpu";
+  case ThreadRole::EmuDSP:
+    return "emu-dsp";
+  case ThreadRole::Audio:
+    return "audio";
+  case ThreadRole::Background:
+    return "background";
+  }
+  return "unknown";
+}
+
+void SetThreadPlacementPolicy(ThreadPlacementPolicy policy)
+{
+  std::lock_guard<std::mutex> lk(s_placement_mutex);
+  // Before any thread is pinned.
+  GetProcessCPUs();
+  if (policy == s_placement_policy)
+    return;
+
+  s_placement_policy = policy;
+  for (auto& entry : s_registered_threads)
+  {
+    RegisteredThread& thread = entry.second;
+    ThreadPlacement placement = ChoosePlacement(thread.placement.role, policy, GetPhysicalCores());
+    ApplyPlacement(thread.handle, &thread.placement, &placement);
+    thread.placement = placement;
+  }
+}
+
+ThreadPlacementPolicy GetThreadPlacementPolicy()
+{
+  std::lock_guard<std::mutex> lk(s_placement_mutex);
+  return s_placement_policy;
+}
+
+void RegisterCurrentThread(ThreadRole role)
+{
+  ThreadPlacement placement;
+  bool log_placement;
+  {
+    std::lock_guard<std::mutex> lk(s_placement_mutex);
+    GetProcessCPUs();
+    placement = ChoosePlacement(role, s_placement_policy, GetPhysicalCores());
+
+    // A thread may be registered again, e.g. under another role.
+    const auto it = s_registered_threads.find(std::this_thread::get_id());
+    if (it == s_registered_threads.end())
+    {
+      const ThreadHandle handle = GetCurrentThreadHandle();
+      ApplyPlacement(handle, nullptr, &placement);
+      s_registered_threads[std::this_thread::get_id()] = {handle, placement};
+    }
+    else
+    {
+      ApplyPlacement(it->second.handle, &it->second.placement, &placement);
+      it->second.placement = placement;
+    }
+    s_registration_guard.registered = true;
+    log_placement = s_placement_policy != ThreadPlacementPolicy::None;
+  }
+
+  if (log_placement)
+  {
+    INFO_LOG(COMMON, "Placed %s thread on %s", GetThreadRoleName(role),
+             DescribePlacement(placement).c_str());
+  }
+}
+
+std::string GetThreadPlacementReport()
+{
+  std::lock_guard<std::mutex> lk(s_placement_mutex);
+  const std::vector<PhysicalCore>& cores = GetPhysicalCores();
+
+  size_t num_logical_cpus = 0;
+  for (const PhysicalCore& core : cores)
+    num_logical_cpus += core.logical_cpus.size();
+
+  std::string report = StringFromFormat(
+      "Thread placement: %s, %zu physical cores, %zu logical CPUs",
+      s_placement_policy == ThreadPlacementPolicy::None ? "none" : "separate cores", cores.size(),
+      num_logical_cpus);
+
+  std::vector<const ThreadPlacement*> placements;
+  for (const auto& entry : s_registered_threads)
+    placements.push_back(&entry.second.placement);
+  std::stable_sort(placements.begin(), placements.end(),
+                   [](const ThreadPlacement* a, const ThreadPlacement* b) {
+                     return static_cast<int>(a->role) < static_cast<int>(b->role);
+                   });
+
+  for (const ThreadPlacement* placement : placements)
+  {
+    report += StringFromFormat("\n  %s: %s", GetThreadRoleName(placement->role),
+                               DescribePlacement(*placement).c_str());
+  }
+
+  return report;
+}
+
 }  // namespace Common
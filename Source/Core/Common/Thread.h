@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <string>
 #include <thread>
 
 // Don't include Common.h here as it will break LogManager
@@ -36,4 +37,39 @@ inline void YieldCPU()
 
 void SetCurrentThreadName(const char* name);
 
+// What a thread is used for. The placement policy uses this to decide which host cores a thread
+// may run on and at what priority.
+enum class ThreadRole
+{
+  EmuCPU,      // "emu-cpu": the CPU thread (also runs the GPU in single core mode)
+  EmuGPU,      // "emu-gpu": the GPU thread in dual core mode
+  EmuDSP,      // "emu-dsp": the DSP LLE thread
+  Audio,       // "audio": audio backend threads
+  Background,  // "background": I/O, job workers and anything else that is not timing critical
+};
+
+enum class ThreadPlacementPolicy
+{
+  // Leave placement and priorities to the OS.
+  None,
+  // Pin the CPU, GPU and DSP threads to separate physical cores, keep everything else off those
+  // cores (including their SMT siblings) and adjust thread priorities by role.
+  SeparateCores,
+};
+
+const char* GetThreadRoleName(ThreadRole role);
+
+// Also places the threads that are already registered again, so that none of them keep what the
+// previous policy did to them.
+void SetThreadPlacementPolicy(ThreadPlacementPolicy policy);
+ThreadPlacementPolicy GetThreadPlacementPolicy();
+
+// Registers the current thread under the given role and applies the placement policy to it.
+// The registration is dropped automatically when the thread exits.
+void RegisterCurrentThread(ThreadRole role);
+
+// Returns a human readable description of the host topology and the placement of all
+// currently registered threads.
+std::string GetThreadPlacementReport();
+
 }  // namespace Common
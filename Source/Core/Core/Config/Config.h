@@ -5,9 +5,11 @@
 #pragma once
 
 #include <string>
+#include <type_traits>
 
 #include "Common/Config/Config.h"
 #include "Common/Config/Enums.h"
+#include "Common/Config/Snapshot.h"
 
 namespace Config
 {
@@ -87,4 +89,44 @@ void SetBaseOrCurrent(const ConfigInfo<T>& info, const T& value)
     Set<T>(LayerType::CurrentRun, info, value);
 }
 
+// A handle to a setting that reads it from the current config snapshot: O(1), lock-free and safe
+// from any thread, unlike Get, which resolves the setting through every layer. The ConfigInfo must
+// outlive the handle, which is the case for the global ones in the *Settings.h headers.
+template <typename T>
+class CachedInfo final
+{
+public:
+  explicit CachedInfo(const ConfigInfo<T>& info)
+      : m_info(info), m_index(RegisterCachedValue([&info](CachedValue* value) {
+          value->Set(LayerExists(LayerType::Meta) ? Config::Get(info) : info.default_value);
+        }))
+  {
+  }
+
+  T Get() const
+  {
+    SnapshotReadGuard guard;
+    const Snapshot* snapshot = guard.GetSnapshot();
+    if (m_index >= snapshot->GetSize())
+      return m_info.default_value;
+    return Read(snapshot->GetValue(m_index), static_cast<T*>(nullptr));
+  }
+
+  const ConfigInfo<T>& GetInfo() const { return m_info; }
+
+private:
+  template <typename U>
+  static U Read(const CachedValue& value, U*)
+  {
+    return value.Get<U>();
+  }
+  static std::string Read(const CachedValue& value, std::string*)
+  {
+    return value.GetString();
+  }
+
+  const ConfigInfo<T>& m_info;
+  const size_t m_index;
+};
+
 }  // namespace Config
@@ -239,11 +239,15 @@ void SConfig::SaveCoreSettings(IniFile& ini)
 
   core->Set("SkipIPL", bHLE_BS2);
   core->Set("TimingVariance", iTimingVariance);
+  core->Set("PrecisePacing", bPrecisePacing);
   core->Set("CPUCore", iCPUCore);
   core->Set("Fastmem", bFastmem);
+  core->Set("HugePages", bHugePages);
+  core->Set("JITHotLayout", bJITHotLayout);
   core->Set("CPUThread", bCPUThread);
   core->Set("DSPHLE", bDSPHLE);
   core->Set("SyncOnSkipIdle", bSyncGPUOnSkipIdleHack);
+  core->Set("ThreadPlacement", static_cast<int>(m_thread_placement));
   core->Set("SyncGPU", bSyncGPU);
   core->Set("SyncGpuMaxDistance", iSyncGpuMaxDistance);
   core->Set("SyncGpuMinDistance", iSyncGpuMinDistance);
@@ -268,6 +272,9 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("SlotB", m_EXIDevice[1]);
   core->Set("SerialPort1", m_EXIDevice[2]);
   core->Set("BBA_MAC", m_bba_mac);
+  core->Set("BBA_Transport", static_cast<int>(m_bba_transport));
+  core->Set("BBA_TunnelRemote", m_bba_tunnel_remote);
+  core->Set("BBA_TunnelPort", m_bba_tunnel_port);
   for (int i = 0; i < SerialInterface::MAX_SI_CHANNELS; ++i)
   {
     core->Set(StringFromFormat("SIDevice%i", i), m_SIDevice[i]);
@@ -340,6 +347,10 @@ void SConfig::SaveNetworkSettings(IniFile& ini)
   network->Set("SSLVerifyCertificates", m_SSLVerifyCert);
   network->Set("SSLDumpRootCA", m_SSLDumpRootCA);
   network->Set("SSLDumpPeerCert", m_SSLDumpPeerCert);
+  network->Set("NetworkCapture", m_network_capture);
+  network->Set("NetworkCaptureSnapLength", m_network_capture_snap_length);
+  network->Set("NetworkCaptureRotateSize", m_network_capture_rotate_size);
+  network->Set("NetworkCaptureMaxFiles", m_network_capture_max_files);
 }
 
 void SConfig::SaveAnalyticsSettings(IniFile& ini)
@@ -562,10 +573,15 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("CPUCore", &iCPUCore, PowerPC::CORE_INTERPRETER);
 #endif
   core->Get("Fastmem", &bFastmem, true);
+  core->Get("HugePages", &bHugePages, false);
+  core->Get("JITHotLayout", &bJITHotLayout, false);
   core->Get("DSPHLE", &bDSPHLE, true);
   core->Get("TimingVariance", &iTimingVariance, 40);
+  core->Get("PrecisePacing", &bPrecisePacing, true);
   core->Get("CPUThread", &bCPUThread, true);
   core->Get("SyncOnSkipIdle", &bSyncGPUOnSkipIdleHack, true);
+  core->Get("ThreadPlacement", (int*)&m_thread_placement,
+            static_cast<int>(Common::ThreadPlacementPolicy::None));
   core->Get("DefaultISO", &m_strDefaultISO);
   core->Get("DVDRoot", &m_strDVDRoot);
   core->Get("Apploader", &m_strApploader);
@@ -584,6 +600,10 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("SlotB", (int*)&m_EXIDevice[1], ExpansionInterface::EXIDEVICE_NONE);
   core->Get("SerialPort1", (int*)&m_EXIDevice[2], ExpansionInterface::EXIDEVICE_NONE);
   core->Get("BBA_MAC", &m_bba_mac);
+  core->Get("BBA_Transport", (int*)&m_bba_transport,
+            static_cast<int>(ExpansionInterface::BBATransport::TAP));
+  core->Get("BBA_TunnelRemote", &m_bba_tunnel_remote);
+  core->Get("BBA_TunnelPort", &m_bba_tunnel_port, 4000);
   for (int i = 0; i < SerialInterface::MAX_SI_CHANNELS; ++i)
   {
     core->Get(StringFromFormat("SIDevice%i", i), (u32*)&m_SIDevice[i],
@@ -599,6 +619,9 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("RunCompareClient", &bRunCompareClient, false);
   core->Get("MMU", &bMMU, false);
   core->Get("BBDumpPort", &iBBDumpPort, -1);
+  core->Get("TelemetryFile", &m_telemetry_file);
+  core->Get("TelemetryPort", &iTelemetryPort, 0);
+  core->Get("InputLatencyStats", &bInputLatencyStats, false);
   core->Get("SyncGPU", &bSyncGPU, false);
   core->Get("SyncGpuMaxDistance", &iSyncGpuMaxDistance, 200000);
   core->Get("SyncGpuMinDistance", &iSyncGpuMinDistance, -200000);
@@ -671,6 +694,10 @@ void SConfig::LoadNetworkSettings(IniFile& ini)
   network->Get("SSLVerifyCertificates", &m_SSLVerifyCert, true);
   network->Get("SSLDumpRootCA", &m_SSLDumpRootCA, false);
   network->Get("SSLDumpPeerCert", &m_SSLDumpPeerCert, false);
+  network->Get("NetworkCapture", &m_network_capture, false);
+  network->Get("NetworkCaptureSnapLength", &m_network_capture_snap_length, 65535);
+  network->Get("NetworkCaptureRotateSize", &m_network_capture_rotate_size, 0);
+  network->Get("NetworkCaptureMaxFiles", &m_network_capture_max_files, 0);
 }
 
 void SConfig::LoadAnalyticsSettings(IniFile& ini)
@@ -817,6 +844,7 @@ void SConfig::LoadDefaults()
 
   iCPUCore = PowerPC::DefaultCPUCore();
   iTimingVariance = 40;
+  bPrecisePacing = true;
   bCPUThread = false;
   bSyncGPUOnSkipIdleHack = true;
   bRunCompareServer = false;
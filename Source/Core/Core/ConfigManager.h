@@ -13,6 +13,7 @@
 
 #include "Common/IniFile.h"
 #include "Common/NonCopyable.h"
+#include "Common/Thread.h"
 #include "Core/HW/EXI/EXI_Device.h"
 #include "Core/HW/SI/SI_Device.h"
 #include "Core/TitleDatabase.h"
@@ -94,10 +95,13 @@ struct SConfig : NonCopyable
   bool bJITBranchOff = false;
 
   bool bFastmem;
+  bool bHugePages = false;
+  bool bJITHotLayout = false;
   bool bFPRF = false;
   bool bAccurateNaNs = false;
 
   int iTimingVariance = 40;  // in milli secounds
+  bool bPrecisePacing = true;
   bool bCPUThread = true;
   bool bDSPThread = false;
   bool bDSPHLE = true;
@@ -122,6 +126,14 @@ struct SConfig : NonCopyable
   int iBBDumpPort = 0;
   bool bFastDiscSpeed = false;
 
+  Common::ThreadPlacementPolicy m_thread_placement = Common::ThreadPlacementPolicy::None;
+
+  // Per-frame performance telemetry, see FrameTelemetry.h
+  std::string m_telemetry_file;
+  int iTelemetryPort = 0;
+  // Input-to-photon latency statistics, see InputLatency.h
+  bool bInputLatencyStats = false;
+
   bool bSyncGPU = false;
   int iSyncGpuMaxDistance;
   int iSyncGpuMinDistance;
@@ -241,6 +253,10 @@ struct SConfig : NonCopyable
   ExpansionInterface::TEXIDevices m_EXIDevice[3];
   SerialInterface::SIDevices m_SIDevice[4];
   std::string m_bba_mac;
+  ExpansionInterface::BBATransport m_bba_transport = ExpansionInterface::BBATransport::TAP;
+  // host:port of the other end of the UDP tunnel, and the local port it sends to.
+  std::string m_bba_tunnel_remote;
+  u32 m_bba_tunnel_port;
 
   // interface language
   std::string m_InterfaceLanguage;
@@ -327,6 +343,11 @@ struct SConfig : NonCopyable
   bool m_SSLVerifyCert;
   bool m_SSLDumpRootCA;
   bool m_SSLDumpPeerCert;
+  bool m_network_capture;
+  u32 m_network_capture_snap_length;
+  // In MiB, 0 disables rotation.
+  u32 m_network_capture_rotate_size;
+  u32 m_network_capture_max_files;
 
   // Save settings
   void SaveSettings();
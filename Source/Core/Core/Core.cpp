@@ -5,6 +5,7 @@
 #include "Core/Core.h"
 
 #include <atomic>
+#include <cinttypes>
 #include <cstring>
 #include <locale>
 #include <mutex>
@@ -22,6 +23,7 @@
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
+#include "Common/HostPerfCounter.h"
 #include "Common/Flag.h"
 #include "Common/Logging/LogManager.h"
 #include "Common/MemoryUtil.h"
@@ -36,6 +38,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/Host.h"
 #include "Core/MemTools.h"
 #ifdef USE_MEMORYWATCHER
@@ -57,6 +60,7 @@
 #include "Core/Movie.h"
 #include "Core/NetPlayClient.h"
 #include "Core/NetPlayProto.h"
+#include "Core/NetworkCapture.h"
 #include "Core/PatchEngine.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -69,6 +73,7 @@
 
 #include "InputCommon/ControllerInterface/ControllerInterface.h"
 #include "InputCommon/GCAdapter.h"
+#include "InputCommon/InputLatency.h"
 
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -245,6 +250,8 @@ bool Init(std::unique_ptr<BootParameters> boot)
   INFO_LOG(BOOT, "Starting core = %s mode", SConfig::GetInstance().bWii ? "Wii" : "GameCube");
   INFO_LOG(BOOT, "CPU Thread separate = %s", SConfig::GetInstance().bCPUThread ? "Yes" : "No");
 
+  Common::SetThreadPlacementPolicy(SConfig::GetInstance().m_thread_placement);
+
   Host_UpdateMainFrame();  // Disable any menus or buttons at boot
 
   s_window_handle = Host_GetRenderHandle();
@@ -343,6 +350,8 @@ static void CpuThread()
     Common::SetCurrentThreadName("CPU-GPU thread");
     g_video_backend->Video_Prepare();
   }
+  Common::RegisterCurrentThread(Common::ThreadRole::EmuCPU);
+  NOTICE_LOG(BOOT, "%s", Common::GetThreadPlacementReport().c_str());
 
   // This needs to be delayed until after the video backend is ready.
   DolphinAnalytics::Instance()->ReportGameStart();
@@ -386,9 +395,39 @@ static void CpuThread()
   MemoryWatcher::Init();
 #endif
 
+  // Count TLB and instruction cache misses on the CPU thread, so that runs with and without huge
+  // pages or the JIT hot layout can be compared.
+  Common::HostPerfCounter dtlb_misses(Common::HostPerfCounter::Event::DTLBLoadMisses);
+  Common::HostPerfCounter itlb_misses(Common::HostPerfCounter::Event::ITLBLoadMisses);
+  Common::HostPerfCounter icache_misses(Common::HostPerfCounter::Event::L1ICacheLoadMisses);
+  Common::HostPerfCounter instructions(Common::HostPerfCounter::Event::Instructions);
+  dtlb_misses.Start();
+  itlb_misses.Start();
+  icache_misses.Start();
+  instructions.Start();
+
   // Enter CPU run loop. When we leave it - we are done.
   CPU::Run();
 
+  dtlb_misses.Stop();
+  itlb_misses.Stop();
+  icache_misses.Stop();
+  instructions.Stop();
+  if (dtlb_misses.IsAvailable() && instructions.IsAvailable())
+  {
+    INFO_LOG(MEMMAP, "CPU thread: %" PRIu64 " dTLB load misses in %" PRIu64
+                     " instructions (huge pages %s)",
+             dtlb_misses.Read(), instructions.Read(),
+             _CoreParameter.bHugePages ? "enabled" : "disabled");
+  }
+  if (itlb_misses.IsAvailable() && icache_misses.IsAvailable() && instructions.IsAvailable())
+  {
+    INFO_LOG(DYNA_REC, "CPU thread: %" PRIu64 " iTLB load misses and %" PRIu64
+                       " L1 icache load misses in %" PRIu64 " instructions (JIT hot layout %s)",
+             itlb_misses.Read(), icache_misses.Read(), instructions.Read(),
+             _CoreParameter.bJITHotLayout ? "enabled" : "disabled");
+  }
+
   s_is_started = false;
 
   if (!_CoreParameter.bCPUThread)
@@ -412,6 +451,7 @@ static void FifoPlayerThread()
     g_video_backend->Video_Prepare();
     Common::SetCurrentThreadName("FIFO-GPU thread");
   }
+  Common::RegisterCurrentThread(Common::ThreadRole::EmuCPU);
 
   // Enter CPU run loop. When we leave it - we are done.
   if (auto cpu_core = FifoPlayer::GetInstance().GetCPUCore())
@@ -475,6 +515,15 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
   Movie::Init(*boot);
   Common::ScopeGuard movie_guard{Movie::Shutdown};
 
+  // Started before the devices it captures and stopped after them.
+  if (core_parameter.m_network_capture)
+  {
+    NetworkCapture::Start(core_parameter.m_network_capture_snap_length,
+                          u64{core_parameter.m_network_capture_rotate_size} * 1024 * 1024,
+                          core_parameter.m_network_capture_max_files);
+  }
+  Common::ScopeGuard network_capture_guard{NetworkCapture::Stop};
+
   HW::Init();
   Common::ScopeGuard hw_guard{[] {
     // We must set up this flag before executing HW::Shutdown()
@@ -553,6 +602,17 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
   AudioCommon::InitSoundStream();
   Common::ScopeGuard audio_guard{AudioCommon::ShutdownSoundStream};
 
+  if (!core_parameter.m_telemetry_file.empty() || core_parameter.iTelemetryPort > 0)
+  {
+    FrameTelemetry::Start(core_parameter.m_telemetry_file,
+                          static_cast<u16>(core_parameter.iTelemetryPort),
+                          !core_parameter.bCPUThread);
+  }
+  Common::ScopeGuard telemetry_guard{FrameTelemetry::Stop};
+
+  InputLatency::SetEnabled(core_parameter.bInputLatencyStats);
+  Common::ScopeGuard input_latency_guard{[] { InputLatency::SetEnabled(false); }};
+
   // The hardware is initialized.
   s_hardware_initialized = true;
   s_is_booting.Clear();
@@ -600,6 +660,7 @@ static void EmuThread(std::unique_ptr<BootParameters> boot)
     // This thread, after creating the EmuWindow, spawns a CPU
     // thread, and then takes over and becomes the video thread
     Common::SetCurrentThreadName("Video thread");
+    Common::RegisterCurrentThread(Common::ThreadRole::EmuGPU);
 
     g_video_backend->Video_Prepare();
 
@@ -810,6 +871,9 @@ bool PauseAndLock(bool do_lock, bool unpause_on_unlock)
 // This should only be called from VI
 void VideoThrottle()
 {
+  FrameTelemetry::EndFrame();
+  JitInterface::EndFrame();
+
   // Update info per second
   u32 ElapseTime = (u32)s_timer.GetTimeDifference();
   if ((ElapseTime >= 1000 && s_drawn_video.load() > 0) || s_request_refresh_info)
@@ -20,6 +20,7 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/PowerPC/PowerPC.h"
 
 #include "VideoCommon/Fifo.h"
@@ -322,6 +323,7 @@ void Advance()
 
   s_is_global_timer_sane = true;
 
+  u64 events_run = 0;
   while (!s_event_queue.empty() && s_event_queue.front().time <= g.global_timer)
   {
     Event evt = std::move(s_event_queue.front());
@@ -330,7 +332,9 @@ void Advance()
     // NOTICE_LOG(POWERPC, "[Scheduler] %-20s (%lld, %lld)", evt.type->name->c_str(),
     //            g.global_timer, evt.time);
     evt.type->callback(evt.userdata, g.global_timer - evt.time);
+    ++events_run;
   }
+  FrameTelemetry::Increment(FrameTelemetry::Counter::CoreTimingEvents, events_run);
 
   s_is_global_timer_sane = false;
 
@@ -385,6 +389,23 @@ void Idle()
   PowerPC::ppcState.downcount = 0;
 }
 
+void IdleUntil(u64 ticks)
+{
+  if (ticks >= static_cast<u64>(g.global_timer + g.slice_length))
+  {
+    Idle();
+    return;
+  }
+
+  const u64 now = GetTicks();
+  if (ticks <= now)
+    return;
+
+  const int cycles = static_cast<int>(ticks - now);
+  s_idled_cycles += cycles;
+  PowerPC::ppcState.downcount -= CyclesToDowncount(cycles);
+}
+
 std::string GetScheduledEventsSummary()
 {
   std::string text = "Scheduled events\n";
@@ -87,6 +87,8 @@ void MoveEvents();
 
 // Pretend that the main CPU has executed enough cycles to reach the next event.
 void Idle();
+// The same, but only up to the given time if that comes before the next event.
+void IdleUntil(u64 ticks);
 
 // Clear all pending events. This should ONLY be done on exit or state load.
 void ClearPendingEvents();
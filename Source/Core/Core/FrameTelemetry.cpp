@@ -0,0 +1,271 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/FrameTelemetry.h"
+
+#include <array>
+#include <cinttypes>
+#include <memory>
+#include <thread>
+
+#include <SFML/Network.hpp>
+
+#include "Common/Event.h"
+#include "Common/FifoQueue.h"
+#include "Common/File.h"
+#include "Common/Flag.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+
+namespace FrameTelemetry
+{
+constexpr size_t NUM_TIMERS = static_cast<size_t>(Timer::NumTimers);
+constexpr size_t NUM_COUNTERS = static_cast<size_t>(Counter::NumCounters);
+
+static constexpr std::array<const char*, NUM_TIMERS> TIMER_NAMES = {{
+    "cpu_jit_compile", "cpu_hle", "cpu_idle", "cpu_sync_wait", "gpu_decode", "gpu_vertex",
+    "gpu_shader", "gpu_backend", "audio_callback",
+}};
+static constexpr std::array<const char*, NUM_COUNTERS> COUNTER_NAMES = {{
+    "shader_compiles", "texture_cache_misses", "coretiming_events", "busy_wait_skips",
+    "jit_blocks_revived",
+}};
+
+// Written from several threads, so each one gets its own cache line.
+struct alignas(64) Accumulator
+{
+  std::atomic<u64> value{0};
+};
+
+std::atomic<bool> detail::s_enabled{false};
+
+static std::array<Accumulator, NUM_TIMERS> s_timers;
+static std::array<Accumulator, NUM_COUNTERS> s_counters;
+static thread_local ScopedTimer* s_current_timer = nullptr;
+
+static bool s_single_core;
+static u64 s_frame;
+static std::chrono::steady_clock::time_point s_frame_start;
+
+static std::thread s_writer_thread;
+static Common::Event s_writer_event;
+static Common::Flag s_writer_exit;
+static Common::FifoQueue<FrameRecord, false> s_records;
+static File::IOFile s_file;
+static bool s_file_is_json;
+static std::unique_ptr<sf::UdpSocket> s_socket;
+static u16 s_port;
+
+static bool IsGPUTimer(size_t index)
+{
+  return index >= static_cast<size_t>(Timer::GPUDecode) &&
+         index <= static_cast<size_t>(Timer::GPUBackend);
+}
+
+static u64 GetElapsedNs(std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+static u64 ToMicroseconds(u64 ns)
+{
+  return (ns + 500) / 1000;
+}
+
+std::string FormatCSVHeader()
+{
+  std::string header = "frame,frame_us,cpu_execute_us";
+  for (const char* name : TIMER_NAMES)
+    header += StringFromFormat(",%s_us", name);
+  for (const char* name : COUNTER_NAMES)
+    header += StringFromFormat(",%s", name);
+  return header + "\n";
+}
+
+std::string FormatCSV(const FrameRecord& record)
+{
+  std::string line =
+      StringFromFormat("%" PRIu64 ",%" PRIu64 ",%" PRIu64, record.frame,
+                       ToMicroseconds(record.frame_ns), ToMicroseconds(record.cpu_execute_ns));
+  for (u64 ns : record.timers_ns)
+    line += StringFromFormat(",%" PRIu64, ToMicroseconds(ns));
+  for (u64 count : record.counters)
+    line += StringFromFormat(",%" PRIu64, count);
+  return line + "\n";
+}
+
+std::string FormatJSON(const FrameRecord& record)
+{
+  std::string line = StringFromFormat(
+      "{\"frame\":%" PRIu64 ",\"frame_us\":%" PRIu64 ",\"cpu_execute_us\":%" PRIu64, record.frame,
+      ToMicroseconds(record.frame_ns), ToMicroseconds(record.cpu_execute_ns));
+  for (size_t i = 0; i < NUM_TIMERS; ++i)
+    line += StringFromFormat(",\"%s_us\":%" PRIu64, TIMER_NAMES[i],
+                             ToMicroseconds(record.timers_ns[i]));
+  for (size_t i = 0; i < NUM_COUNTERS; ++i)
+    line += StringFromFormat(",\"%s\":%" PRIu64, COUNTER_NAMES[i], record.counters[i]);
+  return line + "}\n";
+}
+
+static void WriteRecords()
+{
+  FrameRecord record;
+  while (s_records.Pop(record))
+  {
+    if (s_file.IsOpen())
+    {
+      const std::string line = s_file_is_json ? FormatJSON(record) : FormatCSV(record);
+      s_file.WriteBytes(line.data(), line.size());
+    }
+
+    if (s_socket)
+    {
+      const std::string json = FormatJSON(record);
+      s_socket->send(json.data(), json.size(), sf::IpAddress::LocalHost, s_port);
+    }
+  }
+}
+
+static void WriterThread()
+{
+  Common::SetCurrentThreadName("Telemetry writer");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
+
+  while (!s_writer_exit.IsSet())
+  {
+    s_writer_event.Wait();
+    WriteRecords();
+  }
+
+  WriteRecords();
+  s_file.Flush();
+}
+
+bool Start(const std::string& file, u16 port, bool single_core)
+{
+  Stop();
+
+  if (!file.empty())
+  {
+    if (!s_file.Open(file, "wb"))
+    {
+      ERROR_LOG(CORE, "Failed to open telemetry file %s", file.c_str());
+      return false;
+    }
+
+    std::string extension;
+    SplitPath(file, nullptr, nullptr, &extension);
+    s_file_is_json = extension == ".json";
+    if (!s_file_is_json)
+    {
+      const std::string header = FormatCSVHeader();
+      s_file.WriteBytes(header.data(), header.size());
+    }
+  }
+
+  if (port != 0)
+  {
+    s_socket = std::make_unique<sf::UdpSocket>();
+    s_port = port;
+  }
+
+  if (!s_file.IsOpen() && !s_socket)
+    return false;
+
+  for (Accumulator& timer : s_timers)
+    timer.value.store(0);
+  for (Accumulator& counter : s_counters)
+    counter.value.store(0);
+  s_single_core = single_core;
+  s_frame = 0;
+  s_frame_start = std::chrono::steady_clock::now();
+
+  s_writer_exit.Clear();
+  s_writer_thread = std::thread(WriterThread);
+  detail::s_enabled.store(true);
+
+  NOTICE_LOG(CORE, "Recording frame telemetry to %s%s%s", file.c_str(),
+             file.empty() || !port ? "" : " and ",
+             port ? StringFromFormat("UDP port %u", port).c_str() : "");
+  return true;
+}
+
+void Stop()
+{
+  detail::s_enabled.store(false);
+
+  if (s_writer_thread.joinable())
+  {
+    s_writer_exit.Set();
+    s_writer_event.Set();
+    s_writer_thread.join();
+  }
+
+  s_file.Close();
+  s_socket.reset();
+  s_records.Clear();
+}
+
+void AddTime(Timer timer, u64 ns)
+{
+  if (IsEnabled())
+    s_timers[static_cast<size_t>(timer)].value.fetch_add(ns, std::memory_order_relaxed);
+}
+
+void Increment(Counter counter, u64 amount)
+{
+  if (IsEnabled())
+    s_counters[static_cast<size_t>(counter)].value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+void EndFrame()
+{
+  if (!IsEnabled())
+    return;
+
+  const auto now = std::chrono::steady_clock::now();
+  FrameRecord record;
+  record.frame = s_frame++;
+  record.frame_ns = GetElapsedNs(s_frame_start, now);
+  s_frame_start = now;
+
+  // Whatever the CPU thread didn't spend in one of the timers was spent running the guest.
+  u64 accounted_ns = 0;
+  for (size_t i = 0; i < NUM_TIMERS; ++i)
+  {
+    record.timers_ns[i] = s_timers[i].value.exchange(0, std::memory_order_relaxed);
+    const bool on_cpu_thread = i != static_cast<size_t>(Timer::AudioCallback) &&
+                               (s_single_core || !IsGPUTimer(i));
+    if (on_cpu_thread)
+      accounted_ns += record.timers_ns[i];
+  }
+  record.cpu_execute_ns = record.frame_ns > accounted_ns ? record.frame_ns - accounted_ns : 0;
+
+  for (size_t i = 0; i < NUM_COUNTERS; ++i)
+    record.counters[i] = s_counters[i].value.exchange(0, std::memory_order_relaxed);
+
+  s_records.Push(record);
+  s_writer_event.Set();
+}
+
+void ScopedTimer::Begin()
+{
+  m_start = Clock::now();
+  m_parent = s_current_timer;
+  if (m_parent)
+    AddTime(m_parent->m_timer, GetElapsedNs(m_parent->m_start, m_start));
+  s_current_timer = this;
+}
+
+void ScopedTimer::End()
+{
+  const Clock::time_point now = Clock::now();
+  AddTime(m_timer, GetElapsedNs(m_start, now));
+  s_current_timer = m_parent;
+  if (m_parent)
+    m_parent->m_start = now;
+}
+}  // namespace FrameTelemetry
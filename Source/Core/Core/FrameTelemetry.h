@@ -0,0 +1,111 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Per-frame performance records: where the CPU, GPU and audio threads spent their time during
+// each emulated frame, for profiling and capacity planning. Records are written to a CSV or JSON
+// file and/or sent as JSON datagrams to a local UDP port by a separate thread.
+//
+// When telemetry is disabled, every recording function costs a single relaxed atomic load.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+namespace FrameTelemetry
+{
+enum class Timer
+{
+  JitCompile,
+  HLE,
+  CPUIdle,
+  SyncWait,
+  GPUDecode,
+  GPUVertex,
+  GPUShader,
+  GPUBackend,
+  AudioCallback,
+  NumTimers
+};
+
+enum class Counter
+{
+  ShaderCompiles,
+  TextureCacheMisses,
+  CoreTimingEvents,
+  BusyWaitSkips,
+  JitBlocksRevived,
+  NumCounters
+};
+
+struct FrameRecord
+{
+  u64 frame;
+  u64 frame_ns;
+  // Time on the CPU thread that isn't covered by any CPU timer, i.e. mostly executing guest code.
+  u64 cpu_execute_ns;
+  u64 timers_ns[static_cast<size_t>(Timer::NumTimers)];
+  u64 counters[static_cast<size_t>(Counter::NumCounters)];
+};
+
+// Starts recording. file may be empty; records are JSON lines if its extension is .json, and CSV
+// otherwise. port is a UDP port on localhost that receives every record as a JSON object, or 0.
+// single_core tells whether GPU work runs on the CPU thread.
+bool Start(const std::string& file, u16 port, bool single_core);
+void Stop();
+
+namespace detail
+{
+extern std::atomic<bool> s_enabled;
+}
+
+inline bool IsEnabled()
+{
+  return detail::s_enabled.load(std::memory_order_relaxed);
+}
+
+void AddTime(Timer timer, u64 ns);
+void Increment(Counter counter, u64 amount = 1);
+
+// Closes the current frame. Called on the CPU thread at the end of every emulated field.
+void EndFrame();
+
+std::string FormatCSVHeader();
+std::string FormatCSV(const FrameRecord& record);
+std::string FormatJSON(const FrameRecord& record);
+
+// Measures the time until it goes out of scope. Time spent in nested timers on the same thread is
+// only counted towards the innermost one, so that the timers of a frame add up.
+class ScopedTimer final
+{
+public:
+  explicit ScopedTimer(Timer timer) : m_timer(timer), m_active(IsEnabled())
+  {
+    if (m_active)
+      Begin();
+  }
+  ~ScopedTimer()
+  {
+    if (m_active)
+      End();
+  }
+
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void Begin();
+  void End();
+
+  Timer m_timer;
+  bool m_active;
+  ScopedTimer* m_parent = nullptr;
+  Clock::time_point m_start;
+};
+}  // namespace FrameTelemetry
@@ -10,11 +10,13 @@
 #include "Common/CommonTypes.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/GeckoCode.h"
 #include "Core/HLE/HLE_Misc.h"
 #include "Core/HLE/HLE_OS.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IOS/ES/ES.h"
+#include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
 
@@ -80,6 +82,14 @@ static const SPatch OSBreakPoints[] = {
 };
 // clang-format on
 
+// Hooks are looked up when code is compiled, so the JIT has to compile the code again even though
+// it hasn't changed, instead of reviving the blocks it had.
+static void InvalidateHookedCode(u32 address)
+{
+  PowerPC::ppcState.iCache.Invalidate(address);
+  JitInterface::InvalidateICache(address, 4, true);
+}
+
 void Patch(u32 addr, const char* hle_func_name)
 {
   for (u32 i = 1; i < ArraySize(OSPatches); ++i)
@@ -87,7 +97,7 @@ void Patch(u32 addr, const char* hle_func_name)
     if (!strcmp(OSPatches[i].m_szPatchName, hle_func_name))
     {
       s_original_instructions[addr] = i;
-      PowerPC::ppcState.iCache.Invalidate(addr);
+      InvalidateHookedCode(addr);
       return;
     }
   }
@@ -118,7 +128,7 @@ void PatchFunctions()
   {
     if (OSPatches[i->second].flags != HLE_TYPE_FIXED)
     {
-      PowerPC::ppcState.iCache.Invalidate(i->first);
+      InvalidateHookedCode(i->first);
       i = s_original_instructions.erase(i);
     }
     else
@@ -138,7 +148,7 @@ void PatchFunctions()
       for (u32 addr = symbol->address; addr < symbol->address + symbol->size; addr += 4)
       {
         s_original_instructions[addr] = i;
-        PowerPC::ppcState.iCache.Invalidate(addr);
+        InvalidateHookedCode(addr);
       }
       INFO_LOG(OSHLE, "Patching %s %08x", OSPatches[i].m_szPatchName, symbol->address);
     }
@@ -173,6 +183,7 @@ void Reload()
 
 void Execute(u32 _CurrentPC, u32 _Instruction)
 {
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::HLE);
   unsigned int FunctionIndex = _Instruction & 0xFFFFF;
   if (FunctionIndex > 0 && FunctionIndex < ArraySize(OSPatches))
   {
@@ -235,7 +246,7 @@ u32 UnPatch(const std::string& patch_name)
       if (i->second == patch_idx)
       {
         addr = i->first;
-        PowerPC::ppcState.iCache.Invalidate(i->first);
+        InvalidateHookedCode(i->first);
         i = s_original_instructions.erase(i);
       }
       else
@@ -253,7 +264,7 @@ u32 UnPatch(const std::string& patch_name)
     for (u32 addr = symbol->address; addr < symbol->address + symbol->size; addr += 4)
     {
       s_original_instructions.erase(addr);
-      PowerPC::ppcState.iCache.Invalidate(addr);
+      InvalidateHookedCode(addr);
     }
     return symbol->address;
   }
@@ -271,7 +282,7 @@ bool UnPatch(u32 addr, const std::string& name)
     return false;
 
   s_original_instructions.erase(itr);
-  PowerPC::ppcState.iCache.Invalidate(addr);
+  InvalidateHookedCode(addr);
   return true;
 }
 
@@ -242,6 +242,11 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
                    CoreTiming::RemoveEvent(et_AI);
                    CoreTiming::ScheduleEvent(GetAIPeriod(), et_AI);
                  }));
+  // For busy-wait loops: the sample counter goes up with the time.
+  mmio->RegisterNextChange(base | AI_SAMPLE_COUNTER, [] {
+    const u64 samples = (CoreTiming::GetTicks() - g_LastCPUTime) / g_CPUCyclesPerSample;
+    return g_LastCPUTime + (samples + 1) * g_CPUCyclesPerSample;
+  });
 
   mmio->Register(base | AI_INTERRUPT_TIMING, MMIO::DirectRead<u32>(&m_InterruptTiming),
                  MMIO::ComplexWrite<u32>([](u32, u32 val) {
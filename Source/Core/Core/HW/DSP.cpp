@@ -24,6 +24,8 @@
 
 #include "Core/HW/DSP.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include "AudioCommon/AudioCommon.h"
@@ -203,7 +205,8 @@ void Reinit(bool hle)
     s_ARAM.wii_mode = false;
     s_ARAM.size = ARAM_SIZE;
     s_ARAM.mask = ARAM_MASK;
-    s_ARAM.ptr = static_cast<u8*>(Common::AllocateMemoryPages(s_ARAM.size));
+    s_ARAM.ptr = static_cast<u8*>(
+        Common::AllocateMemoryPages(s_ARAM.size, SConfig::GetInstance().bHugePages));
   }
 
   s_audioDMA = {};
@@ -472,6 +475,16 @@ void UpdateAudioDMA()
   }
 }
 
+// ARAM and main RAM both hold big endian data, so DMAs between them are plain copies. They are
+// done in runs that end wherever the ARAM address wraps or main RAM ends.
+static u32 GetARAMDMARunLength()
+{
+  u32 length = std::min<u32>(s_arDMA.Cnt.count, s_ARAM.mask + 1 - (s_arDMA.ARAddr & s_ARAM.mask));
+  if (s_arDMA.MMAddr < Memory::REALRAM_SIZE)
+    length = std::min<u32>(length, Memory::REALRAM_SIZE - s_arDMA.MMAddr);
+  return length;
+}
+
 static void Do_ARAM_DMA()
 {
   s_dspState.DMAState = 1;
@@ -493,26 +506,17 @@ static void Do_ARAM_DMA()
 
     if (s_arDMA.ARAddr < s_ARAM.size)
     {
+      // The memory map set up in s_ARAM_Info makes no difference for reads from ARAM.
       while (s_arDMA.Cnt.count)
       {
-        // These are logically separated in code to show that a memory map has been set up
-        // See below in the write section for more information
-        if ((s_ARAM_Info.Hex & 0xf) == 3)
-        {
-          Memory::Write_U64_Swap(*(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], s_arDMA.MMAddr);
-        }
-        else if ((s_ARAM_Info.Hex & 0xf) == 4)
-        {
-          Memory::Write_U64_Swap(*(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], s_arDMA.MMAddr);
-        }
-        else
-        {
-          Memory::Write_U64_Swap(*(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], s_arDMA.MMAddr);
-        }
-
-        s_arDMA.MMAddr += 8;
-        s_arDMA.ARAddr += 8;
-        s_arDMA.Cnt.count -= 8;
+        const u32 length = GetARAMDMARunLength();
+        u8* dst = Memory::GetPointer(s_arDMA.MMAddr);
+        if (dst)
+          std::memcpy(dst, &s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], length);
+
+        s_arDMA.MMAddr += length;
+        s_arDMA.ARAddr += length;
+        s_arDMA.Cnt.count -= length;
       }
     }
     else
@@ -542,30 +546,23 @@ static void Do_ARAM_DMA()
     {
       while (s_arDMA.Cnt.count)
       {
-        if ((s_ARAM_Info.Hex & 0xf) == 3)
-        {
-          *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
-              Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
-        }
-        else if ((s_ARAM_Info.Hex & 0xf) == 4)
+        // With the memory map set to 4, writes to the first 4MB are mirrored to the next 4MB.
+        const bool mirror = (s_ARAM_Info.Hex & 0xf) == 4 && s_arDMA.ARAddr < 0x400000;
+        u32 length = GetARAMDMARunLength();
+        if (mirror)
+          length = std::min(length, 0x400000 - s_arDMA.ARAddr);
+
+        const u8* src = Memory::GetPointer(s_arDMA.MMAddr);
+        if (src)
         {
-          if (s_arDMA.ARAddr < 0x400000)
-          {
-            *(u64*)&s_ARAM.ptr[(s_arDMA.ARAddr + 0x400000) & s_ARAM.mask] =
-                Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
-          }
-          *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
-              Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
-        }
-        else
-        {
-          *(u64*)&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask] =
-              Common::swap64(Memory::Read_U64(s_arDMA.MMAddr));
+          if (mirror)
+            std::memcpy(&s_ARAM.ptr[(s_arDMA.ARAddr + 0x400000) & s_ARAM.mask], src, length);
+          std::memcpy(&s_ARAM.ptr[s_arDMA.ARAddr & s_ARAM.mask], src, length);
         }
 
-        s_arDMA.MMAddr += 8;
-        s_arDMA.ARAddr += 8;
-        s_arDMA.Cnt.count -= 8;
+        s_arDMA.MMAddr += length;
+        s_arDMA.ARAddr += length;
+        s_arDMA.Cnt.count -= length;
       }
     }
     else
@@ -11,6 +11,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
+#include "Common/SwapCopy.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
@@ -481,8 +482,10 @@ void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
   {
     int* ptr = (int*)HLEMemory_Get_Pointer(write_addr);
     for (auto& buffer : buffers)
-      for (u32 j = 0; j < 5 * 32; ++j)
-        *ptr++ = Common::swap32(buffer[j]);
+    {
+      Common::SwapCopy(ptr, buffer, 5 * 32);
+      ptr += 5 * 32;
+    }
   }
 
   // Then, we read the new temp from the CPU and add to our current
@@ -498,15 +501,10 @@ void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
 
 void AXUCode::UploadLRS(u32 dst_addr)
 {
-  int buffers[3][5 * 32];
-
-  for (u32 i = 0; i < 5 * 32; ++i)
-  {
-    buffers[0][i] = Common::swap32(m_samples_left[i]);
-    buffers[1][i] = Common::swap32(m_samples_right[i]);
-    buffers[2][i] = Common::swap32(m_samples_surround[i]);
-  }
-  memcpy(HLEMemory_Get_Pointer(dst_addr), buffers, sizeof(buffers));
+  int* ptr = (int*)HLEMemory_Get_Pointer(dst_addr);
+  Common::SwapCopy(ptr, m_samples_left, 5 * 32);
+  Common::SwapCopy(ptr + 5 * 32, m_samples_right, 5 * 32);
+  Common::SwapCopy(ptr + 2 * 5 * 32, m_samples_surround, 5 * 32);
 }
 
 void AXUCode::SetMainLR(u32 src_addr)
@@ -523,11 +521,7 @@ void AXUCode::SetMainLR(u32 src_addr)
 
 void AXUCode::OutputSamples(u32 lr_addr, u32 surround_addr)
 {
-  int surround_buffer[5 * 32];
-
-  for (u32 i = 0; i < 5 * 32; ++i)
-    surround_buffer[i] = Common::swap32(m_samples_surround[i]);
-  memcpy(HLEMemory_Get_Pointer(surround_addr), surround_buffer, sizeof(surround_buffer));
+  Common::SwapCopy((int*)HLEMemory_Get_Pointer(surround_addr), m_samples_surround, 5 * 32);
 
   // 32 samples per ms, 5 ms, 2 channels
   short buffer[5 * 32 * 2];
@@ -549,10 +543,8 @@ void AXUCode::MixAUXBLR(u32 ul_addr, u32 dl_addr)
 {
   // Upload AUXB L/R
   int* ptr = (int*)HLEMemory_Get_Pointer(ul_addr);
-  for (auto& sample : m_samples_auxB_left)
-    *ptr++ = Common::swap32(sample);
-  for (auto& sample : m_samples_auxB_right)
-    *ptr++ = Common::swap32(sample);
+  Common::SwapCopy(ptr, m_samples_auxB_left, 5 * 32);
+  Common::SwapCopy(ptr + 5 * 32, m_samples_auxB_right, 5 * 32);
 
   // Mix AUXB L/R to MAIN L/R, and replace AUXB L/R
   ptr = (int*)HLEMemory_Get_Pointer(dl_addr);
@@ -90,6 +90,7 @@ void DSPLLE::DoState(PointerWrap& p)
 void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 {
   Common::SetCurrentThreadName("DSP thread");
+  Common::RegisterCurrentThread(Common::ThreadRole::EmuDSP);
 
   while (dsp_lle->m_is_running.IsSet())
   {
@@ -345,6 +345,7 @@ static void FinishRead(u64 id, s64 cycles_late)
 static void DVDThread()
 {
   Common::SetCurrentThreadName("DVD thread");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
 
   while (true)
   {
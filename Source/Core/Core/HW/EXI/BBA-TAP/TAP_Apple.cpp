@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 
 #include "Common/Logging/Log.h"
@@ -12,99 +13,89 @@
 
 namespace ExpansionInterface
 {
-bool CEXIETHERNET::Activate()
+bool CEXIETHERNET::TAPNetworkInterface::Activate()
 {
-  if (IsActivated())
-    return true;
-
   // Assumes TunTap OS X is installed, and /dev/tun0 is not in use
   // and readable / writable by the logged-in user
 
-  if ((fd = open("/dev/tap0", O_RDWR)) < 0)
+  if ((m_fd = open("/dev/tap0", O_RDWR)) < 0)
   {
     ERROR_LOG(SP1, "Couldn't open /dev/tap0, unable to init BBA");
     return false;
   }
 
-  INFO_LOG(SP1, "BBA initialized.");
-  return RecvInit();
-}
-
-void CEXIETHERNET::Deactivate()
-{
-  close(fd);
-  fd = -1;
+  if (pipe(m_wake_pipe) != 0)
+  {
+    ERROR_LOG(SP1, "Failed to create the BBA wake-up pipe");
+    close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+  fcntl(m_wake_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(m_wake_pipe[1], F_SETFL, O_NONBLOCK);
 
-  readEnabled.Clear();
-  readThreadShutdown.Set();
-  if (readThread.joinable())
-    readThread.join();
+  INFO_LOG(SP1, "BBA initialized.");
+  return true;
 }
 
-bool CEXIETHERNET::IsActivated()
+void CEXIETHERNET::TAPNetworkInterface::Deactivate()
 {
-  return fd != -1;
+  close(m_fd);
+  m_fd = -1;
+  close(m_wake_pipe[0]);
+  close(m_wake_pipe[1]);
+  m_wake_pipe[0] = m_wake_pipe[1] = -1;
 }
 
-bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
+bool CEXIETHERNET::TAPNetworkInterface::SendFrame(const u8* frame, u32 size)
 {
   INFO_LOG(SP1, "SendFrame %x\n%s", size, ArrayToString(frame, size, 0x10).c_str());
 
-  int writtenBytes = write(fd, frame, size);
+  int writtenBytes = write(m_fd, frame, size);
   if ((u32)writtenBytes != size)
   {
     ERROR_LOG(SP1, "SendFrame(): expected to write %d bytes, instead wrote %d", size, writtenBytes);
     return false;
   }
-  else
-  {
-    SendComplete();
-    return true;
-  }
+  return true;
 }
 
-static void ReadThreadHandler(CEXIETHERNET* self)
+int CEXIETHERNET::TAPNetworkInterface::RecvFrame(u8* buffer, u32 size, int timeout_ms)
 {
-  while (!self->readThreadShutdown.IsSet())
-  {
-    fd_set rfds;
-    FD_ZERO(&rfds);
-    FD_SET(self->fd, &rfds);
+  pollfd fds[2] = {{m_fd, POLLIN, 0}, {m_wake_pipe[0], POLLIN, 0}};
+  if (poll(fds, 2, timeout_ms) <= 0)
+    return 0;
 
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 50000;
-    if (select(self->fd + 1, &rfds, nullptr, nullptr, &timeout) <= 0)
-      continue;
-
-    int readBytes = read(self->fd, self->mRecvBuffer.get(), BBA_RECV_SIZE);
-    if (readBytes < 0)
+  if (fds[1].revents & POLLIN)
+  {
+    char wake_bytes[16];
+    while (read(m_wake_pipe[0], wake_bytes, sizeof(wake_bytes)) > 0)
     {
-      ERROR_LOG(SP1, "Failed to read from BBA, err=%d", readBytes);
     }
-    else if (self->readEnabled.IsSet())
+  }
+  if (!(fds[0].revents & POLLIN))
+  {
+    // These are reported regardless of the requested events, and keep being reported.
+    if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
     {
-      INFO_LOG(SP1, "Read data: %s",
-               ArrayToString(self->mRecvBuffer.get(), readBytes, 0x10).c_str());
-      self->mRecvBufferLength = readBytes;
-      self->RecvHandlePacket();
+      ERROR_LOG(SP1, "BBA device failed, revents=%x", fds[0].revents);
+      return -1;
     }
+    return 0;
   }
-}
 
-bool CEXIETHERNET::RecvInit()
-{
-  readThread = std::thread(ReadThreadHandler, this);
-  return true;
-}
-
-void CEXIETHERNET::RecvStart()
-{
-  readEnabled.Set();
+  int readBytes = read(m_fd, buffer, size);
+  if (readBytes < 0)
+    ERROR_LOG(SP1, "Failed to read from BBA, err=%d", readBytes);
+  else
+    INFO_LOG(SP1, "Read data: %s", ArrayToString(buffer, readBytes, 0x10).c_str());
+  return readBytes;
 }
 
-void CEXIETHERNET::RecvStop()
+void CEXIETHERNET::TAPNetworkInterface::Interrupt()
 {
-  readEnabled.Clear();
+  const char wake_byte = 0;
+  if (write(m_wake_pipe[1], &wake_byte, 1) < 0)
+    DEBUG_LOG(SP1, "BBA wake-up pipe is full");
 }
 }  // namespace ExpansionInterface
@@ -18,8 +18,8 @@
 #include <linux/if_tun.h>
 #include <net/if.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/ioctl.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #endif
 
@@ -28,16 +28,13 @@ namespace ExpansionInterface
 #define NOTIMPLEMENTED(Name)                                                                       \
   NOTICE_LOG(SP1, "CEXIETHERNET::%s not implemented for your UNIX", Name);
 
-bool CEXIETHERNET::Activate()
+bool CEXIETHERNET::TAPNetworkInterface::Activate()
 {
 #ifdef __linux__
-  if (IsActivated())
-    return true;
-
   // Assumes that there is a TAP device named "Dolphin" preconfigured for
   // bridge/NAT/whatever the user wants it configured.
 
-  if ((fd = open("/dev/net/tun", O_RDWR)) < 0)
+  if ((m_fd = open("/dev/net/tun", O_RDWR)) < 0)
   {
     ERROR_LOG(SP1, "Couldn't open /dev/net/tun, unable to init BBA");
     return false;
@@ -53,12 +50,12 @@ bool CEXIETHERNET::Activate()
     strncpy(ifr.ifr_name, StringFromFormat("Dolphin%d", i).c_str(), IFNAMSIZ);
 
     int err;
-    if ((err = ioctl(fd, TUNSETIFF, (void*)&ifr)) < 0)
+    if ((err = ioctl(m_fd, TUNSETIFF, (void*)&ifr)) < 0)
     {
       if (i == (MAX_INTERFACES - 1))
       {
-        close(fd);
-        fd = -1;
+        close(m_fd);
+        m_fd = -1;
         ERROR_LOG(SP1, "TUNSETIFF failed: Interface=%s err=%d", ifr.ifr_name, err);
         return false;
       }
@@ -68,119 +65,100 @@ bool CEXIETHERNET::Activate()
       break;
     }
   }
-  ioctl(fd, TUNSETNOCSUM, 1);
+  ioctl(m_fd, TUNSETNOCSUM, 1);
+
+  if (pipe(m_wake_pipe) != 0)
+  {
+    ERROR_LOG(SP1, "Failed to create the BBA wake-up pipe");
+    close(m_fd);
+    m_fd = -1;
+    return false;
+  }
+  fcntl(m_wake_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(m_wake_pipe[1], F_SETFL, O_NONBLOCK);
 
   INFO_LOG(SP1, "BBA initialized with associated tap %s", ifr.ifr_name);
-  return RecvInit();
+  return true;
 #else
   NOTIMPLEMENTED("Activate");
   return false;
 #endif
 }
 
-void CEXIETHERNET::Deactivate()
+void CEXIETHERNET::TAPNetworkInterface::Deactivate()
 {
 #ifdef __linux__
-  close(fd);
-  fd = -1;
-
-  readEnabled.Clear();
-  readThreadShutdown.Set();
-  if (readThread.joinable())
-    readThread.join();
+  close(m_fd);
+  m_fd = -1;
+  close(m_wake_pipe[0]);
+  close(m_wake_pipe[1]);
+  m_wake_pipe[0] = m_wake_pipe[1] = -1;
 #else
   NOTIMPLEMENTED("Deactivate");
 #endif
 }
 
-bool CEXIETHERNET::IsActivated()
-{
-#ifdef __linux__
-  return fd != -1 ? true : false;
-#else
-  return false;
-#endif
-}
-
-bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
+bool CEXIETHERNET::TAPNetworkInterface::SendFrame(const u8* frame, u32 size)
 {
 #ifdef __linux__
   DEBUG_LOG(SP1, "SendFrame %x\n%s", size, ArrayToString(frame, size, 0x10).c_str());
 
-  int writtenBytes = write(fd, frame, size);
+  int writtenBytes = write(m_fd, frame, size);
   if ((u32)writtenBytes != size)
   {
     ERROR_LOG(SP1, "SendFrame(): expected to write %d bytes, instead wrote %d", size, writtenBytes);
     return false;
   }
-  else
-  {
-    SendComplete();
-    return true;
-  }
+  return true;
 #else
   NOTIMPLEMENTED("SendFrame");
   return false;
 #endif
 }
 
-#ifdef __linux__
-static void ReadThreadHandler(CEXIETHERNET* self)
+int CEXIETHERNET::TAPNetworkInterface::RecvFrame(u8* buffer, u32 size, int timeout_ms)
 {
-  while (!self->readThreadShutdown.IsSet())
+#ifdef __linux__
+  pollfd fds[2] = {{m_fd, POLLIN, 0}, {m_wake_pipe[0], POLLIN, 0}};
+  if (poll(fds, 2, timeout_ms) <= 0)
+    return 0;
+
+  if (fds[1].revents & POLLIN)
   {
-    fd_set rfds;
-    FD_ZERO(&rfds);
-    FD_SET(self->fd, &rfds);
-
-    struct timeval timeout;
-    timeout.tv_sec = 0;
-    timeout.tv_usec = 50000;
-    if (select(self->fd + 1, &rfds, nullptr, nullptr, &timeout) <= 0)
-      continue;
-
-    int readBytes = read(self->fd, self->mRecvBuffer.get(), BBA_RECV_SIZE);
-    if (readBytes < 0)
+    char wake_bytes[16];
+    while (read(m_wake_pipe[0], wake_bytes, sizeof(wake_bytes)) > 0)
     {
-      ERROR_LOG(SP1, "Failed to read from BBA, err=%d", readBytes);
     }
-    else if (self->readEnabled.IsSet())
+  }
+  if (!(fds[0].revents & POLLIN))
+  {
+    // These are reported regardless of the requested events, and keep being reported.
+    if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
     {
-      DEBUG_LOG(SP1, "Read data: %s",
-                ArrayToString(self->mRecvBuffer.get(), readBytes, 0x10).c_str());
-      self->mRecvBufferLength = readBytes;
-      self->RecvHandlePacket();
+      ERROR_LOG(SP1, "BBA device failed, revents=%x", fds[0].revents);
+      return -1;
     }
+    return 0;
   }
-}
-#endif
-
-bool CEXIETHERNET::RecvInit()
-{
-#ifdef __linux__
-  readThread = std::thread(ReadThreadHandler, this);
-  return true;
-#else
-  NOTIMPLEMENTED("RecvInit");
-  return false;
-#endif
-}
 
-void CEXIETHERNET::RecvStart()
-{
-#ifdef __linux__
-  readEnabled.Set();
+  int readBytes = read(m_fd, buffer, size);
+  if (readBytes < 0)
+    ERROR_LOG(SP1, "Failed to read from BBA, err=%d", readBytes);
+  else
+    DEBUG_LOG(SP1, "Read data: %s", ArrayToString(buffer, readBytes, 0x10).c_str());
+  return readBytes;
 #else
-  NOTIMPLEMENTED("RecvStart");
+  NOTIMPLEMENTED("RecvFrame");
+  return -1;
 #endif
 }
 
-void CEXIETHERNET::RecvStop()
+void CEXIETHERNET::TAPNetworkInterface::Interrupt()
 {
 #ifdef __linux__
-  readEnabled.Clear();
-#else
-  NOTIMPLEMENTED("RecvStop");
+  const char wake_byte = 0;
+  if (write(m_wake_pipe[1], &wake_byte, 1) < 0)
+    DEBUG_LOG(SP1, "BBA wake-up pipe is full");
 #endif
 }
 }  // namespace ExpansionInterface
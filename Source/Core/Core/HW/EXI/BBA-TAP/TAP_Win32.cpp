@@ -3,6 +3,10 @@
 // Refer to the license.txt file included.
 
 #include "Core/HW/EXI/BBA-TAP/TAP_Win32.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
@@ -167,11 +171,8 @@ bool OpenTAP(HANDLE& adapter, const std::basic_string<TCHAR>& device_guid)
 
 namespace ExpansionInterface
 {
-bool CEXIETHERNET::Activate()
+bool CEXIETHERNET::TAPNetworkInterface::Activate()
 {
-  if (IsActivated())
-    return true;
-
   DWORD len;
   std::vector<std::basic_string<TCHAR>> device_guids;
 
@@ -183,13 +184,13 @@ bool CEXIETHERNET::Activate()
 
   for (size_t i = 0; i < device_guids.size(); i++)
   {
-    if (Win32TAPHelper::OpenTAP(mHAdapter, device_guids.at(i)))
+    if (Win32TAPHelper::OpenTAP(m_h_adapter, device_guids.at(i)))
     {
       INFO_LOG(SP1, "OPENED %s", device_guids.at(i).c_str());
       break;
     }
   }
-  if (mHAdapter == INVALID_HANDLE_VALUE)
+  if (m_h_adapter == INVALID_HANDLE_VALUE)
   {
     PanicAlert("Failed to open any TAP");
     return false;
@@ -197,8 +198,8 @@ bool CEXIETHERNET::Activate()
 
   /* get driver version info */
   ULONG info[3];
-  if (DeviceIoControl(mHAdapter, TAP_IOCTL_GET_VERSION, &info, sizeof(info), &info, sizeof(info),
-                      &len, nullptr))
+  if (DeviceIoControl(m_h_adapter, TAP_IOCTL_GET_VERSION, &info, sizeof(info), &info,
+                      sizeof(info), &len, nullptr))
   {
     INFO_LOG(SP1, "TAP-Win32 Driver Version %d.%d %s", info[0], info[1], info[2] ? "(DEBUG)" : "");
   }
@@ -215,7 +216,7 @@ bool CEXIETHERNET::Activate()
 
   /* set driver media status to 'connected' */
   ULONG status = TRUE;
-  if (!DeviceIoControl(mHAdapter, TAP_IOCTL_SET_MEDIA_STATUS, &status, sizeof(status), &status,
+  if (!DeviceIoControl(m_h_adapter, TAP_IOCTL_SET_MEDIA_STATUS, &status, sizeof(status), &status,
                        sizeof(status), &len, nullptr))
   {
     ERROR_LOG(SP1, "WARNING: The TAP-Win32 driver rejected a"
@@ -224,144 +225,119 @@ bool CEXIETHERNET::Activate()
   }
 
   /* initialize read/write events */
-  mReadOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
-  mWriteOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
-  if (mReadOverlapped.hEvent == nullptr || mWriteOverlapped.hEvent == nullptr)
+  m_read_overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+  m_write_overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+  m_wake_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+  if (m_read_overlapped.hEvent == nullptr || m_write_overlapped.hEvent == nullptr ||
+      m_wake_event == nullptr)
+  {
     return false;
+  }
 
-  mWriteBuffer.reserve(1518);
-  return RecvInit();
+  return true;
 }
 
-void CEXIETHERNET::Deactivate()
+void CEXIETHERNET::TAPNetworkInterface::Deactivate()
 {
-  if (!IsActivated())
+  if (m_h_adapter == INVALID_HANDLE_VALUE)
     return;
 
-  // Signal read thread to exit.
-  readEnabled.Clear();
-  readThreadShutdown.Set();
-
-  // Cancel any outstanding requests from both this thread (writes), and the read thread.
-  CancelIoEx(mHAdapter, nullptr);
-
-  // Wait for read thread to exit.
-  if (readThread.joinable())
-    readThread.join();
+  // The I/O thread has exited, but its last read may still be pending.
+  CancelIoEx(m_h_adapter, nullptr);
+  if (m_read_pending)
+  {
+    DWORD transferred;
+    GetOverlappedResult(m_h_adapter, &m_read_overlapped, &transferred, TRUE);
+    m_read_pending = false;
+  }
 
   // Clean-up handles
-  CloseHandle(mReadOverlapped.hEvent);
-  CloseHandle(mWriteOverlapped.hEvent);
-  CloseHandle(mHAdapter);
-  mHAdapter = INVALID_HANDLE_VALUE;
-  memset(&mReadOverlapped, 0, sizeof(mReadOverlapped));
-  memset(&mWriteOverlapped, 0, sizeof(mWriteOverlapped));
+  CloseHandle(m_read_overlapped.hEvent);
+  CloseHandle(m_write_overlapped.hEvent);
+  CloseHandle(m_wake_event);
+  CloseHandle(m_h_adapter);
+  m_h_adapter = INVALID_HANDLE_VALUE;
+  m_wake_event = nullptr;
+  memset(&m_read_overlapped, 0, sizeof(m_read_overlapped));
+  memset(&m_write_overlapped, 0, sizeof(m_write_overlapped));
 }
 
-bool CEXIETHERNET::IsActivated()
+bool CEXIETHERNET::TAPNetworkInterface::SendFrame(const u8* frame, u32 size)
 {
-  return mHAdapter != INVALID_HANDLE_VALUE;
+  DEBUG_LOG(SP1, "SendFrame %u bytes:\n%s", size, ArrayToString(frame, size, 0x10).c_str());
+
+  DWORD transferred;
+  if (WriteFile(m_h_adapter, frame, size, &transferred, &m_write_overlapped))
+  {
+    // Returning immediately is not likely to happen, but if so, reset the event state manually.
+    ResetEvent(m_write_overlapped.hEvent);
+    return true;
+  }
+
+  // IO should be pending.
+  if (GetLastError() != ERROR_IO_PENDING)
+  {
+    ERROR_LOG(SP1, "WriteFile failed (err=0x%X)", GetLastError());
+    ResetEvent(m_write_overlapped.hEvent);
+    return false;
+  }
+
+  // The frame is only valid until this returns, and this is the I/O thread, so just wait.
+  if (!GetOverlappedResult(m_h_adapter, &m_write_overlapped, &transferred, TRUE))
+  {
+    ERROR_LOG(SP1, "GetOverlappedResult failed (err=0x%X)", GetLastError());
+    return false;
+  }
+  return true;
 }
 
-static void ReadThreadHandler(CEXIETHERNET* self)
+int CEXIETHERNET::TAPNetworkInterface::RecvFrame(u8* buffer, u32 size, int timeout_ms)
 {
-  while (!self->readThreadShutdown.IsSet())
-  {
-    DWORD transferred;
+  DWORD transferred;
 
-    // Read from TAP into internal buffer.
-    if (ReadFile(self->mHAdapter, self->mRecvBuffer.get(), BBA_RECV_SIZE, &transferred,
-                 &self->mReadOverlapped))
+  // The read outlives this call if nothing arrives in time, so it goes to m_read_buffer.
+  if (!m_read_pending)
+  {
+    if (ReadFile(m_h_adapter, m_read_buffer.data(), BBA_RECV_SIZE, &transferred,
+                 &m_read_overlapped))
     {
       // Returning immediately is not likely to happen, but if so, reset the event state manually.
-      ResetEvent(self->mReadOverlapped.hEvent);
+      ResetEvent(m_read_overlapped.hEvent);
     }
-    else
+    else if (GetLastError() != ERROR_IO_PENDING)
     {
-      // IO should be pending.
-      if (GetLastError() != ERROR_IO_PENDING)
-      {
-        ERROR_LOG(SP1, "ReadFile failed (err=0x%X)", GetLastError());
-        continue;
-      }
-
-      // Block until the read completes.
-      if (!GetOverlappedResult(self->mHAdapter, &self->mReadOverlapped, &transferred, TRUE))
-      {
-        // If CancelIO was called, we should exit (the flag will be set).
-        if (GetLastError() == ERROR_OPERATION_ABORTED)
-          continue;
-
-        // Something else went wrong.
-        ERROR_LOG(SP1, "GetOverlappedResult failed (err=0x%X)", GetLastError());
-        continue;
-      }
+      ERROR_LOG(SP1, "ReadFile failed (err=0x%X)", GetLastError());
+      return -1;
     }
-
-    // Copy to BBA buffer, and fire interrupt if enabled.
-    DEBUG_LOG(SP1, "Received %u bytes:\n %s", transferred,
-              ArrayToString(self->mRecvBuffer.get(), transferred, 0x10).c_str());
-    if (self->readEnabled.IsSet())
+    else
     {
-      self->mRecvBufferLength = transferred;
-      self->RecvHandlePacket();
+      m_read_pending = true;
     }
   }
-}
-
-bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
-{
-  DEBUG_LOG(SP1, "SendFrame %u bytes:\n%s", size, ArrayToString(frame, size, 0x10).c_str());
 
-  // Check for a background write. We can't issue another one until this one has completed.
-  DWORD transferred;
-  if (mWritePending)
+  if (m_read_pending)
   {
-    // Wait for previous write to complete.
-    if (!GetOverlappedResult(mHAdapter, &mWriteOverlapped, &transferred, TRUE))
-      ERROR_LOG(SP1, "GetOverlappedResult failed (err=0x%X)", GetLastError());
-  }
-
-  // Copy to write buffer.
-  mWriteBuffer.assign(frame, frame + size);
-  mWritePending = true;
+    const HANDLE events[] = {m_read_overlapped.hEvent, m_wake_event};
+    if (WaitForMultipleObjects(2, events, FALSE, timeout_ms) != WAIT_OBJECT_0)
+      return 0;
 
-  // Queue async write.
-  if (WriteFile(mHAdapter, mWriteBuffer.data(), size, &transferred, &mWriteOverlapped))
-  {
-    // Returning immediately is not likely to happen, but if so, reset the event state manually.
-    ResetEvent(mWriteOverlapped.hEvent);
-  }
-  else
-  {
-    // IO should be pending.
-    if (GetLastError() != ERROR_IO_PENDING)
+    m_read_pending = false;
+    if (!GetOverlappedResult(m_h_adapter, &m_read_overlapped, &transferred, FALSE))
     {
-      ERROR_LOG(SP1, "WriteFile failed (err=0x%X)", GetLastError());
-      ResetEvent(mWriteOverlapped.hEvent);
-      mWritePending = false;
-      return false;
+      ERROR_LOG(SP1, "GetOverlappedResult failed (err=0x%X)", GetLastError());
+      return -1;
     }
   }
 
-  // Always report the packet as being sent successfully, even though it might be a lie
-  SendComplete();
-  return true;
-}
-
-bool CEXIETHERNET::RecvInit()
-{
-  readThread = std::thread(ReadThreadHandler, this);
-  return true;
-}
-
-void CEXIETHERNET::RecvStart()
-{
-  readEnabled.Set();
+  DEBUG_LOG(SP1, "Received %u bytes:\n %s", transferred,
+            ArrayToString(m_read_buffer.data(), transferred, 0x10).c_str());
+  transferred = std::min<DWORD>(transferred, size);
+  memcpy(buffer, m_read_buffer.data(), transferred);
+  return static_cast<int>(transferred);
 }
 
-void CEXIETHERNET::RecvStop()
+void CEXIETHERNET::TAPNetworkInterface::Interrupt()
 {
-  readEnabled.Clear();
+  SetEvent(m_wake_event);
 }
 }  // namespace ExpansionInterface
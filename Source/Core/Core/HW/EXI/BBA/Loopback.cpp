@@ -0,0 +1,49 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "Core/HW/EXI/EXI_DeviceEthernet.h"
+
+namespace ExpansionInterface
+{
+bool CEXIETHERNET::LoopbackNetworkInterface::Activate()
+{
+  return true;
+}
+
+void CEXIETHERNET::LoopbackNetworkInterface::Deactivate()
+{
+  m_frames.clear();
+}
+
+// Both sending and receiving happen on the I/O thread, so the queue needs no lock.
+bool CEXIETHERNET::LoopbackNetworkInterface::SendFrame(const u8* frame, u32 size)
+{
+  m_frames.emplace_back(frame, frame + size);
+  return true;
+}
+
+int CEXIETHERNET::LoopbackNetworkInterface::RecvFrame(u8* buffer, u32 size, int timeout_ms)
+{
+  if (m_frames.empty())
+  {
+    m_wake_event.WaitFor(std::chrono::milliseconds(timeout_ms));
+    return 0;
+  }
+
+  const std::vector<u8>& frame = m_frames.front();
+  const u32 frame_size = std::min(static_cast<u32>(frame.size()), size);
+  memcpy(buffer, frame.data(), frame_size);
+  m_frames.pop_front();
+  return static_cast<int>(frame_size);
+}
+
+void CEXIETHERNET::LoopbackNetworkInterface::Interrupt()
+{
+  m_wake_event.Set();
+}
+}  // namespace ExpansionInterface
@@ -0,0 +1,118 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <SFML/Network.hpp>
+
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Core/HW/EXI/EXI_DeviceEthernet.h"
+
+namespace ExpansionInterface
+{
+CEXIETHERNET::UDPTunnelNetworkInterface::UDPTunnelNetworkInterface(const std::string& remote,
+                                                                   u16 local_port)
+    : m_remote(remote), m_local_port(local_port)
+{
+}
+
+CEXIETHERNET::UDPTunnelNetworkInterface::~UDPTunnelNetworkInterface() = default;
+
+bool CEXIETHERNET::UDPTunnelNetworkInterface::Activate()
+{
+  const size_t colon = m_remote.rfind(':');
+  u32 remote_port = 0;
+  if (colon == std::string::npos || !TryParse(m_remote.substr(colon + 1), &remote_port) ||
+      remote_port == 0 || remote_port > 0xffff)
+  {
+    ERROR_LOG(SP1, "Invalid BBA tunnel address \"%s\", expected host:port", m_remote.c_str());
+    return false;
+  }
+  const sf::IpAddress remote_address(m_remote.substr(0, colon));
+  m_remote_address = remote_address.toInteger();
+  m_remote_port = static_cast<u16>(remote_port);
+  if (remote_address == sf::IpAddress::None)
+  {
+    ERROR_LOG(SP1, "Couldn't resolve BBA tunnel host %s", m_remote.substr(0, colon).c_str());
+    return false;
+  }
+
+  m_socket = std::make_unique<sf::UdpSocket>();
+  m_wake_socket = std::make_unique<sf::UdpSocket>();
+  if (m_socket->bind(m_local_port) != sf::Socket::Done ||
+      m_wake_socket->bind(sf::Socket::AnyPort) != sf::Socket::Done)
+  {
+    ERROR_LOG(SP1, "Couldn't bind BBA tunnel to UDP port %u", m_local_port);
+    Deactivate();
+    return false;
+  }
+  m_socket->setBlocking(false);
+  m_wake_socket->setBlocking(false);
+
+  m_selector = std::make_unique<sf::SocketSelector>();
+  m_selector->add(*m_socket);
+  m_selector->add(*m_wake_socket);
+
+  INFO_LOG(SP1, "BBA tunnel from UDP port %u to %s", m_local_port, m_remote.c_str());
+  return true;
+}
+
+void CEXIETHERNET::UDPTunnelNetworkInterface::Deactivate()
+{
+  m_selector.reset();
+  m_wake_socket.reset();
+  m_socket.reset();
+}
+
+bool CEXIETHERNET::UDPTunnelNetworkInterface::SendFrame(const u8* frame, u32 size)
+{
+  const sf::IpAddress remote_address(m_remote_address);
+  if (m_socket->send(frame, size, remote_address, m_remote_port) != sf::Socket::Done)
+  {
+    ERROR_LOG(SP1, "Failed to send %u bytes through the BBA tunnel", size);
+    return false;
+  }
+  return true;
+}
+
+int CEXIETHERNET::UDPTunnelNetworkInterface::RecvFrame(u8* buffer, u32 size, int timeout_ms)
+{
+  int received = ReceiveFromRemote(buffer, size);
+  // A zero timeout would make the selector wait forever.
+  if (received != 0 || timeout_ms == 0 || !m_selector->wait(sf::milliseconds(timeout_ms)))
+    return received;
+
+  if (m_selector->isReady(*m_wake_socket))
+  {
+    char wake_bytes[16];
+    std::size_t wake_size;
+    sf::IpAddress sender;
+    unsigned short port;
+    while (m_wake_socket->receive(wake_bytes, sizeof(wake_bytes), wake_size, sender, port) ==
+           sf::Socket::Done)
+    {
+    }
+  }
+  return ReceiveFromRemote(buffer, size);
+}
+
+int CEXIETHERNET::UDPTunnelNetworkInterface::ReceiveFromRemote(u8* buffer, u32 size)
+{
+  std::size_t received;
+  sf::IpAddress sender;
+  unsigned short port;
+  while (m_socket->receive(buffer, size, received, sender, port) == sf::Socket::Done)
+  {
+    // Anybody could send datagrams to the port, but only the other end belongs on the network.
+    if (sender.toInteger() == m_remote_address && port == m_remote_port)
+      return static_cast<int>(received);
+  }
+  return 0;
+}
+
+void CEXIETHERNET::UDPTunnelNetworkInterface::Interrupt()
+{
+  const char wake_byte = 0;
+  m_wake_socket->send(&wake_byte, 1, sf::IpAddress::LocalHost, m_wake_socket->getLocalPort());
+}
+}  // namespace ExpansionInterface
@@ -30,6 +30,14 @@ enum TEXIDevices : int
   EXIDEVICE_NONE = 0xFF
 };
 
+// Where the broadband adapter sends its frames to and receives them from.
+enum class BBATransport
+{
+  TAP,
+  UDPTunnel,
+  Loopback
+};
+
 class IEXIDevice
 {
 public:
@@ -4,6 +4,9 @@
 
 #include "Core/HW/EXI/EXI_DeviceEthernet.h"
 
+#include <array>
+#include <cinttypes>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -11,10 +14,12 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Network.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/EXI/EXI.h"
 #include "Core/HW/Memmap.h"
+#include "Core/NetworkCapture.h"
 
 namespace ExpansionInterface
 {
@@ -22,14 +27,31 @@ namespace ExpansionInterface
 // Multiple parts of this implementation depend on Dolphin
 // being compiled for a little endian host.
 
+// How long the I/O thread waits for a frame before checking whether it should exit. Frames to send
+// wake it up right away.
+constexpr int IO_TIMEOUT_MS = 50;
+// Frames the I/O thread reads without waiting once one has arrived.
+constexpr u32 RECV_BATCH_SIZE = 16;
+
+static CoreTiming::EventType* s_et_recv;
+
+static void RecvCallback(u64 userdata, s64 cycles_late)
+{
+  auto* bba = static_cast<CEXIETHERNET*>(ExpansionInterface::FindDevice(EXIDEVICE_ETH));
+  if (bba)
+    bba->RecvFromRing();
+}
+
+void CEXIETHERNET::Init()
+{
+  s_et_recv = CoreTiming::RegisterEvent("BBARecv", RecvCallback);
+}
+
 CEXIETHERNET::CEXIETHERNET()
 {
   tx_fifo = std::make_unique<u8[]>(BBA_TXFIFO_SIZE);
   mBbaMem = std::make_unique<u8[]>(BBA_MEM_SIZE);
 
-  mRecvBuffer = std::make_unique<u8[]>(BBA_RECV_SIZE);
-  mRecvBufferLength = 0;
-
   MXHardReset();
 
   // Parse MAC address from config, and generate a new one if it doesn't
@@ -49,14 +71,21 @@ CEXIETHERNET::CEXIETHERNET()
   // HACK: .. fully established 100BASE-T link
   mBbaMem[BBA_NWAYS] = NWAYS_LS100 | NWAYS_LPNWAY | NWAYS_100TXF | NWAYS_ANCLPT;
 
-#if defined(_WIN32)
-  mHAdapter = INVALID_HANDLE_VALUE;
-  memset(&mReadOverlapped, 0, sizeof(mReadOverlapped));
-  memset(&mWriteOverlapped, 0, sizeof(mWriteOverlapped));
-  mWritePending = false;
-#elif defined(__linux__) || defined(__APPLE__)
-  fd = -1;
-#endif
+  const SConfig& config = SConfig::GetInstance();
+  switch (config.m_bba_transport)
+  {
+  case BBATransport::UDPTunnel:
+    m_network_interface = std::make_unique<UDPTunnelNetworkInterface>(
+        config.m_bba_tunnel_remote, static_cast<u16>(config.m_bba_tunnel_port));
+    break;
+  case BBATransport::Loopback:
+    m_network_interface = std::make_unique<LoopbackNetworkInterface>();
+    break;
+  case BBATransport::TAP:
+  default:
+    m_network_interface = std::make_unique<TAPNetworkInterface>();
+    break;
+  }
 }
 
 CEXIETHERNET::~CEXIETHERNET()
@@ -204,6 +233,10 @@ void CEXIETHERNET::DoState(PointerWrap& p)
 {
   p.DoArray(tx_fifo.get(), BBA_TXFIFO_SIZE);
   p.DoArray(mBbaMem.get(), BBA_MEM_SIZE);
+
+  // The pending receive event (if any) was replaced by the one in the savestate.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    m_recv_scheduled.store(false);
 }
 
 bool CEXIETHERNET::IsMXCommand(u32 const data)
@@ -403,6 +436,165 @@ void CEXIETHERNET::SendFromPacketBuffer()
   ERROR_LOG(SP1, "tx packet buffer not implemented.");
 }
 
+bool CEXIETHERNET::Activate()
+{
+  if (IsActivated())
+    return true;
+
+  if (!m_network_interface->Activate())
+    return false;
+
+  m_io_thread_shutdown.Clear();
+  m_io_thread = std::thread(&CEXIETHERNET::IOThread, this);
+  return true;
+}
+
+void CEXIETHERNET::Deactivate()
+{
+  if (!IsActivated())
+    return;
+
+  m_recv_enabled.Clear();
+  m_io_thread_shutdown.Set();
+  m_network_interface->Interrupt();
+  m_io_thread.join();
+  m_network_interface->Deactivate();
+
+  const BBAStats stats = GetStats();
+  INFO_LOG(SP1,
+           "BBA sent %" PRIu64 " frames (%" PRIu64 " bytes, %" PRIu64 " dropped), received %" PRIu64
+           " frames (%" PRIu64 " bytes, %" PRIu64 " dropped)",
+           stats.tx_frames, stats.tx_bytes, stats.tx_dropped, stats.rx_frames, stats.rx_bytes,
+           stats.rx_dropped);
+}
+
+bool CEXIETHERNET::IsActivated() const
+{
+  return m_io_thread.joinable();
+}
+
+bool CEXIETHERNET::SendFrame(const u8* frame, u32 size)
+{
+  DEBUG_LOG(SP1, "SendFrame %x", size);
+
+  FrameRing::Frame* slot = IsActivated() ? m_tx_ring.GetWriteSlot() : nullptr;
+  if (slot && size <= sizeof(slot->data))
+  {
+    memcpy(slot->data, frame, size);
+    slot->size = size;
+    m_tx_ring.Push();
+    m_network_interface->Interrupt();
+  }
+  else
+  {
+    slot = nullptr;
+    m_tx_dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The frame has left the FIFO either way.
+  SendComplete();
+  return slot != nullptr;
+}
+
+void CEXIETHERNET::RecvStart()
+{
+  m_recv_enabled.Set();
+}
+
+void CEXIETHERNET::RecvStop()
+{
+  m_recv_enabled.Clear();
+}
+
+// Runs on the CPU thread, and copies everything the I/O thread has received to the packet buffer.
+void CEXIETHERNET::RecvFromRing()
+{
+  // Frames pushed from now on need another event.
+  m_recv_scheduled.store(false);
+
+  while (const FrameRing::Frame* frame = m_rx_ring.Front())
+  {
+    if (m_recv_enabled.IsSet())
+      RecvHandlePacket(frame->data, frame->size);
+    m_rx_ring.Pop();
+  }
+}
+
+void CEXIETHERNET::IOThread()
+{
+  Common::SetCurrentThreadName("BBA I/O");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
+
+  // Frames that can't be queued are still read, so that they don't pile up in the host's buffers.
+  std::array<u8, BBA_RECV_SIZE> discard_buffer;
+
+  while (!m_io_thread_shutdown.IsSet())
+  {
+    while (const FrameRing::Frame* frame = m_tx_ring.Front())
+    {
+      if (m_network_interface->SendFrame(frame->data, frame->size))
+      {
+        NetworkCapture::AddPacket(NetworkCapture::Stream::BBA, frame->data, frame->size);
+        m_tx_frames.fetch_add(1, std::memory_order_relaxed);
+        m_tx_bytes.fetch_add(frame->size, std::memory_order_relaxed);
+      }
+      else
+      {
+        m_tx_dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+      m_tx_ring.Pop();
+    }
+
+    // Wait for a frame, then take whatever else has arrived in the meantime.
+    bool received = false;
+    for (u32 i = 0; i < RECV_BATCH_SIZE; ++i)
+    {
+      FrameRing::Frame* slot = m_rx_ring.GetWriteSlot();
+      u8* buffer = slot ? slot->data : discard_buffer.data();
+      const int size = m_network_interface->RecvFrame(buffer, BBA_RECV_SIZE,
+                                                      i == 0 ? IO_TIMEOUT_MS : 0);
+      if (size < 0 && i == 0)
+      {
+        // Errors are returned immediately, and usually persist, so back off instead of spinning.
+        // Sending is still attempted, in case the device recovers.
+        Common::SleepCurrentThread(IO_TIMEOUT_MS);
+      }
+      if (size <= 0)
+        break;
+      if (!m_recv_enabled.IsSet())
+        continue;
+      // Frames the game won't see because of a full queue are captured all the same.
+      NetworkCapture::AddPacket(NetworkCapture::Stream::BBA, buffer, size);
+      if (!slot)
+      {
+        m_rx_dropped.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+
+      slot->size = size;
+      m_rx_ring.Push();
+      m_rx_frames.fetch_add(1, std::memory_order_relaxed);
+      m_rx_bytes.fetch_add(size, std::memory_order_relaxed);
+      received = true;
+    }
+
+    if (received && !m_recv_scheduled.exchange(true))
+      CoreTiming::ScheduleEvent(0, s_et_recv, 0, CoreTiming::FromThread::NON_CPU);
+  }
+}
+
+BBAStats CEXIETHERNET::GetStats() const
+{
+  BBAStats stats;
+  stats.tx_frames = m_tx_frames.load(std::memory_order_relaxed);
+  stats.tx_bytes = m_tx_bytes.load(std::memory_order_relaxed);
+  stats.tx_dropped = m_tx_dropped.load(std::memory_order_relaxed);
+  stats.rx_frames = m_rx_frames.load(std::memory_order_relaxed);
+  stats.rx_bytes = m_rx_bytes.load(std::memory_order_relaxed);
+  stats.rx_dropped = m_rx_dropped.load(std::memory_order_relaxed);
+  return stats;
+}
+
 void CEXIETHERNET::SendComplete()
 {
   mBbaMem[BBA_NCRA] &= ~(NCRA_ST0 | NCRA_ST1);
@@ -441,7 +633,7 @@ inline u8 CEXIETHERNET::HashIndex(const u8* dest_eth_addr)
   return crc >> 26;
 }
 
-inline bool CEXIETHERNET::RecvMACFilter()
+inline bool CEXIETHERNET::RecvMACFilter(const u8* frame)
 {
   static u8 const broadcast[] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
 
@@ -450,11 +642,11 @@ inline bool CEXIETHERNET::RecvMACFilter()
     return true;
 
   // Unicast?
-  if ((mRecvBuffer[0] & 0x01) == 0)
+  if ((frame[0] & 0x01) == 0)
   {
-    return memcmp(mRecvBuffer.get(), &mBbaMem[BBA_NAFR_PAR0], 6) == 0;
+    return memcmp(frame, &mBbaMem[BBA_NAFR_PAR0], 6) == 0;
   }
-  else if (memcmp(mRecvBuffer.get(), broadcast, 6) == 0)
+  else if (memcmp(frame, broadcast, 6) == 0)
   {
     // Accept broadcast?
     return !!(mBbaMem[BBA_NCRB] & NCRB_AB);
@@ -467,7 +659,7 @@ inline bool CEXIETHERNET::RecvMACFilter()
   else
   {
     // Lookup the dest eth address in the hashmap
-    u16 index = HashIndex(mRecvBuffer.get());
+    u16 index = HashIndex(frame);
     return !!(mBbaMem[BBA_NAFR_MAR0 + index / 8] & (1 << (index % 8)));
   }
 }
@@ -484,7 +676,7 @@ inline void CEXIETHERNET::inc_rwp()
 
 // This function is on the critical path for receiving data.
 // Be very careful about calling into the logger and other slow things
-bool CEXIETHERNET::RecvHandlePacket()
+bool CEXIETHERNET::RecvHandlePacket(const u8* frame, u32 size)
 {
   u8* write_ptr;
   u8* end_ptr;
@@ -493,12 +685,11 @@ bool CEXIETHERNET::RecvHandlePacket()
   u32 status = 0;
   u16 rwp_initial = page_ptr(BBA_RWP);
 
-  if (!RecvMACFilter())
-    goto wait_for_next;
+  if (!RecvMACFilter(frame))
+    return true;
 
 #ifdef BBA_TRACK_PAGE_PTRS
-  INFO_LOG(SP1, "RecvHandlePacket %x\n%s", mRecvBufferLength,
-           ArrayToString(mRecvBuffer, mRecvBufferLength, 0x100).c_str());
+  INFO_LOG(SP1, "RecvHandlePacket %x\n%s", size, ArrayToString(frame, size, 0x100).c_str());
 
   INFO_LOG(SP1, "%x %x %x %x", page_ptr(BBA_BP), page_ptr(BBA_RRP), page_ptr(BBA_RWP),
            page_ptr(BBA_RHBP));
@@ -511,9 +702,9 @@ bool CEXIETHERNET::RecvHandlePacket()
   descriptor = (Descriptor*)write_ptr;
   write_ptr += 4;
 
-  for (u32 i = 0, off = 4; i < mRecvBufferLength; ++i, ++off)
+  for (u32 i = 0, off = 4; i < size; ++i, ++off)
   {
-    *write_ptr++ = mRecvBuffer[i];
+    *write_ptr++ = frame[i];
 
     if (off == 0xff)
     {
@@ -544,7 +735,7 @@ bool CEXIETHERNET::RecvHandlePacket()
   }
 
   // Align up to next page
-  if ((mRecvBufferLength + 4) % 256)
+  if ((size + 4) % 256)
     inc_rwp();
 
 #ifdef BBA_TRACK_PAGE_PTRS
@@ -553,7 +744,7 @@ bool CEXIETHERNET::RecvHandlePacket()
 #endif
 
   // Is the current frame multicast?
-  if (mRecvBuffer[0] & 0x01)
+  if (frame[0] & 0x01)
     status |= DESC_MF;
 
   if (status & DESC_BF)
@@ -568,7 +759,7 @@ bool CEXIETHERNET::RecvHandlePacket()
     }
   }
 
-  descriptor->set(*(u16*)&mBbaMem[BBA_RWP], 4 + mRecvBufferLength, status);
+  descriptor->set(*(u16*)&mBbaMem[BBA_RWP], 4 + size, status);
 
   mBbaMem[BBA_LRPS] = status;
 
@@ -578,7 +769,7 @@ bool CEXIETHERNET::RecvHandlePacket()
     mBbaMem[BBA_IR] |= INT_R;
 
     exi_status.interrupt |= exi_status.TRANSFER;
-    ExpansionInterface::ScheduleUpdateInterrupts(CoreTiming::FromThread::NON_CPU, 0);
+    ExpansionInterface::ScheduleUpdateInterrupts(CoreTiming::FromThread::CPU, 0);
   }
   else
   {
@@ -586,10 +777,6 @@ bool CEXIETHERNET::RecvHandlePacket()
     WARN_LOG(SP1, "NOT raising recv interrupt");
   }
 
-wait_for_next:
-  if (mBbaMem[BBA_NCRA] & NCRA_SR)
-    RecvStart();
-
   return true;
 }
 }  // namespace ExpansionInterface
@@ -4,7 +4,11 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -12,11 +16,18 @@
 #include <Windows.h>
 #endif
 
+#include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Core/HW/EXI/EXI_Device.h"
 
 class PointerWrap;
 
+namespace sf
+{
+class SocketSelector;
+class UdpSocket;
+}
+
 namespace ExpansionInterface
 {
 // Network Control Register A
@@ -196,11 +207,71 @@ enum RecvStatus
 
 #define BBA_RECV_SIZE 0x800
 
+// Frames on their way between the emulation thread and the I/O thread. One thread pushes and the
+// other one pops; neither of them ever blocks or allocates.
+class FrameRing
+{
+public:
+  static constexpr u32 CAPACITY = 64;
+
+  struct Frame
+  {
+    u32 size;
+    u8 data[BBA_RECV_SIZE];
+  };
+
+  FrameRing() : m_frames(std::make_unique<Frame[]>(CAPACITY)) {}
+
+  // Returns the slot for the next frame, or nullptr if the ring is full.
+  Frame* GetWriteSlot()
+  {
+    const u32 write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read.load(std::memory_order_acquire) == CAPACITY)
+      return nullptr;
+    return &m_frames[write % CAPACITY];
+  }
+  void Push()
+  {
+    m_write.store(m_write.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Returns the oldest frame, or nullptr if the ring is empty.
+  const Frame* Front() const
+  {
+    const u32 read = m_read.load(std::memory_order_relaxed);
+    if (read == m_write.load(std::memory_order_acquire))
+      return nullptr;
+    return &m_frames[read % CAPACITY];
+  }
+  void Pop()
+  {
+    m_read.store(m_read.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+private:
+  std::unique_ptr<Frame[]> m_frames;
+  std::atomic<u32> m_read{0};
+  std::atomic<u32> m_write{0};
+};
+
+struct BBAStats
+{
+  u64 tx_frames;
+  u64 tx_bytes;
+  u64 tx_dropped;
+  u64 rx_frames;
+  u64 rx_bytes;
+  u64 rx_dropped;
+};
+
 class CEXIETHERNET : public IEXIDevice
 {
 public:
   CEXIETHERNET();
   virtual ~CEXIETHERNET();
+
+  static void Init();
+
   void SetCS(int cs) override;
   bool IsPresent() const override;
   bool IsInterruptSet() override;
@@ -304,40 +375,115 @@ public:
   void SendFromPacketBuffer();
   void SendComplete();
   u8 HashIndex(const u8* dest_eth_addr);
-  bool RecvMACFilter();
+  bool RecvMACFilter(const u8* frame);
   void inc_rwp();
-  bool RecvHandlePacket();
+  bool RecvHandlePacket(const u8* frame, u32 size);
 
   std::unique_ptr<u8[]> mBbaMem;
   std::unique_ptr<u8[]> tx_fifo;
 
-  // TAP interface
-  bool Activate();
-  void Deactivate();
-  bool IsActivated();
-  bool SendFrame(const u8* frame, u32 size);
-  bool RecvInit();
-  void RecvStart();
-  void RecvStop();
-
-  std::unique_ptr<u8[]> mRecvBuffer;
-  u32 mRecvBufferLength;
+  // Moves frames between the adapter and the host. SendFrame and RecvFrame are only called from
+  // the I/O thread.
+  class NetworkInterface
+  {
+  public:
+    virtual ~NetworkInterface() = default;
+    virtual bool Activate() = 0;
+    virtual void Deactivate() = 0;
+    virtual bool SendFrame(const u8* frame, u32 size) = 0;
+    // Reads one frame, waiting up to timeout_ms for it to arrive. Returns the size of the frame,
+    // 0 if none arrived or Interrupt() was called, and a negative value on errors.
+    virtual int RecvFrame(u8* buffer, u32 size, int timeout_ms) = 0;
+    // Wakes up the I/O thread if it's waiting in RecvFrame.
+    virtual void Interrupt() = 0;
+  };
 
+  class TAPNetworkInterface : public NetworkInterface
+  {
+  public:
+    bool Activate() override;
+    void Deactivate() override;
+    bool SendFrame(const u8* frame, u32 size) override;
+    int RecvFrame(u8* buffer, u32 size, int timeout_ms) override;
+    void Interrupt() override;
+
+  private:
 #if defined(_WIN32)
-  HANDLE mHAdapter;
-  OVERLAPPED mReadOverlapped;
-  OVERLAPPED mWriteOverlapped;
-  std::vector<u8> mWriteBuffer;
-  bool mWritePending;
+    HANDLE m_h_adapter = INVALID_HANDLE_VALUE;
+    HANDLE m_wake_event = nullptr;
+    OVERLAPPED m_read_overlapped = {};
+    OVERLAPPED m_write_overlapped = {};
+    bool m_read_pending = false;
+    std::array<u8, BBA_RECV_SIZE> m_read_buffer;
 #elif defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
-  int fd;
+    int m_fd = -1;
+    int m_wake_pipe[2] = {-1, -1};
 #endif
+  };
 
-#if defined(WIN32) || defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__) ||          \
-    defined(__OpenBSD__)
-  std::thread readThread;
-  Common::Flag readEnabled;
-  Common::Flag readThreadShutdown;
-#endif
+  // Tunnels raw frames through UDP datagrams exchanged with a single peer.
+  class UDPTunnelNetworkInterface : public NetworkInterface
+  {
+  public:
+    UDPTunnelNetworkInterface(const std::string& remote, u16 local_port);
+    ~UDPTunnelNetworkInterface();
+    bool Activate() override;
+    void Deactivate() override;
+    bool SendFrame(const u8* frame, u32 size) override;
+    int RecvFrame(u8* buffer, u32 size, int timeout_ms) override;
+    void Interrupt() override;
+
+  private:
+    // Skips datagrams from anywhere but the remote. Doesn't block.
+    int ReceiveFromRemote(u8* buffer, u32 size);
+
+    std::string m_remote;
+    u16 m_local_port;
+    u32 m_remote_address = 0;
+    u16 m_remote_port = 0;
+    std::unique_ptr<sf::UdpSocket> m_socket;
+    std::unique_ptr<sf::UdpSocket> m_wake_socket;
+    std::unique_ptr<sf::SocketSelector> m_selector;
+  };
+
+  // Hands every sent frame back to the adapter, without involving the host network.
+  class LoopbackNetworkInterface : public NetworkInterface
+  {
+  public:
+    bool Activate() override;
+    void Deactivate() override;
+    bool SendFrame(const u8* frame, u32 size) override;
+    int RecvFrame(u8* buffer, u32 size, int timeout_ms) override;
+    void Interrupt() override;
+
+  private:
+    std::deque<std::vector<u8>> m_frames;
+    Common::Event m_wake_event;
+  };
+
+  bool Activate();
+  void Deactivate();
+  bool IsActivated() const;
+  bool SendFrame(const u8* frame, u32 size);
+  void RecvStart();
+  void RecvStop();
+  void RecvFromRing();
+  void IOThread();
+  BBAStats GetStats() const;
+
+  std::unique_ptr<NetworkInterface> m_network_interface;
+  FrameRing m_tx_ring;
+  FrameRing m_rx_ring;
+  std::thread m_io_thread;
+  Common::Flag m_io_thread_shutdown;
+  Common::Flag m_recv_enabled;
+  std::atomic<bool> m_recv_scheduled{false};
+
+  std::atomic<u64> m_tx_frames{0};
+  std::atomic<u64> m_tx_bytes{0};
+  std::atomic<u64> m_tx_dropped{0};
+  std::atomic<u64> m_rx_frames{0};
+  std::atomic<u64> m_rx_bytes{0};
+  std::atomic<u64> m_rx_dropped{0};
 };
 }  // namespace ExpansionInterface
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstring>
+#include <utility>
 #include <vector>
 
 #include "Common/ColorUtil.h"
@@ -245,26 +246,49 @@ bool GCMemcard::Save()
   mcdFile.WriteBytes(&dir_backup, BLOCK_SIZE);
   mcdFile.WriteBytes(&bat, BLOCK_SIZE);
   mcdFile.WriteBytes(&bat_backup, BLOCK_SIZE);
-  for (unsigned int i = 0; i < maxBlock - MC_FST_BLOCKS; ++i)
-  {
-    mcdFile.WriteBytes(mc_data_blocks[i].block, BLOCK_SIZE);
-  }
+  mcdFile.WriteArray(mc_data_blocks.data(), maxBlock - MC_FST_BLOCKS);
 
   return mcdFile.Close();
 }
 
 void calc_checksumsBE(const u16* buf, u32 length, u16* csum, u16* inv_csum)
 {
-  *csum = *inv_csum = 0;
-
-  for (u32 i = 0; i < length; ++i)
+  // The sum of the big endian values is 256 times the sum of their first bytes plus the sum of
+  // their second bytes. Those are added up four values at a time, in 16-bit lanes that can take
+  // 257 bytes before they overflow.
+  constexpr u64 LANE_MASK = 0x00ff00ff00ff00ffULL;
+  const u8* bytes = reinterpret_cast<const u8*>(buf);
+  u32 high_sum = 0;
+  u32 low_sum = 0;
+  u32 i = 0;
+  while (length - i >= 4)
+  {
+    const u32 end = i + std::min<u32>((length - i) / 4, 257) * 4;
+    u64 high_lanes = 0;
+    u64 low_lanes = 0;
+    for (; i < end; i += 4)
+    {
+      u64 values;
+      std::memcpy(&values, bytes + i * 2, sizeof(values));
+      high_lanes += values & LANE_MASK;
+      low_lanes += (values >> 8) & LANE_MASK;
+    }
+    for (int lane = 0; lane < 64; lane += 16)
+    {
+      high_sum += static_cast<u16>(high_lanes >> lane);
+      low_sum += static_cast<u16>(low_lanes >> lane);
+    }
+  }
+  for (; i < length; ++i)
   {
-    // weird warnings here
-    *csum += BE16(buf[i]);
-    *inv_csum += BE16((u16)(buf[i] ^ 0xffff));
+    high_sum += bytes[i * 2];
+    low_sum += bytes[i * 2 + 1];
   }
-  *csum = BE16(*csum);
-  *inv_csum = BE16(*inv_csum);
+
+  // Every inverted value is 0xffff minus the value, so their sum follows from the plain one.
+  const u16 sum = static_cast<u16>((high_sum << 8) + low_sum);
+  *csum = BE16(sum);
+  *inv_csum = BE16(static_cast<u16>(0u - length - sum));
   if (*csum == 0xffff)
   {
     *csum = 0;
@@ -642,11 +666,46 @@ u32 GCMemcard::GetSaveData(u8 index, std::vector<GCMBlock>& Blocks) const
 }
 // End DEntry functions
 
+void GCMemcard::BeginUpdate()
+{
+  m_saved_backup_dir = *PreviousDir;
+  m_saved_backup_bat = *PreviousBat;
+  *PreviousDir = *CurrentDir;
+  *PreviousBat = *CurrentBat;
+  std::swap(CurrentDir, PreviousDir);
+  std::swap(CurrentBat, PreviousBat);
+}
+
+void GCMemcard::EndUpdate(bool changed)
+{
+  if (!changed)
+  {
+    std::swap(CurrentDir, PreviousDir);
+    std::swap(CurrentBat, PreviousBat);
+    *PreviousDir = m_saved_backup_dir;
+    *PreviousBat = m_saved_backup_bat;
+    return;
+  }
+
+  CurrentDir->UpdateCounter = BE16(BE16(PreviousDir->UpdateCounter) + 1);
+  CurrentDir->fixChecksums();
+  CurrentBat->UpdateCounter = BE16(BE16(PreviousBat->UpdateCounter) + 1);
+  CurrentBat->fixChecksums();
+}
+
 u32 GCMemcard::ImportFile(const DEntry& direntry, std::vector<GCMBlock>& saveBlocks)
 {
   if (!m_valid)
     return NOMEMCARD;
 
+  BeginUpdate();
+  const u32 result = ImportFileInternal(direntry, saveBlocks);
+  EndUpdate(result == SUCCESS);
+  return result;
+}
+
+u32 GCMemcard::ImportFileInternal(const DEntry& direntry, std::vector<GCMBlock>& saveBlocks)
+{
   if (GetNumFiles() >= DIRLEN)
   {
     return OUTOFDIRENTRIES;
@@ -665,38 +724,25 @@ u32 GCMemcard::ImportFile(const DEntry& direntry, std::vector<GCMBlock>& saveBlo
       CurrentBat->NextFreeBlock(maxBlock - MC_FST_BLOCKS, BE16(CurrentBat->LastAllocated));
   if (firstBlock == 0xFFFF)
     return OUTOFBLOCKS;
-  Directory UpdatedDir = *CurrentDir;
 
   // find first free dir entry
   for (int i = 0; i < DIRLEN; i++)
   {
-    if (BE32(UpdatedDir.Dir[i].Gamecode) == 0xFFFFFFFF)
+    if (BE32(CurrentDir->Dir[i].Gamecode) == 0xFFFFFFFF)
     {
-      UpdatedDir.Dir[i] = direntry;
-      *(u16*)&UpdatedDir.Dir[i].FirstBlock = BE16(firstBlock);
-      UpdatedDir.Dir[i].CopyCounter = UpdatedDir.Dir[i].CopyCounter + 1;
+      CurrentDir->Dir[i] = direntry;
+      *(u16*)&CurrentDir->Dir[i].FirstBlock = BE16(firstBlock);
+      CurrentDir->Dir[i].CopyCounter = CurrentDir->Dir[i].CopyCounter + 1;
       break;
     }
   }
-  UpdatedDir.UpdateCounter = BE16(BE16(UpdatedDir.UpdateCounter) + 1);
-  *PreviousDir = UpdatedDir;
-  if (PreviousDir == &dir)
-  {
-    CurrentDir = &dir;
-    PreviousDir = &dir_backup;
-  }
-  else
-  {
-    CurrentDir = &dir_backup;
-    PreviousDir = &dir;
-  }
 
   int fileBlocks = BE16(direntry.BlockCount);
 
   FZEROGX_MakeSaveGameValid(hdr, direntry, saveBlocks);
   PSO_MakeSaveGameValid(hdr, direntry, saveBlocks);
 
-  BlockAlloc UpdatedBat = *CurrentBat;
+  BlockAlloc& UpdatedBat = *CurrentBat;
   u16 nextBlock;
   // keep assuming no freespace fragmentation, and copy over all the data
   for (int i = 0; i < fileBlocks; ++i)
@@ -714,18 +760,6 @@ u32 GCMemcard::ImportFile(const DEntry& direntry, std::vector<GCMBlock>& saveBlo
   }
 
   UpdatedBat.FreeBlocks = BE16(BE16(UpdatedBat.FreeBlocks) - fileBlocks);
-  UpdatedBat.UpdateCounter = BE16(BE16(UpdatedBat.UpdateCounter) + 1);
-  *PreviousBat = UpdatedBat;
-  if (PreviousBat == &bat)
-  {
-    CurrentBat = &bat;
-    PreviousBat = &bat_backup;
-  }
-  else
-  {
-    CurrentBat = &bat_backup;
-    PreviousBat = &bat;
-  }
 
   return SUCCESS;
 }
@@ -737,60 +771,29 @@ u32 GCMemcard::RemoveFile(u8 index)  // index in the directory array
   if (index >= DIRLEN)
     return DELETE_FAIL;
 
-  u16 startingblock = BE16(dir.Dir[index].FirstBlock);
-  u16 numberofblocks = BE16(dir.Dir[index].BlockCount);
+  BeginUpdate();
+  const u32 result = RemoveFileInternal(index);
+  EndUpdate(result == SUCCESS);
+  return result;
+}
 
-  BlockAlloc UpdatedBat = *CurrentBat;
-  if (!UpdatedBat.ClearBlocks(startingblock, numberofblocks))
+u32 GCMemcard::RemoveFileInternal(u8 index)
+{
+  u16 startingblock = BE16(CurrentDir->Dir[index].FirstBlock);
+  u16 numberofblocks = BE16(CurrentDir->Dir[index].BlockCount);
+
+  if (!CurrentBat->ClearBlocks(startingblock, numberofblocks))
     return DELETE_FAIL;
-  UpdatedBat.UpdateCounter = BE16(BE16(UpdatedBat.UpdateCounter) + 1);
-  *PreviousBat = UpdatedBat;
-  if (PreviousBat == &bat)
-  {
-    CurrentBat = &bat;
-    PreviousBat = &bat_backup;
-  }
-  else
-  {
-    CurrentBat = &bat_backup;
-    PreviousBat = &bat;
-  }
 
-  Directory UpdatedDir = *CurrentDir;
   /*
   // TODO: determine when this is used, even on the same memory card I have seen
   // both update to broken file, and not updated
-  *(u32*)&UpdatedDir.Dir[index].Gamecode = 0;
-  *(u16*)&UpdatedDir.Dir[index].Makercode = 0;
-  memset(UpdatedDir.Dir[index].Filename, 0, 0x20);
-  strcpy((char*)UpdatedDir.Dir[index].Filename, "Broken File000");
-  *(u16*)&UpdatedDir.UpdateCounter = BE16(BE16(UpdatedDir.UpdateCounter) + 1);
-
-  *PreviousDir = UpdatedDir;
-  if (PreviousDir == &dir )
-  {
-    CurrentDir = &dir;
-    PreviousDir = &dir_backup;
-  }
-  else
-  {
-    CurrentDir = &dir_backup;
-    PreviousDir = &dir;
-  }
+  *(u32*)&CurrentDir->Dir[index].Gamecode = 0;
+  *(u16*)&CurrentDir->Dir[index].Makercode = 0;
+  memset(CurrentDir->Dir[index].Filename, 0, 0x20);
+  strcpy((char*)CurrentDir->Dir[index].Filename, "Broken File000");
   */
-  memset(&(UpdatedDir.Dir[index]), 0xFF, DENTRY_SIZE);
-  UpdatedDir.UpdateCounter = BE16(BE16(UpdatedDir.UpdateCounter) + 1);
-  *PreviousDir = UpdatedDir;
-  if (PreviousDir == &dir)
-  {
-    CurrentDir = &dir;
-    PreviousDir = &dir_backup;
-  }
-  else
-  {
-    CurrentDir = &dir_backup;
-    PreviousDir = &dir;
-  }
+  memset(&(CurrentDir->Dir[index]), 0xFF, DENTRY_SIZE);
 
   return SUCCESS;
 }
@@ -830,7 +833,13 @@ u32 GCMemcard::ImportGci(const std::string& inputFile, const std::string& output
   if (!gci)
     return OPENFAIL;
 
-  return ImportGciInternal(std::move(gci), inputFile, outputFile);
+  if (!outputFile.empty())
+    return ImportGciInternal(std::move(gci), inputFile, outputFile);
+
+  BeginUpdate();
+  const u32 result = ImportGciInternal(std::move(gci), inputFile, outputFile);
+  EndUpdate(result == SUCCESS);
+  return result;
 }
 
 u32 GCMemcard::ImportGciInternal(File::IOFile&& gci, const std::string& inputFile,
@@ -917,7 +926,7 @@ u32 GCMemcard::ImportGciInternal(File::IOFile&& gci, const std::string& inputFil
       ret = WRITEFAIL;
   }
   else
-    ret = ImportFile(tempDEntry, saveData);
+    ret = ImportFileInternal(tempDEntry, saveData);
 
   return ret;
 }
@@ -1009,6 +1018,49 @@ u32 GCMemcard::ExportGci(u8 index, const std::string& fileName, const std::strin
     return WRITEFAIL;
 }
 
+bool GCMemcard::ApplyBatch(const std::vector<BatchOperation>& operations, std::vector<u32>* results)
+{
+  results->clear();
+  results->reserve(operations.size());
+  if (!m_valid)
+  {
+    results->resize(operations.size(), NOMEMCARD);
+    return false;
+  }
+
+  BeginUpdate();
+  bool changed = false;
+  for (const BatchOperation& operation : operations)
+  {
+    u32 result;
+    switch (operation.type)
+    {
+    case BatchOperation::Type::Import:
+    {
+      File::IOFile gci(operation.path, "rb");
+      result = gci ? ImportGciInternal(std::move(gci), operation.path, "") : OPENFAIL;
+      break;
+    }
+    case BatchOperation::Type::Export:
+      result = ExportGci(operation.index, operation.path, "");
+      break;
+    case BatchOperation::Type::Remove:
+      result = operation.index < DIRLEN ? RemoveFileInternal(operation.index) : DELETE_FAIL;
+      break;
+    default:
+      result = FAIL;
+      break;
+    }
+
+    if (result == SUCCESS && operation.type != BatchOperation::Type::Export)
+      changed = true;
+    results->push_back(result);
+  }
+  EndUpdate(changed);
+
+  return !changed || Save();
+}
+
 void GCMemcard::Gcs_SavConvert(DEntry& tempDEntry, int saveType, int length)
 {
   switch (saveType)
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/NandPaths.h"
@@ -307,6 +308,9 @@ private:
   Header hdr;
   Directory dir, dir_backup, *CurrentDir, *PreviousDir;
   BlockAlloc bat, bat_backup, *CurrentBat, *PreviousBat;
+  // The backups from before an update, restored by EndUpdate if nothing changed.
+  Directory m_saved_backup_dir;
+  BlockAlloc m_saved_backup_bat;
 
   std::vector<GCMBlock> mc_data_blocks;
 
@@ -314,7 +318,33 @@ private:
                         const std::string& outputFile);
   void InitDirBatPointers();
 
+  // Between these, CurrentDir and CurrentBat point to working copies that the *Internal functions
+  // change in place, while PreviousDir and PreviousBat keep the state from before as the backup.
+  // EndUpdate bumps the update counters and fixes the checksums once, or drops the working copies
+  // and restores the backups if nothing changed.
+  void BeginUpdate();
+  void EndUpdate(bool changed);
+  u32 ImportFileInternal(const DEntry& direntry, std::vector<GCMBlock>& saveBlocks);
+  u32 RemoveFileInternal(u8 index);
+
 public:
+  struct BatchOperation
+  {
+    enum class Type
+    {
+      // Imports the .gci/.gcs/.sav file at path.
+      Import,
+      // Exports the file at index in the directory to path, as .gci/.gcs/.sav by its extension.
+      Export,
+      // Deletes the file at index in the directory.
+      Remove,
+    };
+
+    Type type;
+    std::string path;
+    u8 index;
+  };
+
   explicit GCMemcard(const std::string& fileName, bool forceCreation = false,
                      bool shift_jis = false);
   bool IsValid() const { return m_valid; }
@@ -379,6 +409,12 @@ public:
   // writes a .gci file to disk containing index
   u32 ExportGci(u8 index, const std::string& fileName, const std::string& directory) const;
 
+  // Applies the operations in order to the card in memory, then updates the directory, the BAT and
+  // their checksums and writes the card file only once for all of them. results gets the code
+  // ImportGci, ExportGci or RemoveFile would have returned for each operation; failed operations
+  // change nothing. Returns false if the card couldn't be written.
+  bool ApplyBatch(const std::vector<BatchOperation>& operations, std::vector<u32>* results);
+
   // GCI files are untouched, SAV files are byteswapped
   // GCS files have the block count set, default is 1 (For export as GCS)
   static void Gcs_SavConvert(DEntry& tempDEntry, int saveType, int length = BLOCK_SIZE);
@@ -189,6 +189,7 @@ void GCMemcardDirectory::FlushThread()
 
   Common::SetCurrentThreadName(
       StringFromFormat("Memcard %d flushing thread", m_card_index).c_str());
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
 
   constexpr std::chrono::seconds flush_interval{1};
   while (true)
@@ -80,6 +80,7 @@ void MemoryCard::FlushThread()
 
   Common::SetCurrentThreadName(
       StringFromFormat("Memcard %d flushing thread", m_card_index).c_str());
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
 
   const auto flush_interval = std::chrono::seconds(15);
 
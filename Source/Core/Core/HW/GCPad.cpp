@@ -4,11 +4,14 @@
 
 #include "Core/HW/GCPad.h"
 
+#include <array>
 #include <cstring>
 
 #include "Common/Common.h"
 #include "Core/HW/GCPadEmu.h"
+#include "InputCommon/ControlReference/ControlReference.h"
 #include "InputCommon/ControllerEmu/ControlGroup/ControlGroup.h"
+#include "InputCommon/ControllerEmu/ControllerEmu.h"
 #include "InputCommon/ControllerInterface/ControllerInterface.h"
 #include "InputCommon/GCPadStatus.h"
 #include "InputCommon/InputConfig.h"
@@ -16,6 +19,25 @@
 namespace Pad
 {
 static InputConfig s_config("GCPadNew", _trans("Pad"), "GCPad");
+
+// The emulated pad state is a function of the host input, the mappings and settings, and whether
+// input is let through at all. It is only worked out again once one of those has changed.
+struct CachedStatus
+{
+  bool valid = false;
+  u64 input_version;
+  u64 config_version;
+  bool input_gate;
+  GCPadStatus status;
+};
+static std::array<CachedStatus, 4> s_cached_status;
+
+static void InvalidateCachedStatus()
+{
+  for (CachedStatus& cached : s_cached_status)
+    cached.valid = false;
+}
+
 InputConfig* GetConfig()
 {
   return &s_config;
@@ -24,6 +46,7 @@ InputConfig* GetConfig()
 void Shutdown()
 {
   s_config.ClearControllers();
+  InvalidateCachedStatus();
 }
 
 void Initialize()
@@ -47,7 +70,22 @@ void LoadConfig()
 
 GCPadStatus GetStatus(int pad_num)
 {
-  return static_cast<GCPad*>(s_config.GetController(pad_num))->GetInput();
+  CachedStatus& cached = s_cached_status[pad_num];
+  const u64 input_version = g_controller_interface.GetInputVersion();
+  const u64 config_version = ControllerEmu::EmulatedController::GetConfigVersion();
+  const bool input_gate = ControlReference::InputGateOn();
+  if (cached.valid && cached.input_version == input_version &&
+      cached.config_version == config_version && cached.input_gate == input_gate)
+  {
+    return cached.status;
+  }
+
+  cached.status = static_cast<GCPad*>(s_config.GetController(pad_num))->GetInput();
+  cached.input_version = input_version;
+  cached.config_version = config_version;
+  cached.input_gate = input_gate;
+  cached.valid = true;
+  return cached.status;
 }
 
 ControllerEmu::ControlGroup* GetGroup(int pad_num, PadGroup group)
@@ -4,7 +4,9 @@
 
 #include "Core/HW/MMIO.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
@@ -381,6 +383,18 @@ void WriteHandler<T>::ResetMethod(WriteHandlingMethod<T>* method)
   m_WriteFunc = v.ret;
 }
 
+u64 Mapping::GetNextChange(u32 addr, u32 size) const
+{
+  u64 next_change = std::numeric_limits<u64>::max();
+  const u32 id = UniqueID(addr);
+  for (auto it = m_next_change.lower_bound(id); it != m_next_change.end() && it->first < id + size;
+       ++it)
+  {
+    next_change = std::min(next_change, it->second());
+  }
+  return next_change;
+}
+
 // Define all the public specializations that are exported in MMIOHandlers.h.
 #define MaybeExtern
 MMIO_PUBLIC_SPECIALIZATIONS()
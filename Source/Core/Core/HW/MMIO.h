@@ -5,6 +5,8 @@
 #pragma once
 
 #include <array>
+#include <functional>
+#include <map>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -118,6 +120,19 @@ public:
     RegisterWrite(addr, write);
   }
 
+  // Busy-wait loops that poll a register are fast-forwarded to the next CoreTiming event (see
+  // PowerPC/BusyWait.h), which relies on registers only changing in events. Registers whose value
+  // also depends on the time in between use this to tell when their value can next change:
+  // CoreTiming::GetTicks() if at any time.
+  void RegisterNextChange(u32 addr, std::function<u64()> next_change)
+  {
+    m_next_change[UniqueID(addr)] = std::move(next_change);
+  }
+
+  // When the value of the size bytes at addr can next change outside of an event, or the maximum
+  // u64 if it can't.
+  u64 GetNextChange(u32 addr, u32 size) const;
+
   // Direct read/write interface.
   //
   // These functions allow reading/writing an MMIO register at a given
@@ -177,6 +192,9 @@ private:
   HandlerArray<u16>::Write m_write_handlers16;
   HandlerArray<u32>::Write m_write_handlers32;
 
+  // Indexed by UniqueID(addr).
+  std::map<u32, std::function<u64()>> m_next_change;
+
   // Getter functions for the handler arrays.
   template <typename Unit>
   ReadHandler<Unit>& GetReadHandler(size_t index)
@@ -13,10 +13,12 @@
 #include <cstring>
 #include <memory>
 
+#include "Common/Align.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
@@ -168,6 +170,7 @@ void Init()
 {
   bool wii = SConfig::GetInstance().bWii;
   bool bMMU = SConfig::GetInstance().bMMU;
+  const bool use_huge_pages = SConfig::GetInstance().bHugePages;
   bool bFakeVMEM = false;
 #ifndef _ARCH_32
   // If MMU is turned off in GameCube mode, turn on fake VMEM hack.
@@ -186,11 +189,16 @@ void Init()
   {
     if ((flags & region.flags) != region.flags)
       continue;
+    // Huge pages can only back a view whose segment offset is as aligned as its address. Aligning
+    // each region's offset covers the physical views, whose addresses are aligned. The logical
+    // (BAT) views are mapped in BAT_PAGE_SIZE pieces, which are too small for huge pages.
+    if (use_huge_pages)
+      mem_size = Common::AlignUp(mem_size, Common::HUGE_PAGE_SIZE);
     region.shm_position = mem_size;
     mem_size += region.size;
   }
-  g_arena.GrabSHMSegment(mem_size);
-  physical_base = MemArena::FindMemoryBase();
+  g_arena.GrabSHMSegment(mem_size, use_huge_pages);
+  physical_base = MemArena::FindMemoryBase(use_huge_pages ? Common::HUGE_PAGE_SIZE : 1);
 
   for (PhysicalMemoryRegion& region : physical_regions)
   {
@@ -316,7 +324,7 @@ void Clear()
     memset(m_pEXRAM, 0, EXRAM_SIZE);
 }
 
-static inline u8* GetPointerForRange(u32 address, size_t size)
+u8* GetPointerForRange(u32 address, size_t size)
 {
   // Make sure we don't have a range spanning 2 separate banks
   if (size >= EXRAM_SIZE)
@@ -10,6 +10,7 @@
 #include "Common/CommonFuncs.h"
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
+#include "Common/SwapCopy.h"
 #include "Core/PowerPC/PowerPC.h"
 
 // Global declarations
@@ -72,6 +73,8 @@ void Clear();
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
 u8* GetPointer(u32 address);
+// nullptr unless the whole range is in one bank of memory.
+u8* GetPointerForRange(u32 address, size_t size);
 void CopyFromEmu(void* data, u32 address, size_t size);
 void CopyToEmu(u32 address, const void* data, size_t size);
 void Memset(u32 address, u8 value, size_t size);
@@ -95,8 +98,7 @@ void CopyFromEmuSwapped(T* data, u32 address, size_t size)
   if (src == nullptr)
     return;
 
-  for (size_t i = 0; i < size / sizeof(T); i++)
-    data[i] = Common::FromBigEndian(src[i]);
+  Common::SwapCopy(data, src, size / sizeof(T));
 }
 
 template <typename T>
@@ -107,7 +109,6 @@ void CopyToEmuSwapped(u32 address, const T* data, size_t size)
   if (dest == nullptr)
     return;
 
-  for (size_t i = 0; i < size / sizeof(T); i++)
-    dest[i] = Common::FromBigEndian(data[i]);
+  Common::SwapCopy(dest, data, size / sizeof(T));
 }
 }
@@ -21,6 +21,7 @@
 #include "Core/NetPlayProto.h"
 
 #include "InputCommon/ControllerInterface/ControllerInterface.h"
+#include "InputCommon/InputLatency.h"
 
 namespace SerialInterface
 {
@@ -215,6 +216,8 @@ static USIStatusReg s_status_reg;
 static USIEXIClockCount s_exi_clock_count;
 static std::array<u8, 128> s_si_buffer;
 
+static InputLatency::PollSource s_latency_source;
+
 void DoState(PointerWrap& p)
 {
   for (int i = 0; i < MAX_SI_CHANNELS; i++)
@@ -569,6 +572,14 @@ void UpdateDevices()
   // Update inputs at the rate of SI
   // Typically 120hz but is variable
   g_controller_interface.UpdateInput();
+  const u64 input_version = g_controller_interface.GetInputVersion();
+
+  std::array<u32, MAX_SI_CHANNELS * 2> previous_data;
+  for (int i = 0; i < MAX_SI_CHANNELS; ++i)
+  {
+    previous_data[i * 2] = s_channel[i].in_hi.hex;
+    previous_data[i * 2 + 1] = s_channel[i].in_lo.hex;
+  }
 
   // Update channels and set the status bit if there's new data
   s_status_reg.RDST0 =
@@ -580,6 +591,18 @@ void UpdateDevices()
   s_status_reg.RDST3 =
       !!s_channel[3].device->GetData(s_channel[3].in_hi.hex, s_channel[3].in_lo.hex);
 
+  if (InputLatency::IsEnabled())
+  {
+    bool changed = false;
+    for (int i = 0; i < MAX_SI_CHANNELS; ++i)
+    {
+      changed |= previous_data[i * 2] != s_channel[i].in_hi.hex ||
+                 previous_data[i * 2 + 1] != s_channel[i].in_lo.hex;
+    }
+    InputLatency::OnInputPolled(&s_latency_source, input_version, changed,
+                                CoreTiming::GetTicks());
+  }
+
   UpdateInterrupts();
 }
 
@@ -45,15 +45,22 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 
 #include "Core/HW/SystemTimers.h"
 
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <thread>
+
 #include "Common/Atomic.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
 #include "Common/Thread.h"
 #include "Common/Timer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/EXI/EXI_DeviceIPL.h"
@@ -66,7 +73,6 @@ IPC_HLE_PERIOD: For the Wii Remote this is the call schedule:
 namespace SystemTimers
 {
 static CoreTiming::EventType* et_Dec;
-static CoreTiming::EventType* et_VI;
 static CoreTiming::EventType* et_AudioDMA;
 static CoreTiming::EventType* et_DSP;
 static CoreTiming::EventType* et_IPC_HLE;
@@ -88,6 +94,12 @@ static int s_ipc_hle_period;
 // Custom RTC
 static s64 s_localtime_rtc_offset = 0;
 
+// How long before a throttle deadline precise pacing stops sleeping and starts spinning. It
+// follows how much the OS tends to oversleep, so the spin is only as long as it needs to be.
+constexpr u64 MIN_SPIN_MARGIN_NS = 20000;
+constexpr u64 MAX_SPIN_MARGIN_NS = 2000000;
+static u64 s_spin_margin_ns;
+
 u32 GetTicksPerSecond()
 {
   return s_cpu_core_clock;
@@ -118,12 +130,6 @@ static void IPC_HLE_UpdateCallback(u64 userdata, s64 cyclesLate)
   }
 }
 
-static void VICallback(u64 userdata, s64 cyclesLate)
-{
-  VideoInterface::Update(CoreTiming::GetTicks() - cyclesLate);
-  CoreTiming::ScheduleEvent(VideoInterface::GetTicksPerHalfLine() - cyclesLate, et_VI);
-}
-
 static void DecrementerCallback(u64 userdata, s64 cyclesLate)
 {
   PowerPC::ppcState.spr[SPR_DEC] = 0xFFFFFFFF;
@@ -192,14 +198,44 @@ static void PatchEngineCallback(u64 userdata, s64 cycles_late)
   CoreTiming::ScheduleEvent(next_schedule, et_PatchEngine, cycles_pruned);
 }
 
-static void ThrottleCallback(u64 last_time, s64 cyclesLate)
+static u64 GetTimeNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void WaitUntil(u64 deadline)
+{
+  u64 now = GetTimeNs();
+  while (deadline > now + s_spin_margin_ns)
+  {
+    const u64 requested = deadline - now - s_spin_margin_ns;
+    std::this_thread::sleep_for(std::chrono::nanoseconds(requested));
+    const u64 woken = GetTimeNs();
+    const u64 oversleep = woken - now > requested ? woken - now - requested : 0;
+    now = woken;
+
+    // Settles at twice the average oversleep.
+    s_spin_margin_ns = MathUtil::Clamp((s_spin_margin_ns * 7 + oversleep * 2) / 8,
+                                       MIN_SPIN_MARGIN_NS, MAX_SPIN_MARGIN_NS);
+  }
+
+  while (now < deadline)
+  {
+    Common::YieldCPU();
+    now = GetTimeNs();
+  }
+}
+
+static void ThrottleCallback(u64 deadline, s64 cyclesLate)
 {
   // Allow the GPU thread to sleep. Setting this flag here limits the wakeups to 1 kHz.
   Fifo::GpuMaySleep();
 
-  u32 time = Common::Timer::GetTimeMs();
+  const u64 time = GetTimeNs();
 
-  int diff = (u32)last_time - time;
+  const s64 diff = static_cast<s64>(deadline - time);
   const SConfig& config = SConfig::GetInstance();
   bool frame_limiter = config.m_EmulationSpeed > 0.0f && !Core::GetIsThrottlerTempDisabled();
   u32 next_event = GetTicksPerSecond() / 1000;
@@ -207,34 +243,44 @@ static void ThrottleCallback(u64 last_time, s64 cyclesLate)
   {
     if (config.m_EmulationSpeed != 1.0f)
       next_event = u32(next_event * config.m_EmulationSpeed);
-    const int max_fallback = config.iTimingVariance;
-    if (abs(diff) > max_fallback)
+    const s64 max_fallback = config.iTimingVariance * 1000000LL;
+    if (std::abs(diff) > max_fallback)
     {
-      DEBUG_LOG(COMMON, "system too %s, %d ms skipped", diff < 0 ? "slow" : "fast",
-                abs(diff) - max_fallback);
-      last_time = time - max_fallback;
+      DEBUG_LOG(COMMON, "system too %s, %" PRId64 " ms skipped", diff < 0 ? "slow" : "fast",
+                (std::abs(diff) - max_fallback) / 1000000);
+      deadline = time - max_fallback;
     }
     else if (diff > 0)
-      Common::SleepCurrentThread(diff);
+    {
+      FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::CPUIdle);
+      if (config.bPrecisePacing)
+        WaitUntil(deadline);
+      else if (diff >= 1000000)
+        Common::SleepCurrentThread(static_cast<int>(diff / 1000000));
+    }
   }
-  CoreTiming::ScheduleEvent(next_event - cyclesLate, et_Throttle, last_time + 1);
+  CoreTiming::ScheduleEvent(next_event - cyclesLate, et_Throttle, deadline + 1000000);
 }
 
 // split from Init to break a circular dependency between VideoInterface::Init and
 // SystemTimers::Init
+static u32 GetPPCClock(Mode mode)
+{
+  return mode == Mode::Wii ? 729000000u : 486000000u;
+}
+
 void PreInit()
 {
-  ChangePPCClock(SConfig::GetInstance().bWii ? Mode::Wii : Mode::GC);
+  // Nothing has been scheduled yet.
+  s_cpu_core_clock = GetPPCClock(SConfig::GetInstance().bWii ? Mode::Wii : Mode::GC);
 }
 
 void ChangePPCClock(Mode mode)
 {
   const u32 previous_clock = s_cpu_core_clock;
-  if (mode == Mode::Wii)
-    s_cpu_core_clock = 729000000u;
-  else
-    s_cpu_core_clock = 486000000u;
+  s_cpu_core_clock = GetPPCClock(mode);
   CoreTiming::AdjustEventQueueTimes(s_cpu_core_clock, previous_clock);
+  VideoInterface::AdjustEventTimes(s_cpu_core_clock, previous_clock);
 }
 
 void Init()
@@ -252,6 +298,7 @@ void Init()
   s_audio_dma_period = s_cpu_core_clock / (AudioInterface::GetAIDSampleRate() * 4 / 32);
 
   Common::Timer::IncreaseResolution();
+  s_spin_margin_ns = MAX_SPIN_MARGIN_NS / 4;
   // store and convert localtime at boot to timebase ticks
   if (SConfig::GetInstance().bEnableCustomRTC)
   {
@@ -269,17 +316,15 @@ void Init()
   CoreTiming::SetFakeDecStartTicks(CoreTiming::GetTicks());
 
   et_Dec = CoreTiming::RegisterEvent("DecCallback", DecrementerCallback);
-  et_VI = CoreTiming::RegisterEvent("VICallback", VICallback);
   et_DSP = CoreTiming::RegisterEvent("DSPCallback", DSPCallback);
   et_AudioDMA = CoreTiming::RegisterEvent("AudioDMACallback", AudioDMACallback);
   et_IPC_HLE = CoreTiming::RegisterEvent("IPC_HLE_UpdateCallback", IPC_HLE_UpdateCallback);
   et_PatchEngine = CoreTiming::RegisterEvent("PatchEngine", PatchEngineCallback);
   et_Throttle = CoreTiming::RegisterEvent("Throttle", ThrottleCallback);
 
-  CoreTiming::ScheduleEvent(VideoInterface::GetTicksPerHalfLine(), et_VI);
   CoreTiming::ScheduleEvent(0, et_DSP);
   CoreTiming::ScheduleEvent(s_audio_dma_period, et_AudioDMA);
-  CoreTiming::ScheduleEvent(0, et_Throttle, Common::Timer::GetTimeMs());
+  CoreTiming::ScheduleEvent(0, et_Throttle, GetTimeNs());
 
   CoreTiming::ScheduleEvent(VideoInterface::GetTicksPerField(), et_PatchEngine);
 
@@ -4,6 +4,7 @@
 
 #include "Core/HW/VideoInterface.h"
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
@@ -61,6 +62,10 @@ static constexpr std::array<u32, 2> s_clock_freqs{{
     27000000, 54000000,
 }};
 
+// The beam is only moved on the half-lines where something happens (see IsEventHalfLine), and
+// before its timing changes. Everything else follows from the time.
+static CoreTiming::EventType* s_event_type_update;
+static u64 s_ticks_next_half_line;   // when the next half-line starts (and hasn't been handled yet)
 static u64 s_ticks_last_line_start;  // number of ticks when the current full scanline started
 static u32 s_half_line_count;        // number of halflines that have occurred for this full frame
 static u32 s_half_line_of_next_si_poll;  // halfline when next SI poll results should be available
@@ -74,6 +79,18 @@ static u32 s_odd_field_first_hl;   // index first halfline of the odd field
 static u32 s_even_field_last_hl;   // index last halfline of the even field
 static u32 s_odd_field_last_hl;    // index last halfline of the odd field
 
+struct BeamPosition
+{
+  u32 half_line;
+  u64 ticks_last_line_start;
+  u64 ticks_next_half_line;
+};
+
+static void UpdateBeam(u64 ticks);
+static BeamPosition GetBeamPosition(u64 ticks);
+static void ScheduleNextUpdate();
+static void UpdateCallback(u64 userdata, s64 cycles_late);
+
 void DoState(PointerWrap& p)
 {
   p.DoPOD(m_VerticalTimingRegister);
@@ -99,6 +116,7 @@ void DoState(PointerWrap& p)
   p.Do(m_FBWidth);
   p.Do(m_BorderHBlank);
   p.Do(s_target_refresh_rate);
+  p.Do(s_ticks_next_half_line);
   p.Do(s_ticks_last_line_start);
   p.Do(s_half_line_count);
   p.Do(s_half_line_of_next_si_poll);
@@ -191,13 +209,26 @@ void Preset(bool _bNTSC)
   s_current_field = FieldType::Odd;
 
   UpdateParameters();
+  // The half-line length is only known once the registers have been preset.
+  s_ticks_next_half_line = CoreTiming::GetTicks() + GetTicksPerHalfLine();
+  ScheduleNextUpdate();
 }
 
 void Init()
 {
+  s_event_type_update = CoreTiming::RegisterEvent("VICallback", UpdateCallback);
   Preset(true);
 }
 
+// Registers that the beam timing depends on must only change once the beam has caught up.
+template <typename Function>
+static void ChangeTiming(Function change)
+{
+  UpdateBeam(CoreTiming::GetTicks());
+  change();
+  ScheduleNextUpdate();
+}
+
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 {
   struct MappedVar
@@ -278,8 +309,10 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
   {
     mmio->Register(base | mapped_var.addr, MMIO::DirectRead<u16>(mapped_var.ptr),
                    MMIO::ComplexWrite<u16>([mapped_var](u32, u16 val) {
-                     *mapped_var.ptr = val;
-                     UpdateParameters();
+                     ChangeTiming([&] {
+                       *mapped_var.ptr = val;
+                       UpdateParameters();
+                     });
                    }));
   }
 
@@ -312,7 +345,10 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
   // MMIOs with unimplemented writes that trigger warnings.
   mmio->Register(
       base | VI_VERTICAL_BEAM_POSITION,
-      MMIO::ComplexRead<u16>([](u32) { return 1 + (s_half_line_count - 1) / 2; }),
+      MMIO::ComplexRead<u16>([](u32) {
+        const BeamPosition beam = GetBeamPosition(CoreTiming::GetTicks());
+        return 1 + (beam.half_line - 1) / 2;
+      }),
       MMIO::ComplexWrite<u16>([](u32, u16 val) {
         WARN_LOG(VIDEOINTERFACE,
                  "Changing vertical beam position to 0x%04x - not documented or implemented yet",
@@ -320,10 +356,10 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
       }));
   mmio->Register(
       base | VI_HORIZONTAL_BEAM_POSITION, MMIO::ComplexRead<u16>([](u32) {
-        u16 value =
-            static_cast<u16>(1 +
-                             m_HTiming0.HLW * (CoreTiming::GetTicks() - s_ticks_last_line_start) /
-                                 (GetTicksPerHalfLine()));
+        const u64 ticks = CoreTiming::GetTicks();
+        const BeamPosition beam = GetBeamPosition(ticks);
+        u16 value = static_cast<u16>(1 + m_HTiming0.HLW * (ticks - beam.ticks_last_line_start) /
+                                             (GetTicksPerHalfLine()));
         return MathUtil::Clamp(value, static_cast<u16>(1), static_cast<u16>(m_HTiming0.HLW * 2));
       }),
       MMIO::ComplexWrite<u16>([](u32, u16 val) {
@@ -331,30 +367,44 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
                  "Changing horizontal beam position to 0x%04x - not documented or implemented yet",
                  val);
       }));
+  // For busy-wait loops: VCOUNT can only change when a half-line starts, HCOUNT at any time.
+  mmio->RegisterNextChange(base | VI_VERTICAL_BEAM_POSITION, [] {
+    return GetBeamPosition(CoreTiming::GetTicks()).ticks_next_half_line;
+  });
+  mmio->RegisterNextChange(base | VI_HORIZONTAL_BEAM_POSITION,
+                           [] { return CoreTiming::GetTicks(); });
 
   // The following MMIOs are interrupts related and update interrupt status
   // on writes.
   mmio->Register(base | VI_PRERETRACE_HI, MMIO::DirectRead<u16>(&m_InterruptRegister[0].Hi),
                  MMIO::ComplexWrite<u16>([](u32, u16 val) {
-                   m_InterruptRegister[0].Hi = val;
-                   UpdateInterrupts();
+                   ChangeTiming([val] {
+                     m_InterruptRegister[0].Hi = val;
+                     UpdateInterrupts();
+                   });
                  }));
   mmio->Register(base | VI_POSTRETRACE_HI, MMIO::DirectRead<u16>(&m_InterruptRegister[1].Hi),
                  MMIO::ComplexWrite<u16>([](u32, u16 val) {
-                   m_InterruptRegister[1].Hi = val;
-                   UpdateInterrupts();
+                   ChangeTiming([val] {
+                     m_InterruptRegister[1].Hi = val;
+                     UpdateInterrupts();
+                   });
                  }));
   mmio->Register(base | VI_DISPLAY_INTERRUPT_2_HI,
                  MMIO::DirectRead<u16>(&m_InterruptRegister[2].Hi),
                  MMIO::ComplexWrite<u16>([](u32, u16 val) {
-                   m_InterruptRegister[2].Hi = val;
-                   UpdateInterrupts();
+                   ChangeTiming([val] {
+                     m_InterruptRegister[2].Hi = val;
+                     UpdateInterrupts();
+                   });
                  }));
   mmio->Register(base | VI_DISPLAY_INTERRUPT_3_HI,
                  MMIO::DirectRead<u16>(&m_InterruptRegister[3].Hi),
                  MMIO::ComplexWrite<u16>([](u32, u16 val) {
-                   m_InterruptRegister[3].Hi = val;
-                   UpdateInterrupts();
+                   ChangeTiming([val] {
+                     m_InterruptRegister[3].Hi = val;
+                     UpdateInterrupts();
+                   });
                  }));
 
   // Unknown anti-aliasing related MMIO register: puts a warning on log and
@@ -376,23 +426,25 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
   // processing needs to be done if a reset is requested.
   mmio->Register(base | VI_CONTROL_REGISTER, MMIO::DirectRead<u16>(&m_DisplayControlRegister.Hex),
                  MMIO::ComplexWrite<u16>([](u32, u16 val) {
-                   UVIDisplayControlRegister tmpConfig(val);
-                   m_DisplayControlRegister.ENB = tmpConfig.ENB;
-                   m_DisplayControlRegister.NIN = tmpConfig.NIN;
-                   m_DisplayControlRegister.DLR = tmpConfig.DLR;
-                   m_DisplayControlRegister.LE0 = tmpConfig.LE0;
-                   m_DisplayControlRegister.LE1 = tmpConfig.LE1;
-                   m_DisplayControlRegister.FMT = tmpConfig.FMT;
-
-                   if (tmpConfig.RST)
-                   {
-                     // shuffle2 clear all data, reset to default vals, and enter idle mode
-                     m_DisplayControlRegister.RST = 0;
-                     m_InterruptRegister = {};
-                     UpdateInterrupts();
-                   }
+                   ChangeTiming([val] {
+                     UVIDisplayControlRegister tmpConfig(val);
+                     m_DisplayControlRegister.ENB = tmpConfig.ENB;
+                     m_DisplayControlRegister.NIN = tmpConfig.NIN;
+                     m_DisplayControlRegister.DLR = tmpConfig.DLR;
+                     m_DisplayControlRegister.LE0 = tmpConfig.LE0;
+                     m_DisplayControlRegister.LE1 = tmpConfig.LE1;
+                     m_DisplayControlRegister.FMT = tmpConfig.FMT;
+
+                     if (tmpConfig.RST)
+                     {
+                       // shuffle2 clear all data, reset to default vals, and enter idle mode
+                       m_DisplayControlRegister.RST = 0;
+                       m_InterruptRegister = {};
+                       UpdateInterrupts();
+                     }
 
-                   UpdateParameters();
+                     UpdateParameters();
+                   });
                  }));
 
   // Map 8 bit reads (not writes) to 16 bit reads.
@@ -411,12 +463,17 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
   }
 }
 
+static bool IsInterruptAsserted()
+{
+  return (m_InterruptRegister[0].IR_INT && m_InterruptRegister[0].IR_MASK) ||
+         (m_InterruptRegister[1].IR_INT && m_InterruptRegister[1].IR_MASK) ||
+         (m_InterruptRegister[2].IR_INT && m_InterruptRegister[2].IR_MASK) ||
+         (m_InterruptRegister[3].IR_INT && m_InterruptRegister[3].IR_MASK);
+}
+
 void UpdateInterrupts()
 {
-  if ((m_InterruptRegister[0].IR_INT && m_InterruptRegister[0].IR_MASK) ||
-      (m_InterruptRegister[1].IR_INT && m_InterruptRegister[1].IR_MASK) ||
-      (m_InterruptRegister[2].IR_INT && m_InterruptRegister[2].IR_MASK) ||
-      (m_InterruptRegister[3].IR_INT && m_InterruptRegister[3].IR_MASK))
+  if (IsInterruptAsserted())
   {
     ProcessorInterface::SetInterrupt(ProcessorInterface::INT_CAUSE_VI, true);
   }
@@ -718,9 +775,48 @@ static void EndField()
   Core::VideoThrottle();
 }
 
+static u32 GetHalfLinesPerFrame()
+{
+  return GetHalfLinesPerEvenField() + GetHalfLinesPerOddField();
+}
+
+// Moves on to the next half-line. SI polls only move *si_poll_half_line on the half-line where
+// they happen, which is handled by Update.
+static void NextHalfLine(u32* half_line, u32* si_poll_half_line)
+{
+  ++*half_line;
+
+  if (*half_line > GetHalfLinesPerFrame())
+  {
+    *half_line = 1;
+    *si_poll_half_line = num_half_lines_for_si_poll;  // first results start at vsync
+  }
+
+  if (*half_line == GetHalfLinesPerEvenField())
+  {
+    *si_poll_half_line = GetHalfLinesPerEvenField() + num_half_lines_for_si_poll;
+  }
+}
+
+// Whether anything besides the beam position changes on the half-line.
+static bool IsEventHalfLine(u32 half_line, u32 si_poll_half_line)
+{
+  if (half_line == si_poll_half_line || half_line == s_even_field_first_hl ||
+      half_line == s_odd_field_first_hl || half_line == s_even_field_last_hl ||
+      half_line == s_odd_field_last_hl)
+  {
+    return true;
+  }
+
+  return std::any_of(m_InterruptRegister.begin(), m_InterruptRegister.end(),
+                     [half_line](const UVIInterruptRegister& reg) {
+                       return half_line + 1 == 2u * reg.VCT;
+                     });
+}
+
 // Purpose: Send VI interrupt when triggered
 // Run when: When a frame is scanned (progressive/interlace)
-void Update(u64 ticks)
+static void Update(u64 ticks)
 {
   if (s_half_line_of_next_si_poll == s_half_line_count)
   {
@@ -752,25 +848,93 @@ void Update(u64 ticks)
     }
   }
 
-  s_half_line_count++;
+  NextHalfLine(&s_half_line_count, &s_half_line_of_next_si_poll);
 
-  if (s_half_line_count > GetHalfLinesPerEvenField() + GetHalfLinesPerOddField())
+  if (s_half_line_count & 1)
   {
-    s_half_line_count = 1;
-    s_half_line_of_next_si_poll = num_half_lines_for_si_poll;  // first results start at vsync
+    s_ticks_last_line_start = ticks;
   }
 
-  if (s_half_line_count == GetHalfLinesPerEvenField())
+  UpdateInterrupts();
+}
+
+// Handles every half-line that has started by the given time.
+static void UpdateBeam(u64 ticks)
+{
+  while (s_ticks_next_half_line <= ticks)
   {
-    s_half_line_of_next_si_poll = GetHalfLinesPerEvenField() + num_half_lines_for_si_poll;
+    const u64 half_line_ticks = s_ticks_next_half_line;
+    s_ticks_next_half_line += GetTicksPerHalfLine();
+    Update(half_line_ticks);
   }
+}
 
-  if (s_half_line_count & 1)
+// Where the beam is at the given time. Unlike UpdateBeam, this leaves the half-lines that have
+// passed (and the field changes, SI polls and interrupts on them) to the scheduled update, so it
+// can be used from MMIO reads in the middle of a block.
+static BeamPosition GetBeamPosition(u64 ticks)
+{
+  BeamPosition beam = {s_half_line_count, s_ticks_last_line_start, s_ticks_next_half_line};
+  if (ticks < s_ticks_next_half_line)
+    return beam;
+
+  // The same as calling NextHalfLine for each of them.
+  const u64 ticks_per_half_line = GetTicksPerHalfLine();
+  const u64 passed = (ticks - s_ticks_next_half_line) / ticks_per_half_line + 1;
+  const u32 half_lines_per_frame = GetHalfLinesPerFrame();
+  const auto half_line_after = [&](u64 count) {
+    return static_cast<u32>((s_half_line_count - 1 + count) % half_lines_per_frame + 1);
+  };
+  const auto half_line_start = [&](u64 count) {
+    return s_ticks_next_half_line + (count - 1) * ticks_per_half_line;
+  };
+
+  // Lines start on odd half-lines. Of two half-lines in a row, at least one is odd, including
+  // when the frame wraps around to half-line 1.
+  beam.half_line = half_line_after(passed);
+  beam.ticks_next_half_line = half_line_start(passed + 1);
+  if (beam.half_line & 1)
+    beam.ticks_last_line_start = half_line_start(passed);
+  else if (passed > 1)
+    beam.ticks_last_line_start = half_line_start(passed - 1);
+  return beam;
+}
+
+static void ScheduleNextUpdate()
+{
+  // An asserted interrupt is raised again on every half-line, in case it was cleared in PI.
+  u32 half_lines_ahead = 0;
+  if (!IsInterruptAsserted())
   {
-    s_ticks_last_line_start = CoreTiming::GetTicks();
+    u32 half_line = s_half_line_count;
+    u32 si_poll_half_line = s_half_line_of_next_si_poll;
+    const u32 half_lines_per_frame = GetHalfLinesPerFrame();
+    while (half_lines_ahead < half_lines_per_frame &&
+           !IsEventHalfLine(half_line, si_poll_half_line))
+    {
+      NextHalfLine(&half_line, &si_poll_half_line);
+      ++half_lines_ahead;
+    }
   }
 
-  UpdateInterrupts();
+  const u64 ticks = s_ticks_next_half_line + u64{half_lines_ahead} * GetTicksPerHalfLine();
+  CoreTiming::RemoveEvent(s_event_type_update);
+  CoreTiming::ScheduleEvent(static_cast<s64>(ticks - CoreTiming::GetTicks()), s_event_type_update);
+}
+
+static void UpdateCallback(u64 userdata, s64 cycles_late)
+{
+  UpdateBeam(CoreTiming::GetTicks());
+  ScheduleNextUpdate();
+}
+
+void AdjustEventTimes(u32 new_ppc_clock, u32 old_ppc_clock)
+{
+  // The same as CoreTiming::AdjustEventQueueTimes.
+  const s64 global_timer = CoreTiming::g.global_timer;
+  const s64 ticks = static_cast<s64>(s_ticks_next_half_line) - global_timer;
+  s_ticks_next_half_line = static_cast<u64>(global_timer + ticks * new_ppc_clock / old_ppc_clock);
+  ScheduleNextUpdate();
 }
 
 }  // namespace
@@ -354,8 +354,8 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base);
 u32 GetXFBAddressTop();
 u32 GetXFBAddressBottom();
 
-// Update and draw framebuffer
-void Update(u64 ticks);
+// Moves the timing of the next beam update along with the events after the CPU clock has changed.
+void AdjustEventTimes(u32 new_ppc_clock, u32 old_ppc_clock);
 
 // UpdateInterrupts: check if we have to generate a new VI Interrupt
 void UpdateInterrupts();
@@ -6,6 +6,7 @@
 
 #include "Core/HW/WiimoteEmu/Encryption.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include "Common/CommonTypes.h"
@@ -267,17 +268,57 @@ void WiimoteGenerateKey(wiimote_key* const key, const u8* const keydata)
   // for homebrew, ft and sb are all 0x97 which is equivalent to 0x17
 }
 
+// The key repeats every 8 bytes, so data is processed in 8-byte blocks with SWAR byte arithmetic
+// and the key rotated to the first block's address. A short last block is zero-padded.
+static u64 LoadKey(const u8* key_bytes, int addr)
+{
+  u8 rotated[8];
+  for (int i = 0; i < 8; ++i)
+    rotated[i] = key_bytes[(addr + i) % 8];
+  u64 key;
+  std::memcpy(&key, rotated, sizeof(key));
+  return key;
+}
+
+constexpr u64 HIGH_BITS = 0x8080808080808080ULL;
+
+static u64 SubtractBytes(u64 x, u64 y)
+{
+  return ((x | HIGH_BITS) - (y & ~HIGH_BITS)) ^ ((x ^ ~y) & HIGH_BITS);
+}
+
+static u64 AddBytes(u64 x, u64 y)
+{
+  return ((x & ~HIGH_BITS) + (y & ~HIGH_BITS)) ^ ((x ^ y) & HIGH_BITS);
+}
+
 // TODO: is there a reason these can only handle a length of 255?
 /* Encrypt data */
 void WiimoteEncrypt(const wiimote_key* const key, u8* const data, int addr, const u8 len)
 {
-  for (int i = 0; i < len; ++i, ++addr)
-    data[i] = (data[i] - key->ft[addr % 8]) ^ key->sb[addr % 8];
+  const u64 ft = LoadKey(key->ft, addr);
+  const u64 sb = LoadKey(key->sb, addr);
+  for (int i = 0; i < len; i += 8)
+  {
+    const size_t size = std::min(len - i, 8);
+    u64 block = 0;
+    std::memcpy(&block, data + i, size);
+    block = SubtractBytes(block, ft) ^ sb;
+    std::memcpy(data + i, &block, size);
+  }
 }
 
 /* Decrypt data */
 void WiimoteDecrypt(const wiimote_key* const key, u8* const data, int addr, const u8 len)
 {
-  for (int i = 0; i < len; ++i, ++addr)
-    data[i] = (data[i] ^ key->sb[addr % 8]) + key->ft[addr % 8];
+  const u64 ft = LoadKey(key->ft, addr);
+  const u64 sb = LoadKey(key->sb, addr);
+  for (int i = 0; i < len; i += 8)
+  {
+    const size_t size = std::min(len - i, 8);
+    u64 block = 0;
+    std::memcpy(&block, data + i, size);
+    block = AddBytes(block ^ sb, ft);
+    std::memcpy(data + i, &block, size);
+  }
 }
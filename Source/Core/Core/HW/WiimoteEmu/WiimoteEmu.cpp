@@ -17,6 +17,7 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/CoreTiming.h"
 #include "Core/HW/Wiimote.h"
 #include "Core/HW/WiimoteCommon/WiimoteConstants.h"
 #include "Core/HW/WiimoteCommon/WiimoteHid.h"
@@ -25,7 +26,6 @@
 #include "Core/HW/WiimoteEmu/Attachment/Guitar.h"
 #include "Core/HW/WiimoteEmu/Attachment/Nunchuk.h"
 #include "Core/HW/WiimoteEmu/Attachment/Turntable.h"
-#include "Core/HW/WiimoteEmu/MatrixMath.h"
 #include "Core/HW/WiimoteReal/WiimoteReal.h"
 #include "Core/Host.h"
 #include "Core/Movie.h"
@@ -42,6 +42,8 @@
 #include "InputCommon/ControllerEmu/ControlGroup/Tilt.h"
 #include "InputCommon/ControllerEmu/Setting/BooleanSetting.h"
 #include "InputCommon/ControllerEmu/Setting/NumericSetting.h"
+#include "InputCommon/ControllerInterface/ControllerInterface.h"
+#include "InputCommon/InputLatency.h"
 
 namespace
 {
@@ -129,6 +131,12 @@ void EmulateTilt(AccelData* const accel, ControllerEmu::Tilt* const tilt_group,
   // 180 degrees
   tilt_group->GetState(&roll, &pitch);
 
+  EmulateTilt(accel, roll, pitch, sideways, upright);
+}
+
+void EmulateTilt(AccelData* const accel, ControlState roll, ControlState pitch, const bool sideways,
+                 const bool upright)
+{
   roll *= PI;
   pitch *= PI;
 
@@ -481,7 +489,20 @@ void Wiimote::GetAccelData(u8* const data, const ReportFeatures& rptf)
   const bool is_upright =
       m_upright_setting->GetValue() ^ upright_modifier_toggle ^ upright_modifier_switch;
 
-  EmulateTilt(&m_accel, m_tilt, is_sideways, is_upright);
+  ControlState roll, pitch;
+  m_tilt->GetState(&roll, &pitch);
+  if (!m_tilt_cache.valid || roll != m_tilt_cache.roll || pitch != m_tilt_cache.pitch ||
+      is_sideways != m_tilt_cache.sideways || is_upright != m_tilt_cache.upright)
+  {
+    EmulateTilt(&m_tilt_cache.accel, roll, pitch, is_sideways, is_upright);
+    m_tilt_cache.roll = roll;
+    m_tilt_cache.pitch = pitch;
+    m_tilt_cache.sideways = is_sideways;
+    m_tilt_cache.upright = is_upright;
+    m_tilt_cache.valid = true;
+  }
+  m_accel = m_tilt_cache.accel;
+
   EmulateSwing(&m_accel, m_swing, is_sideways, is_upright);
   EmulateShake(&m_accel, m_shake, m_shake_step);
 
@@ -517,9 +538,6 @@ inline void LowPassFilter(double& var, double newval, double period)
 
 void Wiimote::GetIRData(u8* const data, bool use_accel)
 {
-  u16 x[4], y[4];
-  memset(x, 0xFF, sizeof(x));
-
   ControlState xx = 10000, yy = 0, zz = 0;
   double nsin, ncos;
 
@@ -554,7 +572,31 @@ void Wiimote::GetIRData(u8* const data, bool use_accel)
 
   m_ir->GetState(&xx, &yy, &zz, true);
 
-  Vertex v[4];
+  // Fill report with valid data when full handshake was done
+  if (!m_reg_ir.data[0x30])
+    return;
+
+  const u8 mode = m_reg_ir.mode;
+  if (mode == 5)
+  {
+    // full
+    PanicAlert("Full IR report");
+    // UNSUPPORTED
+    return;
+  }
+
+  // basic or extended
+  if (mode != 1 && mode != 3)
+    return;
+
+  const size_t size = mode == 1 ? 2 * sizeof(wm_ir_basic) : 4 * sizeof(wm_ir_extended);
+  if (m_ir_cache.valid && xx == m_ir_cache.x && yy == m_ir_cache.y && zz == m_ir_cache.z &&
+      ir_sin == m_ir_cache.sin && ir_cos == m_ir_cache.cos &&
+      m_sensor_bar_on_top == m_ir_cache.sensor_bar_on_top && mode == m_ir_cache.mode)
+  {
+    memcpy(data, m_ir_cache.data.data(), size);
+    return;
+  }
 
   static const int camWidth = 1024;
   static const int camHeight = 768;
@@ -565,94 +607,78 @@ void Wiimote::GetIRData(u8* const data, bool use_accel)
   static const double dist1 = 100.0 / camWidth;  // this seems the optimal distance for zelda
   static const double dist2 = 1.2 * dist1;
 
-  for (auto& vtx : v)
-  {
-    vtx.x = xx * (bndright - bndleft) / 2 + (bndleft + bndright) / 2;
-    if (m_sensor_bar_on_top)
-      vtx.y = yy * (bndup - bnddown) / 2 + (bndup + bnddown) / 2;
-    else
-      vtx.y = yy * (bndup - bnddown) / 2 - (bndup + bnddown) / 2;
-    vtx.z = 0;
-  }
-
-  v[0].x -= (zz * 0.5 + 1) * dist1;
-  v[1].x += (zz * 0.5 + 1) * dist1;
-  v[2].x -= (zz * 0.5 + 1) * dist2;
-  v[3].x += (zz * 0.5 + 1) * dist2;
-
-#define printmatrix(m)                                                                             \
-  PanicAlert("%f %f %f %f\n%f %f %f %f\n%f %f %f %f\n%f %f %f %f\n", m[0][0], m[0][1], m[0][2],    \
-             m[0][3], m[1][0], m[1][1], m[1][2], m[1][3], m[2][0], m[2][1], m[2][2], m[2][3],      \
-             m[3][0], m[3][1], m[3][2], m[3][3])
-  Matrix rot, tot;
-  static Matrix scale;
-  MatrixScale(scale, 1, camWidth / camHeight, 1);
-  MatrixRotationByZ(rot, ir_sin, ir_cos);
-  MatrixMultiply(tot, scale, rot);
+  // The four dots all lie on the sensor bar, so they only differ in x.
+  const double center_x = xx * (bndright - bndleft) / 2 + (bndleft + bndright) / 2;
+  const double center_y = m_sensor_bar_on_top ? yy * (bndup - bnddown) / 2 + (bndup + bnddown) / 2 :
+                                                yy * (bndup - bnddown) / 2 - (bndup + bnddown) / 2;
+  const double dot_x[4] = {center_x - (zz * 0.5 + 1) * dist1, center_x + (zz * 0.5 + 1) * dist1,
+                           center_x - (zz * 0.5 + 1) * dist2, center_x + (zz * 0.5 + 1) * dist2};
 
+  // Rotate the dots by the roll of the remote. The camera's aspect ratio scale is an integer
+  // division that comes out as 1, so that's the whole projection.
+  u16 x[4], y[4];
+  memset(x, 0xFF, sizeof(x));
   for (int i = 0; i < 4; i++)
   {
-    MatrixTransformVertex(tot, v[i]);
-    if ((v[i].x < -1) || (v[i].x > 1) || (v[i].y < -1) || (v[i].y > 1))
+    const double rotated_x = ir_cos * dot_x[i] - ir_sin * center_y;
+    const double rotated_y = ir_sin * dot_x[i] + ir_cos * center_y;
+    if ((rotated_x < -1) || (rotated_x > 1) || (rotated_y < -1) || (rotated_y > 1))
       continue;
-    x[i] = (u16)lround((v[i].x + 1) / 2 * (camWidth - 1));
-    y[i] = (u16)lround((v[i].y + 1) / 2 * (camHeight - 1));
+    x[i] = (u16)lround((rotated_x + 1) / 2 * (camWidth - 1));
+    y[i] = (u16)lround((rotated_y + 1) / 2 * (camHeight - 1));
   }
-  // Fill report with valid data when full handshake was done
-  if (m_reg_ir.data[0x30])
-    // ir mode
-    switch (m_reg_ir.mode)
-    {
-    // basic
-    case 1:
+
+  memset(data, 0xFF, size);
+  if (mode == 1)
+  {
+    wm_ir_basic* const irdata = reinterpret_cast<wm_ir_basic*>(data);
+    for (unsigned int i = 0; i < 2; ++i)
     {
-      memset(data, 0xFF, 10);
-      wm_ir_basic* const irdata = reinterpret_cast<wm_ir_basic*>(data);
-      for (unsigned int i = 0; i < 2; ++i)
+      if (x[i * 2] < 1024 && y[i * 2] < 768)
       {
-        if (x[i * 2] < 1024 && y[i * 2] < 768)
-        {
-          irdata[i].x1 = static_cast<u8>(x[i * 2]);
-          irdata[i].x1hi = x[i * 2] >> 8;
+        irdata[i].x1 = static_cast<u8>(x[i * 2]);
+        irdata[i].x1hi = x[i * 2] >> 8;
 
-          irdata[i].y1 = static_cast<u8>(y[i * 2]);
-          irdata[i].y1hi = y[i * 2] >> 8;
-        }
-        if (x[i * 2 + 1] < 1024 && y[i * 2 + 1] < 768)
-        {
-          irdata[i].x2 = static_cast<u8>(x[i * 2 + 1]);
-          irdata[i].x2hi = x[i * 2 + 1] >> 8;
+        irdata[i].y1 = static_cast<u8>(y[i * 2]);
+        irdata[i].y1hi = y[i * 2] >> 8;
+      }
+      if (x[i * 2 + 1] < 1024 && y[i * 2 + 1] < 768)
+      {
+        irdata[i].x2 = static_cast<u8>(x[i * 2 + 1]);
+        irdata[i].x2hi = x[i * 2 + 1] >> 8;
 
-          irdata[i].y2 = static_cast<u8>(y[i * 2 + 1]);
-          irdata[i].y2hi = y[i * 2 + 1] >> 8;
-        }
+        irdata[i].y2 = static_cast<u8>(y[i * 2 + 1]);
+        irdata[i].y2hi = y[i * 2 + 1] >> 8;
       }
     }
-    break;
-    // extended
-    case 3:
+  }
+  else
+  {
+    wm_ir_extended* const irdata = reinterpret_cast<wm_ir_extended*>(data);
+    for (unsigned int i = 0; i < 4; ++i)
     {
-      memset(data, 0xFF, 12);
-      wm_ir_extended* const irdata = reinterpret_cast<wm_ir_extended*>(data);
-      for (unsigned int i = 0; i < 4; ++i)
-        if (x[i] < 1024 && y[i] < 768)
-        {
-          irdata[i].x = static_cast<u8>(x[i]);
-          irdata[i].xhi = x[i] >> 8;
+      if (x[i] < 1024 && y[i] < 768)
+      {
+        irdata[i].x = static_cast<u8>(x[i]);
+        irdata[i].xhi = x[i] >> 8;
 
-          irdata[i].y = static_cast<u8>(y[i]);
-          irdata[i].yhi = y[i] >> 8;
+        irdata[i].y = static_cast<u8>(y[i]);
+        irdata[i].yhi = y[i] >> 8;
 
-          irdata[i].size = 10;
-        }
-    }
-    break;
-    // full
-    case 5:
-      PanicAlert("Full IR report");
-      // UNSUPPORTED
-      break;
+        irdata[i].size = 10;
+      }
     }
+  }
+
+  m_ir_cache.x = xx;
+  m_ir_cache.y = yy;
+  m_ir_cache.z = zz;
+  m_ir_cache.sin = ir_sin;
+  m_ir_cache.cos = ir_cos;
+  m_ir_cache.sensor_bar_on_top = m_sensor_bar_on_top;
+  m_ir_cache.mode = mode;
+  m_ir_cache.valid = true;
+  memcpy(m_ir_cache.data.data(), data, size);
 }
 
 void Wiimote::GetExtData(u8* const data)
@@ -690,6 +716,7 @@ void Wiimote::Update()
 
   u8 data[MAX_PAYLOAD];
   memset(data, 0, sizeof(data));
+  const u64 input_version = g_controller_interface.GetInputVersion();
 
   Movie::SetPolledDevice();
 
@@ -825,6 +852,14 @@ void Wiimote::Update()
   // send data report
   if (rptf_size)
   {
+    if (InputLatency::IsEnabled())
+    {
+      const bool changed = std::memcmp(m_latency_report.data(), data, rptf_size) != 0;
+      std::memcpy(m_latency_report.data(), data, rptf_size);
+      InputLatency::OnInputPolled(&m_latency_source, input_version, changed,
+                                  CoreTiming::GetTicks());
+    }
+
     Core::Callback_WiimoteInterruptChannel(m_index, m_reporting_channel, data, rptf_size);
   }
 }
@@ -4,13 +4,16 @@
 
 #pragma once
 
+#include <array>
 #include <queue>
 #include <string>
 
+#include "Core/HW/WiimoteCommon/WiimoteConstants.h"
 #include "Core/HW/WiimoteCommon/WiimoteHid.h"
 #include "Core/HW/WiimoteCommon/WiimoteReport.h"
 #include "Core/HW/WiimoteEmu/Encryption.h"
 #include "InputCommon/ControllerEmu/ControllerEmu.h"
+#include "InputCommon/InputLatency.h"
 
 // Registry sizes
 #define WIIMOTE_EEPROM_SIZE (16 * 1024)
@@ -157,6 +160,8 @@ void EmulateShake(AccelData* const accel_data, ControllerEmu::Buttons* const but
 
 void EmulateTilt(AccelData* const accel, ControllerEmu::Tilt* const tilt_group,
                  const bool sideways = false, const bool upright = false);
+void EmulateTilt(AccelData* const accel, ControlState roll, ControlState pitch, const bool sideways,
+                 const bool upright);
 
 void EmulateSwing(AccelData* const accel, ControllerEmu::Force* const tilt_group,
                   const bool sideways = false, const bool upright = false);
@@ -267,6 +272,31 @@ private:
 
   double ir_sin, ir_cos;  // for the low pass filter
 
+  // Tilt and IR data only change when their inputs do, which is rarely every report. Both are pure
+  // functions of the inputs, so they don't need to be saved in savestates.
+  struct TiltCache
+  {
+    ControlState roll;
+    ControlState pitch;
+    bool sideways;
+    bool upright;
+    bool valid = false;
+    AccelData accel;
+  } m_tilt_cache;
+
+  struct IRCache
+  {
+    ControlState x;
+    ControlState y;
+    ControlState z;
+    double sin;
+    double cos;
+    bool sensor_bar_on_top;
+    u8 mode;
+    bool valid = false;
+    std::array<u8, 12> data;
+  } m_ir_cache;
+
   bool m_rumble_on;
   bool m_speaker_mute;
   bool m_motion_plus_present;
@@ -284,6 +314,10 @@ private:
 
   ADPCMState m_adpcm_state;
 
+  // The last report sent, to tell which reports carry new input
+  std::array<u8, MAX_PAYLOAD> m_latency_report{};
+  InputLatency::PollSource m_latency_source;
+
   // read data request queue
   // maybe it isn't actually a queue
   // maybe read requests cancel any current requests
@@ -130,11 +130,10 @@ IPCCommandResult ES::GetTitles(const std::vector<u64>& titles, const IOCtlVReque
     return GetDefaultReply(ES_EINVAL);
 
   const size_t max_count = Memory::Read_U32(request.in_vectors[0].address);
-  for (size_t i = 0; i < std::min(max_count, titles.size()); i++)
-  {
-    Memory::Write_U64(titles[i], request.io_vectors[0].address + static_cast<u32>(i) * sizeof(u64));
+  const size_t count = std::min(max_count, titles.size());
+  Memory::CopyToEmuSwapped(request.io_vectors[0].address, titles.data(), count * sizeof(u64));
+  for (size_t i = 0; i < count; i++)
     INFO_LOG(IOS_ES, "     title %016" PRIx64, titles[i]);
-  }
   return GetDefaultReply(IPC_SUCCESS);
 }
 
@@ -21,6 +21,7 @@
 #include "Core/Core.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/IOS.h"
+#include "Core/NetworkCapture.h"
 
 #ifdef _WIN32
 #define ERRORCODE(name) WSA##name
@@ -411,6 +412,11 @@ void WiiSocket::Update(bool read, bool write, bool except)
                                      SConfig::GetInstance().GetGameID() + "_write.bin";
               File::IOFile(filename, "ab").WriteBytes(Memory::GetPointer(BufferOut2), ret);
             }
+            if (ret > 0)
+            {
+              NetworkCapture::AddPacket(NetworkCapture::Stream::SSLWrite,
+                                        Memory::GetPointer(BufferOut2), ret);
+            }
 
             if (ret >= 0)
             {
@@ -449,6 +455,11 @@ void WiiSocket::Update(bool read, bool write, bool except)
                                      SConfig::GetInstance().GetGameID() + "_read.bin";
               File::IOFile(filename, "ab").WriteBytes(Memory::GetPointer(BufferIn2), ret);
             }
+            if (ret > 0)
+            {
+              NetworkCapture::AddPacket(NetworkCapture::Stream::SSLRead,
+                                        Memory::GetPointer(BufferIn2), ret);
+            }
 
             if (ret >= 0)
             {
@@ -512,6 +523,11 @@ void WiiSocket::Update(bool read, bool write, bool except)
           int ret = sendto(fd, data, BufferInSize, flags,
                            has_destaddr ? (struct sockaddr*)&local_name : nullptr,
                            has_destaddr ? sizeof(sockaddr) : 0);
+          if (ret > 0)
+          {
+            NetworkCapture::AddPacket(NetworkCapture::Stream::SocketSend,
+                                      reinterpret_cast<const u8*>(data), ret);
+          }
           ReturnValue = WiiSockMan::GetNetErrorCode(ret, "SO_SENDTO", true);
 
           DEBUG_LOG(
@@ -557,6 +573,12 @@ void WiiSocket::Update(bool read, bool write, bool except)
           int ret = recvfrom(fd, data, data_len, flags,
                              BufferOutSize2 ? (struct sockaddr*)&local_name : nullptr,
                              BufferOutSize2 ? &addrlen : nullptr);
+          // Peeked data is captured when it is actually received.
+          if (ret > 0 && !(flags & SO_MSG_PEEK))
+          {
+            NetworkCapture::AddPacket(NetworkCapture::Stream::SocketRecv,
+                                      reinterpret_cast<const u8*>(data), ret);
+          }
           ReturnValue =
               WiiSockMan::GetNetErrorCode(ret, BufferOutSize2 ? "SO_RECVFROM" : "SO_RECV", true);
 
@@ -4,6 +4,7 @@
 
 #include "Core/IOS/SDIO/SDIOSlot0.h"
 
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <memory>
@@ -74,6 +75,82 @@ void SDIOSlot0::OpenInternal()
                         "from a read-only directory?");
     }
   }
+
+  // Blocks are copied straight between the mapped image and emulated memory when possible.
+  if (m_Card && !m_card_mapping.Open(filename))
+    WARN_LOG(IOS_SD, "Could not map the SD Card image, falling back to file I/O");
+}
+
+bool SDIOSlot0::ReadFromCard(u64 offset, u32 address, u32 size)
+{
+  if (size == 0)
+    return true;
+
+  u8* const destination = Memory::GetPointerForRange(address, size);
+  if (!destination)
+  {
+    ERROR_LOG(IOS_SD, "Read of 0x%x bytes into invalid memory at 0x%08x", size, address);
+    return false;
+  }
+
+  if (m_card_mapping.IsOpen())
+  {
+    if (offset + size > m_card_mapping.GetSize())
+    {
+      ERROR_LOG(IOS_SD, "Read of 0x%x bytes at 0x%" PRIx64 " is past the end of the card", size,
+                offset);
+      return false;
+    }
+    std::memcpy(destination, m_card_mapping.GetData() + offset, size);
+    return true;
+  }
+
+  if (!m_Card.Seek(offset, SEEK_SET))
+    ERROR_LOG(IOS_SD, "Seek failed WTF");
+
+  if (!m_Card.ReadBytes(destination, size))
+  {
+    ERROR_LOG(IOS_SD, "Read Failed - error: %i, eof: %i", ferror(m_Card.GetHandle()),
+              feof(m_Card.GetHandle()));
+    return false;
+  }
+  return true;
+}
+
+bool SDIOSlot0::WriteToCard(u64 offset, u32 address, u32 size)
+{
+  if (size == 0)
+    return true;
+
+  const u8* const source = Memory::GetPointerForRange(address, size);
+  if (!source)
+  {
+    ERROR_LOG(IOS_SD, "Write of 0x%x bytes from invalid memory at 0x%08x", size, address);
+    return false;
+  }
+
+  if (m_card_mapping.IsOpen())
+  {
+    if (offset + size > m_card_mapping.GetSize())
+    {
+      ERROR_LOG(IOS_SD, "Write of 0x%x bytes at 0x%" PRIx64 " is past the end of the card", size,
+                offset);
+      return false;
+    }
+    std::memcpy(m_card_mapping.GetData() + offset, source, size);
+    return true;
+  }
+
+  if (!m_Card.Seek(offset, SEEK_SET))
+    ERROR_LOG(IOS_SD, "fseeko failed WTF");
+
+  if (!m_Card.WriteBytes(source, size))
+  {
+    ERROR_LOG(IOS_SD, "Write Failed - error: %i, eof: %i", ferror(m_Card.GetHandle()),
+              feof(m_Card.GetHandle()));
+    return false;
+  }
+  return true;
 }
 
 ReturnCode SDIOSlot0::Open(const OpenRequest& request)
@@ -87,6 +164,8 @@ ReturnCode SDIOSlot0::Open(const OpenRequest& request)
 
 ReturnCode SDIOSlot0::Close(u32 fd)
 {
+  m_card_mapping.Flush();
+  m_card_mapping.Close();
   m_Card.Close();
   m_BlockLength = 0;
   m_BusWidth = 0;
@@ -246,19 +325,10 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 _BufferIn, u32 _Buffer
     {
       u32 size = req.bsize * req.blocks;
 
-      if (!m_Card.Seek(req.arg, SEEK_SET))
-        ERROR_LOG(IOS_SD, "Seek failed WTF");
-
-      if (m_Card.ReadBytes(Memory::GetPointer(req.addr), size))
-      {
+      if (ReadFromCard(req.arg, req.addr, size))
         DEBUG_LOG(IOS_SD, "Outbuffer size %i got %i", _rwBufferSize, size);
-      }
       else
-      {
-        ERROR_LOG(IOS_SD, "Read Failed - error: %i, eof: %i", ferror(m_Card.GetHandle()),
-                  feof(m_Card.GetHandle()));
         ret = RET_FAIL;
-      }
     }
   }
     Memory::Write_U32(0x900, _BufferOut);
@@ -275,15 +345,8 @@ s32 SDIOSlot0::ExecuteCommand(const Request& request, u32 _BufferIn, u32 _Buffer
     {
       u32 size = req.bsize * req.blocks;
 
-      if (!m_Card.Seek(req.arg, SEEK_SET))
-        ERROR_LOG(IOS_SD, "fseeko failed WTF");
-
-      if (!m_Card.WriteBytes(Memory::GetPointer(req.addr), size))
-      {
-        ERROR_LOG(IOS_SD, "Write Failed - error: %i, eof: %i", ferror(m_Card.GetHandle()),
-                  feof(m_Card.GetHandle()));
+      if (!WriteToCard(req.arg, req.addr, size))
         ret = RET_FAIL;
-      }
     }
   }
     Memory::Write_U32(0x900, _BufferOut);
@@ -11,6 +11,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
+#include "Common/MappedFile.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/IOS.h"
 
@@ -131,6 +132,8 @@ private:
   s32 ExecuteCommand(const Request& request, u32 BufferIn, u32 BufferInSize, u32 BufferIn2,
                      u32 BufferInSize2, u32 _BufferOut, u32 BufferOutSize);
   void OpenInternal();
+  bool ReadFromCard(u64 offset, u32 address, u32 size);
+  bool WriteToCard(u64 offset, u32 address, u32 size);
 
   // TODO: do we need more than one?
   std::unique_ptr<Event> m_event;
@@ -142,6 +145,7 @@ private:
   std::array<u32, 0x200 / sizeof(u32)> m_registers;
 
   File::IOFile m_Card;
+  File::MappedFile m_card_mapping;
 };
 }  // namespace Device
 }  // namespace HLE
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <iterator>
 #include <memory>
 #include <string>
 
@@ -389,7 +390,7 @@ void BluetoothEmu::Update()
 
 void BluetoothEmu::ACLPool::Store(const u8* data, const u16 size, const u16 conn_handle)
 {
-  if (m_queue.size() >= 100)
+  if (m_size >= CAPACITY)
   {
     // Many simultaneous exchanges of ACL packets tend to cause the queue to fill up.
     ERROR_LOG(IOS_WIIMOTE, "ACL queue size reached 100 - current packet will be dropped!");
@@ -398,17 +399,16 @@ void BluetoothEmu::ACLPool::Store(const u8* data, const u16 size, const u16 conn
 
   _dbg_assert_msg_(IOS_WIIMOTE, size < ACL_PKT_SIZE, "ACL packet too large for pool");
 
-  m_queue.push_back(Packet());
-  auto& packet = m_queue.back();
-
+  Packet& packet = m_packets[(m_read + m_size) % CAPACITY];
   std::copy(data, data + size, packet.data);
   packet.size = size;
   packet.conn_handle = conn_handle;
+  m_size++;
 }
 
 void BluetoothEmu::ACLPool::WriteToEndpoint(USB::V0BulkMessage& endpoint)
 {
-  auto& packet = m_queue.front();
+  const Packet& packet = m_packets[m_read];
 
   const u8* const data = packet.data;
   const u16 size = packet.size;
@@ -425,11 +425,26 @@ void BluetoothEmu::ACLPool::WriteToEndpoint(USB::V0BulkMessage& endpoint)
   // Write the packet to the buffer
   std::copy(data, data + size, (u8*)pHeader + sizeof(hci_acldata_hdr_t));
 
-  m_queue.pop_front();
+  m_read = (m_read + 1) % CAPACITY;
+  m_size--;
 
   m_ios.EnqueueIPCReply(endpoint.ios_request, sizeof(hci_acldata_hdr_t) + size);
 }
 
+void BluetoothEmu::ACLPool::DoState(PointerWrap& p)
+{
+  u32 size = m_size;
+  p.Do(size);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+  {
+    m_read = 0;
+    m_size = std::min(size, CAPACITY);
+  }
+
+  for (u32 i = 0; i < m_size; ++i)
+    p.Do(m_packets[(m_read + i) % CAPACITY]);
+}
+
 bool BluetoothEmu::SendEventInquiryComplete()
 {
   SQueuedEvent Event(sizeof(SHCIEventInquiryComplete), 0);
@@ -784,6 +799,16 @@ bool BluetoothEmu::SendEventRoleChange(bdaddr_t _bd, bool _master)
 
 bool BluetoothEmu::SendEventNumberOfCompletedPackets()
 {
+  if (std::all_of(std::begin(m_PacketCount), std::end(m_PacketCount),
+                  [](u32 count) { return count == 0; }))
+  {
+    DEBUG_LOG(IOS_WIIMOTE, "SendEventNumberOfCompletedPackets: no packets; no event");
+    return true;
+  }
+
+  if (MergeNumberOfCompletedPackets())
+    return true;
+
   SQueuedEvent Event((u32)(sizeof(hci_event_hdr_t) + sizeof(hci_num_compl_pkts_ep) +
                            (sizeof(hci_num_compl_pkts_info) * m_WiiMotes.size())),
                      0);
@@ -799,8 +824,6 @@ bool BluetoothEmu::SendEventNumberOfCompletedPackets()
   event_hdr->length = sizeof(hci_num_compl_pkts_ep);
   event->num_con_handles = 0;
 
-  u32 acc = 0;
-
   for (unsigned int i = 0; i < m_WiiMotes.size(); i++)
   {
     event_hdr->length += sizeof(hci_num_compl_pkts_info);
@@ -811,18 +834,44 @@ bool BluetoothEmu::SendEventNumberOfCompletedPackets()
     DEBUG_LOG(IOS_WIIMOTE, "  Connection_Handle: 0x%04x", info->con_handle);
     DEBUG_LOG(IOS_WIIMOTE, "  Number_Of_Completed_Packets: %i", info->compl_pkts);
 
-    acc += info->compl_pkts;
     m_PacketCount[i] = 0;
     info++;
   }
 
-  if (acc)
+  AddEventToQueue(Event);
+
+  return true;
+}
+
+// While the stack has no HCI buffer pending, the counts are added to a completed packets event
+// that is still at the back of the queue instead of queueing another event every update.
+bool BluetoothEmu::MergeNumberOfCompletedPackets()
+{
+  if (m_HCIEndpoint || m_EventQueue.empty())
+    return false;
+
+  SQueuedEvent& queued = m_EventQueue.back();
+  const hci_event_hdr_t* event_hdr = (hci_event_hdr_t*)queued.m_buffer;
+  const hci_num_compl_pkts_ep* event =
+      (hci_num_compl_pkts_ep*)((u8*)event_hdr + sizeof(hci_event_hdr_t));
+  hci_num_compl_pkts_info* info =
+      (hci_num_compl_pkts_info*)((u8*)event + sizeof(hci_num_compl_pkts_ep));
+
+  if (event_hdr->event != HCI_EVENT_NUM_COMPL_PKTS || event->num_con_handles != m_WiiMotes.size())
+    return false;
+
+  for (unsigned int i = 0; i < m_WiiMotes.size(); i++)
   {
-    AddEventToQueue(Event);
+    if (info[i].con_handle != m_WiiMotes[i].GetConnectionHandle())
+      return false;
   }
-  else
+
+  DEBUG_LOG(IOS_WIIMOTE, "Event: SendEventNumberOfCompletedPackets (merged into queued event)");
+
+  for (unsigned int i = 0; i < m_WiiMotes.size(); i++)
   {
-    DEBUG_LOG(IOS_WIIMOTE, "SendEventNumberOfCompletedPackets: no packets; no event");
+    info[i].compl_pkts += m_PacketCount[i];
+    m_PacketCount[i] = 0;
   }
 
   return true;
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <deque>
 #include <memory>
 #include <queue>
@@ -79,15 +80,18 @@ private:
   class ACLPool
   {
   public:
-    explicit ACLPool(Kernel& ios) : m_ios(ios), m_queue() {}
+    explicit ACLPool(Kernel& ios) : m_ios(ios) {}
     void Store(const u8* data, const u16 size, const u16 conn_handle);
 
     void WriteToEndpoint(USB::V0BulkMessage& endpoint);
 
-    bool IsEmpty() const { return m_queue.empty(); }
-    // For SaveStates
-    void DoState(PointerWrap& p) { p.Do(m_queue); }
+    bool IsEmpty() const { return m_size == 0; }
+    // For SaveStates. Same layout as the std::deque this used to be.
+    void DoState(PointerWrap& p);
+
   private:
+    static constexpr u32 CAPACITY = 100;
+
     struct Packet
     {
       u8 data[ACL_PKT_SIZE];
@@ -96,7 +100,10 @@ private:
     };
 
     Kernel& m_ios;
-    std::deque<Packet> m_queue;
+    // A ring buffer, so that queueing a packet never allocates.
+    std::array<Packet, CAPACITY> m_packets;
+    u32 m_read = 0;
+    u32 m_size = 0;
   } m_acl_pool{m_ios};
 
   u32 m_PacketCount[MAX_BBMOTES] = {};
@@ -121,6 +128,7 @@ private:
   bool SendEventReadRemoteFeatures(u16 _connectionHandle);
   bool SendEventRoleChange(bdaddr_t _bd, bool _master);
   bool SendEventNumberOfCompletedPackets();
+  bool MergeNumberOfCompletedPackets();
   bool SendEventAuthenticationCompleted(u16 _connectionHandle);
   bool SendEventModeChange(u16 _connectionHandle, u8 _mode, u16 _value);
   bool SendEventDisconnect(u16 _connectionHandle, u8 _Reason);
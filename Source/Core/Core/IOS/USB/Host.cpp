@@ -5,11 +5,13 @@
 #include "Core/IOS/USB/Host.h"
 
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #ifdef __LIBUSB__
 #include <libusb.h>
@@ -31,22 +33,153 @@ namespace HLE
 {
 namespace Device
 {
-USBHost::USBHost(Kernel& ios, const std::string& device_name) : Device(ios, device_name)
-{
 #ifdef __LIBUSB__
-  const int ret = libusb_init(&m_libusb_context);
-  _dbg_assert_msg_(IOS_USB, ret == 0, "Failed to init libusb for USB passthrough.");
+namespace
+{
+class LibusbHostBackend final : public USBHostBackend
+{
+public:
+  explicit LibusbHostBackend(Kernel& ios) : m_ios(ios)
+  {
+    const int ret = libusb_init(&m_context);
+    _dbg_assert_msg_(IOS_USB, ret == 0, "Failed to init libusb for USB passthrough.");
+    if (ret != 0)
+      m_context = nullptr;
+  }
+
+  ~LibusbHostBackend() override
+  {
+    if (!m_context)
+      return;
+    DeregisterHotplugCallbacks();
+    libusb_exit(m_context);
+  }
+
+  bool IsValid() const { return m_context != nullptr; }
+
+  bool GetDevices(const DeviceFilter& filter,
+                  std::vector<std::unique_ptr<USB::Device>>& devices) override
+  {
+    libusb_device** list;
+    const ssize_t count = libusb_get_device_list(m_context, &list);
+    if (count < 0)
+    {
+      WARN_LOG(IOS_USB, "Failed to get device list: %s",
+               libusb_error_name(static_cast<int>(count)));
+      return false;
+    }
+
+    for (ssize_t i = 0; i < count; ++i)
+    {
+      libusb_device_descriptor descriptor;
+      libusb_get_device_descriptor(list[i], &descriptor);
+      if (filter(descriptor.idVendor, descriptor.idProduct))
+        devices.push_back(std::make_unique<USB::LibusbDevice>(m_ios, list[i], descriptor));
+    }
+    // The devices hold references of their own.
+    libusb_free_device_list(list, 1);
+    return true;
+  }
+
+  bool RegisterHotplugCallbacks(DeviceFilter filter, InsertCallback on_insert,
+                                RemoveCallback on_remove) override
+  {
+    if (!libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG))
+      return false;
+
+    m_filter = std::move(filter);
+    m_on_insert = std::move(on_insert);
+    m_on_remove = std::move(on_remove);
+    const int ret = libusb_hotplug_register_callback(
+        m_context,
+        static_cast<libusb_hotplug_event>(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
+                                          LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+        LIBUSB_HOTPLUG_ENUMERATE, LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+        LIBUSB_HOTPLUG_MATCH_ANY, HotplugCallback, this, &m_hotplug_handle);
+    if (ret != LIBUSB_SUCCESS)
+    {
+      WARN_LOG(IOS_USB, "Failed to register hotplug callback: %s", libusb_error_name(ret));
+      return false;
+    }
+    m_hotplug_registered = true;
+    return true;
+  }
+
+  void DeregisterHotplugCallbacks() override
+  {
+    if (!m_hotplug_registered)
+      return;
+    libusb_hotplug_deregister_callback(m_context, m_hotplug_handle);
+    m_hotplug_registered = false;
+  }
+
+  void HandleEvents(std::chrono::milliseconds timeout) override
+  {
+    timeval tv = {static_cast<long>(timeout.count() / 1000),
+                  static_cast<long>(timeout.count() % 1000 * 1000)};
+    libusb_handle_events_timeout_completed(m_context, &tv, nullptr);
+  }
+
+private:
+  static int LIBUSB_CALL HotplugCallback(libusb_context*, libusb_device* device,
+                                         libusb_hotplug_event event, void* user_data)
+  {
+    auto* backend = static_cast<LibusbHostBackend*>(user_data);
+    // The descriptor is cached, so this works for devices that are gone too.
+    libusb_device_descriptor descriptor;
+    if (libusb_get_device_descriptor(device, &descriptor) != LIBUSB_SUCCESS ||
+        !backend->m_filter(descriptor.idVendor, descriptor.idProduct))
+    {
+      return 0;
+    }
+
+    if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED)
+      backend->m_on_insert(std::make_unique<USB::LibusbDevice>(backend->m_ios, device, descriptor));
+    else
+      backend->m_on_remove(USB::LibusbDevice::MakeId(device, descriptor));
+    return 0;
+  }
+
+  Kernel& m_ios;
+  libusb_context* m_context = nullptr;
+
+  bool m_hotplug_registered = false;
+  libusb_hotplug_callback_handle m_hotplug_handle;
+  DeviceFilter m_filter;
+  InsertCallback m_on_insert;
+  RemoveCallback m_on_remove;
+};
+}  // namespace
 #endif
-}
 
-USBHost::~USBHost()
+static std::unique_ptr<USBHostBackend> CreateDefaultBackend(Kernel& ios)
 {
 #ifdef __LIBUSB__
-  if (m_libusb_context)
-    libusb_exit(m_libusb_context);
+  auto backend = std::make_unique<LibusbHostBackend>(ios);
+  if (backend->IsValid())
+    return backend;
 #endif
+  return nullptr;
 }
 
+static bool IsDeviceWhitelisted(u16 vid, u16 pid)
+{
+  return SConfig::GetInstance().IsUSBDeviceWhitelisted({vid, pid});
+}
+
+USBHost::USBHost(Kernel& ios, const std::string& device_name)
+    : USBHost(ios, device_name, CreateDefaultBackend(ios))
+{
+}
+
+USBHost::USBHost(Kernel& ios, const std::string& device_name,
+                 std::unique_ptr<USBHostBackend> backend)
+    : Device(ios, device_name), m_backend(std::move(backend))
+{
+}
+
+USBHost::~USBHost() = default;
+
 ReturnCode USBHost::Open(const OpenRequest& request)
 {
   // Force a device scan to complete, because some games (including Your Shape) only care
@@ -127,49 +260,22 @@ bool USBHost::UpdateDevices(const bool always_add_hooks)
 bool USBHost::AddNewDevices(std::set<u64>& new_devices, DeviceChangeHooks& hooks,
                             const bool always_add_hooks)
 {
-#ifdef __LIBUSB__
-  if (SConfig::GetInstance().m_usb_passthrough_devices.empty())
+  if (!m_backend || SConfig::GetInstance().m_usb_passthrough_devices.empty())
     return true;
 
-  if (m_libusb_context)
-  {
-    libusb_device** list;
-    const ssize_t count = libusb_get_device_list(m_libusb_context, &list);
-    if (count < 0)
-    {
-      WARN_LOG(IOS_USB, "Failed to get device list: %s",
-               libusb_error_name(static_cast<int>(count)));
-      return false;
-    }
-
-    for (ssize_t i = 0; i < count; ++i)
-    {
-      libusb_device* device = list[i];
-      libusb_device_descriptor descriptor;
-      libusb_get_device_descriptor(device, &descriptor);
-      if (!SConfig::GetInstance().IsUSBDeviceWhitelisted(
-              {descriptor.idVendor, descriptor.idProduct}))
-      {
-        libusb_unref_device(device);
-        continue;
-      }
+  std::vector<std::unique_ptr<USB::Device>> devices;
+  if (!m_backend->GetDevices(IsDeviceWhitelisted, devices))
+    return false;
 
-      auto usb_device = std::make_unique<USB::LibusbDevice>(m_ios, device, descriptor);
-      if (!ShouldAddDevice(*usb_device))
-      {
-        libusb_unref_device(device);
-        continue;
-      }
-      const u64 id = usb_device->GetId();
-      new_devices.insert(id);
-      if (AddDevice(std::move(usb_device)) || always_add_hooks)
-        hooks.emplace(GetDeviceById(id), ChangeEvent::Inserted);
-      else
-        libusb_unref_device(device);
-    }
-    libusb_free_device_list(list, 0);
+  for (std::unique_ptr<USB::Device>& device : devices)
+  {
+    if (!ShouldAddDevice(*device))
+      continue;
+    const u64 id = device->GetId();
+    new_devices.insert(id);
+    if (AddDevice(std::move(device)) || always_add_hooks)
+      hooks.emplace(GetDeviceById(id), ChangeEvent::Inserted);
   }
-#endif
   return true;
 }
 
@@ -203,6 +309,67 @@ void USBHost::DispatchHooks(const DeviceChangeHooks& hooks)
     OnDeviceChangeEnd();
 }
 
+// The callbacks run on the event thread, so they only queue the changes for the scan thread.
+bool USBHost::StartHotplug()
+{
+  if (!m_backend)
+    return false;
+
+  const auto queue_event = [this](HotplugEvent event) {
+    {
+      std::lock_guard<std::mutex> lk(m_hotplug_events_mutex);
+      m_hotplug_events.push_back(std::move(event));
+    }
+    m_scan_thread_event.Set();
+  };
+  return m_backend->RegisterHotplugCallbacks(
+      IsDeviceWhitelisted,
+      [queue_event](std::unique_ptr<USB::Device> device) {
+        const u64 id = device->GetId();
+        queue_event({id, std::move(device)});
+      },
+      [queue_event](u64 device_id) { queue_event({device_id, nullptr}); });
+}
+
+void USBHost::HandleHotplugEvents()
+{
+  std::vector<HotplugEvent> events;
+  {
+    std::lock_guard<std::mutex> lk(m_hotplug_events_mutex);
+    events.swap(m_hotplug_events);
+  }
+  if (events.empty() || Core::WantsDeterminism())
+    return;
+
+  DeviceChangeHooks hooks;
+  for (HotplugEvent& event : events)
+  {
+    if (event.device)
+    {
+      if (ShouldAddDevice(*event.device) && AddDevice(std::move(event.device)))
+        hooks.emplace(GetDeviceById(event.device_id), ChangeEvent::Inserted);
+      continue;
+    }
+
+    std::shared_ptr<USB::Device> device;
+    {
+      std::lock_guard<std::mutex> lk(m_devices_mutex);
+      const auto it = m_devices.find(event.device_id);
+      if (it == m_devices.end())
+        continue;
+      device = std::move(it->second);
+      m_devices.erase(it);
+    }
+    // A device that came and went since the last dispatch doesn't need any hook.
+    const auto hook = hooks.find(device);
+    if (hook != hooks.end())
+      hooks.erase(hook);
+    else
+      hooks.emplace(device, ChangeEvent::Removed);
+  }
+  DispatchHooks(hooks);
+}
+
 void USBHost::StartThreads()
 {
   if (Core::WantsDeterminism())
@@ -210,19 +377,33 @@ void USBHost::StartThreads()
 
   if (!m_scan_thread_running.IsSet())
   {
+    m_hotplug_enabled = StartHotplug();
     m_scan_thread_running.Set();
     m_scan_thread = std::thread([this] {
       Common::SetCurrentThreadName("USB Scan Thread");
+      auto whitelist = SConfig::GetInstance().m_usb_passthrough_devices;
       while (m_scan_thread_running.IsSet())
       {
-        UpdateDevices();
-        Common::SleepCurrentThread(50);
+        if (!m_hotplug_enabled)
+        {
+          UpdateDevices();
+          m_scan_thread_event.WaitFor(std::chrono::milliseconds(50));
+          continue;
+        }
+
+        HandleHotplugEvents();
+        // Devices that are already plugged in are not reported again when they get whitelisted.
+        if (whitelist != SConfig::GetInstance().m_usb_passthrough_devices)
+        {
+          whitelist = SConfig::GetInstance().m_usb_passthrough_devices;
+          UpdateDevices();
+        }
+        m_scan_thread_event.WaitFor(std::chrono::seconds(1));
       }
     });
   }
 
-#ifdef __LIBUSB__
-  if (!m_event_thread_running.IsSet() && m_libusb_context)
+  if (!m_event_thread_running.IsSet() && m_backend)
   {
     m_event_thread_running.Set();
     m_event_thread = std::thread([this] {
@@ -235,27 +416,33 @@ void USBHost::StartThreads()
           continue;
         }
 
-        static timeval tv = {0, 50000};
-        libusb_handle_events_timeout_completed(m_libusb_context, &tv, nullptr);
+        m_backend->HandleEvents(std::chrono::milliseconds(50));
       }
     });
   }
-#endif
 }
 
 void USBHost::StopThreads()
 {
+  if (m_hotplug_enabled)
+    m_backend->DeregisterHotplugCallbacks();
   if (m_scan_thread_running.TestAndClear())
+  {
+    m_scan_thread_event.Set();
     m_scan_thread.join();
+  }
+  m_hotplug_enabled = false;
+  {
+    std::lock_guard<std::mutex> lk(m_hotplug_events_mutex);
+    m_hotplug_events.clear();
+  }
 
   // Clear all devices and dispatch removal hooks.
   DeviceChangeHooks hooks;
   DetectRemovedDevices(std::set<u64>(), hooks);
   DispatchHooks(hooks);
-#ifdef __LIBUSB__
   if (m_event_thread_running.TestAndClear())
     m_event_thread.join();
-#endif
 }
 
 IPCCommandResult USBHost::HandleTransfer(std::shared_ptr<USB::Device> device, u32 request,
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <map>
@@ -15,13 +16,13 @@
 #include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Core/IOS/Device.h"
 #include "Core/IOS/IOS.h"
 #include "Core/IOS/USB/Common.h"
 
 class PointerWrap;
-struct libusb_context;
 
 namespace IOS
 {
@@ -29,11 +30,36 @@ namespace HLE
 {
 namespace Device
 {
+// Where USBHost gets its devices from (libusb, normally).
+class USBHostBackend
+{
+public:
+  using DeviceFilter = std::function<bool(u16 vid, u16 pid)>;
+  using InsertCallback = std::function<void(std::unique_ptr<USB::Device> device)>;
+  using RemoveCallback = std::function<void(u64 device_id)>;
+
+  virtual ~USBHostBackend() = default;
+
+  // Lists the plugged devices that pass the filter. Returns false if they couldn't be listed.
+  virtual bool GetDevices(const DeviceFilter& filter,
+                          std::vector<std::unique_ptr<USB::Device>>& devices) = 0;
+  // Reports devices that pass the filter as they are plugged in and unplugged, including the ones
+  // that are plugged in already. Returns false if the backend can't, in which case it has to be
+  // polled with GetDevices.
+  virtual bool RegisterHotplugCallbacks(DeviceFilter filter, InsertCallback on_insert,
+                                        RemoveCallback on_remove) = 0;
+  virtual void DeregisterHotplugCallbacks() = 0;
+  // Waits up to timeout for transfers to complete and devices to be (un)plugged, and handles that.
+  // The hotplug callbacks are called from here.
+  virtual void HandleEvents(std::chrono::milliseconds timeout) = 0;
+};
+
 // Common base class for USB host devices (such as /dev/usb/oh0 and /dev/usb/ven).
 class USBHost : public Device
 {
 public:
   USBHost(Kernel& ios, const std::string& device_name);
+  USBHost(Kernel& ios, const std::string& device_name, std::unique_ptr<USBHostBackend> backend);
   virtual ~USBHost();
 
   ReturnCode Open(const OpenRequest& request) override;
@@ -63,6 +89,13 @@ protected:
                                   std::function<s32()> submit) const;
 
 private:
+  // A device that was plugged in (device is set) or unplugged, as reported by the backend.
+  struct HotplugEvent
+  {
+    u64 device_id;
+    std::unique_ptr<USB::Device> device;
+  };
+
   bool AddDevice(std::unique_ptr<USB::Device> device);
   bool UpdateDevices(bool always_add_hooks = false);
 
@@ -70,16 +103,23 @@ private:
   void DetectRemovedDevices(const std::set<u64>& plugged_devices, DeviceChangeHooks& hooks);
   void DispatchHooks(const DeviceChangeHooks& hooks);
 
-#ifdef __LIBUSB__
-  libusb_context* m_libusb_context = nullptr;
+  bool StartHotplug();
+  void HandleHotplugEvents();
 
-  // Event thread for libusb
+  std::unique_ptr<USBHostBackend> m_backend;
+
+  // Event thread for the backend
   Common::Flag m_event_thread_running;
   std::thread m_event_thread;
-#endif
-  // Device scanning thread
+
+  // Device scanning thread. With hotplug support, it only handles the events the backend
+  // reported; otherwise it rescans every 50 ms.
   Common::Flag m_scan_thread_running;
   std::thread m_scan_thread;
+  Common::Event m_scan_thread_event;
+  bool m_hotplug_enabled = false;
+  std::vector<HotplugEvent> m_hotplug_events;
+  std::mutex m_hotplug_events_mutex;
 };
 }  // namespace Device
 }  // namespace HLE
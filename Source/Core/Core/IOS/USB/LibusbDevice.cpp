@@ -35,14 +35,20 @@ LibusbDevice::LibusbDevice(Kernel& ios, libusb_device* device,
   libusb_ref_device(m_device);
   m_vid = descriptor.idVendor;
   m_pid = descriptor.idProduct;
-  m_id = (static_cast<u64>(m_vid) << 32 | static_cast<u64>(m_pid) << 16 |
-          static_cast<u64>(libusb_get_bus_number(device)) << 8 |
-          static_cast<u64>(libusb_get_device_address(device)));
+  m_id = MakeId(device, descriptor);
 
   for (u8 i = 0; i < descriptor.bNumConfigurations; ++i)
     m_config_descriptors.emplace_back(std::make_unique<LibusbConfigDescriptor>(m_device, i));
 }
 
+u64 LibusbDevice::MakeId(libusb_device* device, const libusb_device_descriptor& descriptor)
+{
+  return static_cast<u64>(descriptor.idVendor) << 32 |
+         static_cast<u64>(descriptor.idProduct) << 16 |
+         static_cast<u64>(libusb_get_bus_number(device)) << 8 |
+         static_cast<u64>(libusb_get_device_address(device));
+}
+
 LibusbDevice::~LibusbDevice()
 {
   if (m_device_attached)
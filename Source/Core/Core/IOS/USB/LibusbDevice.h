@@ -46,6 +46,8 @@ public:
   LibusbDevice(Kernel& ios, libusb_device* device,
                const libusb_device_descriptor& device_descriptor);
   ~LibusbDevice();
+  // The ID a LibusbDevice for this device gets. Also works for devices that were just unplugged.
+  static u64 MakeId(libusb_device* device, const libusb_device_descriptor& descriptor);
   DeviceDescriptor GetDeviceDescriptor() const override;
   std::vector<ConfigDescriptor> GetConfigurations() const override;
   std::vector<InterfaceDescriptor> GetInterfaces(u8 config) const override;
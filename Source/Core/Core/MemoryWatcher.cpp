@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -9,6 +11,8 @@
 #include <unistd.h>
 
 #include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Swap.h"
 #include "Core/CoreTiming.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
@@ -17,6 +21,8 @@
 static std::unique_ptr<MemoryWatcher> s_memory_watcher;
 static CoreTiming::EventType* s_event;
 static const int MW_RATE = 600;  // Steps per second
+// Changes beyond this are sent in further datagrams, to stay below the socket buffer size.
+static const size_t MAX_MESSAGE_SIZE = 0x10000;
 
 static void MWCallback(u64 userdata, s64 cyclesLate)
 {
@@ -38,11 +44,17 @@ void MemoryWatcher::Shutdown()
 }
 
 MemoryWatcher::MemoryWatcher()
+    : MemoryWatcher(File::GetUserPath(F_MEMORYWATCHERLOCATIONS_IDX),
+                    File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX))
+{
+}
+
+MemoryWatcher::MemoryWatcher(const std::string& locations_path, const std::string& socket_path)
 {
   m_running = false;
-  if (!LoadAddresses(File::GetUserPath(F_MEMORYWATCHERLOCATIONS_IDX)))
+  if (!LoadAddresses(locations_path))
     return;
-  if (!OpenSocket(File::GetUserPath(F_MEMORYWATCHERSOCKET_IDX)))
+  if (!OpenSocket(socket_path))
     return;
   m_running = true;
 }
@@ -66,19 +78,24 @@ bool MemoryWatcher::LoadAddresses(const std::string& path)
   while (std::getline(locations, line))
     ParseLine(line);
 
-  return m_values.size() > 0;
+  return m_watches.size() > 0;
 }
 
 void MemoryWatcher::ParseLine(const std::string& line)
 {
-  m_values[line] = 0;
-  m_addresses[line] = std::vector<u32>();
+  Watch watch;
+  watch.line = line;
 
   std::stringstream offsets(line);
   offsets >> std::hex;
   u32 offset;
   while (offsets >> offset)
-    m_addresses[line].push_back(offset);
+    watch.offsets.push_back(offset);
+
+  const bool duplicate = std::any_of(m_watches.begin(), m_watches.end(),
+                                     [&line](const Watch& other) { return other.line == line; });
+  if (!watch.offsets.empty() && !duplicate)
+    m_watches.push_back(std::move(watch));
 }
 
 bool MemoryWatcher::OpenSocket(const std::string& path)
@@ -91,19 +108,93 @@ bool MemoryWatcher::OpenSocket(const std::string& path)
   return m_fd >= 0;
 }
 
-u32 MemoryWatcher::ChasePointer(const std::string& line)
+void MemoryWatcher::UpdateDirtyPages()
 {
+  for (auto& entry : m_pages)
+  {
+    Page& page = entry.second;
+    page.dirty = std::memcmp(page.shadow.data(), entry.first, WATCH_PAGE_SIZE) != 0;
+    if (page.dirty)
+      std::memcpy(page.shadow.data(), entry.first, WATCH_PAGE_SIZE);
+  }
+}
+
+bool MemoryWatcher::AnyDirty(const std::vector<const u8*>& pages) const
+{
+  return std::any_of(pages.begin(), pages.end(),
+                     [this](const u8* page) { return m_pages.at(page).dirty; });
+}
+
+u32 MemoryWatcher::ReadValue(u32 address, std::vector<const u8*>* pages)
+{
+  const u8* pointer = Memory::GetPointer(address);
+  if (!pointer)
+    return 0;
+
+  if (pages)
+  {
+    const u32 page_offset = address & (WATCH_PAGE_SIZE - 1);
+    pages->push_back(pointer - page_offset);
+    if (page_offset > WATCH_PAGE_SIZE - sizeof(u32))
+      pages->push_back(pointer - page_offset + WATCH_PAGE_SIZE);
+  }
+
+  u32 value;
+  std::memcpy(&value, pointer, sizeof(u32));
+  return Common::swap32(value);
+}
+
+void MemoryWatcher::TrackPages(std::vector<const u8*>* tracked, std::vector<const u8*> pages)
+{
+  std::sort(pages.begin(), pages.end());
+  pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+
+  // Pages that start being watched are compared against their current contents from the next
+  // step on, as the value that was just read is already up to date.
+  for (const u8* host_page : pages)
+  {
+    Page& page = m_pages[host_page];
+    if (page.watch_count++ == 0)
+      page.shadow.assign(host_page, host_page + WATCH_PAGE_SIZE);
+  }
+
+  for (const u8* host_page : *tracked)
+  {
+    const auto it = m_pages.find(host_page);
+    if (--it->second.watch_count == 0)
+      m_pages.erase(it);
+  }
+
+  *tracked = std::move(pages);
+}
+
+void MemoryWatcher::ChasePointer(Watch* watch)
+{
+  std::vector<const u8*> chain_pages;
   u32 value = 0;
-  for (u32 offset : m_addresses[line])
-    value = Memory::Read_U32(value + offset);
-  return value;
+  for (size_t i = 0; i + 1 < watch->offsets.size(); ++i)
+    value = ReadValue(value + watch->offsets[i], &chain_pages);
+
+  std::vector<const u8*> value_pages;
+  watch->address = value + watch->offsets.back();
+  watch->value = ReadValue(watch->address, &value_pages);
+  watch->resolved = true;
+
+  TrackPages(&watch->chain_pages, std::move(chain_pages));
+  TrackPages(&watch->value_pages, std::move(value_pages));
 }
 
-std::string MemoryWatcher::ComposeMessage(const std::string& line, u32 value)
+void MemoryWatcher::AppendMessage(std::string* message, const Watch& watch) const
 {
-  std::stringstream message_stream;
-  message_stream << line << '\n' << std::hex << value;
-  return message_stream.str();
+  if (!message->empty())
+    *message += '\n';
+  *message += StringFromFormat("%s\n%x", watch.line.c_str(), watch.value);
+}
+
+void MemoryWatcher::SendMessage(const std::string& message) const
+{
+  sendto(m_fd, message.c_str(), message.size() + 1, 0,
+         reinterpret_cast<const sockaddr*>(&m_addr), sizeof(m_addr));
 }
 
 void MemoryWatcher::Step()
@@ -111,19 +202,32 @@ void MemoryWatcher::Step()
   if (!m_running)
     return;
 
-  for (auto& entry : m_values)
+  UpdateDirtyPages();
+
+  std::string message;
+  for (Watch& watch : m_watches)
   {
-    std::string address = entry.first;
-    u32& current_value = entry.second;
+    const u32 old_value = watch.value;
+    if (!watch.resolved || AnyDirty(watch.chain_pages))
+    {
+      ChasePointer(&watch);
+    }
+    else if (AnyDirty(watch.value_pages))
+    {
+      watch.value = ReadValue(watch.address, nullptr);
+    }
 
-    u32 new_value = ChasePointer(address);
-    if (new_value != current_value)
+    if (watch.value == old_value)
+      continue;
+
+    AppendMessage(&message, watch);
+    if (message.size() >= MAX_MESSAGE_SIZE)
     {
-      // Update the value
-      current_value = new_value;
-      std::string message = ComposeMessage(address, new_value);
-      sendto(m_fd, message.c_str(), message.size() + 1, 0, reinterpret_cast<sockaddr*>(&m_addr),
-             sizeof(m_addr));
+      SendMessage(message);
+      message.clear();
     }
   }
+
+  if (!message.empty())
+    SendMessage(message);
 }
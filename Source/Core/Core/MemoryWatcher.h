@@ -4,44 +4,83 @@
 
 #pragma once
 
-#include <map>
+#include <string>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <unordered_map>
 #include <vector>
 
+#include "Common/CommonTypes.h"
+
 // MemoryWatcher reads a file containing in-game memory addresses and outputs
 // changes to those memory addresses to a unix domain socket as the game runs.
 //
 // The input file is a newline-separated list of hex memory addresses, without
 // the "0x". To follow pointers, separate addresses with a space. For example,
 // "ABCD EF" will watch the address at (*0xABCD) + 0xEF.
-// The output to the socket is two lines. The first is the address from the
-// input file, and the second is the new value in hex.
+// Each change is output as two lines. The first is the address from the
+// input file, and the second is the new value in hex. All changes of a step
+// are sent in a single NUL-terminated datagram, one change after the other.
 class MemoryWatcher final
 {
 public:
   MemoryWatcher();
+  MemoryWatcher(const std::string& locations_path, const std::string& socket_path);
   ~MemoryWatcher();
   void Step();
 
+  bool IsRunning() const { return m_running; }
+
   static void Init();
   static void Shutdown();
 
 private:
+  // Only the memory pages that watched values or pointers live in are checked every step, by
+  // comparing them against a copy from the previous step. Watches that don't depend on any page
+  // that changed are skipped entirely.
+  static constexpr u32 WATCH_PAGE_SIZE = 0x1000;
+
+  struct Page
+  {
+    std::vector<u8> shadow;
+    u32 watch_count = 0;
+    bool dirty = false;
+  };
+
+  struct Watch
+  {
+    // Address as stored in the file
+    std::string line;
+    // Offsets to follow
+    std::vector<u32> offsets;
+    // Host pages of the pointers followed the last time the chain was resolved. The chain is
+    // only resolved again once one of them changes.
+    std::vector<const u8*> chain_pages;
+    // Address of the value as of the last time the chain was resolved, and its host pages
+    u32 address = 0;
+    std::vector<const u8*> value_pages;
+    bool resolved = false;
+    u32 value = 0;
+  };
+
   bool LoadAddresses(const std::string& path);
   bool OpenSocket(const std::string& path);
 
   void ParseLine(const std::string& line);
-  u32 ChasePointer(const std::string& line);
-  std::string ComposeMessage(const std::string& line, u32 value);
+  void UpdateDirtyPages();
+  // Reads a u32, and adds the host pages it spans to pages if that isn't null.
+  static u32 ReadValue(u32 address, std::vector<const u8*>* pages);
+  bool AnyDirty(const std::vector<const u8*>& pages) const;
+  void TrackPages(std::vector<const u8*>* tracked, std::vector<const u8*> pages);
+  void ChasePointer(Watch* watch);
+  void AppendMessage(std::string* message, const Watch& watch) const;
+  void SendMessage(const std::string& message) const;
 
   bool m_running;
 
   int m_fd;
   sockaddr_un m_addr;
 
-  // Address as stored in the file -> list of offsets to follow
-  std::map<std::string, std::vector<u32>> m_addresses;
-  // Address as stored in the file -> current value
-  std::map<std::string, u32> m_values;
+  std::vector<Watch> m_watches;
+  std::unordered_map<const u8*, Page> m_pages;
 };
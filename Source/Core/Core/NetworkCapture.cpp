@@ -0,0 +1,77 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/NetworkCapture.h"
+
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <string>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/PcapFile.h"
+#include "Core/ConfigManager.h"
+
+namespace NetworkCapture
+{
+constexpr size_t NUM_STREAMS = static_cast<size_t>(Stream::NumStreams);
+
+static constexpr std::array<const char*, NUM_STREAMS> STREAM_NAMES = {{
+    "bba", "socket_send", "socket_recv", "ssl_write", "ssl_read",
+}};
+
+static std::atomic<bool> s_enabled{false};
+static std::array<std::unique_ptr<AsyncPCAP>, NUM_STREAMS> s_streams;
+
+void Start(u32 snap_length, u64 rotate_size, u32 max_files)
+{
+  Stop();
+
+  const std::string directory = File::GetUserPath(D_DUMP_IDX) + "Network" DIR_SEP;
+  File::CreateFullPath(directory);
+
+  for (size_t i = 0; i < NUM_STREAMS; ++i)
+  {
+    AsyncPCAP::Options options;
+    options.data_link_type = static_cast<Stream>(i) == Stream::BBA ? PCAP::LINK_TYPE_ETHERNET :
+                                                                      PCAP::LINK_TYPE_USER;
+    options.snap_length = snap_length;
+    options.rotate_size = rotate_size;
+    options.max_files = max_files;
+    const std::string path =
+        directory + SConfig::GetInstance().GetGameID() + "_" + STREAM_NAMES[i] + ".pcap";
+    s_streams[i] = std::make_unique<AsyncPCAP>(path, options);
+  }
+
+  NOTICE_LOG(CORE, "Capturing network traffic to %s", directory.c_str());
+  s_enabled.store(true);
+}
+
+void Stop()
+{
+  if (!s_enabled.exchange(false))
+    return;
+
+  for (size_t i = 0; i < NUM_STREAMS; ++i)
+  {
+    const AsyncPCAP::Stats stats = s_streams[i]->GetStats();
+    if (stats.packets != 0 || stats.dropped != 0)
+    {
+      NOTICE_LOG(CORE,
+                 "Captured %" PRIu64 " %s packets (%" PRIu64 " bytes) in %u files, dropped %" PRIu64,
+                 stats.packets, STREAM_NAMES[i], stats.bytes, stats.files, stats.dropped);
+    }
+    s_streams[i].reset();
+  }
+}
+
+void AddPacket(Stream stream, const u8* data, size_t size)
+{
+  if (s_enabled.load(std::memory_order_relaxed))
+    s_streams[static_cast<size_t>(stream)]->AddPacket(data, size);
+}
+}  // namespace NetworkCapture
@@ -0,0 +1,35 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Captures what the emulated network devices send and receive into PCAP files in Dump/Network/,
+// for inspection with Wireshark. Files are written by separate threads; packets that don't fit in
+// their buffers are dropped and counted, so capturing doesn't change the timing of the emulation.
+
+#pragma once
+
+#include <cstddef>
+
+#include "Common/CommonTypes.h"
+
+namespace NetworkCapture
+{
+enum class Stream
+{
+  // Ethernet frames of the broadband adapter.
+  BBA,
+  // Payloads of the IOS sockets, and the decrypted data of IOS SSL connections.
+  SocketSend,
+  SocketRecv,
+  SSLWrite,
+  SSLRead,
+  NumStreams
+};
+
+// snap_length truncates packets, rotate_size (in bytes, or 0) starts a new file whenever one gets
+// this big and max_files (or 0) limits how many files of a stream are kept.
+void Start(u32 snap_length, u64 rotate_size, u32 max_files);
+void Stop();
+
+void AddPacket(Stream stream, const u8* data, size_t size);
+}  // namespace NetworkCapture
@@ -0,0 +1,151 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Core/PowerPC/BusyWait.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Core/CoreTiming.h"
+#include "Core/FrameTelemetry.h"
+#include "Core/HW/MMIO.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PowerPC.h"
+
+namespace BusyWait
+{
+// How many loops LogStats shows.
+constexpr size_t LOGGED_LOOPS = 10;
+
+static std::map<u32, Loop> s_loops;
+
+u32 GetLoadSize(UGeckoInstruction inst)
+{
+  switch (inst.OPCD)
+  {
+  case 32:  // lwz
+    return 32;
+  case 34:  // lbz
+    return 8;
+  case 40:  // lhz
+  case 42:  // lha
+    return 16;
+  case 31:
+    switch (inst.SUBOP10)
+    {
+    case 23:   // lwzx
+    case 534:  // lwbrx
+      return 32;
+    case 87:  // lbzx
+      return 8;
+    case 279:  // lhzx
+    case 343:  // lhax
+    case 790:  // lhbrx
+      return 16;
+    }
+    break;
+  }
+  return 0;
+}
+
+Loop* GetLoop(u32 loop_address, u32 branch_address)
+{
+  Loop& loop = s_loops[loop_address];
+  loop.stats.address = loop_address;
+
+  // The code may have changed since the loop was last compiled.
+  loop.given_up = false;
+  loop.misses_in_a_row = 0;
+  loop.loads.clear();
+  for (u32 address = loop_address; address != branch_address; address += 4)
+  {
+    const UGeckoInstruction inst{PowerPC::HostRead_Instruction(address)};
+    if (GetLoadSize(inst) != 0)
+      loop.loads.push_back(inst);
+  }
+  return &loop;
+}
+
+static void Miss(Loop* loop)
+{
+  loop->stats.misses++;
+  if (++loop->misses_in_a_row >= MAX_MISSES_IN_A_ROW)
+    loop->given_up = true;
+}
+
+void Skip(Loop* loop)
+{
+  u64 next_change = std::numeric_limits<u64>::max();
+  u32 register_address = 0;
+  for (const UGeckoInstruction inst : loop->loads)
+  {
+    // The loop doesn't change the registers it computes addresses from.
+    const u32 size = GetLoadSize(inst);
+    const u32 base = inst.RA ? GPR(inst.RA) : 0;
+    const u32 effective_address = base + (inst.OPCD == 31 ? GPR(inst.RB) : u32(inst.SIMM_16));
+    register_address = PowerPC::IsOptimizableMMIOAccess(effective_address, size);
+    if (register_address == 0)
+    {
+      Miss(loop);
+      return;
+    }
+    next_change =
+        std::min(next_change, Memory::mmio_mapping->GetNextChange(register_address, size / 8));
+  }
+
+  const u64 ticks = CoreTiming::GetTicks();
+  if (register_address == 0 || next_change <= ticks)
+  {
+    Miss(loop);
+    return;
+  }
+
+  CoreTiming::IdleUntil(next_change);
+  loop->misses_in_a_row = 0;
+  loop->stats.register_address = register_address;
+  loop->stats.skips++;
+  loop->stats.skipped_cycles += CoreTiming::GetTicks() - ticks;
+  FrameTelemetry::Increment(FrameTelemetry::Counter::BusyWaitSkips);
+}
+
+std::vector<LoopStats> GetStats()
+{
+  std::vector<LoopStats> stats;
+  stats.reserve(s_loops.size());
+  for (const auto& entry : s_loops)
+  {
+    if (entry.second.stats.skips != 0 || entry.second.stats.misses != 0)
+      stats.push_back(entry.second.stats);
+  }
+  std::stable_sort(stats.begin(), stats.end(), [](const LoopStats& a, const LoopStats& b) {
+    return a.skipped_cycles > b.skipped_cycles;
+  });
+  return stats;
+}
+
+void LogStats()
+{
+  const std::vector<LoopStats> stats = GetStats();
+  for (size_t i = 0; i < std::min(stats.size(), LOGGED_LOOPS) && stats[i].skips != 0; ++i)
+  {
+    NOTICE_LOG(POWERPC,
+               "Busy-wait loop at %08x polling %08x: skipped %" PRIu64 " times (%" PRIu64
+               " cycles), ran %" PRIu64 " times",
+               stats[i].address, stats[i].register_address, stats[i].skips,
+               stats[i].skipped_cycles, stats[i].misses);
+  }
+}
+
+void ResetStats()
+{
+  // Compiled code may still point to the loops.
+  for (auto& entry : s_loops)
+    entry.second.stats = {entry.first};
+}
+}  // namespace BusyWait
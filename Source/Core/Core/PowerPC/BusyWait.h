@@ -0,0 +1,63 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Games often wait for the hardware by reading a register in a loop, e.g. until the DSP has sent
+// mail, the GPU has reached a PE token or VI has reached a line. PPCAnalyst finds loops that do
+// nothing else, and the JIT calls Skip whenever one is about to go round again. Since registers
+// only change in CoreTiming events (unless they say otherwise, see MMIO::Mapping::
+// RegisterNextChange), the CPU can idle until then instead of running the loop thousands of times.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/PowerPC/Gekko.h"
+
+namespace BusyWait
+{
+// Including the branch back to the start.
+constexpr u32 MAX_LOOP_LENGTH = 8;
+
+// The size in bits of the loads a busy-wait loop may use, or 0 if inst isn't one.
+u32 GetLoadSize(UGeckoInstruction inst);
+
+struct LoopStats
+{
+  u32 address;
+  // The (physical) address of the register polled the last time the loop was skipped.
+  u32 register_address;
+  u64 skips;
+  // How often the loop went round without being skipped, because it read RAM or a register that
+  // can change at any time.
+  u64 misses;
+  u64 skipped_cycles;
+};
+
+// After going round this many times in a row without being skipped, a loop is given up on.
+constexpr u32 MAX_MISSES_IN_A_ROW = 64;
+
+struct Loop
+{
+  // Read by compiled code, which stops calling Skip once it is set.
+  bool given_up = false;
+  u32 misses_in_a_row = 0;
+  // The loads in the loop, decoded when it was compiled.
+  std::vector<UGeckoInstruction> loads;
+  LoopStats stats = {};
+};
+
+// Called when the loop starting at loop_address and ending with the branch at branch_address is
+// compiled. Compiled code keeps the pointer, so loops are never freed.
+Loop* GetLoop(u32 loop_address, u32 branch_address);
+
+// Called when the loop is about to be run again by its branch. Idles if every load in it reads
+// a register.
+void Skip(Loop* loop);
+
+// Most skipped cycles first.
+std::vector<LoopStats> GetStats();
+void LogStats();
+void ResetStats();
+}  // namespace BusyWait
@@ -4,8 +4,10 @@
 
 #include "Core/PowerPC/Jit64/Jit.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 // for the PROFILER stuff
 #ifdef _WIN32
@@ -143,6 +145,14 @@ enum
   GUARD_OFFSET = STACK_SIZE - SAFE_STACK_SIZE - GUARD_SIZE,
 };
 
+// The first hot layout happens once the game has been running for a while, so that it's mostly
+// running its main loop rather than loading.
+constexpr u32 HOT_LAYOUT_WARMUP_FRAMES = 600;
+// After that, it's repeated every so often, since which code is hot changes from scene to scene.
+constexpr u32 HOT_LAYOUT_INTERVAL_FRAMES = 1800;
+// Blocks that ran at least 1/HOT_RUN_COUNT_FRACTION as often as the hottest one are hot.
+constexpr int HOT_RUN_COUNT_FRACTION = 64;
+
 void Jit64::AllocStack()
 {
 #ifndef _WIN32
@@ -225,7 +235,10 @@ void Jit64::Init()
   const size_t trampolines_size = jo.memcheck ? TRAMPOLINE_CODE_SIZE_MMU : TRAMPOLINE_CODE_SIZE;
   const size_t farcode_size = jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE;
   const size_t constpool_size = m_const_pool.CONST_POOL_SIZE;
-  AllocCodeSpace(CODE_SIZE + routines_size + trampolines_size + farcode_size + constpool_size);
+  AllocCodeSpace(CODE_SIZE + HOT_CODE_SIZE + routines_size + trampolines_size + farcode_size +
+                     constpool_size,
+                 SConfig::GetInstance().bHugePages);
+  AddChildCodeSpace(&m_hot_code, HOT_CODE_SIZE);
   AddChildCodeSpace(&asm_routines, routines_size);
   AddChildCodeSpace(&trampolines, trampolines_size);
   AddChildCodeSpace(&m_far_code, farcode_size);
@@ -241,6 +254,10 @@ void Jit64::Init()
   if (m_enable_blr_optimization)
     AllocStack();
 
+  m_hot_layout = SConfig::GetInstance().bJITHotLayout;
+  m_frames_until_relayout = HOT_LAYOUT_WARMUP_FRAMES;
+  m_relayout_pending = false;
+
   blocks.Init();
   asm_routines.Init(m_stack ? (m_stack + STACK_SIZE) : nullptr);
 
@@ -261,6 +278,9 @@ void Jit64::ClearCache()
   blocks.Clear();
   trampolines.ClearCodeSpace();
   m_far_code.ClearCodeSpace();
+  m_hot_code.ClearCodeSpace();
+  m_frames_until_relayout = HOT_LAYOUT_WARMUP_FRAMES;
+  m_relayout_pending = false;
   m_const_pool.Clear();
   ClearCodeSpace();
   Clear();
@@ -558,6 +578,22 @@ void Jit64::Jit(u32 em_address)
 #endif
   }
 
+  if (m_relayout_pending)
+  {
+    m_relayout_pending = false;
+    // Breakpoints, stepping and profiling need every block to be compiled the way it is below.
+    if (!SConfig::GetInstance().bJITNoBlockCache && !SConfig::GetInstance().bEnableDebugging &&
+        !CPU::IsStepping() && !Profiler::g_ProfileBlocks)
+    {
+      // Blocks that were moved before keep their space until the cache is cleared, so once it's
+      // full, start over.
+      if (m_hot_code.IsAlmostFull())
+        ClearCache();
+      else
+        RelayoutHotBlocks();
+    }
+  }
+
   if (IsAlmostFull() || m_far_code.IsAlmostFull() || trampolines.IsAlmostFull() ||
       SConfig::GetInstance().bJITNoBlockCache)
   {
@@ -611,6 +647,69 @@ void Jit64::Jit(u32 em_address)
   blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
 }
 
+void Jit64::EndFrame()
+{
+  if (!m_hot_layout || --m_frames_until_relayout != 0)
+    return;
+
+  m_frames_until_relayout = HOT_LAYOUT_INTERVAL_FRAMES;
+  // This is called in the middle of a block, which the relayout could move, so it waits until the
+  // next block is compiled.
+  m_relayout_pending = true;
+}
+
+void Jit64::RelayoutHotBlocks()
+{
+  int max_run_count = 0;
+  blocks.RunOnBlocks([&max_run_count](const JitBlock& block) {
+    max_run_count = std::max(max_run_count, block.runCount);
+  });
+  if (max_run_count == 0)
+    return;
+
+  // Blocks can only be compiled for the current MSR, and blocks in m_hot_code don't count their
+  // runs (and are where they should be anyway).
+  const u32 msr_bits = MSR & JitBaseBlockCache::JIT_CACHE_MSR_MASK;
+  std::vector<u32> addresses;
+  for (const JitBlock* block :
+       blocks.GetHotBlockLayout(std::max(1, max_run_count / HOT_RUN_COUNT_FRACTION)))
+  {
+    if (block->msrBits == msr_bits && !m_hot_code.IsInSpace(block->checkedEntry))
+      addresses.push_back(block->effectiveAddress);
+  }
+  blocks.ResetRunCounts();
+
+  u8* const near_code = GetWritableCodePtr();
+  SetCodePtr(m_hot_code.GetWritableCodePtr());
+  size_t relaid_blocks = 0;
+  for (u32 address : addresses)
+  {
+    if (m_hot_code.IsAlmostFull() || m_far_code.IsAlmostFull() || trampolines.IsAlmostFull())
+      break;
+
+    JitBlock* old_block = blocks.GetBlockFromStartAddress(address, MSR);
+    if (!old_block)
+      continue;
+
+    const u32 nextPC = analyzer.Analyze(address, &code_block, &code_buffer, code_buffer.GetSize());
+    if (code_block.m_memory_exception)
+      continue;
+
+    // Only the entry points of the old block are overwritten, so anything returning into the
+    // middle of it (see m_enable_blr_optimization) still works.
+    blocks.EraseBlock(*old_block);
+    JitBlock* b = blocks.AllocateBlock(address);
+    DoJit(address, &code_buffer, b, nextPC);
+    blocks.FinalizeBlock(*b, jo.enableBlocklink, code_block.m_physical_addresses);
+    m_hot_code.SetCodePtr(GetWritableCodePtr());
+    relaid_blocks++;
+  }
+  SetCodePtr(near_code);
+
+  INFO_LOG(DYNA_REC, "Moved %zu hot blocks to the hot code region (%zu bytes left)", relaid_blocks,
+           m_hot_code.GetSpaceLeft());
+}
+
 const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBlock* b, u32 nextPC)
 {
   js.firstFPInstructionFound = false;
@@ -658,6 +757,11 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer* code_buf, JitBloc
     // get start tic
     PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
   }
+  else if (m_hot_layout && !m_hot_code.IsInSpace(start))
+  {
+    MOV(64, R(RSCRATCH), ImmPtr(&b->runCount));
+    ADD(32, MatR(RSCRATCH), Imm8(1));
+  }
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
   // should help logged stack-traces become more accurate
   MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
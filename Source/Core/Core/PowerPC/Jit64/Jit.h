@@ -39,6 +39,7 @@ public:
 
   bool HandleFault(uintptr_t access_address, SContext* ctx) override;
   bool HandleStackFault() override;
+  void EndFrame() override;
 
   void EnableOptimization();
   void EnableBlockLink();
@@ -72,6 +73,7 @@ public:
   void WriteExitDestInRSCRATCH(bool bl = false, u32 after = 0);
   void WriteBLRExit();
   void WriteExceptionExit();
+  void WriteBusyWaitSkip(const PPCAnalyst::CodeOp& branch);
   void WriteExternalExceptionExit();
   void WriteRfiExitDestInRSCRATCH();
   bool Cleanup();
@@ -237,6 +239,9 @@ private:
   void AllocStack();
   void FreeStack();
 
+  // Recompiles the hottest blocks next to each other in m_hot_code.
+  void RelayoutHotBlocks();
+
   GPRRegCache gpr{*this};
   FPURegCache fpr{*this};
 
@@ -248,4 +253,10 @@ private:
   bool m_enable_blr_optimization;
   bool m_cleanup_after_stackfault;
   u8* m_stack;
+
+  // Whether blocks outside m_hot_code count their runs, so that RelayoutHotBlocks can be used.
+  bool m_hot_layout;
+  u32 m_frames_until_relayout;
+  // Set by EndFrame, and handled by Jit() when no block is running.
+  bool m_relayout_pending;
 };
@@ -7,6 +7,8 @@
 #include "Common/CommonTypes.h"
 #include "Common/x64Emitter.h"
 #include "Core/CoreTiming.h"
+#include "Core/HW/CPU.h"
+#include "Core/PowerPC/BusyWait.h"
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/Jit64/JitRegCache.h"
 #include "Core/PowerPC/Jit64Common/Jit64PowerPCState.h"
@@ -108,6 +110,23 @@ void Jit64::bx(UGeckoInstruction inst)
   WriteExit(destination, inst.LK, js.compilerPC + 4);
 }
 
+// Goes on the path where a busy-wait loop found by PPCAnalyst goes round again.
+void Jit64::WriteBusyWaitSkip(const PPCAnalyst::CodeOp& branch)
+{
+  if (!branch.isBusyWaitLoop || CPU::IsStepping())
+    return;
+
+  BusyWait::Loop* loop = BusyWait::GetLoop(js.blockStart, branch.address);
+  MOV(64, R(RSCRATCH), ImmPtr(&loop->given_up));
+  CMP(8, MatR(RSCRATCH), Imm8(0));
+  FixupBranch given_up = J_CC(CC_NZ);
+  ABI_PushRegistersAndAdjustStack({}, 0);
+  MOV(64, R(ABI_PARAM1), ImmPtr(loop));
+  ABI_CallFunction(BusyWait::Skip);
+  ABI_PopRegistersAndAdjustStack({}, 0);
+  SetJumpTarget(given_up);
+}
+
 // TODO - optimize to hell and beyond
 // TODO - make nice easy to optimize special cases for the most common
 // variants of this instruction.
@@ -162,6 +181,7 @@ void Jit64::bcx(UGeckoInstruction inst)
 
   gpr.Flush(RegCache::FlushMode::MaintainState);
   fpr.Flush(RegCache::FlushMode::MaintainState);
+  WriteBusyWaitSkip(*js.op);
   WriteExit(destination, inst.LK, js.compilerPC + 4);
 
   if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
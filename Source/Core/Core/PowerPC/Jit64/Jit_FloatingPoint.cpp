@@ -245,8 +245,18 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
   bool packed = inst.OPCD == 4 || (!cpu_info.bAtom && single && js.op->fprIsDuplicated[a] &&
                                    js.op->fprIsDuplicated[b] && js.op->fprIsDuplicated[c]);
 
+  // While we don't know if any games are actually affected (replays seem to work with all the usual
+  // suspects for desyncing), netplay and other applications need absolute perfect determinism, so
+  // be extra careful and don't use FMA, even if in theory it might be okay.
+  // Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
+  // to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
+  // instances on different computers giving identical results.
+  const bool use_fma = cpu_info.bFMA && !Core::WantsDeterminism();
+
   fpr.Lock(a, b, c, d);
 
+  // What a is multiplied by when not using FMA.
+  OpArg product_source = R(XMM1);
   switch (inst.SUBOP5)
   {
   case 14:
@@ -260,23 +270,21 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
       Force25BitPrecision(XMM1, R(XMM1), XMM0);
     break;
   default:
-    bool special = inst.SUBOP5 == 30 && (!cpu_info.bFMA || Core::WantsDeterminism());
+    bool special = inst.SUBOP5 == 30 && !use_fma;
     X64Reg tmp1 = special ? XMM0 : XMM1;
     X64Reg tmp2 = special ? XMM1 : XMM0;
+    product_source = R(tmp1);
     if (single && round_input)
       Force25BitPrecision(tmp1, fpr.R(c), tmp2);
+    // With AVX, the multiplication can read c from its register instead of a copy.
+    else if (!use_fma && cpu_info.bAVX && fpr.R(c).IsSimpleReg())
+      product_source = fpr.R(c);
     else
       MOVAPD(tmp1, fpr.R(c));
     break;
   }
 
-  // While we don't know if any games are actually affected (replays seem to work with all the usual
-  // suspects for desyncing), netplay and other applications need absolute perfect determinism, so
-  // be extra careful and don't use FMA, even if in theory it might be okay.
-  // Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
-  // to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
-  // instances on different computers giving identical results.
-  if (cpu_info.bFMA && !Core::WantsDeterminism())
+  if (use_fma)
   {
     // Statistics suggests b is a lot less likely to be unbound in practice, so
     // if we have to pick one of a or b to bind, let's make it b.
@@ -319,23 +327,17 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
   {
     // We implement nmsub a little differently ((b - a*c) instead of -(a*c - b)), so handle it
     // separately.
-    MOVAPD(XMM1, fpr.R(b));
-    if (packed)
-    {
-      MULPD(XMM0, fpr.R(a));
-      SUBPD(XMM1, R(XMM0));
-    }
-    else
-    {
-      MULSD(XMM0, fpr.R(a));
-      SUBSD(XMM1, R(XMM0));
-    }
+    avx_op(packed ? &XEmitter::VMULPD : &XEmitter::VMULSD,
+           packed ? &XEmitter::MULPD : &XEmitter::MULSD, XMM0, product_source, fpr.R(a), packed);
+    avx_op(packed ? &XEmitter::VSUBPD : &XEmitter::VSUBSD,
+           packed ? &XEmitter::SUBPD : &XEmitter::SUBSD, XMM1, fpr.R(b), R(XMM0), packed);
   }
   else
   {
+    avx_op(packed ? &XEmitter::VMULPD : &XEmitter::VMULSD,
+           packed ? &XEmitter::MULPD : &XEmitter::MULSD, XMM1, product_source, fpr.R(a), packed);
     if (packed)
     {
-      MULPD(XMM1, fpr.R(a));
       if (inst.SUBOP5 == 28)  // msub
         SUBPD(XMM1, fpr.R(b));
       else  //(n)madd(s[01])
@@ -343,7 +345,6 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
     }
     else
     {
-      MULSD(XMM1, fpr.R(a));
       if (inst.SUBOP5 == 28)
         SUBSD(XMM1, fpr.R(b));
       else
@@ -425,7 +426,25 @@ void Jit64::fselx(UGeckoInstruction inst)
   else
     CMPSD(XMM0, fpr.R(a), CMP_NLE);
 
-  if (cpu_info.bSSE4_1)
+  if (cpu_info.bAVX)
+  {
+    X64Reg src = XMM1;
+    if (fpr.R(c).IsSimpleReg())
+      src = fpr.RX(c);
+    else
+      MOVAPD(XMM1, fpr.R(c));
+
+    if (packed)
+    {
+      // Blend straight into d. If d is b, it has to be loaded first.
+      fpr.BindToRegister(d, d == b);
+      VBLENDVPD(fpr.RX(d), src, fpr.R(b), XMM0);
+      fpr.UnlockAll();
+      return;
+    }
+    VBLENDVPD(XMM1, src, fpr.R(b), XMM0);
+  }
+  else if (cpu_info.bSSE4_1)
   {
     MOVAPD(XMM1, fpr.R(c));
     BLENDVPD(XMM1, fpr.R(b));
@@ -41,7 +41,7 @@ bool Jitx86Base::BackPatch(u32 emAddress, SContext* ctx)
 {
   u8* codePtr = reinterpret_cast<u8*>(ctx->CTX_PC);
 
-  if (!IsInSpace(codePtr))
+  if (!IsInSpace(codePtr) && !m_hot_code.IsInSpace(codePtr))
     return false;  // this will become a regular crash real soon after this
 
   auto it = m_back_patch_info.find(codePtr);
@@ -8,6 +8,7 @@
 #include <cstdint>
 
 #include "Common/CommonTypes.h"
+#include "Common/x64Emitter.h"
 #include "Common/x64Reg.h"
 #include "Core/PowerPC/Jit64Common/BlockCache.h"
 #include "Core/PowerPC/Jit64Common/Jit64AsmCommon.h"
@@ -33,6 +34,8 @@ constexpr Gen::X64Reg RMEM = Gen::RBX;
 constexpr Gen::X64Reg RPPCSTATE = Gen::RBP;
 
 constexpr size_t CODE_SIZE = 1024 * 1024 * 32;
+// Room for the hottest blocks, see SConfig::bJITHotLayout. Small enough for one huge page.
+constexpr size_t HOT_CODE_SIZE = 1024 * 1024 * 2;
 
 class Jitx86Base : public JitBase, public QuantizedMemoryRoutines
 {
@@ -40,6 +43,7 @@ protected:
   bool BackPatch(u32 emAddress, SContext* ctx);
   JitBlockCache blocks{*this};
   TrampolineCache trampolines;
+  Gen::X64CodeBlock m_hot_code;
 
 public:
   JitBlockCache* GetBlockCache() override { return &blocks; }
@@ -50,7 +50,7 @@ void JitArm64::Init()
   InitializeInstructionTables();
 
   size_t child_code_size = SConfig::GetInstance().bMMU ? FARCODE_SIZE_MMU : FARCODE_SIZE;
-  AllocCodeSpace(CODE_SIZE + child_code_size);
+  AllocCodeSpace(CODE_SIZE + child_code_size, SConfig::GetInstance().bHugePages);
   AddChildCodeSpace(&farcode, child_code_size);
   jo.enableBlocklink = true;
   jo.optimizeGatherPipe = true;
@@ -6,6 +6,7 @@
 
 #include "Common/CommonTypes.h"
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/HW/CPU.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -14,6 +15,7 @@ JitBase* g_jit;
 
 void JitTrampoline(u32 em_address)
 {
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::JitCompile);
   g_jit->Jit(em_address);
 }
 
@@ -125,6 +125,10 @@ public:
 
   virtual bool HandleFault(uintptr_t access_address, SContext* ctx) = 0;
   virtual bool HandleStackFault() { return false; }
+
+  // Called on the CPU thread at the end of every emulated frame (VI field). That can be in the
+  // middle of a block, so compiled code mustn't be changed here.
+  virtual void EndFrame() {}
 };
 
 void JitTrampoline(u32 em_address);
@@ -16,11 +16,15 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
+
+#include <xxhash.h>
 
 #include "Common/CommonTypes.h"
 #include "Common/JitRegister.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -37,6 +41,15 @@ bool JitBlock::OverlapsPhysicalRange(u32 address, u32 length) const
          physical_addresses.lower_bound(address + length);
 }
 
+static u64 HashInstructions(const JitBlock& block)
+{
+  std::vector<u32> instructions;
+  instructions.reserve(block.physical_addresses.size());
+  for (u32 address : block.physical_addresses)
+    instructions.push_back(PowerPC::ReadPhysicalInstruction(address));
+  return XXH64(instructions.data(), instructions.size() * sizeof(u32), 0);
+}
+
 JitBaseBlockCache::JitBaseBlockCache(JitBase& jit) : m_jit{jit}
 {
 }
@@ -69,6 +82,7 @@ void JitBaseBlockCache::Clear()
     DestroyBlock(e.second);
   }
   block_map.clear();
+  parked_blocks.clear();
   links_to.clear();
   block_range_map.clear();
 
@@ -114,23 +128,9 @@ void JitBaseBlockCache::FinalizeBlock(JitBlock& block, bool block_link,
   block.fast_block_map_index = index;
 
   block.physical_addresses = physical_addresses;
+  block.instruction_hash = HashInstructions(block);
 
-  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
-  for (u32 addr : physical_addresses)
-  {
-    valid_block.Set(addr / 32);
-    block_range_map[addr & range_mask].insert(&block);
-  }
-
-  if (block_link)
-  {
-    for (const auto& e : block.linkData)
-    {
-      links_to.emplace(e.exitAddress, &block);
-    }
-
-    LinkBlock(block);
-  }
+  ActivateBlock(block, block_link);
 
   if (Symbol* symbol = g_symbolDB.GetSymbolFromAddr(block.effectiveAddress))
     JitRegister::Register(block.checkedEntry, block.codeSize, "JIT_PPC_%s_%08x",
@@ -183,6 +183,12 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
   if (!translated.valid)
     return;
   u32 pAddr = translated.address;
+  m_invalidation_count++;
+
+  // A forced invalidation wants the code recompiled (e.g. with a breakpoint check), whether or not
+  // it has changed.
+  if (forced)
+    DiscardParkedBlocks(pAddr, length);
 
   // Optimize the common case of length == 32 which is used by Interpreter::dcb*
   bool destroy_block = true;
@@ -197,7 +203,7 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
   if (destroy_block)
   {
     // destroy JIT blocks
-    ErasePhysicalRange(pAddr, length);
+    ErasePhysicalRange(pAddr, length, !forced);
 
     // If the code was actually modified, we need to clear the relevant entries from the
     // FIFO write address cache, so we don't end up with FIFO checks in places they shouldn't
@@ -212,9 +218,13 @@ void JitBaseBlockCache::InvalidateICache(u32 address, u32 length, bool forced)
       }
     }
   }
+
+  // Parked blocks keep their code until the cache is cleared, so don't let them pile up.
+  if (parked_blocks.size() > MAX_PARKED_BLOCKS)
+    parked_blocks.clear();
 }
 
-void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
+void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length, bool park)
 {
   // Iterate over all macro blocks which overlap the given range.
   u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
@@ -236,13 +246,21 @@ void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
             block_range_map[addr & range_mask].erase(block);
 
         // And remove the block.
-        DestroyBlock(*block);
+        if (park)
+          DeactivateBlock(*block);
+        else
+          DestroyBlock(*block);
         auto block_map_iter = block_map.equal_range(block->physicalAddress);
         while (block_map_iter.first != block_map_iter.second)
         {
           if (&block_map_iter.first->second == block)
           {
-            block_map.erase(block_map_iter.first);
+            // Moving the node keeps the block where it is, as its code may refer to it (e.g. the
+            // profiling counters).
+            if (park)
+              parked_blocks.insert(block_map.extract(block_map_iter.first));
+            else
+              block_map.erase(block_map_iter.first);
             break;
           }
           block_map_iter.first++;
@@ -263,6 +281,72 @@ void JitBaseBlockCache::ErasePhysicalRange(u32 address, u32 length)
   }
 }
 
+void JitBaseBlockCache::EraseBlock(JitBlock& block)
+{
+  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  for (u32 addr : block.physical_addresses)
+  {
+    auto range = block_range_map.find(addr & range_mask);
+    if (range != block_range_map.end())
+      range->second.erase(&block);
+  }
+
+  DestroyBlock(block);
+  auto iter = block_map.equal_range(block.physicalAddress);
+  for (; iter.first != iter.second; iter.first++)
+  {
+    if (&iter.first->second == &block)
+    {
+      block_map.erase(iter.first);
+      break;
+    }
+  }
+}
+
+std::vector<JitBlock*> JitBaseBlockCache::GetHotBlockLayout(int min_run_count)
+{
+  std::vector<JitBlock*> hot_blocks;
+  for (auto& e : block_map)
+  {
+    if (e.second.runCount >= min_run_count)
+      hot_blocks.push_back(&e.second);
+  }
+  std::stable_sort(hot_blocks.begin(), hot_blocks.end(),
+                   [](const JitBlock* a, const JitBlock* b) { return a->runCount > b->runCount; });
+
+  // We don't know how often each exit is taken, so the hottest destination stands in for the
+  // most frequent one.
+  std::vector<JitBlock*> layout;
+  std::set<const JitBlock*> placed;
+  for (JitBlock* block : hot_blocks)
+  {
+    while (block && placed.insert(block).second)
+    {
+      layout.push_back(block);
+
+      JitBlock* next = nullptr;
+      for (const auto& e : block->linkData)
+      {
+        JitBlock* destination = GetBlockFromStartAddress(e.exitAddress, block->msrBits);
+        if (destination && destination->runCount >= min_run_count && !placed.count(destination) &&
+            (!next || destination->runCount > next->runCount))
+        {
+          next = destination;
+        }
+      }
+      block = next;
+    }
+  }
+
+  return layout;
+}
+
+void JitBaseBlockCache::ResetRunCounts()
+{
+  for (auto& e : block_map)
+    e.second.runCount = 0;
+}
+
 u32* JitBaseBlockCache::GetBlockBitSet() const
 {
   return valid_block.m_valid_block.get();
@@ -334,7 +418,27 @@ void JitBaseBlockCache::UnlinkBlock(const JitBlock& block)
   }
 }
 
-void JitBaseBlockCache::DestroyBlock(JitBlock& block)
+void JitBaseBlockCache::ActivateBlock(JitBlock& block, bool block_link)
+{
+  u32 range_mask = ~(BLOCK_RANGE_MAP_ELEMENTS - 1);
+  for (u32 addr : block.physical_addresses)
+  {
+    valid_block.Set(addr / 32);
+    block_range_map[addr & range_mask].insert(&block);
+  }
+
+  if (block_link)
+  {
+    for (const auto& e : block.linkData)
+    {
+      links_to.emplace(e.exitAddress, &block);
+    }
+
+    LinkBlock(block);
+  }
+}
+
+void JitBaseBlockCache::DeactivateBlock(JitBlock& block)
 {
   if (fast_block_map[block.fast_block_map_index] == &block)
     fast_block_map[block.fast_block_map_index] = nullptr;
@@ -353,6 +457,11 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
         it.first++;
     }
   }
+}
+
+void JitBaseBlockCache::DestroyBlock(JitBlock& block)
+{
+  DeactivateBlock(block);
 
   // Raise an signal if we are going to call this block again
   WriteDestroyBlock(block);
@@ -361,6 +470,8 @@ void JitBaseBlockCache::DestroyBlock(JitBlock& block)
 JitBlock* JitBaseBlockCache::MoveBlockIntoFastCache(u32 addr, u32 msr)
 {
   JitBlock* block = GetBlockFromStartAddress(addr, msr);
+  if (!block)
+    block = ReviveParkedBlock(addr, msr);
 
   if (!block)
     return nullptr;
@@ -377,6 +488,58 @@ JitBlock* JitBaseBlockCache::MoveBlockIntoFastCache(u32 addr, u32 msr)
   return block;
 }
 
+JitBlock* JitBaseBlockCache::ReviveParkedBlock(u32 addr, u32 msr)
+{
+  u32 translated_addr = addr;
+  if (UReg_MSR(msr).IR)
+  {
+    auto translated = PowerPC::JitCache_TranslateAddress(addr);
+    if (!translated.valid)
+      return nullptr;
+    translated_addr = translated.address;
+  }
+
+  auto iter = parked_blocks.equal_range(translated_addr);
+  for (; iter.first != iter.second; iter.first++)
+  {
+    JitBlock& parked = iter.first->second;
+    if (parked.effectiveAddress != addr || parked.msrBits != (msr & JIT_CACHE_MSR_MASK) ||
+        parked.changed_at_invalidation == m_invalidation_count)
+    {
+      continue;
+    }
+    if (HashInstructions(parked) != parked.instruction_hash)
+    {
+      // The code may still be swapped back in later.
+      parked.changed_at_invalidation = m_invalidation_count;
+      continue;
+    }
+
+    JitBlock& block = block_map.insert(parked_blocks.extract(iter.first))->second;
+
+    // The exits were pointed back at the dispatcher when the block was parked.
+    for (auto& e : block.linkData)
+      e.linkStatus = false;
+    ActivateBlock(block, m_jit.jo.enableBlocklink);
+    FrameTelemetry::Increment(FrameTelemetry::Counter::JitBlocksRevived);
+    return &block;
+  }
+
+  return nullptr;
+}
+
+void JitBaseBlockCache::DiscardParkedBlocks(u32 address, u32 length)
+{
+  auto iter = parked_blocks.begin();
+  while (iter != parked_blocks.end())
+  {
+    if (iter->second.OverlapsPhysicalRange(address, length))
+      iter = parked_blocks.erase(iter);
+    else
+      iter++;
+  }
+}
+
 size_t JitBaseBlockCache::FastLookupIndexForAddress(u32 address)
 {
   return (address >> 2) & FAST_BLOCK_MAP_MASK;
@@ -64,6 +64,12 @@ struct JitBlock
 
   // This set stores all physical addresses of all occupied instructions.
   std::set<u32> physical_addresses;
+  // A hash of the instructions at physical_addresses when the block was compiled. An invalidated
+  // block can be used again as long as they still hash to this.
+  u64 instruction_hash;
+  // For parked blocks, the invalidation after which the instructions were last found to have
+  // changed. They aren't hashed again until there has been another invalidation.
+  u64 changed_at_invalidation = 0;
 
   // we don't really need to save start and stop
   // TODO (mb2): ticStart and ticStop -> "local var" mean "in block" ... low priority ;)
@@ -118,6 +124,9 @@ public:
   static constexpr u32 FAST_BLOCK_MAP_ELEMENTS = 0x10000;
   static constexpr u32 FAST_BLOCK_MAP_MASK = FAST_BLOCK_MAP_ELEMENTS - 1;
 
+  // Parked blocks (see parked_blocks) are dropped once there are more than this many.
+  static constexpr u32 MAX_PARKED_BLOCKS = 0x4000;
+
   explicit JitBaseBlockCache(JitBase& jit);
   virtual ~JitBaseBlockCache();
 
@@ -144,8 +153,17 @@ public:
   // assembly version.)
   const u8* Dispatch();
 
+  // Unless forced, the blocks in the range are only parked: if their code turns out not to have
+  // changed when they're looked up again, they're revived instead of being recompiled.
   void InvalidateICache(u32 address, u32 length, bool forced);
-  void ErasePhysicalRange(u32 address, u32 length);
+  void ErasePhysicalRange(u32 address, u32 length, bool park);
+  void EraseBlock(JitBlock& block);
+
+  // Returns the blocks that ran at least min_run_count times, in chains that each start with the
+  // hottest block that isn't in an earlier chain and go on with the hottest block the last one
+  // exits to.
+  std::vector<JitBlock*> GetHotBlockLayout(int min_run_count);
+  void ResetRunCounts();
 
   u32* GetBlockBitSet() const;
 
@@ -159,9 +177,13 @@ private:
   void LinkBlockExits(JitBlock& block);
   void LinkBlock(JitBlock& block);
   void UnlinkBlock(const JitBlock& block);
+  void ActivateBlock(JitBlock& block, bool block_link);
+  void DeactivateBlock(JitBlock& block);
   void DestroyBlock(JitBlock& block);
 
   JitBlock* MoveBlockIntoFastCache(u32 em_address, u32 msr);
+  JitBlock* ReviveParkedBlock(u32 em_address, u32 msr);
+  void DiscardParkedBlocks(u32 address, u32 length);
 
   // Fast but risky block lookup based on fast_block_map.
   size_t FastLookupIndexForAddress(u32 address);
@@ -174,6 +196,12 @@ private:
   // This is used to query the block based on the current PC in a slow way.
   std::multimap<u32, JitBlock> block_map;  // start_addr -> block
 
+  // Blocks taken out of block_map by a non-forced invalidation, indexed the same way. Their code
+  // is left intact, but nothing is linked to them and they aren't in any other map.
+  std::multimap<u32, JitBlock> parked_blocks;  // start_addr -> block
+  // Counts the calls to InvalidateICache, starting at 1.
+  u64 m_invalidation_count = 1;
+
   // Range of overlapping code indexed by a masked physical address.
   // This is used for invalidation of memory regions. The range is grouped
   // in macro blocks of each 0x100 bytes.
@@ -253,6 +253,12 @@ void CompileExceptionCheck(ExceptionType type)
   }
 }
 
+void EndFrame()
+{
+  if (g_jit)
+    g_jit->EndFrame();
+}
+
 void Shutdown()
 {
   if (g_jit)
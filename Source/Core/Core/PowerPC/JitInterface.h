@@ -46,5 +46,9 @@ void InvalidateICache(u32 address, u32 size, bool forced);
 
 void CompileExceptionCheck(ExceptionType type);
 
+// Lets the JIT schedule periodic work, such as laying out hot code. Called by VI on the CPU
+// thread.
+void EndFrame();
+
 void Shutdown();
 }
@@ -407,17 +407,16 @@ TryReadInstResult TryReadInstruction(u32 address)
     }
   }
 
-  u32 hex;
+  return TryReadInstResult{true, from_bat, ReadPhysicalInstruction(address), address};
+}
+
+u32 ReadPhysicalInstruction(u32 physical_address)
+{
   // TODO: Refactor this. This icache implementation is totally wrong if used with the fake vmem.
-  if (Memory::m_pFakeVMEM && ((address & 0xFE000000) == 0x7E000000))
-  {
-    hex = Common::swap32(&Memory::m_pFakeVMEM[address & Memory::FAKEVMEM_MASK]);
-  }
-  else
-  {
-    hex = PowerPC::ppcState.iCache.ReadInstruction(address);
-  }
-  return TryReadInstResult{true, from_bat, hex, address};
+  if (Memory::m_pFakeVMEM && ((physical_address & 0xFE000000) == 0x7E000000))
+    return Common::swap32(&Memory::m_pFakeVMEM[physical_address & Memory::FAKEVMEM_MASK]);
+
+  return PowerPC::ppcState.iCache.ReadInstruction(physical_address);
 }
 
 u32 HostRead_Instruction(const u32 address)
@@ -15,6 +15,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
 #include "Core/ConfigManager.h"
+#include "Core/PowerPC/BusyWait.h"
 #include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/PPCTables.h"
 #include "Core/PowerPC/PowerPC.h"
@@ -682,6 +683,43 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock* block, CodeOp* code, const Gekk
   }
 }
 
+// Finds blocks that start with a loop like
+//   loop: lhz r0, 0x500c(r3)
+//         rlwinm. r0, r0, 0, 16, 16
+//         beq loop
+// which doesn't change anything the next time round unless memory has changed.
+static void FindBusyWaitLoop(const CodeBlock* block, CodeOp* code)
+{
+  BitSet32 inputs, outputs;
+  bool loads = false;
+  const u32 length = std::min(block->m_num_instructions, BusyWait::MAX_LOOP_LENGTH);
+  for (u32 i = 0; i < length; ++i)
+  {
+    const UGeckoInstruction inst = code[i].inst;
+    if (inst.OPCD == 16)
+    {
+      const u32 destination = SignExt16(inst.BD << 2) + (inst.AA ? 0 : code[i].address);
+      // A register that is read before it's written must be the same every time round.
+      code[i].isBusyWaitLoop =
+          loads && !inst.LK && (inst.BO & BO_DONT_DECREMENT_FLAG) &&
+          !(inst.BO & BO_DONT_CHECK_CONDITION) && destination == block->m_address &&
+          code[i].address == block->m_address + i * 4 && !(inputs & outputs);
+      return;
+    }
+
+    if (BusyWait::GetLoadSize(inst) != 0)
+      loads = true;
+    else if (code[i].opinfo->type != OPTYPE_INTEGER)
+      return;
+
+    if ((code[i].opinfo->flags & FL_READ_CA) || ((code[i].opinfo->flags & FL_SET_OE) && inst.OE))
+      return;
+
+    inputs |= code[i].regsIn & ~outputs;
+    outputs |= code[i].regsOut;
+  }
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32 blockSize)
 {
   // Clear block stats
@@ -968,6 +1006,8 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock* block, CodeBuffer* buffer, u32
   block->m_gqr_used = gqrUsed;
   block->m_gqr_modified = gqrModified;
   block->m_gpr_inputs = gprBlockInputs;
+
+  FindBusyWaitLoop(block, code);
   return address;
 }
 
@@ -44,6 +44,8 @@ struct CodeOp  // 16B
   bool canEndBlock;
   bool skipLRStack;
   bool skip;  // followed BL-s for example
+  // the branch back to the start of a loop that does nothing but poll memory (see BusyWait.h)
+  bool isBusyWaitLoop;
   // which registers are still needed after this instruction in this block
   BitSet32 fprInUse;
   BitSet32 gprInUse;
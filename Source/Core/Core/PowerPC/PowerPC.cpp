@@ -20,6 +20,7 @@
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/Host.h"
+#include "Core/PowerPC/BusyWait.h"
 #include "Core/PowerPC/CPUCoreBase.h"
 #include "Core/PowerPC/Interpreter/Interpreter.h"
 #include "Core/PowerPC/JitInterface.h"
@@ -40,9 +41,16 @@ MemChecks memchecks;
 PPCDebugInterface debug_interface;
 
 static CoreTiming::EventType* s_invalidate_cache_thread_safe;
+// For the debugger. Its changes must be compiled even if the instructions end up the same.
+static void InvalidateCache(u32 address)
+{
+  ppcState.iCache.Invalidate(address);
+  JitInterface::InvalidateICache(address, 4, true);
+}
+
 static void InvalidateCacheThreadSafe(u64 userdata, s64 cyclesLate)
 {
-  ppcState.iCache.Invalidate(static_cast<u32>(userdata));
+  InvalidateCache(static_cast<u32>(userdata));
 }
 
 u32 CompactCR()
@@ -243,7 +251,7 @@ void ScheduleInvalidateCacheThreadSafe(u32 address)
   }
   else
   {
-    PowerPC::ppcState.iCache.Invalidate(static_cast<u32>(address));
+    InvalidateCache(address);
   }
 }
 
@@ -253,6 +261,8 @@ void Shutdown()
   JitInterface::Shutdown();
   s_interpreter->Shutdown();
   s_cpu_core_base = nullptr;
+  BusyWait::LogStats();
+  BusyWait::ResetStats();
 }
 
 CoreMode GetMode()
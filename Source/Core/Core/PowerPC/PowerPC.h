@@ -241,6 +241,8 @@ struct TryReadInstResult
   u32 physical_address;
 };
 TryReadInstResult TryReadInstruction(u32 address);
+// Reads the instruction at an already translated address the same way TryReadInstruction does.
+u32 ReadPhysicalInstruction(u32 physical_address);
 
 u8 Read_U8(u32 address);
 u16 Read_U16(u32 address);
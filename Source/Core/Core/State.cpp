@@ -8,7 +8,6 @@
 #include <map>
 #include <mutex>
 #include <string>
-#include <thread>
 #include <utility>
 #include <vector>
 
@@ -17,10 +16,10 @@
 #include "Common/Event.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
+#include "Common/JobSystem.h"
 #include "Common/MsgHandler.h"
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
-#include "Common/Thread.h"
 #include "Common/Timer.h"
 
 #include "Core/ConfigManager.h"
@@ -70,10 +69,10 @@ static std::mutex g_cs_undo_load_buffer;
 static std::mutex g_cs_current_buffer;
 static Common::Event g_compressAndDumpStateSyncEvent;
 
-static std::thread g_save_thread;
+static Common::JobHandle g_save_job;
 
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 88;  // Last changed in PR 5733
+static const u32 STATE_VERSION = 89;  // Last changed when VI timing became analytic
 
 // Maps savestate versions to Dolphin versions.
 // Versions after 42 don't need to be added to this list,
@@ -322,7 +321,7 @@ static void CompressAndDumpState(CompressAndDumpState_args save_args)
   std::string& filename = save_args.filename;
 
   // For easy debugging
-  Common::SetCurrentThreadName("SaveState thread");
+  Common::JobSystem::SetCurrentJobName("SaveState thread");
 
   // Moving to last overwritten save-state
   if (File::Exists(filename))
@@ -428,7 +427,9 @@ void SaveAs(const std::string& filename, bool wait)
     save_args.wait = wait;
 
     Flush();
-    g_save_thread = std::thread(CompressAndDumpState, save_args);
+    g_save_job = Common::JobSystem::GetInstance().Schedule(
+        [save_args] { CompressAndDumpState(save_args); }, Common::JobPriority::High,
+        Common::JobAffinity::WorkerOnly);
     g_compressAndDumpStateSyncEvent.Wait();
 
     g_last_filename = filename;
@@ -723,8 +724,7 @@ void SaveFirstSaved()
 void Flush()
 {
   // If already saving state, wait for it to finish
-  if (g_save_thread.joinable())
-    g_save_thread.join();
+  Common::JobSystem::GetInstance().Wait(g_save_job);
 }
 
 // Load the last state before loading the state
@@ -202,7 +202,7 @@ void IOWindow::OnDetectButtonPressed()
 
 void IOWindow::OnRangeChanged(int value)
 {
-  m_reference->range = static_cast<double>(value) / SLIDER_TICK_COUNT;
+  m_reference->SetRange(static_cast<double>(value) / SLIDER_TICK_COUNT);
   m_range_spinbox->setValue(m_reference->range * SLIDER_TICK_COUNT);
   m_range_slider->setValue(m_reference->range * SLIDER_TICK_COUNT);
 }
@@ -584,13 +584,13 @@ void InputConfigDialog::EnableControlButton(const std::string& group_name, const
 void ControlDialog::OnRangeSlide(wxScrollEvent& event)
 {
   m_range_spinner->SetValue(event.GetPosition());
-  control_reference->range = static_cast<ControlState>(event.GetPosition()) / SLIDER_TICK_COUNT;
+  control_reference->SetRange(static_cast<ControlState>(event.GetPosition()) / SLIDER_TICK_COUNT);
 }
 
 void ControlDialog::OnRangeSpin(wxSpinEvent& event)
 {
   m_range_slider->SetValue(event.GetValue());
-  control_reference->range = static_cast<ControlState>(event.GetValue()) / SLIDER_TICK_COUNT;
+  control_reference->SetRange(static_cast<ControlState>(event.GetValue()) / SLIDER_TICK_COUNT);
 }
 
 void ControlDialog::OnRangeThumbtrack(wxScrollEvent& event)
@@ -10,6 +10,8 @@
 #include "Core/Host.h"
 
 #include "InputCommon/ControlReference/ControlReference.h"
+#include "InputCommon/ControllerEmu/ControllerEmu.h"
+#include "InputCommon/ControllerInterface/ControllerInterface.h"
 
 using namespace ciface::ExpressionParser;
 
@@ -34,6 +36,13 @@ void ControlReference::UpdateReference(const ciface::Core::DeviceContainer& devi
   ControlFinder finder(devices, default_device, IsInput());
   m_parse_status = ParseExpression(expression, finder, &expr);
   m_parsed_expression.reset(expr);
+  ControllerEmu::EmulatedController::ConfigChanged();
+}
+
+void ControlReference::SetRange(ControlState new_range)
+{
+  range = new_range;
+  ControllerEmu::EmulatedController::ConfigChanged();
 }
 
 int ControlReference::BoundCount() const
@@ -128,7 +137,7 @@ ciface::Core::Device::Control* InputReference::Detect(const unsigned int ms,
 
   while (time < ms)
   {
-    device->UpdateInput();
+    g_controller_interface.UpdateInput(device);
     i = device->Inputs().begin();
     for (std::vector<bool>::iterator state = states.begin(); i != e; ++i, ++state)
     {
@@ -34,6 +34,8 @@ public:
   ciface::ExpressionParser::ParseStatus GetParseStatus() const;
   void UpdateReference(const ciface::Core::DeviceContainer& devices,
                        const ciface::Core::DeviceQualifier& default_device);
+  // Changes the range, and lets emulated controllers know that their config changed.
+  void SetRange(ControlState new_range);
 
   ControlState range;
   std::string expression;
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <map>
@@ -207,6 +208,75 @@ public:
   }
 };
 
+static ControlState Apply(Instruction::Op op, ControlState lhs, ControlState rhs)
+{
+  switch (op)
+  {
+  case Instruction::Op::Not:
+    return 1.0 - lhs;
+  case Instruction::Op::And:
+    return std::min(lhs, rhs);
+  case Instruction::Op::Or:
+    return std::max(lhs, rhs);
+  case Instruction::Op::Add:
+    return std::min(lhs + rhs, 1.0);
+  default:
+    assert(false);
+    return 0;
+  }
+}
+
+static void EmitConstant(std::vector<Instruction>* program, ControlState value)
+{
+  program->push_back({Instruction::Op::PushConstant, value, nullptr});
+}
+
+// Operations on constants are folded right away. Those are mostly controls that aren't bound.
+static void EmitOperation(std::vector<Instruction>* program, Instruction::Op op)
+{
+  const size_t operands = op == Instruction::Op::Not ? 1 : 2;
+  const bool constant =
+      program->size() >= operands &&
+      std::all_of(program->end() - operands, program->end(), [](const Instruction& instruction) {
+        return instruction.op == Instruction::Op::PushConstant;
+      });
+  if (!constant)
+  {
+    // The last operand is read straight from its input, rather than going through the stack.
+    if (program->back().op == Instruction::Op::PushInput)
+    {
+      program->back().op = op;
+      return;
+    }
+
+    program->push_back({op, 0.0, nullptr});
+    return;
+  }
+
+  const ControlState lhs = program->end()[-static_cast<ptrdiff_t>(operands)].constant;
+  const ControlState rhs = program->back().constant;
+  program->resize(program->size() - operands);
+  EmitConstant(program, Apply(op, lhs, rhs));
+}
+
+static Instruction::Op ToOperation(TokenType op)
+{
+  switch (op)
+  {
+  case TOK_AND:
+    return Instruction::Op::And;
+  case TOK_OR:
+    return Instruction::Op::Or;
+  case TOK_ADD:
+    return Instruction::Op::Add;
+  case TOK_NOT:
+    return Instruction::Op::Not;
+  default:
+    assert(false);
+    return Instruction::Op::PushConstant;
+  }
+}
+
 class ExpressionNode
 {
 public:
@@ -214,6 +284,8 @@ public:
   virtual ControlState GetValue() const { return 0; }
   virtual void SetValue(ControlState state) {}
   virtual int CountNumControls() const { return 0; }
+  // Appends instructions that leave the value of this node on the stack.
+  virtual void Compile(std::vector<Instruction>* program) const { EmitConstant(program, 0.0); }
   virtual operator std::string() const { return ""; }
 };
 
@@ -244,6 +316,15 @@ public:
   ControlState GetValue() const override { return control->ToInput()->GetState(); }
   void SetValue(ControlState value) override { control->ToOutput()->SetState(value); }
   int CountNumControls() const override { return 1; }
+  void Compile(std::vector<Instruction>* program) const override
+  {
+    // Outputs are never read.
+    Device::Input* const input = control->ToInput();
+    if (input)
+      program->push_back({Instruction::Op::PushInput, 0.0, input});
+    else
+      EmitConstant(program, 0.0);
+  }
   operator std::string() const override { return "`" + (std::string)qualifier + "`"; }
 private:
   std::shared_ptr<Device> m_device;
@@ -297,6 +378,13 @@ public:
     return lhs->CountNumControls() + rhs->CountNumControls();
   }
 
+  void Compile(std::vector<Instruction>* program) const override
+  {
+    lhs->Compile(program);
+    rhs->Compile(program);
+    EmitOperation(program, ToOperation(op));
+  }
+
   operator std::string() const override
   {
     return OpName(op) + "(" + (std::string)(*lhs) + ", " + (std::string)(*rhs) + ")";
@@ -338,6 +426,11 @@ public:
   }
 
   int CountNumControls() const override { return inner->CountNumControls(); }
+  void Compile(std::vector<Instruction>* program) const override
+  {
+    inner->Compile(program);
+    EmitOperation(program, ToOperation(op));
+  }
   operator std::string() const override { return OpName(op) + "(" + (std::string)(*inner) + ")"; }
 };
 
@@ -502,6 +595,57 @@ private:
 };
 
 ControlState Expression::GetValue() const
+{
+  // Most expressions are a single control, or not bound to anything at all.
+  const Instruction* instruction = m_program.data();
+  if (m_program.size() == 1 && instruction->op == Instruction::Op::PushInput)
+    return instruction->input->GetState();
+  if (m_program.size() == 1 && instruction->op == Instruction::Op::PushConstant)
+    return instruction->constant;
+
+  if (m_stack_depth > MAX_STACK_DEPTH)
+    return node->GetValue();
+
+  // The value on top of the stack is kept in a local, most instructions only work on that one.
+  std::array<ControlState, MAX_STACK_DEPTH> stack;
+  size_t depth = 0;
+  ControlState top = 0.0;
+  for (const Instruction* const end = instruction + m_program.size(); instruction != end;
+       ++instruction)
+  {
+    switch (instruction->op)
+    {
+    case Instruction::Op::PushConstant:
+      stack[depth++] = top;
+      top = instruction->constant;
+      break;
+    case Instruction::Op::PushInput:
+      stack[depth++] = top;
+      top = instruction->input->GetState();
+      break;
+    case Instruction::Op::Not:
+      if (instruction->input)
+      {
+        stack[depth++] = top;
+        top = Apply(instruction->op, instruction->input->GetState(), 0.0);
+      }
+      else
+      {
+        top = Apply(instruction->op, top, 0.0);
+      }
+      break;
+    default:
+      if (instruction->input)
+        top = Apply(instruction->op, top, instruction->input->GetState());
+      else
+        top = Apply(instruction->op, stack[--depth], top);
+      break;
+    }
+  }
+  return top;
+}
+
+ControlState Expression::GetTreeValue() const
 {
   return node->GetValue();
 }
@@ -515,6 +659,20 @@ Expression::Expression(ExpressionNode* node_)
 {
   node = node_;
   num_controls = node->CountNumControls();
+
+  node->Compile(&m_program);
+  size_t depth = 0;
+  for (const Instruction& instruction : m_program)
+  {
+    const bool pushes = instruction.op == Instruction::Op::PushConstant ||
+                        instruction.op == Instruction::Op::PushInput ||
+                        (instruction.op == Instruction::Op::Not && instruction.input);
+    const bool pops = instruction.op != Instruction::Op::Not && !pushes && !instruction.input;
+    if (pushes)
+      m_stack_depth = std::max(m_stack_depth, ++depth);
+    else if (pops)
+      --depth;
+  }
 }
 
 Expression::~Expression()
@@ -6,6 +6,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
 #include "InputCommon/ControllerInterface/Device.h"
 
 namespace ciface
@@ -46,6 +49,25 @@ private:
   bool is_input;
 };
 
+// One step of a compiled expression, which runs on a small stack of values.
+struct Instruction
+{
+  enum class Op : u8
+  {
+    PushConstant,
+    PushInput,
+    Not,
+    And,
+    Or,
+    Add,
+  };
+
+  Op op;
+  ControlState constant;
+  // For operations, the input that gives the last operand instead of the stack.
+  Core::Device::Input* input;
+};
+
 class ExpressionNode;
 class Expression
 {
@@ -53,10 +75,20 @@ public:
   Expression() : node(nullptr) {}
   Expression(ExpressionNode* node);
   ~Expression();
+  // Runs the compiled program, which gives the same result as evaluating the tree.
   ControlState GetValue() const;
+  // Evaluates the tree directly. Only useful to check the compiled program against.
+  ControlState GetTreeValue() const;
   void SetValue(ControlState state);
+  const std::vector<Instruction>& GetProgram() const { return m_program; }
   int num_controls;
   ExpressionNode* node;
+
+private:
+  static constexpr size_t MAX_STACK_DEPTH = 32;
+
+  std::vector<Instruction> m_program;
+  size_t m_stack_depth = 0;
 };
 
 enum class ParseStatus
@@ -4,6 +4,7 @@
 
 #include "InputCommon/ControllerEmu/ControllerEmu.h"
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -19,6 +20,7 @@
 namespace ControllerEmu
 {
 static std::recursive_mutex s_get_state_mutex;
+static std::atomic<u64> s_config_version{0};
 
 EmulatedController::~EmulatedController() = default;
 
@@ -31,6 +33,16 @@ std::unique_lock<std::recursive_mutex> EmulatedController::GetStateLock()
   return lock;
 }
 
+u64 EmulatedController::GetConfigVersion()
+{
+  return s_config_version.load(std::memory_order_acquire);
+}
+
+void EmulatedController::ConfigChanged()
+{
+  s_config_version++;
+}
+
 void EmulatedController::UpdateReferences(const ControllerInterface& devi)
 {
   const auto lock = GetStateLock();
@@ -75,6 +87,8 @@ void EmulatedController::LoadConfig(IniFile::Section* sec, const std::string& ba
 
   for (auto& cg : groups)
     cg->LoadConfig(sec, defdev, base);
+
+  ConfigChanged();
 }
 
 void EmulatedController::SaveConfig(IniFile::Section* sec, const std::string& base)
@@ -99,5 +113,7 @@ void EmulatedController::LoadDefaults(const ControllerInterface& ciface)
     default_device.FromString(default_device_string);
     UpdateDefaultDevice();
   }
+
+  ConfigChanged();
 }
 }  // namespace ControllerEmu
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "Common/CommonTypes.h"
 #include "Common/IniFile.h"
 #include "InputCommon/ControllerInterface/Device.h"
 
@@ -42,6 +43,11 @@ public:
   // could be called before we have finished updating the reference.
   static std::unique_lock<std::recursive_mutex> GetStateLock();
 
+  // Changes whenever a mapping or setting of any emulated controller changes. Together with
+  // ControllerInterface::GetInputVersion(), this tells when cached controller state is stale.
+  static u64 GetConfigVersion();
+  static void ConfigChanged();
+
   std::vector<std::unique_ptr<ControlGroup>> groups;
 
   ciface::Core::DeviceQualifier default_device;
@@ -4,6 +4,8 @@
 
 #include "InputCommon/ControllerEmu/Setting/BooleanSetting.h"
 
+#include "InputCommon/ControllerEmu/ControllerEmu.h"
+
 namespace ControllerEmu
 {
 BooleanSetting::BooleanSetting(const std::string& setting_name, const std::string& ui_name,
@@ -26,6 +28,7 @@ bool BooleanSetting::GetValue() const
 void BooleanSetting::SetValue(bool value)
 {
   m_value = value;
+  EmulatedController::ConfigChanged();
 }
 
 }  // namespace ControllerEmu
@@ -4,6 +4,8 @@
 
 #include "InputCommon/ControllerEmu/Setting/NumericSetting.h"
 
+#include "InputCommon/ControllerEmu/ControllerEmu.h"
+
 namespace ControllerEmu
 {
 NumericSetting::NumericSetting(const std::string& setting_name, const ControlState default_value,
@@ -20,6 +22,7 @@ ControlState NumericSetting::GetValue() const
 void NumericSetting::SetValue(ControlState value)
 {
   m_value = value;
+  EmulatedController::ConfigChanged();
 }
 
 }  // namespace ControllerEmu
@@ -5,6 +5,7 @@
 #include <mutex>
 
 #include "InputCommon/ControllerInterface/ControllerInterface.h"
+#include "InputCommon/InputLatency.h"
 
 #ifdef CIFACE_USE_XINPUT
 #include "InputCommon/ControllerInterface/XInput/XInput.h"
@@ -31,9 +32,18 @@
 #ifdef CIFACE_USE_PIPES
 #include "InputCommon/ControllerInterface/Pipes/Pipes.h"
 #endif
+#ifdef CIFACE_USE_INPUT_THREAD
+#include "InputCommon/ControllerInterface/InputThread.h"
+#endif
 
 ControllerInterface g_controller_interface;
 
+ControllerInterface::ControllerInterface() : m_is_init(false), m_hwnd(nullptr)
+{
+}
+
+ControllerInterface::~ControllerInterface() = default;
+
 //
 // Init
 //
@@ -46,6 +56,10 @@ void ControllerInterface::Initialize(void* const hwnd)
 
   m_hwnd = hwnd;
 
+#ifdef CIFACE_USE_INPUT_THREAD
+  m_input_thread = std::make_unique<ciface::Core::InputThread>([this] { InputChanged(); });
+#endif
+
 #ifdef CIFACE_USE_DINPUT
 // nothing needed
 #endif
@@ -83,7 +97,11 @@ void ControllerInterface::RefreshDevices()
 
   {
     std::lock_guard<std::mutex> lk(m_devices_mutex);
+    if (m_input_thread)
+      m_input_thread->RemoveAllDevices();
+    m_input_thread_devices.clear();
     m_devices.clear();
+    m_input_version++;
   }
 
 #ifdef CIFACE_USE_DINPUT
@@ -133,7 +151,11 @@ void ControllerInterface::Shutdown()
         o->SetState(0);
     }
 
+    // Also releases the devices it was reading.
+    m_input_thread.reset();
+    m_input_thread_devices.clear();
     m_devices.clear();
+    m_input_version++;
   }
 
 #ifdef CIFACE_USE_XINPUT
@@ -180,15 +202,29 @@ void ControllerInterface::AddDevice(std::shared_ptr<ciface::Core::Device> device
       id++;
   }
   device->SetId(id);
+  if (m_input_thread && m_input_thread->IsRunning() && m_input_thread->AddDevice(device))
+    m_input_thread_devices.push_back(device.get());
   m_devices.emplace_back(std::move(device));
+  m_input_version++;
 }
 
 void ControllerInterface::RemoveDevice(std::function<bool(const ciface::Core::Device*)> callback)
 {
   std::lock_guard<std::mutex> lk(m_devices_mutex);
   m_devices.erase(std::remove_if(m_devices.begin(), m_devices.end(),
-                                 [&callback](const auto& dev) { return callback(dev.get()); }),
+                                 [this, &callback](const auto& dev) {
+                                   if (!callback(dev.get()))
+                                     return false;
+                                   if (m_input_thread)
+                                     m_input_thread->RemoveDevice(dev.get());
+                                   m_input_thread_devices.erase(
+                                       std::remove(m_input_thread_devices.begin(),
+                                                   m_input_thread_devices.end(), dev.get()),
+                                       m_input_thread_devices.end());
+                                   return true;
+                                 }),
                   m_devices.end());
+  m_input_version++;
 }
 
 //
@@ -202,11 +238,40 @@ void ControllerInterface::UpdateInput()
   if (m_devices_mutex.try_lock())
   {
     std::lock_guard<std::mutex> lk(m_devices_mutex, std::adopt_lock);
+    bool changed = false;
     for (const auto& d : m_devices)
+    {
+      if (IsReadByInputThread(d.get()))
+        continue;
+
       d->UpdateInput();
+      changed |= d->InputChanged();
+    }
+
+    if (changed)
+      InputChanged();
   }
 }
 
+void ControllerInterface::InputChanged()
+{
+  InputLatency::OnInputChanged(m_input_version.fetch_add(1, std::memory_order_release) + 1);
+}
+
+void ControllerInterface::UpdateInput(ciface::Core::Device* device)
+{
+  std::lock_guard<std::mutex> lk(m_devices_mutex);
+  if (!IsReadByInputThread(device))
+    device->UpdateInput();
+}
+
+bool ControllerInterface::IsReadByInputThread(const ciface::Core::Device* device) const
+{
+  return m_input_thread && m_input_thread->IsRunning() &&
+         std::find(m_input_thread_devices.begin(), m_input_thread_devices.end(), device) !=
+             m_input_thread_devices.end();
+}
+
 //
 // RegisterHotplugCallback
 //
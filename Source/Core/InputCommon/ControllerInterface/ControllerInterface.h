@@ -5,8 +5,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -34,6 +36,17 @@
 #if defined(USE_PIPES)
 #define CIFACE_USE_PIPES
 #endif
+#if defined(__linux__) && !defined(ANDROID)
+#define CIFACE_USE_INPUT_THREAD
+#endif
+
+namespace ciface
+{
+namespace Core
+{
+class InputThread;
+}
+}
 
 //
 // ControllerInterface
@@ -44,7 +57,8 @@
 class ControllerInterface : public ciface::Core::DeviceContainer
 {
 public:
-  ControllerInterface() : m_is_init(false), m_hwnd(nullptr) {}
+  ControllerInterface();
+  ~ControllerInterface();
   void Initialize(void* const hwnd);
   void RefreshDevices();
   void Shutdown();
@@ -52,12 +66,26 @@ public:
   void RemoveDevice(std::function<bool(const ciface::Core::Device*)> callback);
   bool IsInit() const { return m_is_init; }
   void UpdateInput();
+  // Updates a single device, unless the input thread is already reading it.
+  void UpdateInput(ciface::Core::Device* device);
+  // Changes whenever an update may have changed the state of any input, or when devices are
+  // added or removed. Lets consumers skip evaluating input that cannot have changed.
+  u64 GetInputVersion() const { return m_input_version.load(std::memory_order_acquire); }
 
   void RegisterHotplugCallback(std::function<void(void)> callback);
   void InvokeHotplugCallbacks() const;
 
 private:
+  // Called from any thread when a device read changed any input.
+  void InputChanged();
+  // m_devices_mutex must be held.
+  bool IsReadByInputThread(const ciface::Core::Device* device) const;
+
   std::vector<std::function<void()>> m_hotplug_callbacks;
+  std::unique_ptr<ciface::Core::InputThread> m_input_thread;
+  // Devices that were successfully registered with the input thread. Guarded by m_devices_mutex.
+  std::vector<const ciface::Core::Device*> m_input_thread_devices;
+  std::atomic<u64> m_input_version{0};
   bool m_is_init;
   void* m_hwnd;
 };
@@ -80,6 +80,13 @@ public:
   virtual std::string GetName() const = 0;
   virtual std::string GetSource() const = 0;
   virtual void UpdateInput() {}
+  // Whether the last UpdateInput() may have changed the state of any input. Backends that can't
+  // tell, or whose inputs change outside of UpdateInput(), keep this default.
+  virtual bool InputChanged() const { return true; }
+  // Devices that can be read whenever a file descriptor becomes readable return it here. Where
+  // there is an input thread, it reads those devices instead of UpdateInput() being called on
+  // the emulation threads, so their inputs must be safe to read from any thread.
+  virtual int GetPollFD() const { return -1; }
   virtual bool IsValid() const { return true; }
   const std::vector<Input*>& Inputs() const { return m_inputs; }
   const std::vector<Output*>& Outputs() const { return m_outputs; }
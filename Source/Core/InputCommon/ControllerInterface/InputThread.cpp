@@ -0,0 +1,147 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "InputCommon/ControllerInterface/InputThread.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+
+namespace ciface
+{
+namespace Core
+{
+InputThread::InputThread(std::function<void()> on_input_changed)
+    : m_on_input_changed(std::move(on_input_changed))
+{
+  m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  m_wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (m_epoll_fd < 0 || m_wakeup_fd < 0)
+  {
+    ERROR_LOG(SERIALINTERFACE, "Couldn't create the input thread's descriptors: %d", errno);
+    return;
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = m_wakeup_fd;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, m_wakeup_fd, &event) != 0)
+  {
+    ERROR_LOG(SERIALINTERFACE, "Couldn't watch the input thread's wakeup descriptor: %d", errno);
+    return;
+  }
+
+  m_running.Set();
+  m_thread = std::thread(&InputThread::ThreadFunc, this);
+}
+
+InputThread::~InputThread()
+{
+  m_running.Clear();
+  if (m_thread.joinable())
+  {
+    const u64 value = 1;
+    if (write(m_wakeup_fd, &value, sizeof(value)) < 0)
+    {
+    }
+    m_thread.join();
+  }
+
+  RemoveAllDevices();
+  if (m_wakeup_fd >= 0)
+    close(m_wakeup_fd);
+  if (m_epoll_fd >= 0)
+    close(m_epoll_fd);
+}
+
+bool InputThread::AddDevice(std::shared_ptr<Device> device)
+{
+  const int fd = device->GetPollFD();
+  if (fd < 0)
+    return false;
+
+  std::lock_guard<std::mutex> lk(m_devices_mutex);
+
+  // Edge-triggered, as a pipe whose writer went away would be reported as hung up forever.
+  // Devices read until there is nothing left anyway.
+  epoll_event event = {};
+  event.events = EPOLLIN | EPOLLET;
+  event.data.fd = fd;
+  if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+  {
+    ERROR_LOG(SERIALINTERFACE, "Couldn't watch %s for input: %d", device->GetName().c_str(),
+              errno);
+    return false;
+  }
+
+  m_devices.emplace_back(std::move(device));
+  return true;
+}
+
+void InputThread::RemoveDevice(const Device* device)
+{
+  std::lock_guard<std::mutex> lk(m_devices_mutex);
+  const auto it = std::find_if(m_devices.begin(), m_devices.end(),
+                               [device](const auto& d) { return d.get() == device; });
+  if (it == m_devices.end())
+    return;
+
+  epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, (*it)->GetPollFD(), nullptr);
+  m_devices.erase(it);
+}
+
+void InputThread::RemoveAllDevices()
+{
+  std::lock_guard<std::mutex> lk(m_devices_mutex);
+  for (const auto& device : m_devices)
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, device->GetPollFD(), nullptr);
+  m_devices.clear();
+}
+
+void InputThread::ThreadFunc()
+{
+  Common::SetCurrentThreadName("Input thread");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
+
+  std::array<epoll_event, 16> events;
+  while (m_running.IsSet())
+  {
+    const int count = epoll_wait(m_epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+    if (count < 0 && errno != EINTR)
+    {
+      // Devices are polled on the emulation threads again from now on.
+      ERROR_LOG(SERIALINTERFACE, "Input thread stopped: %d", errno);
+      m_running.Clear();
+      break;
+    }
+
+    bool changed = false;
+    {
+      std::lock_guard<std::mutex> lk(m_devices_mutex);
+      for (int i = 0; i < count; ++i)
+      {
+        // Devices may have been removed since the descriptor became readable.
+        const int fd = events[i].data.fd;
+        const auto it = std::find_if(m_devices.begin(), m_devices.end(),
+                                     [fd](const auto& d) { return d->GetPollFD() == fd; });
+        if (it == m_devices.end())
+          continue;
+
+        (*it)->UpdateInput();
+        changed |= (*it)->InputChanged();
+      }
+    }
+
+    if (changed)
+      m_on_input_changed();
+  }
+}
+}
+}
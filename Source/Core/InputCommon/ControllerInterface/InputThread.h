@@ -0,0 +1,56 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Common/Flag.h"
+#include "InputCommon/ControllerInterface/Device.h"
+
+namespace ciface
+{
+namespace Core
+{
+//
+// InputThread
+//
+// Reads devices that have a poll file descriptor as soon as their descriptor becomes readable,
+// using epoll. Those devices publish their input state for other threads to read, so the
+// emulation threads never have to poll them, or wait for them.
+//
+class InputThread final
+{
+public:
+  // on_input_changed is called on the input thread whenever a read changed any input.
+  explicit InputThread(std::function<void()> on_input_changed);
+  ~InputThread();
+
+  bool IsRunning() const { return m_running.IsSet(); }
+
+  // Returns whether the device is read by the input thread from now on. If not, it has to be
+  // polled as usual.
+  bool AddDevice(std::shared_ptr<Device> device);
+  void RemoveDevice(const Device* device);
+  void RemoveAllDevices();
+
+private:
+  void ThreadFunc();
+
+  std::function<void()> m_on_input_changed;
+  int m_epoll_fd = -1;
+  int m_wakeup_fd = -1;
+  std::thread m_thread;
+  Common::Flag m_running;
+
+  // Only contended when devices are added or removed.
+  std::mutex m_devices_mutex;
+  std::vector<std::shared_ptr<Device>> m_devices;
+};
+}
+}
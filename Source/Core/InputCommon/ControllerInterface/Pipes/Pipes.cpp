@@ -100,6 +100,7 @@ void PipeDevice::UpdateInput()
     bytes_read = read(m_fd, buf, sizeof buf);
   }
   std::size_t newline = m_buf.find("\n");
+  m_input_changed = newline != std::string::npos;
   while (newline != std::string::npos)
   {
     std::string command = m_buf.substr(0, newline);
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
@@ -31,6 +32,8 @@ public:
   ~PipeDevice();
 
   void UpdateInput() override;
+  bool InputChanged() const override { return m_input_changed; }
+  int GetPollFD() const override { return m_fd; }
   std::string GetName() const override { return m_name; }
   std::string GetSource() const override { return "Pipe"; }
 private:
@@ -39,11 +42,12 @@ private:
   public:
     PipeInput(const std::string& name) : m_name(name), m_state(0.0) {}
     std::string GetName() const override { return m_name; }
-    ControlState GetState() const override { return m_state; }
-    void SetState(ControlState state) { m_state = state; }
+    ControlState GetState() const override { return m_state.load(std::memory_order_relaxed); }
+    void SetState(ControlState state) { m_state.store(state, std::memory_order_relaxed); }
   private:
     const std::string m_name;
-    ControlState m_state;
+    // Written by whichever thread reads the pipe
+    std::atomic<ControlState> m_state;
   };
 
   void AddAxis(const std::string& name, double value);
@@ -53,6 +57,7 @@ private:
   const int m_fd;
   const std::string m_name;
   std::string m_buf;
+  bool m_input_changed = true;
   std::map<std::string, PipeInput*> m_buttons;
   std::map<std::string, PipeInput*> m_axes;
 };
@@ -186,7 +186,10 @@ std::string Device::GetSource() const
 
 void Device::UpdateInput()
 {
-  PXInputGetState(m_index, &m_state_in);
+  // The packet number only changes along with the controller state.
+  const DWORD last_packet = m_state_in.dwPacketNumber;
+  const DWORD result = PXInputGetState(m_index, &m_state_in);
+  m_input_changed = result != ERROR_SUCCESS || m_state_in.dwPacketNumber != last_packet;
 }
 
 void Device::UpdateMotors()
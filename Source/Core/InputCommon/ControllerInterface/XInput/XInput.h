@@ -89,6 +89,7 @@ private:
 
 public:
   void UpdateInput() override;
+  bool InputChanged() const override { return m_input_changed; }
 
   Device(const XINPUT_CAPABILITIES& capabilities, u8 index);
 
@@ -103,6 +104,7 @@ private:
   XINPUT_VIBRATION m_current_state_out{};
   const BYTE m_subtype;
   const u8 m_index;
+  bool m_input_changed = true;
 };
 }
 }
@@ -197,7 +197,7 @@ void Shutdown()
 
 evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
 {
-  // The device file will be read on one of the main threads, so we open in non-blocking mode.
+  // The device file is read until there are no events left, so we open in non-blocking mode.
   m_fd = open(devnode.c_str(), O_RDWR | O_NONBLOCK);
   int ret = libevdev_new_from_fd(m_fd, &m_dev);
 
@@ -215,15 +215,25 @@ evdevDevice::evdevDevice(const std::string& devnode) : m_devfile(devnode)
   int num_buttons = 0;
   for (int key = 0; key < KEY_MAX; key++)
     if (libevdev_has_event_code(m_dev, EV_KEY, key))
-      AddInput(new Button(num_buttons++, key, m_dev));
+    {
+      Button* button = new Button(num_buttons++, key, m_dev);
+      button->UpdateValue();
+      AddInput(button);
+      m_buttons.push_back(button);
+    }
 
   // Absolute axis (thumbsticks)
   int num_axis = 0;
   for (int axis = 0; axis < 0x100; axis++)
     if (libevdev_has_event_code(m_dev, EV_ABS, axis))
     {
-      AddAnalogInputs(new Axis(num_axis, axis, false, m_dev),
-                      new Axis(num_axis, axis, true, m_dev));
+      Axis* lower = new Axis(num_axis, axis, false, m_dev);
+      Axis* upper = new Axis(num_axis, axis, true, m_dev);
+      lower->UpdateValue();
+      upper->UpdateValue();
+      AddAnalogInputs(lower, upper);
+      m_axes.push_back(lower);
+      m_axes.push_back(upper);
       num_axis++;
     }
 
@@ -261,13 +271,23 @@ void evdevDevice::UpdateInput()
   // later with libevdev_fetch_event_value()
   input_event ev;
   int rc = LIBEVDEV_READ_STATUS_SUCCESS;
+  m_input_changed = false;
   do
   {
     if (rc == LIBEVDEV_READ_STATUS_SYNC)
       rc = libevdev_next_event(m_dev, LIBEVDEV_READ_FLAG_SYNC, &ev);
     else
       rc = libevdev_next_event(m_dev, LIBEVDEV_READ_FLAG_NORMAL, &ev);
+    m_input_changed |= rc >= 0;
   } while (rc >= 0);
+
+  if (!m_input_changed)
+    return;
+
+  for (Button* button : m_buttons)
+    button->UpdateValue();
+  for (Axis* axis : m_axes)
+    axis->UpdateValue();
 }
 
 bool evdevDevice::IsValid() const
@@ -300,11 +320,16 @@ std::string evdevDevice::Button::GetName() const
   return "Button " + std::to_string(m_index);
 }
 
-ControlState evdevDevice::Button::GetState() const
+void evdevDevice::Button::UpdateValue()
 {
   int value = 0;
   libevdev_fetch_event_value(m_dev, EV_KEY, m_code, &value);
-  return value;
+  m_value.store(value, std::memory_order_relaxed);
+}
+
+ControlState evdevDevice::Button::GetState() const
+{
+  return m_value.load(std::memory_order_relaxed);
 }
 
 evdevDevice::Axis::Axis(u8 index, u16 code, bool upper, libevdev* dev)
@@ -319,10 +344,16 @@ std::string evdevDevice::Axis::GetName() const
   return "Axis " + std::to_string(m_index) + (m_upper ? "+" : "-");
 }
 
-ControlState evdevDevice::Axis::GetState() const
+void evdevDevice::Axis::UpdateValue()
 {
   int value = 0;
   libevdev_fetch_event_value(m_dev, EV_ABS, m_code, &value);
+  m_value.store(value, std::memory_order_relaxed);
+}
+
+ControlState evdevDevice::Axis::GetState() const
+{
+  const int value = m_value.load(std::memory_order_relaxed);
 
   // Value from 0.0 to 1.0
   ControlState fvalue = MathUtil::Clamp(double(value - m_min) / double(m_range), 0.0, 1.0);
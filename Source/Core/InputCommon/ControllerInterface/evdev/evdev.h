@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <libevdev/libevdev.h>
 #include <string>
 #include <vector>
@@ -21,17 +22,21 @@ void Shutdown();
 class evdevDevice : public Core::Device
 {
 private:
+  // Inputs keep a copy of their value, taken by the thread that reads the device, so they can
+  // be read from any thread while libevdev processes new events.
   class Button : public Core::Device::Input
   {
   public:
     std::string GetName() const override;
     Button(u8 index, u16 code, libevdev* dev) : m_index(index), m_code(code), m_dev(dev) {}
     ControlState GetState() const override;
+    void UpdateValue();
 
   private:
     const u8 m_index;
     const u16 m_code;
     libevdev* m_dev;
+    std::atomic<int> m_value{0};
   };
 
   class Axis : public Core::Device::Input
@@ -40,6 +45,7 @@ private:
     std::string GetName() const override;
     Axis(u8 index, u16 code, bool upper, libevdev* dev);
     ControlState GetState() const override;
+    void UpdateValue();
 
   private:
     const u16 m_code;
@@ -48,6 +54,7 @@ private:
     int m_range;
     int m_min;
     libevdev* m_dev;
+    std::atomic<int> m_value{0};
   };
 
   class ForceFeedback : public Core::Device::Output
@@ -66,6 +73,8 @@ private:
 
 public:
   void UpdateInput() override;
+  bool InputChanged() const override { return m_input_changed; }
+  int GetPollFD() const override { return m_initialized ? m_fd : -1; }
   bool IsValid() const override;
 
   evdevDevice(const std::string& devnode);
@@ -81,6 +90,9 @@ private:
   std::string m_name;
   bool m_initialized;
   bool m_interesting;
+  bool m_input_changed = true;
+  std::vector<Button*> m_buttons;
+  std::vector<Axis*> m_axes;
 };
 }
 }
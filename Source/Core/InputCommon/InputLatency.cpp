@@ -0,0 +1,186 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "InputCommon/InputLatency.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "Common/StringUtil.h"
+
+namespace InputLatency
+{
+// Input events older than this many versions can't be attributed to a poll anymore.
+constexpr size_t MAX_INPUT_EVENTS = 256;
+constexpr size_t MAX_SAMPLES = 1024;
+
+struct InputEvent
+{
+  u64 version;
+  u64 time_ns;
+};
+
+struct Sample
+{
+  u64 input_ns;
+  u64 poll_ns;
+  u64 poll_ticks;
+  u64 present_ns;
+};
+
+std::atomic<bool> detail::s_enabled{false};
+
+static std::mutex s_mutex;
+static std::array<InputEvent, MAX_INPUT_EVENTS> s_input_events;
+// Polled, waiting for their frame to be presented
+static std::vector<Sample> s_in_flight;
+// Ring buffer of complete samples
+static std::vector<Sample> s_samples;
+static size_t s_next_sample;
+
+static u64 GetSteadyClockNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static std::atomic<u64 (*)()> s_clock{GetSteadyClockNs};
+
+static u64 GetTimeNs()
+{
+  return s_clock.load(std::memory_order_relaxed)();
+}
+
+void SetEnabled(bool enabled)
+{
+  std::lock_guard<std::mutex> lk(s_mutex);
+  s_input_events = {};
+  s_in_flight.clear();
+  s_samples.clear();
+  s_next_sample = 0;
+  detail::s_enabled.store(enabled);
+}
+
+void SetClock(u64 (*clock)())
+{
+  s_clock.store(clock ? clock : GetSteadyClockNs);
+}
+
+void OnInputChanged(u64 input_version)
+{
+  if (!IsEnabled())
+    return;
+
+  const u64 now = GetTimeNs();
+  std::lock_guard<std::mutex> lk(s_mutex);
+  s_input_events[input_version % MAX_INPUT_EVENTS] = {input_version, now};
+}
+
+void OnInputPolled(PollSource* source, u64 input_version, bool changed, u64 ticks)
+{
+  const u64 last_version = source->last_input_version;
+  source->last_input_version = input_version;
+  if (!IsEnabled() || !changed || input_version <= last_version)
+    return;
+
+  const u64 now = GetTimeNs();
+  std::lock_guard<std::mutex> lk(s_mutex);
+
+  // The earliest event that this source hasn't seen yet.
+  const u64 first_version =
+      std::max(last_version + 1, input_version >= MAX_INPUT_EVENTS ?
+                                     input_version - MAX_INPUT_EVENTS + 1 :
+                                     0);
+  for (u64 version = first_version; version <= input_version; ++version)
+  {
+    const InputEvent& event = s_input_events[version % MAX_INPUT_EVENTS];
+    if (event.version == version && event.time_ns != 0)
+    {
+      // Nothing is presented while frames are skipped, for example.
+      if (s_in_flight.size() >= MAX_SAMPLES)
+        s_in_flight.erase(s_in_flight.begin());
+      s_in_flight.push_back({event.time_ns, now, ticks, 0});
+      return;
+    }
+  }
+}
+
+void OnFramePresented(u64 ticks)
+{
+  if (!IsEnabled())
+    return;
+
+  const u64 now = GetTimeNs();
+  std::lock_guard<std::mutex> lk(s_mutex);
+  const auto presented = std::partition(s_in_flight.begin(), s_in_flight.end(),
+                                        [ticks](const Sample& s) { return s.poll_ticks > ticks; });
+  for (auto it = presented; it != s_in_flight.end(); ++it)
+  {
+    Sample sample = *it;
+    sample.present_ns = now;
+    if (s_samples.size() < MAX_SAMPLES)
+      s_samples.push_back(sample);
+    else
+      s_samples[s_next_sample] = sample;
+    s_next_sample = (s_next_sample + 1) % MAX_SAMPLES;
+  }
+  s_in_flight.erase(presented, s_in_flight.end());
+}
+
+static Percentiles ComputePercentiles(std::vector<u64> durations_ns)
+{
+  if (durations_ns.empty())
+    return {};
+
+  std::sort(durations_ns.begin(), durations_ns.end());
+  const auto percentile = [&durations_ns](size_t p) {
+    return durations_ns[(durations_ns.size() - 1) * p / 100] / 1000;
+  };
+  return {percentile(50), percentile(90), percentile(99), durations_ns.back() / 1000};
+}
+
+Statistics GetStatistics()
+{
+  std::vector<u64> input_to_poll, poll_to_present, total;
+  {
+    std::lock_guard<std::mutex> lk(s_mutex);
+    for (const Sample& sample : s_samples)
+    {
+      input_to_poll.push_back(sample.poll_ns - sample.input_ns);
+      poll_to_present.push_back(sample.present_ns - sample.poll_ns);
+      total.push_back(sample.present_ns - sample.input_ns);
+    }
+  }
+
+  Statistics statistics;
+  statistics.samples = total.size();
+  statistics.input_to_poll = ComputePercentiles(std::move(input_to_poll));
+  statistics.poll_to_present = ComputePercentiles(std::move(poll_to_present));
+  statistics.total = ComputePercentiles(std::move(total));
+  return statistics;
+}
+
+static std::string FormatPercentiles(const char* name, const Percentiles& percentiles)
+{
+  return StringFromFormat("%s: p50 %.1f p90 %.1f p99 %.1f max %.1f ms\n", name,
+                          percentiles.p50_us / 1000.0, percentiles.p90_us / 1000.0,
+                          percentiles.p99_us / 1000.0, percentiles.max_us / 1000.0);
+}
+
+std::string GetStatisticsString()
+{
+  if (!IsEnabled())
+    return "";
+
+  const Statistics statistics = GetStatistics();
+  return StringFromFormat("Input latency (%zu samples):\n", statistics.samples) +
+         FormatPercentiles(" Input to poll", statistics.input_to_poll) +
+         FormatPercentiles(" Poll to present", statistics.poll_to_present) +
+         FormatPercentiles(" Input to present", statistics.total);
+}
+}  // namespace InputLatency
@@ -0,0 +1,78 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Measures input-to-photon latency: the time from a host input event to the emulated poll that
+// first carries it, and from there to the presentation of the first frame emulated after that
+// poll.
+//
+// Input events are identified by the ControllerInterface input version they produced. Each poll
+// source remembers the input version it last saw, so a poll whose data changed is attributed to
+// the earliest input event since its previous poll. Events that never change a poll (unmapped
+// inputs, for example) are never counted.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+namespace InputLatency
+{
+namespace detail
+{
+extern std::atomic<bool> s_enabled;
+}
+
+inline bool IsEnabled()
+{
+  return detail::s_enabled.load(std::memory_order_relaxed);
+}
+
+// Enabling or disabling clears all samples.
+void SetEnabled(bool enabled);
+
+// Replaces the host clock, which returns nanoseconds, e.g. for tests. nullptr restores it.
+void SetClock(u64 (*clock)());
+
+// Called from any thread, after a device's input changed and bumped the input version.
+void OnInputChanged(u64 input_version);
+
+// Something that polls input for the game, such as the serial interface or an emulated Wii
+// Remote.
+struct PollSource
+{
+  u64 last_input_version = 0;
+};
+
+// Called on the CPU thread after a poll. input_version is the input version the polled data was
+// built from, changed whether that data differs from the source's previous poll, and ticks the
+// emulated time of the poll.
+void OnInputPolled(PollSource* source, u64 input_version, bool changed, u64 ticks);
+
+// Called on the GPU thread once a frame has been presented. ticks is the emulated time at which
+// that frame was output.
+void OnFramePresented(u64 ticks);
+
+struct Percentiles
+{
+  u64 p50_us;
+  u64 p90_us;
+  u64 p99_us;
+  u64 max_us;
+};
+
+struct Statistics
+{
+  size_t samples;
+  Percentiles input_to_poll;
+  Percentiles poll_to_present;
+  Percentiles total;
+};
+
+// Over the most recent samples.
+Statistics GetStatistics();
+// An empty string if disabled.
+std::string GetStatisticsString();
+}  // namespace InputLatency
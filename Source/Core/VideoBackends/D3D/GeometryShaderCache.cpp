@@ -10,6 +10,7 @@
 #include "Common/StringUtil.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 #include "VideoBackends/D3D/D3DBase.h"
 #include "VideoBackends/D3D/D3DShader.h"
@@ -230,6 +231,8 @@ bool GeometryShaderCache::SetShader(u32 primitive_type)
   }
 
   // Need to compile a new shader
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
   ShaderCode code = GenerateGeometryShaderCode(APIType::D3D, uid.GetUidData());
 
   D3DBlob* pbytecode;
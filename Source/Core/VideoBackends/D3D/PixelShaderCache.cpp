@@ -11,6 +11,7 @@
 #include "Common/StringUtil.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 #include "VideoBackends/D3D/D3DBase.h"
 #include "VideoBackends/D3D/D3DShader.h"
@@ -583,6 +584,8 @@ bool PixelShaderCache::SetShader()
   }
 
   // Need to compile a new shader
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
   ShaderCode code = GeneratePixelShaderCode(APIType::D3D, uid.GetUidData());
 
   D3DBlob* pbytecode;
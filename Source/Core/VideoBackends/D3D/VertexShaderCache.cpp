@@ -11,6 +11,7 @@
 #include "Common/StringUtil.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 #include "VideoBackends/D3D/D3DShader.h"
 #include "VideoBackends/D3D/VertexShaderCache.h"
@@ -222,6 +223,8 @@ bool VertexShaderCache::SetShader()
     return (entry.shader != nullptr);
   }
 
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
   ShaderCode code = GenerateVertexShaderCode(APIType::D3D, uid.GetUidData());
 
   D3DBlob* pbytecode = nullptr;
@@ -15,6 +15,7 @@
 #include "Common/StringUtil.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 #include "VideoBackends/OGL/Render.h"
 #include "VideoBackends/OGL/StreamBuffer.h"
@@ -212,6 +213,9 @@ SHADER* ProgramShaderCache::SetShader(u32 primitive_type)
     return &last_entry->shader;
   }
 
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
+
   // Make an entry in the table
   PCacheEntry& newentry = pshaders[uid];
   last_entry = &newentry;
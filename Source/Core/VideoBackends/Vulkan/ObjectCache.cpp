@@ -15,6 +15,7 @@
 #include "Common/MsgHandler.h"
 
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 #include "VideoBackends/Vulkan/ShaderCompiler.h"
 #include "VideoBackends/Vulkan/StreamBuffer.h"
@@ -693,6 +694,8 @@ VkShaderModule ObjectCache::GetVertexShaderForUid(const VertexShaderUid& uid)
     return it->second;
 
   // Not in the cache, so compile the shader.
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
   ShaderCompiler::SPIRVCodeVector spv;
   VkShaderModule module = VK_NULL_HANDLE;
   ShaderCode source_code = GenerateVertexShaderCode(APIType::Vulkan, uid.GetUidData());
@@ -723,6 +726,8 @@ VkShaderModule ObjectCache::GetGeometryShaderForUid(const GeometryShaderUid& uid
     return it->second;
 
   // Not in the cache, so compile the shader.
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
   ShaderCompiler::SPIRVCodeVector spv;
   VkShaderModule module = VK_NULL_HANDLE;
   ShaderCode source_code = GenerateGeometryShaderCode(APIType::Vulkan, uid.GetUidData());
@@ -748,6 +753,8 @@ VkShaderModule ObjectCache::GetPixelShaderForUid(const PixelShaderUid& uid)
     return it->second;
 
   // Not in the cache, so compile the shader.
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUShader);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
   ShaderCompiler::SPIRVCodeVector spv;
   VkShaderModule module = VK_NULL_HANDLE;
   ShaderCode source_code = GeneratePixelShaderCode(APIType::Vulkan, uid.GetUidData());
@@ -16,6 +16,7 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/Host.h"
@@ -160,7 +161,10 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
   if (s_use_deterministic_gpu_thread)
   {
-    s_gpu_mainloop.Wait();
+    {
+      FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::SyncWait);
+      s_gpu_mainloop.Wait();
+    }
     if (!s_gpu_mainloop.IsRunning())
       return;
 
@@ -314,6 +318,7 @@ void RunGpuLoop()
           // See comment in SyncGPU
           if (write_ptr > seen_ptr)
           {
+            FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUDecode);
             s_video_buffer_read_ptr =
                 OpcodeDecoder::Run(DataReader(s_video_buffer_read_ptr, write_ptr), nullptr, false);
             s_video_buffer_seen_ptr = write_ptr;
@@ -349,8 +354,11 @@ void RunGpuLoop()
                          fifo.CPReadWriteDistance - 32);
 
             u8* write_ptr = s_video_buffer_write_ptr;
-            s_video_buffer_read_ptr = OpcodeDecoder::Run(
-                DataReader(s_video_buffer_read_ptr, write_ptr), &cyclesExecuted, false);
+            {
+              FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUDecode);
+              s_video_buffer_read_ptr = OpcodeDecoder::Run(
+                  DataReader(s_video_buffer_read_ptr, write_ptr), &cyclesExecuted, false);
+            }
 
             Common::AtomicStore(fifo.CPReadPointer, readPtr);
             Common::AtomicAdd(fifo.CPReadWriteDistance, static_cast<u32>(-32));
@@ -401,6 +409,7 @@ void FlushGpu()
   if (!param.bCPUThread || s_use_deterministic_gpu_thread)
     return;
 
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::SyncWait);
   s_gpu_mainloop.Wait();
 }
 
@@ -460,6 +469,7 @@ static int RunGpuOnCpu(int ticks)
       }
       ReadDataFromFifo(fifo.CPReadPointer);
       u32 cycles = 0;
+      FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUDecode);
       s_video_buffer_read_ptr = OpcodeDecoder::Run(
           DataReader(s_video_buffer_read_ptr, s_video_buffer_write_ptr), &cycles, false);
       available_ticks -= cycles;
@@ -556,7 +566,10 @@ static int WaitForGpuThread(int ticks)
 
   // Wait for GPU
   if (now >= param.iSyncGpuMaxDistance)
+  {
+    FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::SyncWait);
     s_sync_wakeup_event.Wait();
+  }
 
   return GPU_TIME_SLOT_SIZE;
 }
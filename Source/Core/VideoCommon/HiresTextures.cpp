@@ -41,6 +41,8 @@ static Common::Flag s_textureCacheAbortLoading;
 static bool s_check_native_format;
 static bool s_check_new_format;
 
+// Not a job, since it can take minutes, and it would keep a pool worker from other jobs all that
+// time.
 static std::thread s_prefetcher;
 
 static const std::string s_format_prefix = "tex1_";
@@ -15,6 +15,7 @@
 #include "VideoCommon/RenderBase.h"
 
 #include <cinttypes>
+#include <chrono>
 #include <cmath>
 #include <memory>
 #include <mutex>
@@ -37,9 +38,11 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/Host.h"
 #include "Core/Movie.h"
+#include "InputCommon/InputLatency.h"
 
 #include "VideoCommon/AVIDump.h"
 #include "VideoCommon/BPMemory.h"
@@ -92,6 +95,8 @@ Renderer::Renderer(int backbuffer_width, int backbuffer_height)
   OSDChoice = 0;
   OSDTime = 0;
 
+  stats.ResetFrameTimes();
+
   if (SConfig::GetInstance().bWii)
   {
     m_aspect_wide = SConfig::GetInstance().m_wii_aspect_ratio != 0;
@@ -712,6 +717,8 @@ void Renderer::RecordVideoMemory()
 void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const EFBRectangle& rc,
                     u64 ticks, float Gamma)
 {
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUBackend);
+
   // Heuristic to detect if a GameCube game is in 16:9 anamorphic widescreen mode.
   if (!SConfig::GetInstance().bWii)
   {
@@ -732,7 +739,11 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
   SwapImpl(xfbAddr, fbWidth, fbStride, fbHeight, rc, ticks, Gamma);
 
   if (m_xfb_written)
+  {
     m_fps_counter.Update();
+    stats.AddFrameTime(std::chrono::steady_clock::now());
+    InputLatency::OnFramePresented(ticks);
+  }
 
   frameCount++;
   GFX_DEBUGGER_PAUSE_AT(NEXT_FRAME, true);
@@ -802,6 +813,7 @@ void Renderer::FinishFrameData()
 void Renderer::RunFrameDumps()
 {
   Common::SetCurrentThreadName("FrameDumping");
+  Common::RegisterCurrentThread(Common::ThreadRole::Background);
   bool dump_to_avi = !g_ActiveConfig.bDumpFramesAsImages;
   bool frame_dump_started = false;
 
@@ -2,11 +2,13 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <utility>
 
 #include "Common/StringUtil.h"
+#include "InputCommon/InputLatency.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoConfig.h"
@@ -18,6 +20,63 @@ void Statistics::ResetFrame()
   memset(&thisFrame, 0, sizeof(ThisFrame));
 }
 
+void Statistics::ResetFrameTimes()
+{
+  frameTimeHistogram.fill(0);
+  numFrameTimes = 0;
+  lastFrameTime = {};
+}
+
+void Statistics::AddFrameTime(std::chrono::steady_clock::time_point now)
+{
+  const std::chrono::steady_clock::time_point last = lastFrameTime;
+  lastFrameTime = now;
+  // The first frame has nothing to be measured against.
+  if (last == std::chrono::steady_clock::time_point{})
+    return;
+
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(now - last).count();
+  const size_t bucket = std::min<size_t>(us / FRAME_TIME_BUCKET_US, NUM_FRAME_TIME_BUCKETS - 1);
+  frameTimeHistogram[bucket]++;
+  numFrameTimes++;
+}
+
+static std::string FrameTimesToString()
+{
+  if (stats.numFrameTimes == 0)
+    return "";
+
+  // Percentiles are reported as the upper end of the bucket they fall into.
+  auto percentile = [](u32 permille) {
+    const u32 rank = (static_cast<u64>(stats.numFrameTimes) * permille + 999) / 1000;
+    u32 seen = 0;
+    for (size_t i = 0; i < Statistics::NUM_FRAME_TIME_BUCKETS; ++i)
+    {
+      seen += stats.frameTimeHistogram[i];
+      if (seen >= rank)
+        return (i + 1) * Statistics::FRAME_TIME_BUCKET_US / 1000.0f;
+    }
+    return Statistics::NUM_FRAME_TIME_BUCKETS * Statistics::FRAME_TIME_BUCKET_US / 1000.0f;
+  };
+
+  std::string str = StringFromFormat("Frame times: %u, p50 %.1f ms, p99 %.1f ms\n",
+                                     stats.numFrameTimes, percentile(500), percentile(990));
+  for (size_t i = 0; i < Statistics::NUM_FRAME_TIME_BUCKETS; ++i)
+  {
+    if (stats.frameTimeHistogram[i] == 0)
+      continue;
+
+    const float start = i * Statistics::FRAME_TIME_BUCKET_US / 1000.0f;
+    if (i == Statistics::NUM_FRAME_TIME_BUCKETS - 1)
+      str += StringFromFormat("  >= %4.1f ms: %u\n", start, stats.frameTimeHistogram[i]);
+    else
+      str += StringFromFormat("  %4.1f-%4.1f ms: %u\n", start,
+                              start + Statistics::FRAME_TIME_BUCKET_US / 1000.0f,
+                              stats.frameTimeHistogram[i]);
+  }
+  return str;
+}
+
 void Statistics::SwapDL()
 {
   std::swap(stats.thisFrame.numDLPrims, stats.thisFrame.numPrims);
@@ -67,6 +126,8 @@ std::string Statistics::ToString()
   str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
   str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
   str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
+  str += FrameTimesToString();
+  str += InputLatency::GetStatisticsString();
 
   std::string vertex_list = VertexLoaderManager::VertexLoadersToString();
 
@@ -76,7 +137,7 @@ std::string Statistics::ToString()
   // window)
   // we should really reset the list instead of using substr
   if (vertex_list.size() + str.size() > 8170)
-    vertex_list = vertex_list.substr(0, 8170 - str.size());
+    vertex_list = vertex_list.substr(0, 8170 - std::min<size_t>(str.size(), 8170));
 
   str += vertex_list;
 
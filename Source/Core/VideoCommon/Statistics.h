@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <string>
 
+#include "Common/CommonTypes.h"
+
 struct Statistics
 {
   int numPixelShadersCreated;
@@ -63,7 +67,19 @@ struct Statistics
     int tevPixelsOut;
   };
   ThisFrame thisFrame;
+
+  // Time between presented frames, in FRAME_TIME_BUCKET_US wide buckets. The last bucket also
+  // counts everything longer.
+  static constexpr u32 FRAME_TIME_BUCKET_US = 500;
+  static constexpr size_t NUM_FRAME_TIME_BUCKETS = 100;
+  std::array<u32, NUM_FRAME_TIME_BUCKETS> frameTimeHistogram;
+  u32 numFrameTimes;
+  std::chrono::steady_clock::time_point lastFrameTime;
+
   void ResetFrame();
+  // Called on boot, so that frame times don't carry over from the previous game.
+  void ResetFrameTimes();
+  void AddFrameTime(std::chrono::steady_clock::time_point now);
   static void SwapDL();
 
   static std::string ToString();
@@ -21,6 +21,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/FifoPlayer/FifoPlayer.h"
 #include "Core/FifoPlayer/FifoRecorder.h"
+#include "Core/FrameTelemetry.h"
 #include "Core/HW/Memmap.h"
 
 #include "VideoCommon/BPMemory.h"
@@ -772,6 +773,8 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
                                                 static_cast<TlutFormat>(tlutfmt)) &&
       !(from_tmem && texformat == GX_TF_RGBA8);
 
+  FrameTelemetry::Increment(FrameTelemetry::Counter::TextureCacheMisses);
+
   // create the entry/texture
   TextureConfig config;
   config.width = width;
@@ -12,6 +12,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Core/ConfigManager.h"
+#include "Core/FrameTelemetry.h"
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/DataReader.h"
@@ -189,6 +190,8 @@ void VertexManagerBase::Flush()
   if (m_is_flushed)
     return;
 
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::GPUBackend);
+
   // loading a state will invalidate BP, so check for it
   g_video_backend->CheckInvalidState();
 
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <type_traits>
 
 #include "Common/CommonTypes.h"
 #include "Core/Config/GraphicsSettings.h"
@@ -41,6 +42,16 @@ VideoConfig::VideoConfig()
   bBackendMultithreading = true;
 }
 
+// Refresh runs on every config change, so it reads from the config snapshot, which has already
+// resolved every setting, instead of going through the layers again. The handles are created on
+// first use.
+template <const auto& info>
+static auto GetCached()
+{
+  static const Config::CachedInfo<std::decay_t<decltype(info.default_value)>> s_handle(info);
+  return s_handle.Get();
+}
+
 void VideoConfig::Refresh()
 {
   if (!s_has_registered_callback)
@@ -49,87 +60,87 @@ void VideoConfig::Refresh()
     s_has_registered_callback = true;
   }
 
-  bVSync = Config::Get(Config::GFX_VSYNC);
-  iAdapter = Config::Get(Config::GFX_ADAPTER);
-
-  bWidescreenHack = Config::Get(Config::GFX_WIDESCREEN_HACK);
-  iAspectRatio = Config::Get(Config::GFX_ASPECT_RATIO);
-  bCrop = Config::Get(Config::GFX_CROP);
-  bUseXFB = Config::Get(Config::GFX_USE_XFB);
-  bUseRealXFB = Config::Get(Config::GFX_USE_REAL_XFB);
-  iSafeTextureCache_ColorSamples = Config::Get(Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES);
-  bShowFPS = Config::Get(Config::GFX_SHOW_FPS);
-  bShowNetPlayPing = Config::Get(Config::GFX_SHOW_NETPLAY_PING);
-  bShowNetPlayMessages = Config::Get(Config::GFX_SHOW_NETPLAY_MESSAGES);
-  bLogRenderTimeToFile = Config::Get(Config::GFX_LOG_RENDER_TIME_TO_FILE);
-  bOverlayStats = Config::Get(Config::GFX_OVERLAY_STATS);
-  bOverlayProjStats = Config::Get(Config::GFX_OVERLAY_PROJ_STATS);
-  bDumpTextures = Config::Get(Config::GFX_DUMP_TEXTURES);
-  bHiresTextures = Config::Get(Config::GFX_HIRES_TEXTURES);
-  bConvertHiresTextures = Config::Get(Config::GFX_CONVERT_HIRES_TEXTURES);
-  bCacheHiresTextures = Config::Get(Config::GFX_CACHE_HIRES_TEXTURES);
-  bDumpEFBTarget = Config::Get(Config::GFX_DUMP_EFB_TARGET);
-  bDumpFramesAsImages = Config::Get(Config::GFX_DUMP_FRAMES_AS_IMAGES);
-  bFreeLook = Config::Get(Config::GFX_FREE_LOOK);
-  bUseFFV1 = Config::Get(Config::GFX_USE_FFV1);
-  sDumpFormat = Config::Get(Config::GFX_DUMP_FORMAT);
-  sDumpCodec = Config::Get(Config::GFX_DUMP_CODEC);
-  sDumpPath = Config::Get(Config::GFX_DUMP_PATH);
-  iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
-  bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
-  bEnableGPUTextureDecoding = Config::Get(Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
-  bEnablePixelLighting = Config::Get(Config::GFX_ENABLE_PIXEL_LIGHTING);
-  bFastDepthCalc = Config::Get(Config::GFX_FAST_DEPTH_CALC);
-  iMultisamples = Config::Get(Config::GFX_MSAA);
-  bSSAA = Config::Get(Config::GFX_SSAA);
-  iEFBScale = Config::Get(Config::GFX_EFB_SCALE);
-  bTexFmtOverlayEnable = Config::Get(Config::GFX_TEXFMT_OVERLAY_ENABLE);
-  bTexFmtOverlayCenter = Config::Get(Config::GFX_TEXFMT_OVERLAY_CENTER);
-  bWireFrame = Config::Get(Config::GFX_ENABLE_WIREFRAME);
-  bDisableFog = Config::Get(Config::GFX_DISABLE_FOG);
-  bBorderlessFullscreen = Config::Get(Config::GFX_BORDERLESS_FULLSCREEN);
-  bEnableValidationLayer = Config::Get(Config::GFX_ENABLE_VALIDATION_LAYER);
-  bBackendMultithreading = Config::Get(Config::GFX_BACKEND_MULTITHREADING);
-  iCommandBufferExecuteInterval = Config::Get(Config::GFX_COMMAND_BUFFER_EXECUTE_INTERVAL);
-  bShaderCache = Config::Get(Config::GFX_SHADER_CACHE);
-
-  bZComploc = Config::Get(Config::GFX_SW_ZCOMPLOC);
-  bZFreeze = Config::Get(Config::GFX_SW_ZFREEZE);
-  bDumpObjects = Config::Get(Config::GFX_SW_DUMP_OBJECTS);
-  bDumpTevStages = Config::Get(Config::GFX_SW_DUMP_TEV_STAGES);
-  bDumpTevTextureFetches = Config::Get(Config::GFX_SW_DUMP_TEV_TEX_FETCHES);
-  drawStart = Config::Get(Config::GFX_SW_DRAW_START);
-  drawEnd = Config::Get(Config::GFX_SW_DRAW_END);
-
-  bForceFiltering = Config::Get(Config::GFX_ENHANCE_FORCE_FILTERING);
-  iMaxAnisotropy = Config::Get(Config::GFX_ENHANCE_MAX_ANISOTROPY);
-  sPostProcessingShader = Config::Get(Config::GFX_ENHANCE_POST_SHADER);
-  bForceTrueColor = Config::Get(Config::GFX_ENHANCE_FORCE_TRUE_COLOR);
-
-  iStereoMode = Config::Get(Config::GFX_STEREO_MODE);
-  iStereoDepth = Config::Get(Config::GFX_STEREO_DEPTH);
-  iStereoConvergencePercentage = Config::Get(Config::GFX_STEREO_CONVERGENCE_PERCENTAGE);
-  bStereoSwapEyes = Config::Get(Config::GFX_STEREO_SWAP_EYES);
-  iStereoConvergence = Config::Get(Config::GFX_STEREO_CONVERGENCE);
-  bStereoEFBMonoDepth = Config::Get(Config::GFX_STEREO_EFB_MONO_DEPTH);
-  iStereoDepthPercentage = Config::Get(Config::GFX_STEREO_DEPTH_PERCENTAGE);
-
-  bEFBAccessEnable = Config::Get(Config::GFX_HACK_EFB_ACCESS_ENABLE);
-  bBBoxEnable = Config::Get(Config::GFX_HACK_BBOX_ENABLE);
+  bVSync = GetCached<Config::GFX_VSYNC>();
+  iAdapter = GetCached<Config::GFX_ADAPTER>();
+
+  bWidescreenHack = GetCached<Config::GFX_WIDESCREEN_HACK>();
+  iAspectRatio = GetCached<Config::GFX_ASPECT_RATIO>();
+  bCrop = GetCached<Config::GFX_CROP>();
+  bUseXFB = GetCached<Config::GFX_USE_XFB>();
+  bUseRealXFB = GetCached<Config::GFX_USE_REAL_XFB>();
+  iSafeTextureCache_ColorSamples = GetCached<Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES>();
+  bShowFPS = GetCached<Config::GFX_SHOW_FPS>();
+  bShowNetPlayPing = GetCached<Config::GFX_SHOW_NETPLAY_PING>();
+  bShowNetPlayMessages = GetCached<Config::GFX_SHOW_NETPLAY_MESSAGES>();
+  bLogRenderTimeToFile = GetCached<Config::GFX_LOG_RENDER_TIME_TO_FILE>();
+  bOverlayStats = GetCached<Config::GFX_OVERLAY_STATS>();
+  bOverlayProjStats = GetCached<Config::GFX_OVERLAY_PROJ_STATS>();
+  bDumpTextures = GetCached<Config::GFX_DUMP_TEXTURES>();
+  bHiresTextures = GetCached<Config::GFX_HIRES_TEXTURES>();
+  bConvertHiresTextures = GetCached<Config::GFX_CONVERT_HIRES_TEXTURES>();
+  bCacheHiresTextures = GetCached<Config::GFX_CACHE_HIRES_TEXTURES>();
+  bDumpEFBTarget = GetCached<Config::GFX_DUMP_EFB_TARGET>();
+  bDumpFramesAsImages = GetCached<Config::GFX_DUMP_FRAMES_AS_IMAGES>();
+  bFreeLook = GetCached<Config::GFX_FREE_LOOK>();
+  bUseFFV1 = GetCached<Config::GFX_USE_FFV1>();
+  sDumpFormat = GetCached<Config::GFX_DUMP_FORMAT>();
+  sDumpCodec = GetCached<Config::GFX_DUMP_CODEC>();
+  sDumpPath = GetCached<Config::GFX_DUMP_PATH>();
+  iBitrateKbps = GetCached<Config::GFX_BITRATE_KBPS>();
+  bInternalResolutionFrameDumps = GetCached<Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS>();
+  bEnableGPUTextureDecoding = GetCached<Config::GFX_ENABLE_GPU_TEXTURE_DECODING>();
+  bEnablePixelLighting = GetCached<Config::GFX_ENABLE_PIXEL_LIGHTING>();
+  bFastDepthCalc = GetCached<Config::GFX_FAST_DEPTH_CALC>();
+  iMultisamples = GetCached<Config::GFX_MSAA>();
+  bSSAA = GetCached<Config::GFX_SSAA>();
+  iEFBScale = GetCached<Config::GFX_EFB_SCALE>();
+  bTexFmtOverlayEnable = GetCached<Config::GFX_TEXFMT_OVERLAY_ENABLE>();
+  bTexFmtOverlayCenter = GetCached<Config::GFX_TEXFMT_OVERLAY_CENTER>();
+  bWireFrame = GetCached<Config::GFX_ENABLE_WIREFRAME>();
+  bDisableFog = GetCached<Config::GFX_DISABLE_FOG>();
+  bBorderlessFullscreen = GetCached<Config::GFX_BORDERLESS_FULLSCREEN>();
+  bEnableValidationLayer = GetCached<Config::GFX_ENABLE_VALIDATION_LAYER>();
+  bBackendMultithreading = GetCached<Config::GFX_BACKEND_MULTITHREADING>();
+  iCommandBufferExecuteInterval = GetCached<Config::GFX_COMMAND_BUFFER_EXECUTE_INTERVAL>();
+  bShaderCache = GetCached<Config::GFX_SHADER_CACHE>();
+
+  bZComploc = GetCached<Config::GFX_SW_ZCOMPLOC>();
+  bZFreeze = GetCached<Config::GFX_SW_ZFREEZE>();
+  bDumpObjects = GetCached<Config::GFX_SW_DUMP_OBJECTS>();
+  bDumpTevStages = GetCached<Config::GFX_SW_DUMP_TEV_STAGES>();
+  bDumpTevTextureFetches = GetCached<Config::GFX_SW_DUMP_TEV_TEX_FETCHES>();
+  drawStart = GetCached<Config::GFX_SW_DRAW_START>();
+  drawEnd = GetCached<Config::GFX_SW_DRAW_END>();
+
+  bForceFiltering = GetCached<Config::GFX_ENHANCE_FORCE_FILTERING>();
+  iMaxAnisotropy = GetCached<Config::GFX_ENHANCE_MAX_ANISOTROPY>();
+  sPostProcessingShader = GetCached<Config::GFX_ENHANCE_POST_SHADER>();
+  bForceTrueColor = GetCached<Config::GFX_ENHANCE_FORCE_TRUE_COLOR>();
+
+  iStereoMode = GetCached<Config::GFX_STEREO_MODE>();
+  iStereoDepth = GetCached<Config::GFX_STEREO_DEPTH>();
+  iStereoConvergencePercentage = GetCached<Config::GFX_STEREO_CONVERGENCE_PERCENTAGE>();
+  bStereoSwapEyes = GetCached<Config::GFX_STEREO_SWAP_EYES>();
+  iStereoConvergence = GetCached<Config::GFX_STEREO_CONVERGENCE>();
+  bStereoEFBMonoDepth = GetCached<Config::GFX_STEREO_EFB_MONO_DEPTH>();
+  iStereoDepthPercentage = GetCached<Config::GFX_STEREO_DEPTH_PERCENTAGE>();
+
+  bEFBAccessEnable = GetCached<Config::GFX_HACK_EFB_ACCESS_ENABLE>();
+  bBBoxEnable = GetCached<Config::GFX_HACK_BBOX_ENABLE>();
   bBBoxPreferStencilImplementation =
-      Config::Get(Config::GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION);
-  bForceProgressive = Config::Get(Config::GFX_HACK_FORCE_PROGRESSIVE);
-  bSkipEFBCopyToRam = Config::Get(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM);
-  bCopyEFBScaled = Config::Get(Config::GFX_HACK_COPY_EFB_ENABLED);
-  bEFBEmulateFormatChanges = Config::Get(Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES);
-  bVertexRounding = Config::Get(Config::GFX_HACK_VERTEX_ROUDING);
-
-  phack.m_enable = Config::Get(Config::GFX_PROJECTION_HACK) == 1;
-  phack.m_sznear = Config::Get(Config::GFX_PROJECTION_HACK_SZNEAR) == 1;
-  phack.m_szfar = Config::Get(Config::GFX_PROJECTION_HACK_SZFAR) == 1;
-  phack.m_znear = Config::Get(Config::GFX_PROJECTION_HACK_ZNEAR);
-  phack.m_zfar = Config::Get(Config::GFX_PROJECTION_HACK_ZFAR);
-  bPerfQueriesEnable = Config::Get(Config::GFX_PERF_QUERIES_ENABLE);
+      GetCached<Config::GFX_HACK_BBOX_PREFER_STENCIL_IMPLEMENTATION>();
+  bForceProgressive = GetCached<Config::GFX_HACK_FORCE_PROGRESSIVE>();
+  bSkipEFBCopyToRam = GetCached<Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM>();
+  bCopyEFBScaled = GetCached<Config::GFX_HACK_COPY_EFB_ENABLED>();
+  bEFBEmulateFormatChanges = GetCached<Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES>();
+  bVertexRounding = GetCached<Config::GFX_HACK_VERTEX_ROUDING>();
+
+  phack.m_enable = GetCached<Config::GFX_PROJECTION_HACK>() == 1;
+  phack.m_sznear = GetCached<Config::GFX_PROJECTION_HACK_SZNEAR>() == 1;
+  phack.m_szfar = GetCached<Config::GFX_PROJECTION_HACK_SZFAR>() == 1;
+  phack.m_znear = GetCached<Config::GFX_PROJECTION_HACK_ZNEAR>();
+  phack.m_zfar = GetCached<Config::GFX_PROJECTION_HACK_ZFAR>();
+  bPerfQueriesEnable = GetCached<Config::GFX_PERF_QUERIES_ENABLE>();
 
   if (iEFBScale == SCALE_FORCE_INTEGRAL)
   {
@@ -0,0 +1,101 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/HostPerfCounter.h"
+#include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
+
+namespace
+{
+constexpr size_t ARENA_SIZE = 0x4000000;
+
+// Touches memory in an order that defeats both the caches and the hardware prefetchers, so that
+// nearly every access needs a fresh translation with regular pages.
+u64 RandomAccess(u8* memory, size_t size)
+{
+  u64 sum = 0;
+  u32 state = 0x12345678;
+  for (int i = 0; i < 2000000; ++i)
+  {
+    state = state * 1664525 + 1013904223;
+    sum += memory[(state >> 4) % size];
+  }
+  return sum;
+}
+}  // namespace
+
+TEST(HugePages, AllocateMemoryPages)
+{
+  for (bool use_huge_pages : {false, true})
+  {
+    u8* memory = static_cast<u8*>(Common::AllocateMemoryPages(ARENA_SIZE, use_huge_pages));
+    ASSERT_NE(nullptr, memory);
+    std::memset(memory, 0xAB, ARENA_SIZE);
+    EXPECT_EQ(0xAB, memory[0]);
+    EXPECT_EQ(0xAB, memory[ARENA_SIZE - 1]);
+    Common::FreeMemoryPages(memory, ARENA_SIZE);
+  }
+}
+
+TEST(HugePages, ArenaKeepsViewLayout)
+{
+  MemArena arena;
+  arena.GrabSHMSegment(2 * Common::HUGE_PAGE_SIZE, true);
+
+  u8* base = MemArena::FindMemoryBase(Common::HUGE_PAGE_SIZE);
+  ASSERT_NE(nullptr, base);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(base) % Common::HUGE_PAGE_SIZE);
+
+  // Two views of the same backing memory must mirror each other, as they do for fastmem.
+  u8* view = static_cast<u8*>(arena.CreateView(0, 2 * Common::HUGE_PAGE_SIZE, base));
+  u8* mirror = static_cast<u8*>(
+      arena.CreateView(0, 2 * Common::HUGE_PAGE_SIZE, base + 4 * Common::HUGE_PAGE_SIZE));
+  ASSERT_EQ(base, view);
+  ASSERT_EQ(base + 4 * Common::HUGE_PAGE_SIZE, mirror);
+
+  view[0x1234] = 0x42;
+  view[Common::HUGE_PAGE_SIZE + 5] = 0x24;
+  EXPECT_EQ(0x42, mirror[0x1234]);
+  EXPECT_EQ(0x24, mirror[Common::HUGE_PAGE_SIZE + 5]);
+
+  arena.ReleaseView(mirror, 2 * Common::HUGE_PAGE_SIZE);
+  arena.ReleaseView(view, 2 * Common::HUGE_PAGE_SIZE);
+  arena.ReleaseSHMSegment();
+}
+
+TEST(HugePages, DTLBMissBenchmark)
+{
+  Common::HostPerfCounter dtlb_misses(Common::HostPerfCounter::Event::DTLBLoadMisses);
+  if (!dtlb_misses.IsAvailable())
+  {
+    std::printf("dTLB miss counter unavailable on this host, skipping measurement\n");
+    return;
+  }
+
+  u64 misses[2];
+  for (bool use_huge_pages : {false, true})
+  {
+    u8* memory = static_cast<u8*>(Common::AllocateMemoryPages(ARENA_SIZE, use_huge_pages));
+    ASSERT_NE(nullptr, memory);
+    std::memset(memory, 1, ARENA_SIZE);
+
+    dtlb_misses.Start();
+    const u64 sum = RandomAccess(memory, ARENA_SIZE);
+    dtlb_misses.Stop();
+    misses[use_huge_pages] = dtlb_misses.Read();
+    EXPECT_NE(0u, sum);
+
+    Common::FreeMemoryPages(memory, ARENA_SIZE);
+  }
+
+  std::printf("dTLB load misses: %" PRIu64 " with regular pages, %" PRIu64 " with huge pages\n",
+              misses[0], misses[1]);
+}
@@ -0,0 +1,203 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Common/Event.h"
+#include "Common/JobSystem.h"
+
+TEST(JobSystem, ScheduleAndWait)
+{
+  Common::JobSystem jobs(2);
+  std::atomic<int> counter(0);
+  std::vector<Common::JobHandle> handles;
+  for (int i = 0; i < 1000; i++)
+    handles.push_back(jobs.Schedule([&] { counter++; }));
+
+  for (const Common::JobHandle& handle : handles)
+    jobs.Wait(handle);
+
+  EXPECT_EQ(1000, counter.load());
+  for (const Common::JobHandle& handle : handles)
+    EXPECT_TRUE(handle.IsDone());
+
+  // Empty handles are always done and must not block.
+  Common::JobHandle empty;
+  EXPECT_TRUE(empty.IsDone());
+  jobs.Wait(empty);
+}
+
+TEST(JobSystem, DestructorDrainsQueue)
+{
+  std::atomic<int> counter(0);
+  {
+    Common::JobSystem jobs(1);
+    for (int i = 0; i < 100; i++)
+      jobs.Schedule([&] { counter++; }, Common::JobPriority::Low);
+  }
+  EXPECT_EQ(100, counter.load());
+}
+
+TEST(JobSystem, Priorities)
+{
+  Common::JobSystem jobs(1);
+
+  // Keep the only worker busy while the queue fills up.
+  Common::Event started;
+  Common::Event release;
+  Common::JobHandle blocker = jobs.Schedule(
+      [&] {
+        started.Set();
+        release.Wait();
+      },
+      Common::JobPriority::Normal, Common::JobAffinity::WorkerOnly);
+  started.Wait();
+
+  std::vector<int> order;
+  std::vector<Common::JobHandle> handles;
+  handles.push_back(jobs.Schedule([&] { order.push_back(2); }, Common::JobPriority::Low,
+                                  Common::JobAffinity::WorkerOnly));
+  handles.push_back(jobs.Schedule([&] { order.push_back(1); }, Common::JobPriority::Normal,
+                                  Common::JobAffinity::WorkerOnly));
+  handles.push_back(jobs.Schedule([&] { order.push_back(0); }, Common::JobPriority::High,
+                                  Common::JobAffinity::WorkerOnly));
+  release.Set();
+
+  jobs.Wait(blocker);
+  for (const Common::JobHandle& handle : handles)
+    jobs.Wait(handle);
+
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+}
+
+TEST(JobSystem, WorkerOnlyAffinity)
+{
+  Common::JobSystem jobs(2);
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<int> ran_on_caller(0);
+  std::vector<Common::JobHandle> handles;
+  for (int i = 0; i < 200; i++)
+  {
+    handles.push_back(jobs.Schedule(
+        [&] {
+          if (std::this_thread::get_id() == caller)
+            ran_on_caller++;
+        },
+        Common::JobPriority::Normal, Common::JobAffinity::WorkerOnly));
+  }
+
+  for (const Common::JobHandle& handle : handles)
+    jobs.Wait(handle);
+
+  EXPECT_EQ(0, ran_on_caller.load());
+}
+
+TEST(JobSystem, ParallelFor)
+{
+  Common::JobSystem jobs(3);
+  std::vector<std::atomic<int>> hits(10007);
+  for (auto& hit : hits)
+    hit.store(0);
+
+  jobs.ParallelFor(0, hits.size(), 64, [&](size_t i) { hits[i]++; });
+  for (const auto& hit : hits)
+    EXPECT_EQ(1, hit.load());
+
+  // Degenerate ranges and grain sizes.
+  std::atomic<int> calls(0);
+  jobs.ParallelFor(5, 5, 1, [&](size_t) { calls++; });
+  EXPECT_EQ(0, calls.load());
+  jobs.ParallelFor(0, 3, 0, [&](size_t) { calls++; });
+  EXPECT_EQ(3, calls.load());
+  jobs.ParallelFor(0, 3, 1000, [&](size_t) { calls++; });
+  EXPECT_EQ(6, calls.load());
+}
+
+TEST(JobSystem, NestedParallelFor)
+{
+  Common::JobSystem jobs(2);
+  std::atomic<int> sum(0);
+
+  // Every outer iteration runs on a worker and waits on inner work, which only completes if the
+  // workers help out or steal from each other while waiting.
+  jobs.ParallelFor(0, 16, 1, [&](size_t) {
+    jobs.ParallelFor(0, 100, 10, [&](size_t i) { sum += static_cast<int>(i); });
+  });
+
+  EXPECT_EQ(16 * 4950, sum.load());
+}
+
+#ifdef __linux__
+static std::string GetCurrentThreadName()
+{
+  char name[16] = {};
+  pthread_getname_np(pthread_self(), name, sizeof(name));
+  return name;
+}
+
+TEST(JobSystem, JobNames)
+{
+  Common::JobSystem jobs(1);
+  std::string named, unnamed;
+  jobs.Wait(jobs.Schedule(
+      [&] {
+        Common::JobSystem::SetCurrentJobName("Named job");
+        named = GetCurrentThreadName();
+      },
+      Common::JobPriority::Normal, Common::JobAffinity::WorkerOnly));
+  // The worker gets its own name back for the next job.
+  jobs.Wait(jobs.Schedule([&] { unnamed = GetCurrentThreadName(); }, Common::JobPriority::Normal,
+                          Common::JobAffinity::WorkerOnly));
+  EXPECT_EQ("Named job", named);
+  EXPECT_EQ("Job worker 0", unnamed);
+
+  // Threads other than workers keep their names.
+  const std::string name = GetCurrentThreadName();
+  Common::JobSystem::SetCurrentJobName("Not a job");
+  EXPECT_EQ(name, GetCurrentThreadName());
+}
+#endif
+
+TEST(JobSystem, SchedulingBenchmark)
+{
+  Common::JobSystem jobs;
+  constexpr int NUM_JOBS = 100000;
+
+  std::atomic<int> counter(0);
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Common::JobHandle> handles;
+  handles.reserve(NUM_JOBS);
+  for (int i = 0; i < NUM_JOBS; i++)
+    handles.push_back(jobs.Schedule([&] { counter++; }));
+  for (const Common::JobHandle& handle : handles)
+    jobs.Wait(handle);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(NUM_JOBS, counter.load());
+
+  const double schedule_ns =
+      std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(NUM_JOBS);
+  std::printf("Schedule+Wait: %.1f ns per job on %u workers\n", schedule_ns,
+              jobs.GetWorkerCount());
+
+  counter = 0;
+  start = std::chrono::steady_clock::now();
+  jobs.ParallelFor(0, NUM_JOBS, 256, [&](size_t) { counter++; });
+  elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(NUM_JOBS, counter.load());
+
+  const double parallel_for_ns =
+      std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(NUM_JOBS);
+  std::printf("ParallelFor: %.1f ns per index\n", parallel_for_ns);
+}
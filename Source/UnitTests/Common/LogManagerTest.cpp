@@ -0,0 +1,201 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/Event.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/Logging/LogManager.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+class TestListener : public LogListener
+{
+public:
+  void Log(LogTypes::LOG_LEVELS, const char* msg) override
+  {
+    if (block_first)
+    {
+      block_first = false;
+      blocked.Set();
+      release.Wait();
+    }
+
+    std::lock_guard<std::mutex> lk(mutex);
+    messages.emplace_back(msg);
+    thread_ids.push_back(std::this_thread::get_id());
+  }
+
+  bool block_first = false;
+  Common::Event blocked;
+  Common::Event release;
+
+  std::mutex mutex;
+  std::vector<std::string> messages;
+  std::vector<std::thread::id> thread_ids;
+};
+
+// Returns the text of a message, without the timestamp and location.
+std::string GetText(const std::string& message)
+{
+  const size_t start = message.find("]: ");
+  return start == std::string::npos ? "" : message.substr(start + 3);
+}
+}  // namespace
+
+class LogManagerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    LogManager::Init();
+
+    LogManager* manager = LogManager::GetInstance();
+    manager->EnableListener(LogListener::FILE_LISTENER, false);
+    manager->EnableListener(LogListener::CONSOLE_LISTENER, false);
+    manager->RegisterListener(LogListener::LOG_WINDOW_LISTENER, &m_listener);
+    manager->EnableListener(LogListener::LOG_WINDOW_LISTENER, true);
+    manager->SetEnable(LogTypes::COMMON, true);
+    manager->SetLogLevel(LogTypes::LNOTICE);
+  }
+
+  void TearDown() override
+  {
+    LogManager::GetInstance()->RegisterListener(LogListener::LOG_WINDOW_LISTENER, nullptr);
+    LogManager::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  TestListener m_listener;
+
+private:
+  std::string m_profile_path;
+};
+
+TEST_F(LogManagerTest, AsynchronousKeepsPerThreadOrder)
+{
+  LogManager* manager = LogManager::GetInstance();
+  ASSERT_TRUE(manager->IsAsynchronous());
+
+  constexpr int NUM_THREADS = 4;
+  constexpr int NUM_MESSAGES = 200;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < NUM_THREADS; i++)
+  {
+    threads.emplace_back([i] {
+      for (int j = 0; j < NUM_MESSAGES; j++)
+        NOTICE_LOG(COMMON, "thread %d message %d", i, j);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+
+  manager->Flush();
+  EXPECT_EQ(0u, manager->GetDroppedMessageCount());
+
+  std::lock_guard<std::mutex> lk(m_listener.mutex);
+  ASSERT_EQ(static_cast<size_t>(NUM_THREADS * NUM_MESSAGES), m_listener.messages.size());
+
+  int next_message[NUM_THREADS] = {};
+  for (const std::string& message : m_listener.messages)
+  {
+    int thread;
+    int index;
+    ASSERT_EQ(2, std::sscanf(GetText(message).c_str(), "thread %d message %d", &thread, &index));
+    ASSERT_LT(thread, NUM_THREADS);
+    EXPECT_EQ(next_message[thread]++, index);
+  }
+
+  // None of the listener calls happened on the logging threads.
+  for (const std::thread::id& id : m_listener.thread_ids)
+    EXPECT_NE(std::this_thread::get_id(), id);
+}
+
+TEST_F(LogManagerTest, DropsInsteadOfBlocking)
+{
+  LogManager* manager = LogManager::GetInstance();
+  m_listener.block_first = true;
+
+  NOTICE_LOG(COMMON, "blocker");
+  m_listener.blocked.Wait();
+
+  // The drain thread is stuck in the listener, so this fills up the ring and must not block.
+  constexpr int NUM_MESSAGES = 1000;
+  for (int i = 0; i < NUM_MESSAGES; i++)
+    NOTICE_LOG(COMMON, "message %d", i);
+
+  const u64 dropped = manager->GetDroppedMessageCount();
+  EXPECT_GT(dropped, 0u);
+  EXPECT_LT(dropped, static_cast<u64>(NUM_MESSAGES));
+
+  m_listener.release.Set();
+  manager->Flush();
+
+  std::lock_guard<std::mutex> lk(m_listener.mutex);
+  EXPECT_EQ(NUM_MESSAGES - dropped + 2, m_listener.messages.size());
+  EXPECT_NE(std::string::npos, m_listener.messages.back().find("were dropped"));
+}
+
+TEST_F(LogManagerTest, SwitchingToSynchronousKeepsMessages)
+{
+  LogManager* manager = LogManager::GetInstance();
+
+  constexpr int NUM_THREADS = 4;
+  constexpr int NUM_MESSAGES = 2000;
+  Common::Event started;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < NUM_THREADS; i++)
+  {
+    threads.emplace_back([&started, i] {
+      for (int j = 0; j < NUM_MESSAGES; j++)
+      {
+        NOTICE_LOG(COMMON, "thread %d message %d", i, j);
+        if (j == NUM_MESSAGES / 4)
+          started.Set();
+      }
+    });
+  }
+  started.Wait();
+  manager->SetAsynchronous(false);
+  for (std::thread& thread : threads)
+    thread.join();
+
+  std::lock_guard<std::mutex> lk(m_listener.mutex);
+  size_t received = 0;
+  for (const std::string& message : m_listener.messages)
+  {
+    if (GetText(message).compare(0, 7, "thread ") == 0)
+      received++;
+  }
+  EXPECT_EQ(NUM_THREADS * NUM_MESSAGES - manager->GetDroppedMessageCount(), received);
+}
+
+TEST_F(LogManagerTest, Synchronous)
+{
+  LogManager* manager = LogManager::GetInstance();
+  manager->SetAsynchronous(false);
+
+  NOTICE_LOG(COMMON, "synchronous %d", 42);
+
+  std::lock_guard<std::mutex> lk(m_listener.mutex);
+  ASSERT_EQ(1u, m_listener.messages.size());
+  EXPECT_EQ("synchronous 42\n", GetText(m_listener.messages[0]));
+  EXPECT_EQ(std::this_thread::get_id(), m_listener.thread_ids[0]);
+
+  // Filtered out messages never reach the listeners.
+  manager->SetEnable(LogTypes::COMMON, false);
+  NOTICE_LOG(COMMON, "filtered");
+  EXPECT_EQ(1u, m_listener.messages.size());
+}
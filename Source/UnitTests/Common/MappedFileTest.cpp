@@ -0,0 +1,101 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/MappedFile.h"
+#include "Common/SDCardUtil.h"
+
+namespace
+{
+class MappedFileTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_temp_dir = File::CreateTempDir(); }
+  void TearDown() override { File::DeleteDirRecursively(m_temp_dir); }
+
+  std::string m_temp_dir;
+};
+}  // namespace
+
+TEST_F(MappedFileTest, OnlyMapsExistingFiles)
+{
+  File::MappedFile mapping;
+  EXPECT_FALSE(mapping.Open(m_temp_dir + DIR_SEP "missing.raw"));
+  EXPECT_FALSE(mapping.IsOpen());
+
+  const std::string empty = m_temp_dir + DIR_SEP "empty.raw";
+  File::IOFile(empty, "wb");
+  EXPECT_FALSE(mapping.Open(empty));
+  EXPECT_FALSE(mapping.Flush());
+}
+
+TEST_F(MappedFileTest, MapsSDCardImage)
+{
+  constexpr u64 SIZE = 16 * 1024 * 1024;
+  const std::string path = m_temp_dir + DIR_SEP "sd.raw";
+  ASSERT_TRUE(SDCardCreate(SIZE / (1024 * 1024), path));
+  EXPECT_EQ(SIZE, File::GetSize(path));
+
+  File::MappedFile mapping;
+  ASSERT_TRUE(mapping.Open(path));
+  ASSERT_EQ(SIZE, mapping.GetSize());
+  const u8* data = mapping.GetData();
+  // The boot sector and its backup in sector 6 end with the boot signature.
+  EXPECT_EQ(0x55, data[510]);
+  EXPECT_EQ(0xaa, data[511]);
+  EXPECT_EQ(0, std::memcmp(data, data + 6 * 512, 512));
+  EXPECT_EQ(0, data[SIZE - 1]);
+
+  // Writes reach the file, both through the mapping and after closing it.
+  const std::vector<u8> block(512, 0x5a);
+  std::memcpy(mapping.GetData() + SIZE - block.size(), block.data(), block.size());
+  EXPECT_TRUE(mapping.Flush());
+  std::vector<u8> read_back(block.size());
+  File::IOFile file(path, "rb");
+  ASSERT_TRUE(file.Seek(SIZE - block.size(), SEEK_SET));
+  ASSERT_TRUE(file.ReadBytes(read_back.data(), read_back.size()));
+  EXPECT_EQ(block, read_back);
+
+  std::memcpy(mapping.GetData(), block.data(), block.size());
+  mapping.Close();
+  EXPECT_FALSE(mapping.IsOpen());
+  ASSERT_TRUE(file.Seek(0, SEEK_SET));
+  ASSERT_TRUE(file.ReadBytes(read_back.data(), read_back.size()));
+  EXPECT_EQ(block, read_back);
+}
+
+TEST_F(MappedFileTest, MapsOpenFile)
+{
+  // As the SD card does, which keeps the file open for when the mapping can't be used.
+  constexpr u64 SIZE = 8 * 1024 * 1024;
+  const std::string path = m_temp_dir + DIR_SEP "sd.raw";
+  ASSERT_TRUE(SDCardCreate(SIZE / (1024 * 1024), path));
+  File::IOFile file(path, "r+b");
+  ASSERT_TRUE(file);
+  File::MappedFile mapping;
+  ASSERT_TRUE(mapping.Open(path));
+
+  const std::vector<u8> written(512, 0xa5);
+  ASSERT_TRUE(file.Seek(SIZE - written.size(), SEEK_SET));
+  ASSERT_TRUE(file.WriteBytes(written.data(), written.size()));
+  ASSERT_TRUE(file.Flush());
+  EXPECT_EQ(0, std::memcmp(written.data(), mapping.GetData() + SIZE - written.size(),
+                           written.size()));
+
+  std::memset(mapping.GetData(), 0x3c, written.size());
+  EXPECT_TRUE(mapping.Flush());
+  std::vector<u8> read_back(written.size());
+  ASSERT_TRUE(file.Seek(0, SEEK_SET));
+  ASSERT_TRUE(file.ReadBytes(read_back.data(), read_back.size()));
+  EXPECT_EQ(std::vector<u8>(written.size(), 0x3c), read_back);
+}
@@ -0,0 +1,215 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/PcapFile.h"
+
+namespace
+{
+constexpr size_t FILE_HEADER_SIZE = 24;
+constexpr size_t RECORD_HEADER_SIZE = 16;
+
+struct Record
+{
+  u32 real_size;
+  std::vector<u8> data;
+};
+
+// Reads back the link type and the records of a capture file.
+bool ReadCapture(const std::string& path, u32* link_type, u32* snap_length,
+                 std::vector<Record>* records)
+{
+  std::string contents;
+  if (!File::ReadFileToString(path, contents) || contents.size() < FILE_HEADER_SIZE)
+    return false;
+
+  u32 magic;
+  std::memcpy(&magic, &contents[0], sizeof(magic));
+  std::memcpy(snap_length, &contents[16], sizeof(*snap_length));
+  std::memcpy(link_type, &contents[20], sizeof(*link_type));
+  if (magic != 0xa1b2c3d4)
+    return false;
+
+  records->clear();
+  size_t offset = FILE_HEADER_SIZE;
+  while (offset + RECORD_HEADER_SIZE <= contents.size())
+  {
+    u32 size;
+    Record record;
+    std::memcpy(&size, &contents[offset + 8], sizeof(size));
+    std::memcpy(&record.real_size, &contents[offset + 12], sizeof(record.real_size));
+    offset += RECORD_HEADER_SIZE;
+    if (offset + size > contents.size())
+      return false;
+    record.data.assign(contents.begin() + offset, contents.begin() + offset + size);
+    records->push_back(std::move(record));
+    offset += size;
+  }
+  return offset == contents.size();
+}
+
+std::vector<u8> MakePacket(u8 id, size_t size)
+{
+  return std::vector<u8>(size, id);
+}
+
+class PcapFileTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_temp_dir = File::CreateTempDir(); }
+  void TearDown() override { File::DeleteDirRecursively(m_temp_dir); }
+
+  std::string m_temp_dir;
+};
+}  // namespace
+
+TEST_F(PcapFileTest, WritesHeaderAndTruncatesPackets)
+{
+  const std::string path = m_temp_dir + DIR_SEP "capture.pcap";
+  {
+    PCAP pcap(new File::IOFile(path, "wb"), 32, PCAP::LINK_TYPE_ETHERNET);
+    const std::vector<u8> small = MakePacket(1, 20);
+    const std::vector<u8> large = MakePacket(2, 100);
+    pcap.AddPacket(small.data(), small.size());
+    pcap.AddPacket(large.data(), large.size());
+  }
+
+  u32 link_type, snap_length;
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadCapture(path, &link_type, &snap_length, &records));
+  EXPECT_EQ(PCAP::LINK_TYPE_ETHERNET, link_type);
+  EXPECT_EQ(32u, snap_length);
+  ASSERT_EQ(2u, records.size());
+  EXPECT_EQ(MakePacket(1, 20), records[0].data);
+  EXPECT_EQ(20u, records[0].real_size);
+  EXPECT_EQ(MakePacket(2, 32), records[1].data);
+  EXPECT_EQ(100u, records[1].real_size);
+}
+
+TEST_F(PcapFileTest, AsyncWritesEverythingBeforeDestruction)
+{
+  const std::string path = m_temp_dir + DIR_SEP "capture.pcap";
+  AsyncPCAP::Options options;
+  options.snap_length = 64;
+  {
+    AsyncPCAP pcap(path, options);
+    ASSERT_TRUE(pcap.IsOpen());
+    for (u32 i = 0; i < 1000; ++i)
+    {
+      const std::vector<u8> packet = MakePacket(static_cast<u8>(i), 1 + i % 128);
+      pcap.AddPacket(packet.data(), packet.size());
+    }
+
+    const AsyncPCAP::Stats stats = pcap.GetStats();
+    EXPECT_EQ(1000u, stats.packets);
+    EXPECT_EQ(0u, stats.dropped);
+    EXPECT_EQ(1u, stats.files);
+  }
+
+  u32 link_type, snap_length;
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadCapture(path, &link_type, &snap_length, &records));
+  EXPECT_EQ(PCAP::LINK_TYPE_USER, link_type);
+  ASSERT_EQ(1000u, records.size());
+  for (u32 i = 0; i < records.size(); ++i)
+  {
+    const size_t size = 1 + i % 128;
+    EXPECT_EQ(size, records[i].real_size);
+    EXPECT_EQ(MakePacket(static_cast<u8>(i), std::min<size_t>(size, 64)), records[i].data);
+  }
+}
+
+TEST_F(PcapFileTest, AsyncDropsWhatDoesNotFit)
+{
+  const std::string path = m_temp_dir + DIR_SEP "capture.pcap";
+  AsyncPCAP::Options options;
+  options.buffer_size = 64;
+  {
+    AsyncPCAP pcap(path, options);
+    const std::vector<u8> packet = MakePacket(1, 100);
+    pcap.AddPacket(packet.data(), packet.size());
+    pcap.AddPacket(packet.data(), 8);
+
+    const AsyncPCAP::Stats stats = pcap.GetStats();
+    EXPECT_EQ(1u, stats.packets);
+    EXPECT_EQ(8u, stats.bytes);
+    EXPECT_EQ(1u, stats.dropped);
+  }
+
+  u32 link_type, snap_length;
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadCapture(path, &link_type, &snap_length, &records));
+  ASSERT_EQ(1u, records.size());
+  EXPECT_EQ(MakePacket(1, 8), records[0].data);
+}
+
+TEST_F(PcapFileTest, AsyncRotatesFiles)
+{
+  const std::string path = m_temp_dir + DIR_SEP "capture.pcap";
+  AsyncPCAP::Options options;
+  // Room for exactly one packet per file.
+  options.rotate_size = FILE_HEADER_SIZE + RECORD_HEADER_SIZE + 100;
+  options.max_files = 2;
+  {
+    AsyncPCAP pcap(path, options);
+    for (u8 i = 0; i < 5; ++i)
+    {
+      const std::vector<u8> packet = MakePacket(i, 100);
+      pcap.AddPacket(packet.data(), packet.size());
+    }
+  }
+
+  EXPECT_EQ(m_temp_dir + DIR_SEP "capture.3.pcap", AsyncPCAP::GetFilePath(path, 3));
+  EXPECT_FALSE(File::Exists(AsyncPCAP::GetFilePath(path, 0)));
+  EXPECT_FALSE(File::Exists(AsyncPCAP::GetFilePath(path, 2)));
+  EXPECT_FALSE(File::Exists(AsyncPCAP::GetFilePath(path, 5)));
+  for (u8 i = 3; i < 5; ++i)
+  {
+    u32 link_type, snap_length;
+    std::vector<Record> records;
+    ASSERT_TRUE(ReadCapture(AsyncPCAP::GetFilePath(path, i), &link_type, &snap_length, &records));
+    ASSERT_EQ(1u, records.size());
+    EXPECT_EQ(MakePacket(i, 100), records[0].data);
+  }
+}
+
+TEST_F(PcapFileTest, AsyncStopsWhenRotationFails)
+{
+  const std::string path = m_temp_dir + DIR_SEP "capture.pcap";
+  // A directory where the second file would go.
+  ASSERT_TRUE(File::CreateDir(AsyncPCAP::GetFilePath(path, 1)));
+  AsyncPCAP::Options options;
+  options.rotate_size = FILE_HEADER_SIZE + RECORD_HEADER_SIZE + 100;
+  {
+    AsyncPCAP pcap(path, options);
+    const std::vector<u8> packet = MakePacket(1, 100);
+    pcap.AddPacket(packet.data(), packet.size());
+    pcap.AddPacket(packet.data(), packet.size());
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (pcap.IsOpen() && std::chrono::steady_clock::now() < timeout)
+      std::this_thread::yield();
+    ASSERT_FALSE(pcap.IsOpen());
+
+    pcap.AddPacket(packet.data(), packet.size());
+    EXPECT_EQ(2u, pcap.GetStats().packets);
+  }
+
+  u32 link_type, snap_length;
+  std::vector<Record> records;
+  ASSERT_TRUE(ReadCapture(path, &link_type, &snap_length, &records));
+  EXPECT_EQ(1u, records.size());
+}
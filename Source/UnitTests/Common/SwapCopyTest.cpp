@@ -0,0 +1,154 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "Common/SwapCopy.h"
+
+namespace
+{
+// Runs a test once for every implementation the host supports.
+template <typename F>
+void ForEachImplementation(F f)
+{
+  const bool avx2 = cpu_info.bAVX2;
+  const bool ssse3 = cpu_info.bSSSE3;
+
+  cpu_info.bAVX2 = false;
+  cpu_info.bSSSE3 = false;
+  f("scalar");
+  if (ssse3)
+  {
+    cpu_info.bSSSE3 = true;
+    f("SSSE3");
+  }
+  if (avx2)
+  {
+    cpu_info.bAVX2 = true;
+    f("AVX2");
+  }
+
+  cpu_info.bAVX2 = avx2;
+  cpu_info.bSSSE3 = ssse3;
+}
+
+template <typename T>
+void CheckSwapCopy(const char* implementation)
+{
+  constexpr size_t MAX_COUNT = 300;
+  std::vector<u8> src(MAX_COUNT * sizeof(T) + 1);
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = static_cast<u8>(i * 7 + 3);
+
+  // Unaligned on both sides, and every length around the vector widths.
+  for (size_t offset = 0; offset < 2; ++offset)
+  {
+    for (size_t count = 0; count < MAX_COUNT; ++count)
+    {
+      std::vector<u8> dst(src.size() + 2, 0xcc);
+      Common::SwapCopy(reinterpret_cast<T*>(dst.data() + 1),
+                       reinterpret_cast<const T*>(src.data() + offset), count);
+
+      EXPECT_EQ(0xcc, dst[0]);
+      for (size_t i = 0; i < count; ++i)
+      {
+        T expected, actual;
+        std::memcpy(&expected, src.data() + offset + i * sizeof(T), sizeof(T));
+        std::memcpy(&actual, dst.data() + 1 + i * sizeof(T), sizeof(T));
+        ASSERT_EQ(Common::FromBigEndian(expected), actual)
+            << implementation << ", " << sizeof(T) * 8 << "-bit, count " << count << ", element "
+            << i;
+      }
+      EXPECT_EQ(0xcc, dst[1 + count * sizeof(T)]) << implementation << " wrote past the end";
+    }
+  }
+}
+
+template <typename T>
+void CheckInPlace(const char* implementation)
+{
+  constexpr size_t COUNT = 123;
+  std::vector<T> values(COUNT);
+  for (size_t i = 0; i < COUNT; ++i)
+    values[i] = static_cast<T>(0x0123456789abcdefull * (i + 1));
+
+  std::vector<T> swapped = values;
+  Common::SwapCopy(swapped.data(), swapped.data(), COUNT);
+  for (size_t i = 0; i < COUNT; ++i)
+    ASSERT_EQ(Common::FromBigEndian(values[i]), swapped[i]) << implementation;
+}
+
+// What the DMA paths used to do.
+void SwapLoop32(u32* dst, const u32* src, size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+    dst[i] = Common::FromBigEndian(src[i]);
+}
+}  // namespace
+
+TEST(SwapCopy, AllWidths)
+{
+  ForEachImplementation([](const char* implementation) {
+    CheckSwapCopy<u16>(implementation);
+    CheckSwapCopy<u32>(implementation);
+    CheckSwapCopy<u64>(implementation);
+  });
+}
+
+TEST(SwapCopy, InPlace)
+{
+  ForEachImplementation([](const char* implementation) {
+    CheckInPlace<u16>(implementation);
+    CheckInPlace<u32>(implementation);
+    CheckInPlace<u64>(implementation);
+  });
+}
+
+TEST(SwapCopy, Bytes)
+{
+  const u8 src[5] = {1, 2, 3, 4, 5};
+  u8 dst[5] = {};
+  Common::SwapCopy(dst, src, 5);
+  EXPECT_EQ(0, std::memcmp(src, dst, 5));
+}
+
+TEST(SwapCopy, ThroughputBenchmark)
+{
+  // About the size of a large ARAM or DSP DMA, so that it stays in cache.
+  constexpr size_t SIZE = 64 * 1024;
+  constexpr int ITERATIONS = 2000;
+  std::vector<u32> src(SIZE / sizeof(u32));
+  std::vector<u32> dst(src.size());
+  for (size_t i = 0; i < src.size(); ++i)
+    src[i] = static_cast<u32>(i);
+
+  auto measure = [&](auto copy) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+      copy();
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(SIZE) * ITERATIONS / seconds / (1024 * 1024 * 1024);
+  };
+
+  // Called through a volatile pointer so that the compiler can't hoist the copy out of the loop.
+  void (*volatile swap_loop)(u32*, const u32*, size_t) = SwapLoop32;
+  const double loop = measure([&] { swap_loop(dst.data(), src.data(), src.size()); });
+  EXPECT_EQ(Common::swap32(src.back()), dst.back());
+  std::printf("Element loop: %.2f GiB/s\n", loop);
+
+  ForEachImplementation([&](const char* implementation) {
+    const double swap_copy = measure([&] { Common::SwapCopy(dst.data(), src.data(), src.size()); });
+    EXPECT_EQ(Common::swap32(src.back()), dst.back());
+    std::printf("SwapCopy32 (%s): %.2f GiB/s\n", implementation, swap_copy);
+  });
+}
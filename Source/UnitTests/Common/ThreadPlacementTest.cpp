@@ -0,0 +1,51 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "Common/Event.h"
+#include "Common/Thread.h"
+
+#ifdef __linux__
+static cpu_set_t GetAffinity(std::thread& thread)
+{
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  pthread_getaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+  return cpu_set;
+}
+
+TEST(ThreadPlacement, PolicyChangesReachRegisteredThreads)
+{
+  Common::SetThreadPlacementPolicy(Common::ThreadPlacementPolicy::None);
+  Common::Event registered;
+  Common::Event done;
+  std::thread thread([&] {
+    Common::RegisterCurrentThread(Common::ThreadRole::Background);
+    registered.Set();
+    done.Wait();
+  });
+  registered.Wait();
+  const cpu_set_t initial = GetAffinity(thread);
+
+  // The thread is pinned away from the emulation threads (if there are enough cores), and goes
+  // back to where it could run before once the policy is turned off again.
+  Common::SetThreadPlacementPolicy(Common::ThreadPlacementPolicy::SeparateCores);
+  Common::SetThreadPlacementPolicy(Common::ThreadPlacementPolicy::None);
+  const cpu_set_t restored = GetAffinity(thread);
+  EXPECT_TRUE(CPU_EQUAL(&initial, &restored));
+  EXPECT_NE(std::string::npos, Common::GetThreadPlacementReport().find("background: any CPU"));
+
+  done.Set();
+  thread.join();
+}
+#endif
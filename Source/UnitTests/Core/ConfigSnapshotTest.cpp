@@ -0,0 +1,155 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "Common/Config/Config.h"
+#include "Core/Config/Config.h"
+
+namespace
+{
+const Config::ConfigInfo<bool> TEST_BOOL{{Config::System::Main, "Test", "Bool"}, false};
+const Config::ConfigInfo<int> TEST_INT{{Config::System::Main, "Test", "Int"}, 42};
+const Config::ConfigInfo<float> TEST_FLOAT{{Config::System::Main, "Test", "Float"}, 1.5f};
+const Config::ConfigInfo<std::string> TEST_STRING{{Config::System::Main, "Test", "String"},
+                                                   "default"};
+
+// Registered during static initialization, before the config system exists.
+const Config::CachedInfo<bool> CACHED_BOOL{TEST_BOOL};
+const Config::CachedInfo<int> CACHED_INT{TEST_INT};
+const Config::CachedInfo<std::string> CACHED_STRING{TEST_STRING};
+
+class ScopeInit final
+{
+public:
+  ScopeInit()
+  {
+    Config::Init();
+    Config::AddLayer(std::make_unique<Config::Layer>(Config::LayerType::Base));
+  }
+  ~ScopeInit() { Config::Shutdown(); }
+};
+}  // namespace
+
+TEST(ConfigSnapshot, DefaultsBeforeInit)
+{
+  EXPECT_FALSE(CACHED_BOOL.Get());
+  EXPECT_EQ(42, CACHED_INT.Get());
+  EXPECT_EQ("default", CACHED_STRING.Get());
+}
+
+TEST(ConfigSnapshot, FollowsChanges)
+{
+  ScopeInit init;
+  EXPECT_EQ(42, CACHED_INT.Get());
+
+  Config::SetBase(TEST_BOOL, true);
+  Config::SetBase(TEST_INT, -7);
+  Config::SetBase(TEST_STRING, std::string("base"));
+  EXPECT_TRUE(CACHED_BOOL.Get());
+  EXPECT_EQ(-7, CACHED_INT.Get());
+  EXPECT_EQ("base", CACHED_STRING.Get());
+
+  // Higher layers win, exactly like with Config::Get.
+  Config::SetCurrent(TEST_INT, 1234);
+  EXPECT_EQ(1234, CACHED_INT.Get());
+  EXPECT_EQ(Config::Get(TEST_INT), CACHED_INT.Get());
+
+  Config::ClearCurrentRunLayer();
+  Config::InvokeConfigChangedCallbacks();
+  EXPECT_EQ(-7, CACHED_INT.Get());
+}
+
+TEST(ConfigSnapshot, RegisterAfterInit)
+{
+  ScopeInit init;
+  Config::SetBase(TEST_FLOAT, 2.25f);
+
+  const Config::CachedInfo<float> cached_float(TEST_FLOAT);
+  EXPECT_EQ(2.25f, cached_float.Get());
+}
+
+TEST(ConfigSnapshot, ReadFromOtherThread)
+{
+  ScopeInit init;
+  Config::SetBase(TEST_INT, 1);
+
+  std::atomic<bool> stop(false);
+  std::atomic<bool> saw_invalid(false);
+  std::thread reader([&] {
+    while (!stop.load())
+    {
+      const int value = CACHED_INT.Get();
+      if (value < 1 || value > 1000)
+        saw_invalid = true;
+    }
+  });
+
+  for (int i = 1; i <= 1000; i++)
+    Config::SetBase(TEST_INT, i);
+  stop = true;
+  reader.join();
+
+  EXPECT_FALSE(saw_invalid.load());
+  EXPECT_EQ(1000, CACHED_INT.Get());
+}
+
+TEST(ConfigSnapshot, ReclaimsReplacedSnapshots)
+{
+  ScopeInit init;
+  for (int i = 0; i < 100; i++)
+    Config::SetBase(TEST_INT, i);
+  EXPECT_EQ(0u, Config::GetRetiredSnapshotCount());
+
+  {
+    Config::SnapshotReadGuard guard;
+    const Config::Snapshot* snapshot = guard.GetSnapshot();
+    const size_t size = snapshot->GetSize();
+    Config::SetBase(TEST_INT, 1000);
+    Config::SetBase(TEST_INT, 1001);
+
+    // The snapshot that is being read must stay alive.
+    EXPECT_EQ(2u, Config::GetRetiredSnapshotCount());
+    EXPECT_EQ(size, snapshot->GetSize());
+    EXPECT_EQ(1001, CACHED_INT.Get());
+  }
+
+  Config::SetBase(TEST_INT, 1002);
+  EXPECT_EQ(0u, Config::GetRetiredSnapshotCount());
+}
+
+TEST(ConfigSnapshot, ReadBenchmark)
+{
+  ScopeInit init;
+  Config::SetBase(TEST_INT, 5);
+  constexpr int NUM_READS = 1000000;
+
+  int sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_READS / 100; i++)
+    sum += Config::Get(TEST_INT);
+  const double layered_ns = std::chrono::duration<double, std::nano>(
+                                std::chrono::steady_clock::now() - start)
+                                .count() /
+                            (NUM_READS / 100);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < NUM_READS; i++)
+    sum += CACHED_INT.Get();
+  const double cached_ns = std::chrono::duration<double, std::nano>(
+                               std::chrono::steady_clock::now() - start)
+                               .count() /
+                           NUM_READS;
+
+  EXPECT_EQ(5 * (NUM_READS / 100 + NUM_READS), sum);
+  std::printf("Config::Get: %.1f ns per read, CachedInfo::Get: %.2f ns per read\n", layered_ns,
+              cached_ns);
+}
@@ -0,0 +1,116 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Core/FrameTelemetry.h"
+
+namespace
+{
+std::vector<std::string> ReadLines(const std::string& path)
+{
+  std::string contents;
+  File::ReadFileToString(path, contents);
+  std::vector<std::string> lines = SplitString(contents, '\n');
+  if (!lines.empty() && lines.back().empty())
+    lines.pop_back();
+  return lines;
+}
+
+std::vector<std::string> ReadColumns(const std::string& line)
+{
+  return SplitString(line, ',');
+}
+}  // namespace
+
+TEST(FrameTelemetry, DisabledByDefault)
+{
+  EXPECT_FALSE(FrameTelemetry::IsEnabled());
+  FrameTelemetry::ScopedTimer timer(FrameTelemetry::Timer::HLE);
+  FrameTelemetry::Increment(FrameTelemetry::Counter::ShaderCompiles);
+  FrameTelemetry::EndFrame();
+}
+
+TEST(FrameTelemetry, FormatJSON)
+{
+  FrameTelemetry::FrameRecord record{};
+  record.frame = 3;
+  record.frame_ns = 16683000;
+  record.timers_ns[static_cast<size_t>(FrameTelemetry::Timer::GPUShader)] = 1499;
+  record.counters[static_cast<size_t>(FrameTelemetry::Counter::ShaderCompiles)] = 2;
+
+  const std::string json = FrameTelemetry::FormatJSON(record);
+  EXPECT_EQ(0u, json.find("{\"frame\":3,\"frame_us\":16683,"));
+  EXPECT_NE(std::string::npos, json.find("\"gpu_shader_us\":1,"));
+  EXPECT_NE(std::string::npos, json.find("\"shader_compiles\":2,"));
+  EXPECT_EQ("}\n", json.substr(json.size() - 2));
+}
+
+TEST(FrameTelemetry, RecordsToCSV)
+{
+  const std::string temp_dir = File::CreateTempDir();
+  const std::string path = temp_dir + DIR_SEP "telemetry.csv";
+  ASSERT_TRUE(FrameTelemetry::Start(path, 0, false));
+  EXPECT_TRUE(FrameTelemetry::IsEnabled());
+
+  {
+    FrameTelemetry::ScopedTimer hle(FrameTelemetry::Timer::HLE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    {
+      FrameTelemetry::ScopedTimer jit(FrameTelemetry::Timer::JitCompile);
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+  }
+  FrameTelemetry::Increment(FrameTelemetry::Counter::TextureCacheMisses, 5);
+  FrameTelemetry::EndFrame();
+  FrameTelemetry::EndFrame();
+  FrameTelemetry::Stop();
+  EXPECT_FALSE(FrameTelemetry::IsEnabled());
+
+  const std::vector<std::string> lines = ReadLines(path);
+  File::DeleteDirRecursively(temp_dir);
+  ASSERT_EQ(3u, lines.size());
+  EXPECT_EQ(FrameTelemetry::FormatCSVHeader(), lines[0] + "\n");
+
+  const std::vector<std::string> header = ReadColumns(lines[0]);
+  const std::vector<std::string> first = ReadColumns(lines[1]);
+  const std::vector<std::string> second = ReadColumns(lines[2]);
+  ASSERT_EQ(header.size(), first.size());
+  ASSERT_EQ(header.size(), second.size());
+
+  auto column = [&](const std::vector<std::string>& row, const std::string& name) {
+    for (size_t i = 0; i < header.size(); ++i)
+    {
+      if (header[i] == name)
+        return std::stoull(row[i]);
+    }
+    ADD_FAILURE() << "No column " << name;
+    return 0ull;
+  };
+
+  EXPECT_EQ(0u, column(first, "frame"));
+  EXPECT_EQ(1u, column(second, "frame"));
+
+  // Nested timers are exclusive, so the inner sleep only counts towards the JIT.
+  const u64 hle_us = column(first, "cpu_hle_us");
+  const u64 jit_us = column(first, "cpu_jit_compile_us");
+  EXPECT_GE(hle_us, 20000u);
+  EXPECT_LT(hle_us, 40000u);
+  EXPECT_GE(jit_us, 20000u);
+  // Everything else on the CPU thread was spent executing, up to rounding to microseconds.
+  EXPECT_NEAR(static_cast<double>(column(first, "frame_us")),
+              static_cast<double>(hle_us + jit_us + column(first, "cpu_execute_us")), 2.0);
+  EXPECT_EQ(5u, column(first, "texture_cache_misses"));
+
+  EXPECT_EQ(0u, column(second, "cpu_hle_us"));
+  EXPECT_EQ(0u, column(second, "texture_cache_misses"));
+}
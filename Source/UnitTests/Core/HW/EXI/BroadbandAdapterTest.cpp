@@ -0,0 +1,178 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/EXI/EXI.h"
+#include "Core/HW/EXI/EXI_DeviceEthernet.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+using namespace ExpansionInterface;
+
+namespace
+{
+using Frame = std::array<u8, 64>;
+
+// Drives the adapter in slot B through its registers like a game does, with every frame that is
+// sent coming straight back.
+class BroadbandAdapterTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    SConfig::GetInstance().m_EXIDevice[0] = EXIDEVICE_NONE;
+    SConfig::GetInstance().m_EXIDevice[1] = EXIDEVICE_ETH;
+    SConfig::GetInstance().m_bba_transport = BBATransport::Loopback;
+    SConfig::GetInstance().m_bba_mac = "00:09:bf:01:02:03";
+    PowerPC::Init(PowerPC::CORE_INTERPRETER);
+    CoreTiming::Init();
+    ExpansionInterface::Init();
+
+    m_bba = static_cast<CEXIETHERNET*>(FindDevice(EXIDEVICE_ETH));
+    ASSERT_NE(nullptr, m_bba);
+  }
+
+  void TearDown() override
+  {
+    ExpansionInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void WriteMX(u16 address, u8 value)
+  {
+    m_bba->ImmWrite(0xc0000000 | (address << 8), 4);
+    m_bba->ImmWrite(value << 24, 1);
+    m_bba->SetCS(1);
+  }
+
+  // Receive buffer in pages 1 to 14, then reset (which activates the adapter) and start receiving.
+  void Start()
+  {
+    WriteMX(BBA_BP, 1);
+    WriteMX(BBA_RWP, 1);
+    WriteMX(BBA_RRP, 1);
+    WriteMX(BBA_RHBP, 0x0f);
+    WriteMX(BBA_IMR, INT_R | INT_T);
+    WriteMX(BBA_NCRA, NCRA_RESET);
+    WriteMX(BBA_NCRA, NCRA_SR);
+  }
+
+  void Send(const Frame& frame)
+  {
+    m_bba->ImmWrite(0xc0000000 | (BBA_WRTXFIFOD << 8), 4);
+    for (size_t i = 0; i < frame.size(); i += 4)
+    {
+      m_bba->ImmWrite(frame[i] << 24 | frame[i + 1] << 16 | frame[i + 2] << 8 | frame[i + 3], 4);
+    }
+    m_bba->SetCS(1);
+    WriteMX(BBA_NCRA, NCRA_SR | NCRA_ST1);
+    WriteMX(BBA_NCRA, NCRA_SR);
+  }
+
+  // Waits until the I/O thread has taken care of everything that was sent.
+  BBAStats WaitForIOThread(u64 sent)
+  {
+    BBAStats stats;
+    for (int i = 0; i < 5000; ++i)
+    {
+      stats = m_bba->GetStats();
+      if (stats.tx_frames + stats.tx_dropped == sent &&
+          stats.rx_frames + stats.rx_dropped == stats.tx_frames)
+      {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return stats;
+  }
+
+  std::string m_profile_path;
+  CEXIETHERNET* m_bba = nullptr;
+};
+
+Frame MakeFrame(u8 id)
+{
+  Frame frame;
+  frame.fill(id);
+  // Broadcast, from the adapter itself.
+  std::memset(frame.data(), 0xff, 6);
+  const u8 source[] = {0x00, 0x09, 0xbf, 0x01, 0x02, 0x03};
+  std::memcpy(frame.data() + 6, source, sizeof(source));
+  return frame;
+}
+}  // namespace
+
+TEST_F(BroadbandAdapterTest, Loopback)
+{
+  Start();
+  const Frame frame = MakeFrame(0x42);
+  Send(frame);
+  EXPECT_TRUE(m_bba->mBbaMem[BBA_IR] & INT_T);
+
+  const BBAStats stats = WaitForIOThread(1);
+  EXPECT_EQ(1u, stats.tx_frames);
+  EXPECT_EQ(frame.size(), stats.tx_bytes);
+  EXPECT_EQ(1u, stats.rx_frames);
+  EXPECT_EQ(frame.size(), stats.rx_bytes);
+  EXPECT_EQ(0u, stats.rx_dropped);
+
+  // Nothing reaches the packet buffer outside of the CPU thread's scheduler.
+  EXPECT_FALSE(m_bba->mBbaMem[BBA_IR] & INT_R);
+  CoreTiming::Advance();
+  EXPECT_TRUE(m_bba->mBbaMem[BBA_IR] & INT_R);
+
+  // The frame follows its descriptor at the start of the first page of the receive buffer.
+  EXPECT_EQ(0, std::memcmp(&m_bba->mBbaMem[0x104], frame.data(), frame.size()));
+  EXPECT_EQ(2, m_bba->page_ptr(BBA_RWP));
+  u32 descriptor;
+  std::memcpy(&descriptor, &m_bba->mBbaMem[0x100], sizeof(descriptor));
+  EXPECT_EQ(2u, descriptor & 0xfff);
+  EXPECT_EQ(4 + frame.size(), (descriptor >> 12) & 0xfff);
+}
+
+TEST_F(BroadbandAdapterTest, DropsWhenQueuesAreFull)
+{
+  Start();
+  constexpr u32 NUM_FRAMES = FrameRing::CAPACITY * 3;
+  for (u32 i = 0; i < NUM_FRAMES; ++i)
+    Send(MakeFrame(static_cast<u8>(i)));
+
+  // Nothing is delivered before the scheduler runs, so the receive queue can only take so much.
+  const BBAStats stats = WaitForIOThread(NUM_FRAMES);
+  EXPECT_EQ(NUM_FRAMES, stats.tx_frames + stats.tx_dropped);
+  EXPECT_EQ(stats.tx_frames, stats.rx_frames + stats.rx_dropped);
+  EXPECT_LE(stats.rx_frames, FrameRing::CAPACITY);
+  EXPECT_GT(stats.rx_dropped + stats.tx_dropped, 0u);
+
+  CoreTiming::Advance();
+  EXPECT_EQ(nullptr, m_bba->m_rx_ring.Front());
+
+  // Once the queue is drained, frames get through again.
+  Send(MakeFrame(0x42));
+  const BBAStats after = WaitForIOThread(NUM_FRAMES + 1);
+  EXPECT_EQ(stats.rx_frames + 1, after.rx_frames);
+}
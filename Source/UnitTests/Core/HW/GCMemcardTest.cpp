@@ -0,0 +1,284 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Swap.h"
+#include "Core/HW/GCMemcard/GCMemcard.h"
+
+namespace
+{
+constexpr u16 CARD_SIZE_MB = MemCard59Mb;
+constexpr u16 SAVE_BLOCKS = 2;
+
+// The straightforward version of calc_checksumsBE.
+void ReferenceChecksums(const u16* buf, u32 length, u16* csum, u16* inv_csum)
+{
+  u16 sum = 0, inv_sum = 0;
+  for (u32 i = 0; i < length; ++i)
+  {
+    sum += Common::swap16(buf[i]);
+    inv_sum += Common::swap16(static_cast<u16>(buf[i] ^ 0xffff));
+  }
+  *csum = Common::swap16(sum == 0xffff ? 0 : sum);
+  *inv_csum = Common::swap16(inv_sum == 0xffff ? 0 : inv_sum);
+}
+
+class GCMemcardTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_temp_dir = File::CreateTempDir(); }
+  void TearDown() override { File::DeleteDirRecursively(m_temp_dir); }
+
+  // Writes a freshly formatted card without going through the 16 MB card GCMemcard would create.
+  std::string CreateCard(const std::string& name)
+  {
+    const std::string path = m_temp_dir + DIR_SEP + name + ".raw";
+    std::vector<u8> data(CARD_SIZE_MB * MBIT_TO_BLOCKS * BLOCK_SIZE, 0xff);
+    GCMemcard::Format(data.data(), false, CARD_SIZE_MB);
+    File::IOFile(path, "wb").WriteBytes(data.data(), data.size());
+    return path;
+  }
+
+  std::string CreateGci(u32 id)
+  {
+    DEntry entry;
+    std::memcpy(entry.Gamecode, "GTST", 4);
+    std::memcpy(entry.Makercode, "01", 2);
+    std::memset(entry.Filename, 0, sizeof(entry.Filename));
+    std::snprintf(reinterpret_cast<char*>(entry.Filename), sizeof(entry.Filename), "save%u", id);
+    *reinterpret_cast<u16*>(entry.BlockCount) = Common::swap16(SAVE_BLOCKS);
+
+    const std::string path = m_temp_dir + DIR_SEP + entry.GCI_FileName();
+    File::IOFile gci(path, "wb");
+    gci.WriteBytes(&entry, DENTRY_SIZE);
+    for (u16 i = 0; i < SAVE_BLOCKS; ++i)
+    {
+      GCMBlock block;
+      std::memset(block.block, static_cast<u8>(id * SAVE_BLOCKS + i), BLOCK_SIZE);
+      gci.WriteBytes(block.block, BLOCK_SIZE);
+    }
+    return path;
+  }
+
+  std::string m_temp_dir;
+};
+
+// The files on a card, in directory order, with their contents.
+std::vector<std::pair<std::string, std::vector<u8>>> ReadFiles(const GCMemcard& card)
+{
+  std::vector<std::pair<std::string, std::vector<u8>>> files;
+  for (u8 i = 0; i < card.GetNumFiles(); ++i)
+  {
+    const u8 index = card.GetFileIndex(i);
+    std::vector<GCMBlock> blocks;
+    EXPECT_EQ(SUCCESS, card.GetSaveData(index, blocks));
+    std::vector<u8> data;
+    for (const GCMBlock& block : blocks)
+      data.insert(data.end(), block.block, block.block + BLOCK_SIZE);
+    files.emplace_back(card.DEntry_FileName(index), std::move(data));
+  }
+  return files;
+}
+}  // namespace
+
+TEST(GCMemcardChecksums, MatchReference)
+{
+  std::mt19937 random(1234);
+  std::vector<u16> data(0x1000);
+  for (u16& value : data)
+    value = static_cast<u16>(random());
+
+  for (u32 length : {0u, 1u, 3u, 4u, 5u, 0xFEu, 257u * 4, 257u * 4 + 3, 0xFFEu, 0x1000u})
+  {
+    u16 csum, inv_csum, expected_csum, expected_inv_csum;
+    calc_checksumsBE(data.data(), length, &csum, &inv_csum);
+    ReferenceChecksums(data.data(), length, &expected_csum, &expected_inv_csum);
+    EXPECT_EQ(expected_csum, csum) << length;
+    EXPECT_EQ(expected_inv_csum, inv_csum) << length;
+  }
+
+  // All bytes at their maximum, which is where the lanes would overflow first.
+  std::fill(data.begin(), data.end(), 0xffff);
+  u16 csum, inv_csum, expected_csum, expected_inv_csum;
+  calc_checksumsBE(data.data(), 0x1000, &csum, &inv_csum);
+  ReferenceChecksums(data.data(), 0x1000, &expected_csum, &expected_inv_csum);
+  EXPECT_EQ(expected_csum, csum);
+  EXPECT_EQ(expected_inv_csum, inv_csum);
+}
+
+TEST_F(GCMemcardTest, BatchMatchesSingleOperations)
+{
+  std::vector<std::string> gcis;
+  for (u32 i = 0; i < 5; ++i)
+    gcis.push_back(CreateGci(i));
+
+  const std::string single_path = CreateCard("single");
+  {
+    GCMemcard card(single_path);
+    ASSERT_TRUE(card.IsValid());
+    for (const std::string& gci : gcis)
+    {
+      EXPECT_EQ(SUCCESS, card.ImportGci(gci, ""));
+      card.FixChecksums();
+      ASSERT_TRUE(card.Save());
+    }
+    EXPECT_EQ(SUCCESS, card.RemoveFile(1));
+    card.FixChecksums();
+    ASSERT_TRUE(card.Save());
+  }
+
+  const std::string batch_path = CreateCard("batch");
+  const std::string exported = m_temp_dir + DIR_SEP "exported.gci";
+  {
+    GCMemcard card(batch_path);
+    std::vector<GCMemcard::BatchOperation> operations;
+    for (const std::string& gci : gcis)
+      operations.push_back({GCMemcard::BatchOperation::Type::Import, gci, 0});
+    operations.push_back({GCMemcard::BatchOperation::Type::Remove, "", 1});
+    // Sees the card as the earlier operations left it.
+    operations.push_back({GCMemcard::BatchOperation::Type::Export, exported, 4});
+    std::vector<u32> results;
+    ASSERT_TRUE(card.ApplyBatch(operations, &results));
+    EXPECT_EQ(std::vector<u32>(operations.size(), SUCCESS), results);
+  }
+
+  std::string exported_data, original_data;
+  ASSERT_TRUE(File::ReadFileToString(exported, exported_data));
+  ASSERT_TRUE(File::ReadFileToString(gcis[4], original_data));
+  // The directory entry gets its first block and copy counter on import.
+  ASSERT_EQ(original_data.size(), exported_data.size());
+  EXPECT_EQ(0, original_data.compare(0, 8 + DENTRY_STRLEN, exported_data, 0, 8 + DENTRY_STRLEN));
+  EXPECT_TRUE(original_data.compare(DENTRY_SIZE, std::string::npos, exported_data, DENTRY_SIZE,
+                                    std::string::npos) == 0);
+
+  const GCMemcard single(single_path);
+  const GCMemcard batch(batch_path);
+  ASSERT_TRUE(batch.IsValid());
+  EXPECT_EQ(0u, batch.TestChecksums());
+  EXPECT_EQ(4, batch.GetNumFiles());
+  EXPECT_EQ(single.GetFreeBlocks(), batch.GetFreeBlocks());
+  EXPECT_EQ(ReadFiles(single), ReadFiles(batch));
+}
+
+TEST_F(GCMemcardTest, FailedBatchOperationsChangeNothing)
+{
+  const std::string path = CreateCard("card");
+  const std::string gci = CreateGci(0);
+  GCMemcard card(path);
+  const u16 free_blocks = card.GetFreeBlocks();
+
+  std::vector<u32> results;
+  const std::vector<GCMemcard::BatchOperation> operations = {
+      {GCMemcard::BatchOperation::Type::Import, m_temp_dir + DIR_SEP "missing.gci", 0},
+      {GCMemcard::BatchOperation::Type::Import, gci, 0},
+      {GCMemcard::BatchOperation::Type::Import, gci, 0},
+      {GCMemcard::BatchOperation::Type::Remove, "", DIRLEN},
+  };
+  ASSERT_TRUE(card.ApplyBatch(operations, &results));
+  EXPECT_EQ(std::vector<u32>({OPENFAIL, SUCCESS, TITLEPRESENT, DELETE_FAIL}), results);
+  EXPECT_EQ(1, card.GetNumFiles());
+  EXPECT_EQ(free_blocks - SAVE_BLOCKS, card.GetFreeBlocks());
+  EXPECT_EQ(0u, card.TestChecksums());
+}
+
+TEST_F(GCMemcardTest, FailedBatchKeepsBackup)
+{
+  const std::string path = CreateCard("card");
+  const std::string gci = CreateGci(0);
+  std::string before;
+  {
+    // Makes the backup directory and BAT differ from the current ones.
+    GCMemcard card(path);
+    ASSERT_EQ(SUCCESS, card.ImportGci(gci, ""));
+    ASSERT_TRUE(card.Save());
+    ASSERT_TRUE(File::ReadFileToString(path, before));
+  }
+
+  GCMemcard card(path);
+  std::vector<u32> results;
+  const std::vector<GCMemcard::BatchOperation> operations = {
+      {GCMemcard::BatchOperation::Type::Import, gci, 0},
+      {GCMemcard::BatchOperation::Type::Remove, "", DIRLEN},
+  };
+  ASSERT_TRUE(card.ApplyBatch(operations, &results));
+  EXPECT_EQ(std::vector<u32>({TITLEPRESENT, DELETE_FAIL}), results);
+  ASSERT_TRUE(card.Save());
+
+  std::string after;
+  ASSERT_TRUE(File::ReadFileToString(path, after));
+  EXPECT_TRUE(before == after);
+}
+
+TEST_F(GCMemcardTest, ThroughputBenchmark)
+{
+  constexpr u32 NUM_CARDS = 16;
+  constexpr u32 FILES_PER_CARD = 16;
+  std::vector<std::string> gcis;
+  std::vector<GCMemcard::BatchOperation> operations;
+  for (u32 i = 0; i < FILES_PER_CARD; ++i)
+  {
+    gcis.push_back(CreateGci(i));
+    operations.push_back({GCMemcard::BatchOperation::Type::Import, gcis.back(), 0});
+  }
+  std::vector<std::string> single_cards, batch_cards;
+  for (u32 i = 0; i < NUM_CARDS; ++i)
+  {
+    single_cards.push_back(CreateCard("single" + std::to_string(i)));
+    batch_cards.push_back(CreateCard("batch" + std::to_string(i)));
+  }
+
+  auto measure = [](auto migrate) {
+    const auto start = std::chrono::steady_clock::now();
+    migrate();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  // What the memory card manager does for every file.
+  const double single = measure([&] {
+    for (const std::string& path : single_cards)
+    {
+      GCMemcard card(path);
+      for (const std::string& gci : gcis)
+      {
+        card.ImportGci(gci, "");
+        card.FixChecksums();
+        card.Save();
+      }
+    }
+  });
+
+  const double batch = measure([&] {
+    std::vector<u32> results;
+    for (const std::string& path : batch_cards)
+    {
+      GCMemcard card(path);
+      card.ApplyBatch(operations, &results);
+    }
+  });
+
+  for (u32 i = 0; i < NUM_CARDS; ++i)
+  {
+    const GCMemcard card(batch_cards[i]);
+    EXPECT_EQ(FILES_PER_CARD, card.GetNumFiles());
+    EXPECT_EQ(0u, card.TestChecksums());
+    EXPECT_EQ(ReadFiles(GCMemcard(single_cards[i])), ReadFiles(card));
+  }
+
+  std::printf("Importing %u files into %u cards: %.1f ms one by one, %.1f ms batched\n",
+              FILES_PER_CARD, NUM_CARDS, single * 1000, batch * 1000);
+}
@@ -0,0 +1,213 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/MMIO.h"
+#include "Core/HW/ProcessorInterface.h"
+#include "Core/HW/SI/SI.h"
+#include "Core/HW/SI/SI_Device.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/HW/VideoInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 VI_BASE = 0x0C002000;
+// What VideoInterface::Preset sets up: two 525 half-line fields with no active lines.
+constexpr u64 HALF_LINES_PER_FRAME = 1050;
+constexpr u16 HALF_LINE_WIDTH = 429;
+
+class VideoInterfaceTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    for (SerialInterface::SIDevices& device : SConfig::GetInstance().m_SIDevice)
+      device = SerialInterface::SIDEVICE_NONE;
+    PowerPC::Init(PowerPC::CORE_INTERPRETER);
+    CoreTiming::Init();
+    SystemTimers::PreInit();
+    ProcessorInterface::Init();
+    SerialInterface::Init();
+    VideoInterface::Init();
+    VideoInterface::RegisterMMIO(&m_mmio, VI_BASE);
+
+    // Starts the first slice.
+    CoreTiming::Advance();
+  }
+
+  void TearDown() override
+  {
+    SerialInterface::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Pretends the CPU ran until the given time. Display interrupts are acknowledged the way a game
+  // would, and when they were raised is recorded.
+  void RunTo(u64 ticks)
+  {
+    while (ticks >= static_cast<u64>(CoreTiming::g.global_timer + CoreTiming::g.slice_length))
+    {
+      PowerPC::ppcState.downcount = 0;
+      CoreTiming::Advance();
+      RecordVIEvent();
+      AcknowledgeInterrupt(VideoInterface::VI_PRERETRACE_HI, &m_pre_retrace_ticks);
+      AcknowledgeInterrupt(VideoInterface::VI_POSTRETRACE_HI, &m_post_retrace_ticks);
+    }
+    PowerPC::ppcState.downcount =
+        static_cast<int>(CoreTiming::g.global_timer + CoreTiming::g.slice_length - ticks);
+    ASSERT_EQ(ticks, CoreTiming::GetTicks());
+  }
+
+  void RecordVIEvent()
+  {
+    std::istringstream summary(CoreTiming::GetScheduledEventsSummary());
+    std::string line;
+    while (std::getline(summary, line))
+    {
+      long long time;
+      if (std::sscanf(line.c_str(), "VICallback : %lld", &time) == 1)
+        m_vi_event_ticks.insert(time);
+    }
+  }
+
+  void AcknowledgeInterrupt(u32 address, std::vector<u64>* raised_ticks)
+  {
+    const u16 value = m_mmio.Read<u16>(VI_BASE | address);
+    if (!(value & 0x8000))
+      return;
+    raised_ticks->push_back(CoreTiming::GetTicks());
+    m_mmio.Write<u16>(VI_BASE | address, value & 0x7fff);
+  }
+
+  u16 ReadVCount()
+  {
+    return m_mmio.Read<u16>(VI_BASE | VideoInterface::VI_VERTICAL_BEAM_POSITION);
+  }
+  u16 ReadHCount()
+  {
+    return m_mmio.Read<u16>(VI_BASE | VideoInterface::VI_HORIZONTAL_BEAM_POSITION);
+  }
+
+  std::string m_profile_path;
+  MMIO::Mapping m_mmio;
+  std::set<s64> m_vi_event_ticks;
+  std::vector<u64> m_pre_retrace_ticks;
+  std::vector<u64> m_post_retrace_ticks;
+};
+}  // namespace
+
+// The beam position and display interrupts must be what an update on every half-line (the first
+// one a half-line after boot) gives.
+TEST_F(VideoInterfaceTest, MatchesHalfLineStepping)
+{
+  const u64 ticks_per_half_line = VideoInterface::GetTicksPerHalfLine();
+  ASSERT_EQ(ticks_per_half_line * HALF_LINES_PER_FRAME / 2, VideoInterface::GetTicksPerField());
+
+  constexpr u32 FRAMES = 3;
+  const u64 end = ticks_per_half_line * HALF_LINES_PER_FRAME * FRAMES;
+  // Not a divisor of anything, so that every position within a line is seen.
+  constexpr u64 STEP = 7919;
+  for (u64 ticks = STEP; ticks < end; ticks += STEP)
+  {
+    RunTo(ticks);
+
+    const u64 half_lines = ticks / ticks_per_half_line;
+    const u64 half_line_count = 1 + half_lines % HALF_LINES_PER_FRAME;
+    // Lines start on odd half-line counts.
+    const u64 line_start_half_lines = half_lines - (half_lines % HALF_LINES_PER_FRAME) % 2;
+    const u64 line_start = line_start_half_lines * ticks_per_half_line;
+    const u16 h_count = std::min<u16>(
+        static_cast<u16>(1 + HALF_LINE_WIDTH * (ticks - line_start) / ticks_per_half_line),
+        2 * HALF_LINE_WIDTH);
+
+    EXPECT_EQ(1 + (half_line_count - 1) / 2, ReadVCount()) << ticks;
+    EXPECT_EQ(h_count, ReadHCount()) << ticks;
+  }
+
+  // Pre-retrace is on line 263 and post-retrace on line 1. Each is raised at the end of the
+  // half-line before its line.
+  std::vector<u64> expected_pre_retrace, expected_post_retrace;
+  for (u64 frame = 0; frame < FRAMES; ++frame)
+  {
+    expected_pre_retrace.push_back((frame * HALF_LINES_PER_FRAME + 525) * ticks_per_half_line);
+    expected_post_retrace.push_back((frame * HALF_LINES_PER_FRAME + 1) * ticks_per_half_line);
+  }
+  EXPECT_EQ(expected_pre_retrace, m_pre_retrace_ticks);
+  EXPECT_EQ(expected_post_retrace, m_post_retrace_ticks);
+
+  // Fields, SI polls and interrupts (with the half-line after each interrupt, until the game
+  // acknowledges it) instead of every half-line.
+  const size_t events_per_frame = m_vi_event_ticks.size() / FRAMES;
+  std::printf("VI events per frame: %zu instead of %" PRIu64 "\n", events_per_frame,
+              HALF_LINES_PER_FRAME);
+  EXPECT_GE(16u, events_per_frame);
+}
+
+TEST_F(VideoInterfaceTest, TimingChangesApplyFromTheNextHalfLine)
+{
+  const u64 old_ticks_per_half_line = VideoInterface::GetTicksPerHalfLine();
+  RunTo(old_ticks_per_half_line * 10 + 5);
+  EXPECT_EQ(6, ReadVCount());
+
+  // Halves the line length, starting with the half-line after the one in progress.
+  m_mmio.Write<u16>(VI_BASE | VideoInterface::VI_HORIZONTAL_TIMING_0_HI, 0);
+  m_mmio.Write<u16>(VI_BASE | VideoInterface::VI_HORIZONTAL_TIMING_0_LO, HALF_LINE_WIDTH / 2);
+  const u64 new_ticks_per_half_line = VideoInterface::GetTicksPerHalfLine();
+  ASSERT_GT(old_ticks_per_half_line, new_ticks_per_half_line);
+
+  const u64 next_half_line = old_ticks_per_half_line * 11;
+  RunTo(next_half_line + new_ticks_per_half_line * 3 - 1);
+  EXPECT_EQ(7, ReadVCount());
+  RunTo(next_half_line + new_ticks_per_half_line * 3);
+  EXPECT_EQ(8, ReadVCount());
+}
+
+// Reads in a block that runs past a half-line see the new position, but what happens on that
+// half-line is left to the scheduled update.
+TEST_F(VideoInterfaceTest, ReadsHaveNoSideEffects)
+{
+  const u64 ticks_per_half_line = VideoInterface::GetTicksPerHalfLine();
+  // Pre-retrace is raised at the end of half-line 525, which is the next update.
+  const u64 pre_retrace = 525 * ticks_per_half_line;
+  RunTo(pre_retrace - 1);
+  ASSERT_EQ(pre_retrace, static_cast<u64>(CoreTiming::g.global_timer + CoreTiming::g.slice_length));
+
+  PowerPC::ppcState.downcount = -static_cast<int>(ticks_per_half_line * 2);
+  ASSERT_EQ(pre_retrace + ticks_per_half_line * 2, CoreTiming::GetTicks());
+  EXPECT_EQ(264, ReadVCount());
+  EXPECT_EQ(1 + HALF_LINE_WIDTH, ReadHCount());
+  const u16 pre_retrace_hi = VI_BASE | VideoInterface::VI_PRERETRACE_HI;
+  EXPECT_EQ(0, m_mmio.Read<u16>(pre_retrace_hi) & 0x8000);
+
+  CoreTiming::Advance();
+  EXPECT_NE(0, m_mmio.Read<u16>(pre_retrace_hi) & 0x8000);
+  EXPECT_EQ(264, ReadVCount());
+}
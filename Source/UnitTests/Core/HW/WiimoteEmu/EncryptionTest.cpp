@@ -0,0 +1,73 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <random>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/WiimoteEmu/Encryption.h"
+
+namespace
+{
+void ReferenceEncrypt(const wiimote_key& key, u8* data, int addr, u8 len)
+{
+  for (int i = 0; i < len; ++i, ++addr)
+    data[i] = (data[i] - key.ft[addr % 8]) ^ key.sb[addr % 8];
+}
+
+wiimote_key MakeKey(std::mt19937* rng)
+{
+  std::array<u8, 16> keydata;
+  for (u8& byte : keydata)
+    byte = static_cast<u8>((*rng)());
+
+  wiimote_key key;
+  WiimoteGenerateKey(&key, keydata.data());
+  return key;
+}
+}  // namespace
+
+TEST(WiimoteEncryption, MatchesBytewise)
+{
+  std::mt19937 rng(42);
+  for (int k = 0; k < 4; ++k)
+  {
+    const wiimote_key key = MakeKey(&rng);
+    for (int addr = 0; addr < 16; ++addr)
+    {
+      for (u8 len = 0; len <= 32; ++len)
+      {
+        std::array<u8, 32> data;
+        for (u8& byte : data)
+          byte = static_cast<u8>(rng());
+        std::array<u8, 32> expected = data;
+
+        ReferenceEncrypt(key, expected.data(), addr, len);
+        WiimoteEncrypt(&key, data.data(), addr, len);
+        EXPECT_EQ(expected, data) << "addr " << addr << ", len " << int(len);
+      }
+    }
+  }
+}
+
+TEST(WiimoteEncryption, RoundTrip)
+{
+  std::mt19937 rng(7);
+  const wiimote_key key = MakeKey(&rng);
+
+  std::array<u8, 255> original;
+  for (u8& byte : original)
+    byte = static_cast<u8>(rng());
+
+  for (int addr : {0, 3, 0xfa})
+  {
+    std::array<u8, 255> data = original;
+    WiimoteEncrypt(&key, data.data(), addr, static_cast<u8>(data.size()));
+    EXPECT_NE(original, data);
+    WiimoteDecrypt(&key, data.data(), addr, static_cast<u8>(data.size()));
+    EXPECT_EQ(original, data);
+  }
+}
@@ -0,0 +1,283 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/IOS/IOS.h"
+#include "Core/IOS/USB/Bluetooth/BTEmu.h"
+#include "Core/IOS/USB/Bluetooth/l2cap.h"
+#include "Core/IOS/USB/USBV0.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/WiiRoot.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u8 HCI_EVENT_ENDPOINT = 0x81;
+constexpr u8 ACL_DATA_IN_ENDPOINT = 0x82;
+constexpr u8 ACL_DATA_OUT_ENDPOINT = 0x02;
+
+constexpr u32 REQUEST_SIZE = 0x400;
+constexpr u32 BUFFER_OFFSET = 0x100;
+
+// Plays the part of the Bluetooth stack of a game, with IPC requests built in emulated memory.
+class BluetoothEmuTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    SConfig::GetInstance().bWii = true;
+    // IOS wipes the /tmp of the session NAND, which must not be the real one.
+    Core::InitializeWiiRoot(false);
+    PowerPC::Init(PowerPC::CORE_INTERPRETER);
+    CoreTiming::Init();
+    Memory::Init();
+    IOS::HLE::Init();
+
+    m_bt = std::static_pointer_cast<IOS::HLE::Device::BluetoothEmu>(
+        IOS::HLE::GetIOS()->GetDeviceByName("/dev/usb/oh1/57e/305"));
+    ASSERT_NE(nullptr, m_bt);
+  }
+
+  void TearDown() override
+  {
+    m_bt.reset();
+    IOS::HLE::Shutdown();
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    Core::ShutdownWiiRoot();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Builds a USBV0 bulk or interrupt message and returns its address.
+  u32 Submit(u32 ioctlv, u8 endpoint, const std::vector<u8>& data, u16 length)
+  {
+    const u32 address = m_next_request;
+    m_next_request += REQUEST_SIZE;
+
+    Memory::Memset(address, 0, REQUEST_SIZE);
+    Memory::Write_U32(IOS::HLE::IPC_CMD_IOCTLV, address);
+    Memory::Write_U32(ioctlv, address + 0x0c);
+    Memory::Write_U32(2, address + 0x10);
+    Memory::Write_U32(1, address + 0x14);
+    Memory::Write_U32(address + 0x40, address + 0x18);
+
+    const u32 vectors[] = {address + 0x80, 1, address + 0x88, 2, address + BUFFER_OFFSET, length};
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); ++i)
+      Memory::Write_U32(vectors[i], address + 0x40 + static_cast<u32>(i) * 4);
+    Memory::Write_U8(endpoint, address + 0x80);
+    Memory::Write_U16(length, address + 0x88);
+    if (!data.empty())
+      Memory::CopyToEmu(address + BUFFER_OFFSET, data.data(), data.size());
+
+    m_bt->IOCtlV(IOS::HLE::IOCtlVRequest{address});
+    return address;
+  }
+
+  u32 SubmitHCIEventBuffer()
+  {
+    return Submit(IOS::HLE::USB::IOCTLV_USBV0_INTRMSG, HCI_EVENT_ENDPOINT, {}, 0x100);
+  }
+
+  u32 SubmitACLBuffer()
+  {
+    return Submit(IOS::HLE::USB::IOCTLV_USBV0_BLKMSG, ACL_DATA_IN_ENDPOINT, {}, 0x200);
+  }
+
+  // Sends an L2CAP connection request for the HID interrupt channel to a remote.
+  void Connect(u16 connection_handle, u16 cid)
+  {
+    std::vector<u8> packet(sizeof(hci_acldata_hdr_t) + sizeof(l2cap_hdr_t) +
+                           sizeof(l2cap_cmd_hdr_t) + sizeof(l2cap_con_req_cp));
+    auto* acl = reinterpret_cast<hci_acldata_hdr_t*>(packet.data());
+    auto* l2cap = reinterpret_cast<l2cap_hdr_t*>(acl + 1);
+    auto* cmd = reinterpret_cast<l2cap_cmd_hdr_t*>(l2cap + 1);
+    auto* req = reinterpret_cast<l2cap_con_req_cp*>(cmd + 1);
+
+    acl->con_handle = HCI_MK_CON_HANDLE(connection_handle, HCI_PACKET_START, HCI_POINT2POINT);
+    acl->length = static_cast<u16>(packet.size() - sizeof(hci_acldata_hdr_t));
+    l2cap->length = sizeof(l2cap_cmd_hdr_t) + sizeof(l2cap_con_req_cp);
+    l2cap->dcid = L2CAP_SIGNAL_CID;
+    cmd->code = L2CAP_CONNECT_REQ;
+    cmd->ident = static_cast<u8>(cid);
+    cmd->length = sizeof(l2cap_con_req_cp);
+    req->psm = L2CAP_PSM_HID_INTR;
+    req->scid = cid;
+
+    Submit(IOS::HLE::USB::IOCTLV_USBV0_BLKMSG, ACL_DATA_OUT_ENDPOINT, packet,
+           static_cast<u16>(packet.size()));
+  }
+
+  static bool IsReplied(u32 address)
+  {
+    return Memory::Read_U32(address) == IOS::HLE::IPC_REPLY;
+  }
+
+  static std::vector<u8> GetReply(u32 address)
+  {
+    std::vector<u8> data(Memory::Read_U32(address + 4));
+    Memory::CopyFromEmu(data.data(), address + BUFFER_OFFSET, data.size());
+    return data;
+  }
+
+  std::string m_profile_path;
+  std::shared_ptr<IOS::HLE::Device::BluetoothEmu> m_bt;
+  u32 m_next_request = 0x00100000;
+};
+
+// The remote's connection handle, the channel and the first payload byte of an ACL packet.
+struct ACLPacket
+{
+  u16 connection_handle;
+  u16 dcid;
+  u8 first_byte;
+};
+
+ACLPacket ParseACLPacket(const std::vector<u8>& data)
+{
+  EXPECT_GE(data.size(), sizeof(hci_acldata_hdr_t) + sizeof(l2cap_hdr_t) + 1);
+  hci_acldata_hdr_t acl;
+  l2cap_hdr_t l2cap;
+  std::memcpy(&acl, data.data(), sizeof(acl));
+  std::memcpy(&l2cap, data.data() + sizeof(acl), sizeof(l2cap));
+  EXPECT_EQ(data.size() - sizeof(acl), acl.length);
+  return {static_cast<u16>(HCI_CON_HANDLE(acl.con_handle)), l2cap.dcid,
+          data[sizeof(acl) + sizeof(l2cap)]};
+}
+}  // namespace
+
+TEST_F(BluetoothEmuTest, CoalescesCompletedPackets)
+{
+  // Every remote gets a packet per update, while the stack is busy and has no event buffer out.
+  constexpr int NUM_UPDATES = 5;
+  for (int i = 0; i < NUM_UPDATES; ++i)
+  {
+    for (const auto& wiimote : m_bt->m_WiiMotes)
+      Connect(wiimote.GetConnectionHandle(), 0x40);
+    m_bt->Update();
+  }
+
+  // All of them are reported in a single event.
+  const u32 first = SubmitHCIEventBuffer();
+  m_bt->Update();
+  ASSERT_TRUE(IsReplied(first));
+  const std::vector<u8> event = GetReply(first);
+  ASSERT_EQ(sizeof(hci_event_hdr_t) + sizeof(hci_num_compl_pkts_ep) +
+                m_bt->m_WiiMotes.size() * sizeof(hci_num_compl_pkts_info),
+            event.size());
+  EXPECT_EQ(HCI_EVENT_NUM_COMPL_PKTS, event[0]);
+
+  const u8* info = event.data() + sizeof(hci_event_hdr_t) + sizeof(hci_num_compl_pkts_ep);
+  for (const auto& wiimote : m_bt->m_WiiMotes)
+  {
+    hci_num_compl_pkts_info counts;
+    std::memcpy(&counts, info, sizeof(counts));
+    EXPECT_EQ(wiimote.GetConnectionHandle(), counts.con_handle);
+    EXPECT_EQ(NUM_UPDATES, counts.compl_pkts);
+    info += sizeof(counts);
+  }
+
+  const u32 second = SubmitHCIEventBuffer();
+  m_bt->Update();
+  EXPECT_FALSE(IsReplied(second));
+}
+
+TEST_F(BluetoothEmuTest, QueuesReportsInOrder)
+{
+  for (const auto& wiimote : m_bt->m_WiiMotes)
+    Connect(wiimote.GetConnectionHandle(), 0x41);
+
+  // Reports from all remotes in the same slice, before the stack has handed out ACL buffers.
+  constexpr int NUM_REPORTS = 3;
+  for (u8 report = 0; report < NUM_REPORTS; ++report)
+  {
+    for (size_t i = 0; i < m_bt->m_WiiMotes.size(); ++i)
+    {
+      const u8 data[] = {static_cast<u8>(0xA1 + report), 0x30, static_cast<u8>(i), 0x00};
+      m_bt->m_WiiMotes[i].ReceiveL2capData(0x41, data, sizeof(data));
+    }
+  }
+
+  // Drain the completed packets event so that ACL data isn't held back behind it.
+  SubmitHCIEventBuffer();
+  m_bt->Update();
+
+  // First the connection responses, then the reports, one per buffer.
+  for (const auto& wiimote : m_bt->m_WiiMotes)
+  {
+    const u32 address = SubmitACLBuffer();
+    m_bt->Update();
+    ASSERT_TRUE(IsReplied(address));
+    const ACLPacket packet = ParseACLPacket(GetReply(address));
+    EXPECT_EQ(wiimote.GetConnectionHandle(), packet.connection_handle);
+    EXPECT_EQ(L2CAP_SIGNAL_CID, packet.dcid);
+    EXPECT_EQ(L2CAP_CONNECT_RSP, packet.first_byte);
+  }
+
+  for (u8 report = 0; report < NUM_REPORTS; ++report)
+  {
+    for (const auto& wiimote : m_bt->m_WiiMotes)
+    {
+      const u32 address = SubmitACLBuffer();
+      m_bt->Update();
+      ASSERT_TRUE(IsReplied(address));
+      const ACLPacket packet = ParseACLPacket(GetReply(address));
+      EXPECT_EQ(wiimote.GetConnectionHandle(), packet.connection_handle);
+      EXPECT_EQ(0x41, packet.dcid);
+      EXPECT_EQ(0xA1 + report, packet.first_byte);
+    }
+  }
+
+  // Nothing left, so the next report goes straight into the waiting buffer.
+  const u32 waiting = SubmitACLBuffer();
+  m_bt->Update();
+  EXPECT_FALSE(IsReplied(waiting));
+  const u8 data[] = {0xA1, 0x30, 0x00, 0x00};
+  m_bt->m_WiiMotes[0].ReceiveL2capData(0x41, data, sizeof(data));
+  EXPECT_TRUE(IsReplied(waiting));
+}
+
+TEST_F(BluetoothEmuTest, DropsReportsWhenFull)
+{
+  Connect(m_bt->m_WiiMotes[0].GetConnectionHandle(), 0x41);
+  SubmitHCIEventBuffer();
+  m_bt->Update();
+
+  const u8 data[] = {0xA1, 0x30, 0x00, 0x00};
+  for (int i = 0; i < 150; ++i)
+    m_bt->m_WiiMotes[0].ReceiveL2capData(0x41, data, sizeof(data));
+
+  // The connection response and 99 reports fit.
+  int delivered = 0;
+  while (true)
+  {
+    const u32 address = SubmitACLBuffer();
+    m_bt->Update();
+    if (!IsReplied(address))
+      break;
+    ++delivered;
+  }
+  EXPECT_EQ(100, delivered);
+}
@@ -0,0 +1,317 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/FileUtil.h"
+#include "Common/Thread.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/IOS/IOS.h"
+#include "Core/IOS/USB/Common.h"
+#include "Core/IOS/USB/Host.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/WiiRoot.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+using IOS::HLE::Device::USBHostBackend;
+
+constexpr u16 VID = 0x1234;
+constexpr u16 PID = 0x0001;
+constexpr u16 OTHER_PID = 0x0002;
+constexpr u16 NOT_WHITELISTED_PID = 0x0003;
+constexpr u32 OPEN_REQUEST_ADDRESS = 0x00100000;
+
+class FakeDevice final : public IOS::HLE::USB::Device
+{
+public:
+  FakeDevice(u64 id, u16 vid, u16 pid) : m_vid(vid), m_pid(pid) { m_id = id; }
+
+  IOS::HLE::USB::DeviceDescriptor GetDeviceDescriptor() const override
+  {
+    IOS::HLE::USB::DeviceDescriptor descriptor{};
+    descriptor.idVendor = m_vid;
+    descriptor.idProduct = m_pid;
+    return descriptor;
+  }
+  std::vector<IOS::HLE::USB::ConfigDescriptor> GetConfigurations() const override { return {}; }
+  std::vector<IOS::HLE::USB::InterfaceDescriptor> GetInterfaces(u8) const override { return {}; }
+  std::vector<IOS::HLE::USB::EndpointDescriptor> GetEndpoints(u8, u8, u8) const override
+  {
+    return {};
+  }
+  bool Attach(u8) override { return true; }
+  int CancelTransfer(u8) override { return 0; }
+  int ChangeInterface(u8) override { return 0; }
+  int GetNumberOfAltSettings(u8) override { return 0; }
+  int SetAltSetting(u8) override { return 0; }
+  int SubmitTransfer(std::unique_ptr<IOS::HLE::USB::CtrlMessage>) override { return 0; }
+  int SubmitTransfer(std::unique_ptr<IOS::HLE::USB::BulkMessage>) override { return 0; }
+  int SubmitTransfer(std::unique_ptr<IOS::HLE::USB::IntrMessage>) override { return 0; }
+  int SubmitTransfer(std::unique_ptr<IOS::HLE::USB::IsoMessage>) override { return 0; }
+
+private:
+  u16 m_vid;
+  u16 m_pid;
+};
+
+// Stands in for libusb: the test plugs and unplugs devices, and they are reported the way the
+// libusb hotplug callbacks would report them.
+class FakeBackend final : public USBHostBackend
+{
+public:
+  explicit FakeBackend(bool supports_hotplug) : m_supports_hotplug(supports_hotplug) {}
+
+  bool GetDevices(const DeviceFilter& filter,
+                  std::vector<std::unique_ptr<IOS::HLE::USB::Device>>& devices) override
+  {
+    ++m_get_devices_calls;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (const PluggedDevice& device : m_plugged)
+    {
+      if (filter(device.vid, device.pid))
+        devices.push_back(std::make_unique<FakeDevice>(device.id, device.vid, device.pid));
+    }
+    return true;
+  }
+
+  bool RegisterHotplugCallbacks(DeviceFilter filter, InsertCallback on_insert,
+                                RemoveCallback on_remove) override
+  {
+    if (!m_supports_hotplug)
+      return false;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_filter = std::move(filter);
+    m_on_insert = std::move(on_insert);
+    m_on_remove = std::move(on_remove);
+    for (const PluggedDevice& device : m_plugged)
+      ReportInserted(device);
+    return true;
+  }
+
+  void DeregisterHotplugCallbacks() override
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_filter = nullptr;
+    m_on_insert = nullptr;
+    m_on_remove = nullptr;
+  }
+
+  void HandleEvents(std::chrono::milliseconds timeout) override
+  {
+    Common::SleepCurrentThread(static_cast<int>(timeout.count()));
+  }
+
+  void Plug(u64 id, u16 vid, u16 pid)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_plugged.push_back({id, vid, pid});
+    ReportInserted(m_plugged.back());
+  }
+
+  void Unplug(u64 id)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    const auto it = std::find_if(m_plugged.begin(), m_plugged.end(),
+                                 [id](const PluggedDevice& device) { return device.id == id; });
+    ASSERT_NE(m_plugged.end(), it);
+    const PluggedDevice device = *it;
+    m_plugged.erase(it);
+    if (m_on_remove && m_filter(device.vid, device.pid))
+      m_on_remove(device.id);
+  }
+
+  int GetDevicesCalls() const { return m_get_devices_calls; }
+
+private:
+  struct PluggedDevice
+  {
+    u64 id;
+    u16 vid;
+    u16 pid;
+  };
+
+  void ReportInserted(const PluggedDevice& device)
+  {
+    if (m_on_insert && m_filter(device.vid, device.pid))
+      m_on_insert(std::make_unique<FakeDevice>(device.id, device.vid, device.pid));
+  }
+
+  bool m_supports_hotplug;
+  std::atomic<int> m_get_devices_calls{0};
+  std::mutex m_mutex;
+  std::vector<PluggedDevice> m_plugged;
+  DeviceFilter m_filter;
+  InsertCallback m_on_insert;
+  RemoveCallback m_on_remove;
+};
+
+class TestHost final : public IOS::HLE::Device::USBHost
+{
+public:
+  using Change = std::pair<bool, u64>;
+
+  TestHost(IOS::HLE::Kernel& ios, std::unique_ptr<USBHostBackend> backend)
+      : USBHost(ios, "/dev/usb/test", std::move(backend))
+  {
+  }
+  ~TestHost() override { StopThreads(); }
+
+  // Waits until count insertions or removals have been seen, and returns them (true for an
+  // insertion).
+  std::vector<Change> WaitForChanges(size_t count)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+      {
+        std::lock_guard<std::mutex> lk(m_changes_mutex);
+        if (m_changes.size() >= count)
+          break;
+      }
+      m_changes_event.WaitFor(std::chrono::milliseconds(10));
+    }
+    std::lock_guard<std::mutex> lk(m_changes_mutex);
+    return std::exchange(m_changes, {});
+  }
+
+private:
+  void OnDeviceChange(ChangeEvent event, std::shared_ptr<IOS::HLE::USB::Device> device) override
+  {
+    std::lock_guard<std::mutex> lk(m_changes_mutex);
+    m_changes.emplace_back(event == ChangeEvent::Inserted, device->GetId());
+  }
+  void OnDeviceChangeEnd() override { m_changes_event.Set(); }
+
+  std::mutex m_changes_mutex;
+  std::vector<Change> m_changes;
+  Common::Event m_changes_event;
+};
+
+class USBHostTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    SConfig::GetInstance().bWii = true;
+    SConfig::GetInstance().m_usb_passthrough_devices = {{VID, PID}, {VID, OTHER_PID}};
+    Core::InitializeWiiRoot(false);
+    PowerPC::Init(PowerPC::CORE_INTERPRETER);
+    CoreTiming::Init();
+    Memory::Init();
+    IOS::HLE::Init();
+  }
+
+  void TearDown() override
+  {
+    m_host.reset();
+    IOS::HLE::Shutdown();
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    Core::ShutdownWiiRoot();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  FakeBackend* CreateHost(bool supports_hotplug)
+  {
+    auto backend = std::make_unique<FakeBackend>(supports_hotplug);
+    FakeBackend* fake = backend.get();
+    m_host = std::make_unique<TestHost>(*IOS::HLE::GetIOS(), std::move(backend));
+    return fake;
+  }
+
+  void Open()
+  {
+    const std::string path = "/dev/usb/test";
+    Memory::Memset(OPEN_REQUEST_ADDRESS, 0, 0x100);
+    Memory::Write_U32(IOS::HLE::IPC_CMD_OPEN, OPEN_REQUEST_ADDRESS);
+    Memory::Write_U32(OPEN_REQUEST_ADDRESS + 0x40, OPEN_REQUEST_ADDRESS + 0x0c);
+    Memory::CopyToEmu(OPEN_REQUEST_ADDRESS + 0x40, path.c_str(), path.size() + 1);
+    EXPECT_EQ(IOS::HLE::IPC_SUCCESS,
+              m_host->Open(IOS::HLE::OpenRequest{OPEN_REQUEST_ADDRESS}));
+  }
+
+  std::string m_profile_path;
+  std::unique_ptr<TestHost> m_host;
+};
+}  // namespace
+
+TEST_F(USBHostTest, HotplugInsertAndRemove)
+{
+  FakeBackend* backend = CreateHost(true);
+  backend->Plug(1, VID, PID);
+
+  // The device that was there from the start is known by the time Open returns, and isn't
+  // inserted again when the hotplug callbacks report it.
+  Open();
+  EXPECT_EQ(std::vector<TestHost::Change>({{true, 1}}), m_host->WaitForChanges(1));
+
+  backend->Plug(2, VID, OTHER_PID);
+  EXPECT_EQ(std::vector<TestHost::Change>({{true, 2}}), m_host->WaitForChanges(1));
+
+  backend->Plug(3, VID, NOT_WHITELISTED_PID);
+  backend->Unplug(3);
+  backend->Unplug(1);
+  EXPECT_EQ(std::vector<TestHost::Change>({{false, 1}}), m_host->WaitForChanges(1));
+
+  // Nothing rescans when every change is reported.
+  Common::SleepCurrentThread(200);
+  EXPECT_EQ(std::vector<TestHost::Change>(), m_host->WaitForChanges(0));
+  EXPECT_EQ(1, backend->GetDevicesCalls());
+}
+
+TEST_F(USBHostTest, RescansWithoutHotplug)
+{
+  FakeBackend* backend = CreateHost(false);
+  Open();
+
+  backend->Plug(1, VID, PID);
+  EXPECT_EQ(std::vector<TestHost::Change>({{true, 1}}), m_host->WaitForChanges(1));
+
+  backend->Unplug(1);
+  EXPECT_EQ(std::vector<TestHost::Change>({{false, 1}}), m_host->WaitForChanges(1));
+  EXPECT_LT(1, backend->GetDevicesCalls());
+}
+
+TEST_F(USBHostTest, StoppingRemovesDevices)
+{
+  FakeBackend* backend = CreateHost(true);
+  Open();
+  backend->Plug(1, VID, PID);
+  EXPECT_EQ(std::vector<TestHost::Change>({{true, 1}}), m_host->WaitForChanges(1));
+
+  m_host->UpdateWantDeterminism(true);
+  EXPECT_EQ(std::vector<TestHost::Change>({{false, 1}}), m_host->WaitForChanges(1));
+
+  // Nothing is reported once the callbacks are gone.
+  backend->Plug(2, VID, OTHER_PID);
+  Common::SleepCurrentThread(100);
+  EXPECT_EQ(std::vector<TestHost::Change>(), m_host->WaitForChanges(0));
+}
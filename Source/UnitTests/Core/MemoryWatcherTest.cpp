@@ -0,0 +1,156 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemoryWatcher.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// Emulated memory, a locations file and a bound socket standing in for the client.
+class MemoryWatcherTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_temp_dir = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_temp_dir);
+    SConfig::Init();
+    Memory::Init();
+
+    m_socket_path = m_temp_dir + DIR_SEP "socket";
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, m_socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    m_fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    ASSERT_GE(m_fd, 0);
+    ASSERT_EQ(0, bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)));
+  }
+
+  void TearDown() override
+  {
+    close(m_fd);
+    Memory::Shutdown();
+    SConfig::Shutdown();
+    File::DeleteDirRecursively(m_temp_dir);
+  }
+
+  std::unique_ptr<MemoryWatcher> CreateWatcher(const std::string& locations)
+  {
+    const std::string locations_path = m_temp_dir + DIR_SEP "Locations.txt";
+    File::WriteStringToFile(locations, locations_path);
+    return std::make_unique<MemoryWatcher>(locations_path, m_socket_path);
+  }
+
+  // Returns the next datagram, or an empty string if there is none.
+  std::string Receive()
+  {
+    char buffer[0x1000];
+    const ssize_t size = recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (size <= 0)
+      return "";
+    return std::string(buffer, size);
+  }
+
+  std::string m_temp_dir;
+  std::string m_socket_path;
+  int m_fd = -1;
+};
+
+std::string Message(const std::string& text)
+{
+  return text + '\0';
+}
+}  // namespace
+
+TEST_F(MemoryWatcherTest, NoLocations)
+{
+  EXPECT_FALSE(CreateWatcher("")->IsRunning());
+  EXPECT_FALSE(MemoryWatcher(m_temp_dir + DIR_SEP "missing.txt", m_socket_path).IsRunning());
+}
+
+TEST_F(MemoryWatcherTest, BatchesChanges)
+{
+  auto watcher = CreateWatcher("80000100\n80000104\n80000100\n80001000\n");
+  ASSERT_TRUE(watcher->IsRunning());
+
+  // Values that are still zero aren't reported, just like changes back to the same value.
+  Memory::Write_U32(0x2a, 0x80000100);
+  Memory::Write_U32(0xdeadbeef, 0x80001000);
+  watcher->Step();
+  EXPECT_EQ(Message("80000100\n2a\n80001000\ndeadbeef"), Receive());
+  EXPECT_EQ("", Receive());
+
+  watcher->Step();
+  EXPECT_EQ("", Receive());
+
+  Memory::Write_U32(1, 0x80000104);
+  Memory::Write_U32(0x2b, 0x80000100);
+  Memory::Write_U32(2, 0x80000100);
+  Memory::Write_U32(0x12345678, 0x80000108);
+  watcher->Step();
+  EXPECT_EQ(Message("80000100\n2\n80000104\n1"), Receive());
+
+  // Writes that leave a value unchanged aren't reported either.
+  Memory::Write_U32(0xdeadbeef, 0x80001000);
+  watcher->Step();
+  EXPECT_EQ("", Receive());
+}
+
+TEST_F(MemoryWatcherTest, ValueSpanningPages)
+{
+  auto watcher = CreateWatcher("80000ffe\n");
+  watcher->Step();
+  EXPECT_EQ("", Receive());
+
+  Memory::Write_U8(0x55, 0x80001001);
+  watcher->Step();
+  EXPECT_EQ(Message("80000ffe\n55"), Receive());
+}
+
+TEST_F(MemoryWatcherTest, FollowsPointers)
+{
+  auto watcher = CreateWatcher("80000200 10\n80000300 4 8\n");
+  Memory::Write_U32(0x80002000, 0x80000200);
+  Memory::Write_U32(5, 0x80002010);
+  watcher->Step();
+  EXPECT_EQ(Message("80000200 10\n5"), Receive());
+
+  Memory::Write_U32(6, 0x80002010);
+  watcher->Step();
+  EXPECT_EQ(Message("80000200 10\n6"), Receive());
+
+  // Moving the pointer makes the watcher follow it, and forget about the old target.
+  Memory::Write_U32(7, 0x80003010);
+  Memory::Write_U32(0x80003000, 0x80000200);
+  watcher->Step();
+  EXPECT_EQ(Message("80000200 10\n7"), Receive());
+
+  Memory::Write_U32(8, 0x80002010);
+  watcher->Step();
+  EXPECT_EQ("", Receive());
+
+  // Two levels of pointers: *(*0x80000300 + 4) + 8
+  Memory::Write_U32(0x80004000, 0x80000300);
+  Memory::Write_U32(0x80005000, 0x80004004);
+  Memory::Write_U32(9, 0x80005008);
+  watcher->Step();
+  EXPECT_EQ(Message("80000300 4 8\n9"), Receive());
+
+  Memory::Write_U32(0x80006000, 0x80004004);
+  watcher->Step();
+  EXPECT_EQ(Message("80000300 4 8\n0"), Receive());
+}
@@ -0,0 +1,243 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/HW/ProcessorInterface.h"
+#include "Core/HW/SI/SI.h"
+#include "Core/HW/SI/SI_Device.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/HW/VideoInterface.h"
+#include "Core/PowerPC/BusyWait.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr u32 CODE_ADDRESS = 0x80003000;
+
+// loop: lhz r0, 0x2c(r3)
+//       cmplwi r0, 200
+//       bne loop
+//       blr
+constexpr u32 LHZ_R0_2C_R3 = 0xa003002c;
+constexpr u32 CMPLWI_R0_200 = 0x280000c8;
+constexpr u32 BNE_MINUS_8 = 0x4082fff8;
+constexpr u32 BLR = 0x4e800020;
+
+class BusyWaitTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    for (SerialInterface::SIDevices& device : SConfig::GetInstance().m_SIDevice)
+      device = SerialInterface::SIDEVICE_NONE;
+    PowerPC::Init(PowerPC::CORE_INTERPRETER);
+    CoreTiming::Init();
+    SystemTimers::PreInit();
+    Memory::Init();
+    ProcessorInterface::Init();
+    SerialInterface::Init();
+    VideoInterface::Init();
+
+    // What CBoot::SetupBAT does for GameCube games.
+    PowerPC::ppcState.spr[SPR_IBAT0U] = 0x80001fff;
+    PowerPC::ppcState.spr[SPR_IBAT0L] = 0x00000002;
+    PowerPC::ppcState.spr[SPR_DBAT0U] = 0x80001fff;
+    PowerPC::ppcState.spr[SPR_DBAT0L] = 0x00000002;
+    PowerPC::ppcState.spr[SPR_DBAT1U] = 0xc0001fff;
+    PowerPC::ppcState.spr[SPR_DBAT1L] = 0x0000002a;
+    PowerPC::DBATUpdated();
+    PowerPC::IBATUpdated();
+    UReg_MSR& msr = reinterpret_cast<UReg_MSR&>(MSR);
+    msr.IR = 1;
+    msr.DR = 1;
+
+    // Starts the first slice.
+    CoreTiming::Advance();
+  }
+
+  void TearDown() override
+  {
+    SerialInterface::Shutdown();
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void WriteCode(u32 address, const std::vector<u32>& code)
+  {
+    for (size_t i = 0; i < code.size(); ++i)
+      PowerPC::HostWrite_U32(code[i], address + static_cast<u32>(i * 4));
+  }
+
+  // Analyzes code the way Jit64 does, and returns the address of the branch that closes a
+  // busy-wait loop, or 0.
+  u32 FindBusyWaitLoop(const std::vector<u32>& code)
+  {
+    WriteCode(m_code_address, code);
+
+    PPCAnalyst::PPCAnalyzer analyzer;
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+    analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_FOLLOW);
+
+    PPCAnalyst::BlockStats stats;
+    PPCAnalyst::BlockRegStats gpa, fpa;
+    PPCAnalyst::CodeBlock block;
+    block.m_stats = &stats;
+    block.m_gpa = &gpa;
+    block.m_fpa = &fpa;
+    PPCAnalyst::CodeBuffer buffer(32);
+    analyzer.Analyze(m_code_address, &block, &buffer, buffer.GetSize());
+
+    u32 branch = 0;
+    for (u32 i = 0; i < block.m_num_instructions; ++i)
+    {
+      if (buffer.codebuffer[i].isBusyWaitLoop)
+        branch = buffer.codebuffer[i].address;
+    }
+    // Every case gets its own code, so that nothing is left over from the last one.
+    m_code_address += 0x100;
+    return branch;
+  }
+
+  // Runs the loop as the JIT would, until it reads the given VCOUNT.
+  void WaitForVCount(u16 vcount)
+  {
+    BusyWait::Loop* loop = BusyWait::GetLoop(CODE_ADDRESS, CODE_ADDRESS + 8);
+    while (PowerPC::Read_U16(GPR(3) + 0x2c) != vcount)
+    {
+      BusyWait::Skip(loop);
+      if (PowerPC::ppcState.downcount <= 0)
+        CoreTiming::Advance();
+    }
+  }
+
+  std::string m_profile_path;
+  u32 m_code_address = CODE_ADDRESS + 0x1000;
+};
+}  // namespace
+
+TEST_F(BusyWaitTest, FindsLoopsThatOnlyPoll)
+{
+  u32 loop = m_code_address;
+  EXPECT_EQ(loop + 8, FindBusyWaitLoop({LHZ_R0_2C_R3, CMPLWI_R0_200, BNE_MINUS_8, BLR}));
+  // lwzx r0, r3, r4; rlwinm. r0, r0, 0, 16, 16; beq loop
+  loop = m_code_address;
+  EXPECT_EQ(loop + 8, FindBusyWaitLoop({0x7c03202e, 0x54000421, 0x4182fff8, BLR}));
+
+  // Nothing is read.
+  EXPECT_EQ(0u, FindBusyWaitLoop({CMPLWI_R0_200, 0x4082fffc, BLR}));
+  // addi r4, r4, 1 counts the iterations.
+  EXPECT_EQ(0u, FindBusyWaitLoop({LHZ_R0_2C_R3, 0x38840001, CMPLWI_R0_200, 0x4082fff4, BLR}));
+  // lhzu r0, 2(r3) moves on every time.
+  EXPECT_EQ(0u, FindBusyWaitLoop({0xa4030002, CMPLWI_R0_200, BNE_MINUS_8, BLR}));
+  // stw r0, 0(r5) stores what it reads.
+  EXPECT_EQ(0u, FindBusyWaitLoop({LHZ_R0_2C_R3, 0x90050000, CMPLWI_R0_200, 0x4082fff4, BLR}));
+  // bdnz counts down.
+  EXPECT_EQ(0u, FindBusyWaitLoop({LHZ_R0_2C_R3, 0x4200fffc, BLR}));
+  // The branch goes somewhere else.
+  EXPECT_EQ(0u, FindBusyWaitLoop({LHZ_R0_2C_R3, CMPLWI_R0_200, 0x4082fffc, BLR}));
+}
+
+TEST_F(BusyWaitTest, SkipsToTheNextEvent)
+{
+  // lhz r0, 0xe(r3)
+  WriteCode(CODE_ADDRESS, {0xa003000e, CMPLWI_R0_200, BNE_MINUS_8});
+
+  // A PE register, which only changes in events.
+  GPR(3) = 0xcc001000;
+  BusyWait::Loop* loop = BusyWait::GetLoop(CODE_ADDRESS, CODE_ADDRESS + 8);
+  const u64 start = CoreTiming::GetTicks();
+  const u64 slice_end = CoreTiming::g.global_timer + CoreTiming::g.slice_length;
+  BusyWait::Skip(loop);
+  EXPECT_EQ(slice_end, CoreTiming::GetTicks());
+  EXPECT_EQ(0, PowerPC::ppcState.downcount);
+
+  // RAM, which the loop doesn't get skipped for.
+  CoreTiming::Advance();
+  const u64 ticks = CoreTiming::GetTicks();
+  GPR(3) = 0x80001000;
+  BusyWait::Skip(loop);
+  EXPECT_EQ(ticks, CoreTiming::GetTicks());
+
+  const std::vector<BusyWait::LoopStats> stats = BusyWait::GetStats();
+  ASSERT_EQ(1u, stats.size());
+  EXPECT_EQ(CODE_ADDRESS, stats[0].address);
+  EXPECT_EQ(0x0c00100eu, stats[0].register_address);
+  EXPECT_EQ(1u, stats[0].skips);
+  EXPECT_EQ(1u, stats[0].misses);
+  EXPECT_EQ(slice_end - start, stats[0].skipped_cycles);
+}
+
+TEST_F(BusyWaitTest, StopsWhereVCountChanges)
+{
+  WriteCode(CODE_ADDRESS, {LHZ_R0_2C_R3, CMPLWI_R0_200, BNE_MINUS_8});
+  GPR(3) = 0xcc002000;
+
+  // VCOUNT is 200 from the 399th half-line, and the first one starts at 0.
+  WaitForVCount(200);
+  EXPECT_EQ(398u * VideoInterface::GetTicksPerHalfLine(), CoreTiming::GetTicks());
+  const BusyWait::LoopStats stats = BusyWait::GetStats().at(0);
+  EXPECT_EQ(CoreTiming::GetTicks(), stats.skipped_cycles);
+  EXPECT_EQ(0u, stats.misses);
+  // Once per half-line at most, rather than thousands of times.
+  EXPECT_GE(398u, stats.skips);
+
+  // HCOUNT (lhz r0, 0x2e(r3)) can change at any time.
+  PowerPC::HostWrite_U32(0xa003002e, CODE_ADDRESS);
+  BusyWait::Loop* loop = BusyWait::GetLoop(CODE_ADDRESS, CODE_ADDRESS + 8);
+  const u64 ticks = CoreTiming::GetTicks();
+  BusyWait::Skip(loop);
+  EXPECT_EQ(ticks, CoreTiming::GetTicks());
+  EXPECT_EQ(1u, BusyWait::GetStats().at(0).misses);
+}
+
+TEST_F(BusyWaitTest, GivesUpOnLoopsThatAreNeverSkipped)
+{
+  // A spinlock in RAM.
+  WriteCode(CODE_ADDRESS, {LHZ_R0_2C_R3, CMPLWI_R0_200, BNE_MINUS_8});
+  GPR(3) = 0x80001000;
+  BusyWait::Loop* loop = BusyWait::GetLoop(CODE_ADDRESS, CODE_ADDRESS + 8);
+  for (u32 i = 0; i < BusyWait::MAX_MISSES_IN_A_ROW - 1; ++i)
+    BusyWait::Skip(loop);
+  EXPECT_FALSE(loop->given_up);
+
+  // A skip starts the count over.
+  GPR(3) = 0xcc002000;
+  BusyWait::Skip(loop);
+  GPR(3) = 0x80001000;
+  for (u32 i = 0; i < BusyWait::MAX_MISSES_IN_A_ROW - 1; ++i)
+    BusyWait::Skip(loop);
+  EXPECT_FALSE(loop->given_up);
+  BusyWait::Skip(loop);
+  EXPECT_TRUE(loop->given_up);
+
+  // Compiling the loop again gives it another chance.
+  EXPECT_EQ(loop, BusyWait::GetLoop(CODE_ADDRESS, CODE_ADDRESS + 8));
+  EXPECT_FALSE(loop->given_up);
+}
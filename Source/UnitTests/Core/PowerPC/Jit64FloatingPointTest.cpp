@@ -0,0 +1,198 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+// JitBase.h pulls in the x64Emitter, whose TEST method conflicts with gtest's TEST macro. Only
+// TEST_F is used here.
+#undef TEST
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// With address translation off, so that this is also the physical address.
+constexpr u32 CODE_ADDRESS = 0x00003000;
+
+constexpr u32 AForm(u32 opcd, u32 d, u32 a, u32 b, u32 c, u32 xo)
+{
+  return opcd << 26 | d << 21 | a << 16 | b << 11 | c << 6 | xo << 1;
+}
+
+constexpr u32 PS_MERGE01(u32 d, u32 a, u32 b)
+{
+  return 4 << 26 | d << 21 | a << 16 | b << 11 | 560 << 1;
+}
+constexpr u32 FMADD(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(63, d, a, b, c, 29);
+}
+constexpr u32 FMSUB(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(63, d, a, b, c, 28);
+}
+constexpr u32 FNMSUB(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(63, d, a, b, c, 30);
+}
+constexpr u32 FNMADD(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(63, d, a, b, c, 31);
+}
+constexpr u32 FMADDS(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(59, d, a, b, c, 29);
+}
+constexpr u32 PS_MADD(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(4, d, a, b, c, 29);
+}
+constexpr u32 PS_NMSUB(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(4, d, a, b, c, 30);
+}
+constexpr u32 FSEL(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(63, d, a, b, c, 23);
+}
+constexpr u32 PS_SEL(u32 d, u32 a, u32 c, u32 b)
+{
+  return AForm(4, d, a, b, c, 23);
+}
+constexpr u32 B_SELF = 0x48000000;
+
+using Registers = std::array<std::array<u64, 2>, 32>;
+
+class Jit64FloatingPointTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CORE_JIT64);
+    CoreTiming::Init();
+    Memory::Init();
+    ASSERT_NE(nullptr, g_jit);
+
+    UReg_MSR& msr = reinterpret_cast<UReg_MSR&>(MSR);
+    msr.FP = 1;
+    m_cpu_info = cpu_info;
+  }
+
+  void TearDown() override
+  {
+    cpu_info = m_cpu_info;
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  // Compiles the code with or without AVX, and runs it (until the end of the CoreTiming slice,
+  // which is where it stops, since the CPU isn't running) on the given registers.
+  Registers Run(const std::vector<u32>& code, const Registers& registers, bool avx)
+  {
+    cpu_info.bAVX = avx;
+    // Otherwise, fmadd and co. wouldn't need three operand forms.
+    cpu_info.bFMA = false;
+    JitInterface::ClearCache();
+
+    for (size_t i = 0; i < code.size(); ++i)
+      PowerPC::HostWrite_U32(code[i], CODE_ADDRESS + static_cast<u32>(i * 4));
+    for (size_t i = 0; i < registers.size(); ++i)
+    {
+      riPS0(i) = registers[i][0];
+      riPS1(i) = registers[i][1];
+    }
+    PC = CODE_ADDRESS;
+    g_jit->Run();
+
+    const JitBlock* block = g_jit->GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR);
+    m_code_size = block ? block->codeSize : 0;
+
+    Registers result;
+    for (size_t i = 0; i < result.size(); ++i)
+      result[i] = {{riPS0(i), riPS1(i)}};
+    return result;
+  }
+
+  std::string m_profile_path;
+  CPUInfo m_cpu_info;
+  u32 m_code_size = 0;
+};
+}  // namespace
+
+TEST_F(Jit64FloatingPointTest, AVXMatchesSSE)
+{
+  if (!m_cpu_info.bAVX)
+    return;
+
+  const std::vector<u32> code = {
+      // f1-f4 get loaded into registers, which the AVX forms can read from; f5-f8 stay in memory.
+      PS_MERGE01(1, 1, 1), PS_MERGE01(2, 2, 2), PS_MERGE01(3, 3, 3), PS_MERGE01(4, 4, 4),
+      FMADD(10, 1, 3, 2), FMSUB(11, 1, 3, 2), FNMSUB(12, 1, 3, 2), FNMADD(13, 1, 3, 2),
+      FMADDS(14, 1, 3, 2), PS_MADD(15, 1, 3, 2), PS_NMSUB(16, 4, 3, 1), FMADD(17, 5, 7, 6),
+      FNMSUB(18, 5, 7, 6), FSEL(19, 1, 2, 3), PS_SEL(20, 4, 2, 3), PS_SEL(21, 5, 6, 7),
+      PS_SEL(3, 4, 2, 3), PS_SEL(6, 4, 5, 6), PS_SEL(1, 1, 5, 2), B_SELF};
+
+  constexpr u64 SNAN = 0x7ff4000000000123;
+  constexpr u64 QNAN = 0xfff8000000000456;
+  constexpr u64 MINUS_ZERO = 0x8000000000000000;
+  constexpr u64 ONE_AND_A_HALF = 0x3ff8000000000000;
+  constexpr u64 MINUS_THREE = 0xc008000000000000;
+  constexpr u64 DENORMAL = 0x0000000000000001;
+  constexpr u64 HUGE = 0x7fefffffffffffff;
+  constexpr u64 PI = 0x400921fb54442d18;
+
+  std::vector<Registers> inputs(2);
+  for (u64 i = 0; i < 32; ++i)
+    inputs[0][i] = {{0x3ff0000000000000 + (i << 44), 0xbfe0000000000000 - (i << 40)}};
+  inputs[0][4] = {{MINUS_THREE, PI}};
+  inputs[0][5] = {{MINUS_ZERO, 0}};
+
+  inputs[1] = inputs[0];
+  inputs[1][1] = {{SNAN, MINUS_ZERO}};
+  inputs[1][2] = {{PI, QNAN}};
+  inputs[1][3] = {{HUGE, DENORMAL}};
+  inputs[1][4] = {{QNAN, MINUS_THREE}};
+  inputs[1][5] = {{ONE_AND_A_HALF, SNAN}};
+  inputs[1][7] = {{DENORMAL, HUGE}};
+
+  for (bool accurate_nans : {false, true})
+  {
+    SConfig::GetInstance().bAccurateNaNs = accurate_nans;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+      const Registers sse = Run(code, inputs[i], false);
+      const u32 sse_code_size = m_code_size;
+      const Registers avx = Run(code, inputs[i], true);
+
+      EXPECT_EQ(sse, avx) << "inputs " << i << ", accurate NaNs " << accurate_nans;
+      EXPECT_NE(inputs[i], sse);
+      EXPECT_GT(sse_code_size, m_code_size);
+    }
+  }
+}
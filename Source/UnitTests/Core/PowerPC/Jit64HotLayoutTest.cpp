@@ -0,0 +1,110 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+// JitBase.h pulls in the x64Emitter, whose TEST method conflicts with gtest's TEST macro. Only
+// TEST_F is used here.
+#undef TEST
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// With address translation off, so that these are also the physical addresses.
+constexpr u32 HOT_ADDRESS = 0x00003000;
+constexpr u32 COLD_ADDRESS = 0x00004000;
+
+constexpr u32 BLR = 0x4e800020;
+
+// The frames before the first hot layout.
+constexpr int WARMUP_FRAMES = 600;
+
+class Jit64HotLayoutTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    SConfig::GetInstance().bJITHotLayout = true;
+    PowerPC::Init(PowerPC::CORE_JIT64);
+    CoreTiming::Init();
+    Memory::Init();
+    ASSERT_NE(nullptr, g_jit);
+
+    PowerPC::HostWrite_U32(BLR, HOT_ADDRESS);
+    PowerPC::HostWrite_U32(BLR, COLD_ADDRESS);
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  JitBlock* GetBlock(u32 address)
+  {
+    return g_jit->GetBlockCache()->GetBlockFromStartAddress(address, MSR);
+  }
+
+  JitBlock* Compile(u32 address)
+  {
+    PC = address;
+    g_jit->Jit(address);
+    return GetBlock(address);
+  }
+
+  // Compiles a hot block, and ends enough frames for it to be moved.
+  const u8* CompileHotBlock()
+  {
+    JitBlock* block = Compile(HOT_ADDRESS);
+    block->runCount = 1000;
+    for (int i = 0; i < WARMUP_FRAMES; ++i)
+      g_jit->EndFrame();
+    return block->checkedEntry;
+  }
+
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(Jit64HotLayoutTest, MovesHotBlocksBeforeCompiling)
+{
+  const u8* entry = CompileHotBlock();
+  // The end of a frame can be in the middle of the block, so it must not be moved yet.
+  EXPECT_EQ(entry, GetBlock(HOT_ADDRESS)->checkedEntry);
+
+  Compile(COLD_ADDRESS);
+  ASSERT_NE(nullptr, GetBlock(HOT_ADDRESS));
+  EXPECT_NE(entry, GetBlock(HOT_ADDRESS)->checkedEntry);
+}
+
+TEST_F(Jit64HotLayoutTest, LeavesBlocksAloneWhileDebugging)
+{
+  const u8* entry = CompileHotBlock();
+  SConfig::GetInstance().bEnableDebugging = true;
+  Compile(COLD_ADDRESS);
+  EXPECT_EQ(entry, GetBlock(HOT_ADDRESS)->checkedEntry);
+}
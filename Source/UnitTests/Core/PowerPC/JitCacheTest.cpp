@@ -0,0 +1,196 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+// JitBase.h pulls in the x64Emitter, whose TEST method conflicts with gtest's TEST macro. Only
+// TEST_F is used here.
+#undef TEST
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/Config/Config.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HLE/HLE.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+#include "Core/PowerPC/JitCommon/JitCache.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+// With address translation off, so that this is also the physical address.
+constexpr u32 CODE_ADDRESS = 0x00003000;
+
+constexpr u32 ADDI_R3_R3_1 = 0x38630001;
+constexpr u32 ADDI_R3_R3_2 = 0x38630002;
+constexpr u32 BLR = 0x4e800020;
+
+class JitCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    Core::DeclareAsCPUThread();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    PowerPC::Init(PowerPC::CORE_CACHEDINTERPRETER);
+    CoreTiming::Init();
+    Memory::Init();
+    ASSERT_NE(nullptr, g_jit);
+  }
+
+  void TearDown() override
+  {
+    Memory::Shutdown();
+    CoreTiming::Shutdown();
+    PowerPC::Shutdown();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    Core::UndeclareAsCPUThread();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void WriteCode(const std::vector<u32>& code, u32 address = CODE_ADDRESS)
+  {
+    for (size_t i = 0; i < code.size(); ++i)
+      PowerPC::HostWrite_U32(code[i], address + static_cast<u32>(i * 4));
+  }
+
+  // Returns the entry of the block at the address, compiling it if there isn't one.
+  const u8* GetEntry(u32 address = CODE_ADDRESS)
+  {
+    if (const u8* entry = Dispatch(address))
+      return entry;
+    PC = address;
+    g_jit->Jit(address);
+    return Dispatch(address);
+  }
+
+  const u8* Dispatch(u32 address = CODE_ADDRESS)
+  {
+    PC = address;
+    return g_jit->GetBlockCache()->Dispatch();
+  }
+
+  // Compiles a block that ran run_count times and exits to the given addresses.
+  JitBlock* AddBlock(u32 address, int run_count, const std::vector<u32>& exits)
+  {
+    WriteCode({BLR}, address);
+    GetEntry(address);
+    JitBlock* block = g_jit->GetBlockCache()->GetBlockFromStartAddress(address, MSR);
+    block->runCount = run_count;
+    for (u32 exit : exits)
+      block->linkData.push_back({nullptr, exit, false, false});
+    return block;
+  }
+
+  std::string m_profile_path;
+};
+}  // namespace
+
+TEST_F(JitCacheTest, RevivesUnchangedBlocks)
+{
+  WriteCode({ADDI_R3_R3_1, BLR});
+  const u8* entry = GetEntry();
+  ASSERT_NE(nullptr, entry);
+  const JitBlock* block = g_jit->GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR);
+
+  JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+  EXPECT_EQ(nullptr, g_jit->GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR));
+  EXPECT_EQ(entry, Dispatch());
+  // Compiled code may point into the block, so it must not have moved.
+  EXPECT_EQ(block, g_jit->GetBlockCache()->GetBlockFromStartAddress(CODE_ADDRESS, MSR));
+
+  // It can be invalidated again.
+  JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+  EXPECT_EQ(entry, Dispatch());
+}
+
+TEST_F(JitCacheTest, RecompilesChangedBlocks)
+{
+  WriteCode({ADDI_R3_R3_1, BLR});
+  const u8* old_entry = GetEntry();
+
+  WriteCode({ADDI_R3_R3_2, BLR});
+  JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+  EXPECT_EQ(nullptr, Dispatch());
+  const u8* new_entry = GetEntry();
+  EXPECT_NE(old_entry, new_entry);
+
+  // Code that is swapped back in doesn't need to be compiled again either.
+  WriteCode({ADDI_R3_R3_1, BLR});
+  JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+  EXPECT_EQ(old_entry, Dispatch());
+  WriteCode({ADDI_R3_R3_2, BLR});
+  JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+  EXPECT_EQ(new_entry, Dispatch());
+}
+
+TEST_F(JitCacheTest, ForcedInvalidationRecompiles)
+{
+  WriteCode({ADDI_R3_R3_1, BLR});
+  GetEntry();
+  g_jit->GetBlockCache()->InvalidateICache(CODE_ADDRESS, 4, true);
+  EXPECT_EQ(nullptr, Dispatch());
+
+  // Including blocks that were parked by an earlier invalidation.
+  GetEntry();
+  JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+  g_jit->GetBlockCache()->InvalidateICache(CODE_ADDRESS, 4, true);
+  EXPECT_EQ(nullptr, Dispatch());
+}
+
+TEST_F(JitCacheTest, HLEPatchingRecompiles)
+{
+  // The instructions don't change, but the hook has to be compiled in, and out again.
+  WriteCode({ADDI_R3_R3_1, BLR});
+  GetEntry();
+  HLE::Patch(CODE_ADDRESS, "HBReload");
+  EXPECT_EQ(nullptr, Dispatch());
+  GetEntry();
+  EXPECT_TRUE(HLE::UnPatch(CODE_ADDRESS, "HBReload"));
+  EXPECT_EQ(nullptr, Dispatch());
+}
+
+TEST_F(JitCacheTest, DropsParkedBlocksPastTheLimit)
+{
+  for (u32 i = 0; i <= JitBaseBlockCache::MAX_PARKED_BLOCKS; ++i)
+  {
+    const u32 address = CODE_ADDRESS + i * 4;
+    WriteCode({BLR}, address);
+    GetEntry(address);
+    JitInterface::InvalidateICache(address, 4, false);
+  }
+  EXPECT_EQ(nullptr, Dispatch());
+}
+
+TEST_F(JitCacheTest, LaysOutHotChains)
+{
+  const u32 a = CODE_ADDRESS, b = a + 0x100, c = a + 0x200, d = a + 0x300, e = a + 0x400,
+            f = a + 0x500;
+  JitBlock* block_a = AddBlock(a, 100, {b, c});
+  JitBlock* block_b = AddBlock(b, 10, {});
+  JitBlock* block_c = AddBlock(c, 50, {b, a});
+  AddBlock(d, 1, {a});
+  JitBlock* block_e = AddBlock(e, 20, {});
+  JitBlock* block_f = AddBlock(f, 30, {e});
+
+  // a goes on with c, its hottest destination, and c with b, since a is already placed. d isn't
+  // hot.
+  EXPECT_EQ(std::vector<JitBlock*>({block_a, block_c, block_b, block_f, block_e}),
+            g_jit->GetBlockCache()->GetHotBlockLayout(5));
+
+  g_jit->GetBlockCache()->ResetRunCounts();
+  EXPECT_EQ(std::vector<JitBlock*>(), g_jit->GetBlockCache()->GetHotBlockLayout(1));
+}
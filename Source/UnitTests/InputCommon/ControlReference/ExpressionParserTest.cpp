@@ -0,0 +1,207 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "InputCommon/ControlReference/ExpressionParser.h"
+#include "InputCommon/ControllerInterface/Device.h"
+
+using namespace ciface::ExpressionParser;
+
+namespace
+{
+class TestDevice final : public ciface::Core::Device
+{
+public:
+  class TestInput final : public Input
+  {
+  public:
+    explicit TestInput(const std::string& name) : m_name(name) {}
+    std::string GetName() const override { return m_name; }
+    ControlState GetState() const override { return m_state; }
+    void SetState(ControlState state) { m_state = state; }
+
+  private:
+    std::string m_name;
+    ControlState m_state = 0.0;
+  };
+
+  TestDevice()
+  {
+    for (char c = 'A'; c <= 'P'; ++c)
+    {
+      m_test_inputs.push_back(new TestInput(std::string(1, c)));
+      AddInput(m_test_inputs.back());
+    }
+  }
+
+  std::string GetName() const override { return "Device"; }
+  std::string GetSource() const override { return "Test"; }
+  const std::vector<TestInput*>& GetTestInputs() const { return m_test_inputs; }
+
+private:
+  std::vector<TestInput*> m_test_inputs;
+};
+
+class TestContainer final : public ciface::Core::DeviceContainer
+{
+public:
+  void AddDevice(std::shared_ptr<ciface::Core::Device> device)
+  {
+    m_devices.push_back(std::move(device));
+  }
+};
+
+class ExpressionParserTest : public testing::Test
+{
+protected:
+  ExpressionParserTest() : m_device(std::make_shared<TestDevice>())
+  {
+    m_device->SetId(0);
+    m_container.AddDevice(m_device);
+    m_default_device.FromDevice(m_device.get());
+  }
+
+  std::unique_ptr<Expression> Parse(const std::string& text)
+  {
+    ControlFinder finder(m_container, m_default_device, true);
+    Expression* expression = nullptr;
+    ParseExpression(text, finder, &expression);
+    return std::unique_ptr<Expression>(expression);
+  }
+
+  void Randomize()
+  {
+    for (TestDevice::TestInput* input : m_device->GetTestInputs())
+      input->SetState(m_distribution(m_generator));
+  }
+
+  std::shared_ptr<TestDevice> m_device;
+  TestContainer m_container;
+  ciface::Core::DeviceQualifier m_default_device;
+  std::mt19937 m_generator{1234};
+  std::uniform_real_distribution<ControlState> m_distribution{0.0, 1.0};
+};
+
+// A profile with a Wiimote and Nunchuk mapped with modifiers and combinations.
+const std::vector<std::string> COMPLEX_PROFILE = {
+    "A",
+    "!B",
+    "B & !C",
+    "(C | D) & !(E + F)",
+    "`Test/0/Device:G` + `Test/0/Device:H`",
+    "(A & B) | (C & D) | (E & F) | (G & H)",
+    "!(!(!(!(I | J))))",
+    "K + (L | M) + (N & !O)",
+    "(P & A) | (P & B) | (P & C) | (P & D) | (P & E)",
+    "A | (B | (C | (D | (E | (F | G)))))",
+    "`Missing` | (`Missing` & K)",
+    "M + N + O + P",
+    "!`Missing`",
+};
+}  // namespace
+
+TEST_F(ExpressionParserTest, MatchesTree)
+{
+  for (const std::string& text : COMPLEX_PROFILE)
+  {
+    const auto expression = Parse(text);
+    ASSERT_NE(nullptr, expression) << text;
+    for (int i = 0; i < 100; ++i)
+    {
+      Randomize();
+      EXPECT_EQ(expression->GetTreeValue(), expression->GetValue()) << text;
+    }
+  }
+}
+
+TEST_F(ExpressionParserTest, DeepNesting)
+{
+  std::string text = "A";
+  // Deeper than the stack of the compiled program.
+  for (int i = 0; i < 2; ++i)
+  {
+    for (char c = 'B'; c <= 'P'; ++c)
+      text = std::string(1, c) + " & (" + text + ")";
+  }
+  for (int i = 0; i < 3; ++i)
+    text = "A | (" + text + ")";
+
+  const auto expression = Parse(text);
+  ASSERT_NE(nullptr, expression);
+  for (int i = 0; i < 100; ++i)
+  {
+    Randomize();
+    EXPECT_EQ(expression->GetTreeValue(), expression->GetValue());
+  }
+}
+
+TEST_F(ExpressionParserTest, FoldsConstants)
+{
+  auto expression = Parse("!`Missing`");
+  ASSERT_EQ(1u, expression->GetProgram().size());
+  EXPECT_EQ(Instruction::Op::PushConstant, expression->GetProgram()[0].op);
+  EXPECT_EQ(1.0, expression->GetValue());
+
+  expression = Parse("A & !(`Missing` | `Other`)");
+  ASSERT_EQ(3u, expression->GetProgram().size());
+  EXPECT_EQ(Instruction::Op::PushInput, expression->GetProgram()[0].op);
+  EXPECT_EQ(m_device->GetTestInputs()[0], expression->GetProgram()[0].input);
+  EXPECT_EQ(Instruction::Op::PushConstant, expression->GetProgram()[1].op);
+  EXPECT_EQ(1.0, expression->GetProgram()[1].constant);
+  EXPECT_EQ(Instruction::Op::And, expression->GetProgram()[2].op);
+
+  m_device->GetTestInputs()[0]->SetState(0.75);
+  EXPECT_EQ(0.75, expression->GetValue());
+}
+
+TEST_F(ExpressionParserTest, EvaluationBenchmark)
+{
+  std::vector<std::unique_ptr<Expression>> profile;
+  for (int i = 0; i < 10; ++i)
+  {
+    for (const std::string& text : COMPLEX_PROFILE)
+      profile.push_back(Parse(text));
+  }
+  Randomize();
+
+  // Best of a few runs, as both variants are short enough to be thrown off by anything else.
+  constexpr int NUM_RUNS = 5;
+  constexpr int NUM_POLLS = 10000;
+  const auto measure = [&profile](bool compiled, ControlState* sum) {
+    double best_ns = 0.0;
+    for (int run = 0; run < NUM_RUNS; ++run)
+    {
+      *sum = 0.0;
+      const auto start = std::chrono::steady_clock::now();
+      for (int poll = 0; poll < NUM_POLLS; ++poll)
+      {
+        for (const auto& expression : profile)
+          *sum += compiled ? expression->GetValue() : expression->GetTreeValue();
+      }
+      const double ns = std::chrono::duration<double, std::nano>(
+                            std::chrono::steady_clock::now() - start)
+                            .count() /
+                        NUM_POLLS;
+      if (run == 0 || ns < best_ns)
+        best_ns = ns;
+    }
+    return best_ns;
+  };
+
+  ControlState tree_sum, compiled_sum;
+  const double tree_ns = measure(false, &tree_sum);
+  const double compiled_ns = measure(true, &compiled_sum);
+
+  EXPECT_EQ(tree_sum, compiled_sum);
+  std::printf("%zu references per poll: tree %.0f ns, compiled %.0f ns per poll\n",
+              profile.size(), tree_ns, compiled_ns);
+}
@@ -0,0 +1,142 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/Event.h"
+#include "Common/FileUtil.h"
+#include "InputCommon/ControllerInterface/ControllerInterface.h"
+#include "InputCommon/ControllerInterface/Pipes/Pipes.h"
+#ifdef CIFACE_USE_INPUT_THREAD
+#include "InputCommon/ControllerInterface/InputThread.h"
+#endif
+
+namespace
+{
+class PipesTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_temp_dir = File::CreateTempDir();
+    m_pipe_path = m_temp_dir + DIR_SEP "pipe";
+    ASSERT_EQ(0, mkfifo(m_pipe_path.c_str(), 0600));
+
+    // Opened like PopulateDevices() does. The writer can only be opened once there is a reader.
+    const int fd = open(m_pipe_path.c_str(), O_RDONLY | O_NONBLOCK);
+    ASSERT_GE(fd, 0);
+    m_device = std::make_shared<ciface::Pipes::PipeDevice>(fd, "pipe");
+    OpenWriter();
+  }
+
+  void TearDown() override
+  {
+    close(m_writer);
+    m_device.reset();
+    File::DeleteDirRecursively(m_temp_dir);
+  }
+
+  void OpenWriter()
+  {
+    m_writer = open(m_pipe_path.c_str(), O_WRONLY | O_NONBLOCK);
+    ASSERT_GE(m_writer, 0);
+  }
+
+  void Write(const std::string& text)
+  {
+    ASSERT_EQ(static_cast<ssize_t>(text.size()), write(m_writer, text.data(), text.size()));
+  }
+
+  ControlState GetState(const std::string& input) const
+  {
+    const ciface::Core::Device::Input* const control = m_device->FindInput(input);
+    EXPECT_NE(nullptr, control) << input;
+    return control ? control->GetState() : -1.0;
+  }
+
+  std::string m_temp_dir;
+  std::string m_pipe_path;
+  std::shared_ptr<ciface::Pipes::PipeDevice> m_device;
+  int m_writer = -1;
+};
+}  // namespace
+
+TEST_F(PipesTest, ParsesCommands)
+{
+  EXPECT_EQ(0.0, GetState("Button A"));
+  EXPECT_EQ(0.5, GetState("Axis MAIN X +"));
+
+  Write("PRESS A\nPRESS START\nSET MAIN 1 0\nSET L 1\nRELEASE A\n");
+  m_device->UpdateInput();
+  EXPECT_TRUE(m_device->InputChanged());
+  EXPECT_EQ(0.0, GetState("Button A"));
+  EXPECT_EQ(1.0, GetState("Button START"));
+  EXPECT_EQ(1.0, GetState("Axis MAIN X +"));
+  EXPECT_EQ(0.0, GetState("Axis MAIN X -"));
+  EXPECT_EQ(1.0, GetState("Axis MAIN Y -"));
+  EXPECT_EQ(1.0, GetState("Axis L +"));
+
+  // Nothing changes until a command is complete.
+  Write("PRESS B");
+  m_device->UpdateInput();
+  EXPECT_FALSE(m_device->InputChanged());
+  EXPECT_EQ(0.0, GetState("Button B"));
+  Write("\n");
+  m_device->UpdateInput();
+  EXPECT_TRUE(m_device->InputChanged());
+  EXPECT_EQ(1.0, GetState("Button B"));
+}
+
+#ifdef CIFACE_USE_INPUT_THREAD
+TEST_F(PipesTest, InputThread)
+{
+  Common::Event changed;
+  ciface::Core::InputThread thread([&changed] { changed.Set(); });
+  ASSERT_TRUE(thread.IsRunning());
+  ASSERT_TRUE(thread.AddDevice(m_device));
+
+  Write("PRESS X\n");
+  ASSERT_TRUE(changed.WaitFor(std::chrono::seconds(10)));
+  EXPECT_EQ(1.0, GetState("Button X"));
+
+  // A partial command doesn't count as a change.
+  Write("RELEASE ");
+  Write("X\n");
+  ASSERT_TRUE(changed.WaitFor(std::chrono::seconds(10)));
+  EXPECT_EQ(0.0, GetState("Button X"));
+
+  // Commands are usually sent by processes that open the pipe, write and close it again.
+  close(m_writer);
+  OpenWriter();
+  Write("SET R 1\n");
+  ASSERT_TRUE(changed.WaitFor(std::chrono::seconds(10)));
+  EXPECT_EQ(1.0, GetState("Axis R +"));
+
+  thread.RemoveDevice(m_device.get());
+  EXPECT_EQ(1, m_device.use_count());
+}
+
+TEST_F(PipesTest, InputThreadRejectsRegularFiles)
+{
+  // epoll can't watch regular files, so a device on one has to be polled as usual.
+  const std::string file_path = m_temp_dir + DIR_SEP "file";
+  ASSERT_TRUE(File::CreateEmptyFile(file_path));
+  const int fd = open(file_path.c_str(), O_RDONLY | O_NONBLOCK);
+  ASSERT_GE(fd, 0);
+  auto device = std::make_shared<ciface::Pipes::PipeDevice>(fd, "file");
+
+  ciface::Core::InputThread thread([] {});
+  ASSERT_TRUE(thread.IsRunning());
+  EXPECT_FALSE(thread.AddDevice(device));
+  EXPECT_EQ(1, device.use_count());
+}
+#endif
@@ -0,0 +1,150 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/FileUtil.h"
+#include "InputCommon/ControllerInterface/ControllerInterface.h"
+#include "InputCommon/ControllerInterface/Pipes/Pipes.h"
+#include "InputCommon/InputLatency.h"
+
+namespace
+{
+// Drives a pipe device from a script, and polls and presents like the emulated hardware would.
+class InputLatencyTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_temp_dir = File::CreateTempDir();
+    const std::string pipe_path = m_temp_dir + DIR_SEP "pipe";
+    ASSERT_EQ(0, mkfifo(pipe_path.c_str(), 0600));
+    const int fd = open(pipe_path.c_str(), O_RDONLY | O_NONBLOCK);
+    ASSERT_GE(fd, 0);
+    m_device = std::make_unique<ciface::Pipes::PipeDevice>(fd, "pipe");
+    m_writer = open(pipe_path.c_str(), O_WRONLY | O_NONBLOCK);
+    ASSERT_GE(m_writer, 0);
+
+    // Not 0, which marks an unused input event.
+    s_now_ns = 1;
+    InputLatency::SetClock([] { return s_now_ns; });
+    InputLatency::SetEnabled(true);
+  }
+
+  void TearDown() override
+  {
+    InputLatency::SetEnabled(false);
+    InputLatency::SetClock(nullptr);
+    close(m_writer);
+    m_device.reset();
+    File::DeleteDirRecursively(m_temp_dir);
+  }
+
+  // What ControllerInterface does when a device's input changed.
+  void SendCommand(const std::string& command)
+  {
+    const std::string line = command + "\n";
+    ASSERT_EQ(static_cast<ssize_t>(line.size()), write(m_writer, line.data(), line.size()));
+    m_device->UpdateInput();
+    ASSERT_TRUE(m_device->InputChanged());
+    InputLatency::OnInputChanged(++m_input_version);
+  }
+
+  // Only button A is mapped.
+  void Poll()
+  {
+    const ControlState state = m_device->FindInput("Button A")->GetState();
+    InputLatency::OnInputPolled(&m_source, m_input_version, state != m_last_state, ++m_ticks);
+    m_last_state = state;
+  }
+
+  void Present() { InputLatency::OnFramePresented(++m_ticks); }
+
+  // The host time stands still otherwise, so that the statistics don't depend on scheduling.
+  static void AdvanceMs(u64 ms) { s_now_ns += ms * 1000000; }
+
+  static u64 s_now_ns;
+
+  std::string m_temp_dir;
+  std::unique_ptr<ciface::Pipes::PipeDevice> m_device;
+  int m_writer = -1;
+  u64 m_input_version = 0;
+  u64 m_ticks = 0;
+  InputLatency::PollSource m_source;
+  ControlState m_last_state = 0.0;
+};
+
+u64 InputLatencyTest::s_now_ns;
+}  // namespace
+
+TEST_F(InputLatencyTest, Disabled)
+{
+  InputLatency::SetEnabled(false);
+  SendCommand("PRESS A");
+  Poll();
+  Present();
+  EXPECT_EQ(0u, InputLatency::GetStatistics().samples);
+  EXPECT_EQ("", InputLatency::GetStatisticsString());
+}
+
+TEST_F(InputLatencyTest, ScriptedPresses)
+{
+  constexpr int NUM_PRESSES = 10;
+  for (int i = 0; i < NUM_PRESSES; ++i)
+  {
+    SendCommand(i % 2 ? "RELEASE A" : "PRESS A");
+    AdvanceMs(2);
+    Poll();
+    AdvanceMs(3);
+    Present();
+  }
+
+  const InputLatency::Statistics statistics = InputLatency::GetStatistics();
+  EXPECT_EQ(static_cast<size_t>(NUM_PRESSES), statistics.samples);
+  EXPECT_EQ(2000u, statistics.input_to_poll.p50_us);
+  EXPECT_EQ(3000u, statistics.poll_to_present.p50_us);
+  EXPECT_EQ(5000u, statistics.total.p50_us);
+  EXPECT_EQ(5000u, statistics.total.max_us);
+  EXPECT_NE(std::string::npos, InputLatency::GetStatisticsString().find("(10 samples)"));
+}
+
+TEST_F(InputLatencyTest, EarliestEventSincePoll)
+{
+  // Button B isn't mapped, so it never shows up in a poll and doesn't count.
+  SendCommand("PRESS B");
+  Poll();
+  AdvanceMs(20);
+
+  // Both changes arrive in the same poll, which is attributed to the earlier one.
+  SendCommand("PRESS A");
+  AdvanceMs(5);
+  SendCommand("RELEASE B");
+  Poll();
+  Present();
+
+  const InputLatency::Statistics statistics = InputLatency::GetStatistics();
+  EXPECT_EQ(1u, statistics.samples);
+  EXPECT_EQ(5000u, statistics.input_to_poll.max_us);
+}
+
+TEST_F(InputLatencyTest, PresentedAfterPoll)
+{
+  SendCommand("PRESS A");
+
+  // A frame that was output before the poll can't reflect it.
+  const u64 earlier_frame = m_ticks;
+  Poll();
+  InputLatency::OnFramePresented(earlier_frame);
+  EXPECT_EQ(0u, InputLatency::GetStatistics().samples);
+
+  Present();
+  EXPECT_EQ(1u, InputLatency::GetStatistics().samples);
+}